@@ -12,6 +12,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QEventLoop>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QThread>
 #include <QtNetwork/QNetworkDiskCache>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
@@ -35,6 +36,7 @@
 #include "avatars/ScriptableAvatar.h"
 #include "RecordingScriptingInterface.h"
 #include "AbstractAudioInterface.h"
+#include "AudioCodec.h"
 
 #include "Agent.h"
 
@@ -77,7 +79,7 @@ void Agent::handleOctreePacket(QSharedPointer<NLPacket> packet, SharedNodePointe
             // pull out the piggybacked packet and create a new QSharedPointer<NLPacket> for it
             int piggyBackedSizeWithHeader = packet->getPayloadSize() - statsMessageLength;
             
-            auto buffer = std::unique_ptr<char[]>(new char[piggyBackedSizeWithHeader]);
+            auto buffer = udt::PacketData(new char[piggyBackedSizeWithHeader]);
             memcpy(buffer.get(), packet->getPayload() + statsMessageLength, piggyBackedSizeWithHeader);
 
             auto newPacket = NLPacket::fromReceivedPacket(std::move(buffer), piggyBackedSizeWithHeader, packet->getSenderSockAddr());
@@ -135,15 +137,20 @@ void Agent::run() {
                                                  << NodeType::MessagesMixer
                                                 );
 
+    // the payload is the URL of the script, optionally followed by the number of instances of it this agent hosts
+    QStringList payloadParts = QString(_payload).split(' ', QString::SkipEmptyParts);
+    QString scriptFileName = payloadParts.value(0);
+    int numInstances = qMax(payloadParts.value(1).toInt(), 1);
+
     // figure out the URL for the script for this agent assignment
     QUrl scriptURL;
-    if (_payload.isEmpty())  {
+    if (scriptFileName.isEmpty())  {
         scriptURL = QUrl(QString("http://%1:%2/assignment/%3")
             .arg(DependencyManager::get<NodeList>()->getDomainHandler().getIP().toString())
             .arg(DOMAIN_SERVER_HTTP_PORT)
             .arg(uuidStringWithoutCurlyBraces(_uuid)));
     } else {
-        scriptURL = QUrl(_payload);
+        scriptURL = QUrl(scriptFileName);
     }
 
     QNetworkAccessManager& networkAccessManager = NetworkAccessManager::getInstance();
@@ -168,7 +175,31 @@ void Agent::run() {
 
     qDebug() << "Downloaded script:" << scriptContents;
 
-    _scriptEngine = std::unique_ptr<ScriptEngine>(new ScriptEngine(scriptContents, _payload));
+    auto avatarHashMap = DependencyManager::set<AvatarHashMap>();
+
+    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+    packetReceiver.registerListener(PacketType::BulkAvatarData, avatarHashMap.data(), "processAvatarDataPacket");
+    packetReceiver.registerListener(PacketType::KillAvatar, avatarHashMap.data(), "processKillAvatar");
+    packetReceiver.registerListener(PacketType::AvatarIdentity, avatarHashMap.data(), "processAvatarIdentityPacket");
+    packetReceiver.registerListener(PacketType::AvatarBillboard, avatarHashMap.data(), "processAvatarBillboardPacket");
+
+    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
+
+    // we need to make sure that init has been called for our EntityScriptingInterface
+    // so that it actually has a jurisdiction listener when we ask it for it next
+    entityScriptingInterface->init();
+    _entityViewer.setJurisdictionListener(entityScriptingInterface->getJurisdictionListener());
+    
+    _entityViewer.init();
+    
+    entityScriptingInterface->setEntityTree(_entityViewer.getTree());
+
+    if (numInstances > 1) {
+        runHostedScripts(scriptContents, scriptFileName, numInstances);
+        return;
+    }
+
+    _scriptEngine = std::unique_ptr<ScriptEngine>(new ScriptEngine(scriptContents, scriptFileName));
     _scriptEngine->setParent(this); // be the parent of the script engine so it gets moved when we do
 
     // setup an Avatar for the script to use
@@ -199,20 +230,13 @@ void Agent::run() {
         Transform audioTransform;
         audioTransform.setTranslation(scriptedAvatar->getPosition());
         audioTransform.setRotation(scriptedAvatar->getOrientation());
-        AbstractAudioInterface::emitAudioPacket(audio.data(), audio.size(), audioSequenceNumber, audioTransform, PacketType::MicrophoneAudioNoEcho);
+        AbstractAudioInterface::emitAudioPacket(audio.data(), audio.size(), audioSequenceNumber, audioTransform,
+                                                PacketType::MicrophoneAudioNoEcho, AudioCodec::getPCM());
     });
 
 
-
-    auto avatarHashMap = DependencyManager::set<AvatarHashMap>();
     _scriptEngine->registerGlobalObject("AvatarList", avatarHashMap.data());
 
-    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
-    packetReceiver.registerListener(PacketType::BulkAvatarData, avatarHashMap.data(), "processAvatarDataPacket");
-    packetReceiver.registerListener(PacketType::KillAvatar, avatarHashMap.data(), "processKillAvatar");
-    packetReceiver.registerListener(PacketType::AvatarIdentity, avatarHashMap.data(), "processAvatarIdentityPacket");
-    packetReceiver.registerListener(PacketType::AvatarBillboard, avatarHashMap.data(), "processAvatarBillboardPacket");
-
     // register ourselves to the script engine
     _scriptEngine->registerGlobalObject("Agent", this);
 
@@ -225,18 +249,7 @@ void Agent::run() {
     QScriptValue webSocketServerConstructorValue = _scriptEngine->newFunction(WebSocketServerClass::constructor);
     _scriptEngine->globalObject().setProperty("WebSocketServer", webSocketServerConstructorValue);
 
-    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
-
     _scriptEngine->registerGlobalObject("EntityViewer", &_entityViewer);
-    
-    // we need to make sure that init has been called for our EntityScriptingInterface
-    // so that it actually has a jurisdiction listener when we ask it for it next
-    entityScriptingInterface->init();
-    _entityViewer.setJurisdictionListener(entityScriptingInterface->getJurisdictionListener());
-    
-    _entityViewer.init();
-    
-    entityScriptingInterface->setEntityTree(_entityViewer.getTree());
 
     // wire up our additional agent related processing to the update signal
     QObject::connect(_scriptEngine.get(), &ScriptEngine::update, this, &Agent::processAgentAvatarAndAudio);
@@ -249,6 +262,36 @@ void Agent::run() {
     setFinished(true);
 }
 
+void Agent::runHostedScripts(const QString& scriptContents, const QString& scriptFileName, int numInstances) {
+    qDebug() << "Hosting" << numInstances << "instances of" << scriptFileName;
+
+    // the instances share this agent's node, so they don't get the Agent, Avatar or EntityViewer objects that steer it -
+    // those are thread-affine and there is only one of each to go around. A script that needs them runs as its own agent.
+    _scriptScheduler = std::unique_ptr<ScriptScheduler>(new ScriptScheduler());
+
+    // the instances update on several scheduler threads and PacketSender::process() isn't safe to call from more than
+    // one of them, so the edit sender gets a thread of its own and the instances only release their edits to it
+    _entityEditSender.initialize(true);
+    connect(_scriptScheduler.get(), &ScriptScheduler::allScriptsFinished, this, [this] {
+        setFinished(true);
+    });
+
+    auto avatarHashMap = DependencyManager::get<AvatarHashMap>();
+    auto soundCache = DependencyManager::get<SoundCache>();
+
+    for (int i = 0; i < numInstances; ++i) {
+        ScriptEngine* scriptEngine = new ScriptEngine(scriptContents, scriptFileName);
+
+        scriptEngine->registerGlobalObject("AvatarList", avatarHashMap.data());
+        scriptEngine->registerGlobalObject("SoundCache", soundCache.data());
+
+        QScriptValue webSocketServerConstructorValue = scriptEngine->newFunction(WebSocketServerClass::constructor);
+        scriptEngine->globalObject().setProperty("WebSocketServer", webSocketServerConstructorValue);
+
+        _scriptScheduler->addScript(scriptEngine);
+    }
+}
+
 void Agent::setIsAvatar(bool isAvatar) {
     _isAvatar = isAvatar;
 
@@ -383,7 +426,8 @@ void Agent::processAgentAvatarAndAudio(float deltaTime) {
                 glm::quat headOrientation = scriptedAvatar->getHeadOrientation();
                 audioPacket->writePrimitive(headOrientation);
 
-                // write the raw audio data
+                // write the raw audio data, agents don't negotiate a codec with the audio-mixer so it is always PCM
+                audioPacket->writePrimitive(AudioCodec::getPCM()->getID());
                 audioPacket->write(reinterpret_cast<const char*>(nextSoundOutput), numAvailableSamples * sizeof(int16_t));
             }
 
@@ -410,6 +454,15 @@ void Agent::aboutToFinish() {
     if (_scriptEngine) {
         _scriptEngine->stop();
     }
+    if (_scriptScheduler) {
+        _scriptScheduler->stopAllScripts();
+
+        // the instances have released their last edits, let the sender's thread get them out before it goes away
+        while (_entityEditSender.hasPacketsToSend()) {
+            QThread::msleep(1);
+        }
+        _entityEditSender.terminate();
+    }
 
     // our entity tree is going to go away so tell that to the EntityScriptingInterface
     DependencyManager::get<EntityScriptingInterface>()->setEntityTree(NULL);
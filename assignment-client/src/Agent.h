@@ -23,6 +23,7 @@
 #include <EntityTree.h>
 #include <EntityTreeHeadlessViewer.h>
 #include <ScriptEngine.h>
+#include <ScriptScheduler.h>
 #include <ThreadedAssignment.h>
 
 #include "MixedAudioStream.h"
@@ -62,6 +63,7 @@ private slots:
 
 private:
     std::unique_ptr<ScriptEngine> _scriptEngine;
+    std::unique_ptr<ScriptScheduler> _scriptScheduler; // hosts the instances when there is more than one
     EntityEditPacketSender _entityEditSender;
     EntityTreeHeadlessViewer _entityViewer;
     
@@ -70,6 +72,8 @@ private:
 
     void setAvatarSound(Sound* avatarSound) { _avatarSound = avatarSound; }
 
+    void runHostedScripts(const QString& scriptContents, const QString& scriptFileName, int numInstances);
+
     void sendAvatarIdentityPacket();
     void sendAvatarBillboardPacket();
 
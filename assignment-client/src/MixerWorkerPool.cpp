@@ -0,0 +1,94 @@
+//
+//  MixerWorkerPool.cpp
+//  assignment-client/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "MixerWorkerPool.h"
+
+MixerWorkerPool::MixerWorkerPool(int numWorkers) {
+    // the thread calling run() does its share of the work, so we only need to spin up the others
+    for (int i = 1; i < numWorkers; ++i) {
+        _threads.emplace_back(&MixerWorkerPool::workerLoop, this, i);
+    }
+}
+
+MixerWorkerPool::~MixerWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _frameStarted.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void MixerWorkerPool::run(int numJobs, const Job& job) {
+    if (_threads.empty()) {
+        // no helpers, this is the serial path
+        for (int i = 0; i < numJobs; ++i) {
+            job(0, i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = &job;
+        _numJobs = numJobs;
+        _nextJob = 0;
+        _numWorkersBusy = (int) _threads.size();
+        ++_frame;
+    }
+    _frameStarted.notify_all();
+
+    drainJobs(0);
+
+    // wait for every worker to be done with this frame before we hand the results back
+    std::unique_lock<std::mutex> lock(_mutex);
+    _frameCompleted.wait(lock, [this]{ return _numWorkersBusy == 0; });
+    _job = nullptr;
+}
+
+void MixerWorkerPool::workerLoop(int workerIndex) {
+    int lastFrame = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _frameStarted.wait(lock, [&]{ return _isStopping || _frame != lastFrame; });
+
+            if (_isStopping) {
+                return;
+            }
+
+            lastFrame = _frame;
+        }
+
+        drainJobs(workerIndex);
+
+        bool isLastWorker = false;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            isLastWorker = (--_numWorkersBusy == 0);
+        }
+
+        if (isLastWorker) {
+            _frameCompleted.notify_one();
+        }
+    }
+}
+
+void MixerWorkerPool::drainJobs(int workerIndex) {
+    // jobs are handed out one at a time so that a few expensive listeners don't stall a single worker
+    int jobIndex;
+    while ((jobIndex = _nextJob++) < _numJobs) {
+        (*_job)(workerIndex, jobIndex);
+    }
+}
@@ -0,0 +1,55 @@
+//
+//  MixerWorkerPool.h
+//  assignment-client/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_MixerWorkerPool_h
+#define hifi_MixerWorkerPool_h
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed set of threads that a mixer fans its per-listener work out to once per frame.
+/// The thread calling run() takes part in the work and run() acts as the frame barrier.
+class MixerWorkerPool {
+public:
+    using Job = std::function<void(int workerIndex, int jobIndex)>;
+
+    MixerWorkerPool(int numWorkers);
+    ~MixerWorkerPool();
+
+    /// number of workers including the calling thread - worker indexes passed to jobs are in [0, getNumWorkers())
+    int getNumWorkers() const { return (int) _threads.size() + 1; }
+
+    /// runs job for every index in [0, numJobs) across the pool, returns once every job has completed
+    void run(int numJobs, const Job& job);
+
+private:
+    void workerLoop(int workerIndex);
+    void drainJobs(int workerIndex);
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _frameStarted;
+    std::condition_variable _frameCompleted;
+
+    const Job* _job { nullptr };
+    int _numJobs { 0 };
+    std::atomic<int> _nextJob { 0 };
+
+    int _frame { 0 }; // bumped once per run() call, workers wake up when it changes
+    int _numWorkersBusy { 0 };
+    bool _isStopping { false };
+};
+
+#endif // hifi_MixerWorkerPool_h
@@ -0,0 +1,155 @@
+//
+//  AssetFileCache.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetFileCache.h"
+
+#include <QtCore/QDebug>
+
+void AssetFileCache::setMaxMappedFiles(int maxMappedFiles) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxMappedFiles = maxMappedFiles;
+    evict();
+}
+
+void AssetFileCache::setHotCacheBudget(qint64 hotCacheBytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _hotCacheBudget = hotCacheBytes;
+    evict();
+}
+
+AssetFileDataPointer AssetFileCache::getAsset(const QString& filePath) {
+    AssetFileDataPointer promotionCandidate;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        auto it = _entries.find(filePath);
+
+        if (it != _entries.end()) {
+            Entry& entry = it.value();
+            auto& lru = entry.isHot ? _hotLRU : _mappedLRU;
+            lru.splice(lru.begin(), lru, entry.lruPosition);
+
+            if (entry.isHot) {
+                ++_numHotHits;
+                return entry.data;
+            }
+
+            ++_numMappedHits;
+
+            if (++entry.numRequests < HOT_REQUEST_THRESHOLD || entry.data->getSize() > _hotCacheBudget) {
+                return entry.data;
+            }
+
+            promotionCandidate = entry.data;
+        } else {
+            ++_numMisses;
+        }
+    }
+
+    if (promotionCandidate) {
+        // the copy happens outside of the lock so that other requests aren't held up behind it
+        return promote(filePath, promotionCandidate);
+    }
+
+    auto mappedData = mapFile(filePath);
+
+    if (!mappedData) {
+        return mappedData;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(filePath);
+    if (it != _entries.end()) {
+        // another request mapped it while we were, use theirs and let ours go
+        return it.value().data;
+    }
+
+    _mappedLRU.push_front(filePath);
+    _entries.insert(filePath, { mappedData, _mappedLRU.begin(), 1, false });
+    evict();
+
+    return mappedData;
+}
+
+AssetFileCache::Stats AssetFileCache::sampleStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return { (int) _mappedLRU.size(), (int) _hotLRU.size(), _hotCacheBytes, _numMappedHits, _numHotHits, _numMisses };
+}
+
+AssetFileDataPointer AssetFileCache::mapFile(const QString& filePath) {
+    auto data = std::make_shared<AssetFileData>();
+    data->_file.reset(new QFile(filePath));
+
+    if (!data->_file->open(QIODevice::ReadOnly)) {
+        return AssetFileDataPointer();
+    }
+
+    data->_size = data->_file->size();
+
+    if (data->_size == 0) {
+        // there is nothing to map for an empty file
+        data->_data = data->_bytes.constData();
+        return data;
+    }
+
+    auto mapping = data->_file->map(0, data->_size);
+
+    if (!mapping) {
+        qDebug() << "Could not map asset file" << filePath << "-" << data->_file->errorString();
+        return AssetFileDataPointer();
+    }
+
+    data->_data = reinterpret_cast<const char*>(mapping);
+    return data;
+}
+
+AssetFileDataPointer AssetFileCache::promote(const QString& filePath, const AssetFileDataPointer& mappedData) {
+    auto hotData = std::make_shared<AssetFileData>();
+    hotData->_bytes = QByteArray(mappedData->getData(), mappedData->getSize());
+    hotData->_data = hotData->_bytes.constData();
+    hotData->_size = hotData->_bytes.size();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto it = _entries.find(filePath);
+    if (it == _entries.end() || it.value().isHot || it.value().data != mappedData) {
+        // the entry changed while we were copying, it's either hot already or was evicted
+        return hotData;
+    }
+
+    Entry& entry = it.value();
+    _mappedLRU.erase(entry.lruPosition);
+    _hotLRU.push_front(filePath);
+
+    entry.data = hotData;
+    entry.lruPosition = _hotLRU.begin();
+    entry.isHot = true;
+
+    _hotCacheBytes += hotData->getSize();
+    evict();
+
+    return hotData;
+}
+
+void AssetFileCache::evict() {
+    while ((int) _mappedLRU.size() > _maxMappedFiles) {
+        _entries.remove(_mappedLRU.back());
+        _mappedLRU.pop_back();
+    }
+
+    while (_hotCacheBytes > _hotCacheBudget && !_hotLRU.empty()) {
+        auto it = _entries.find(_hotLRU.back());
+        _hotCacheBytes -= it.value().data->getSize();
+        _entries.erase(it);
+        _hotLRU.pop_back();
+    }
+}
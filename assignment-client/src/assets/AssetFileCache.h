@@ -0,0 +1,95 @@
+//
+//  AssetFileCache.h
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetFileCache_h
+#define hifi_AssetFileCache_h
+
+#include <list>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+// The contents of an asset file, either memory-mapped or copied into memory once the asset is hot.
+// It stays valid for as long as someone holds on to it, even if the cache has since dropped it.
+class AssetFileData {
+public:
+    const char* getData() const { return _data; }
+    qint64 getSize() const { return _size; }
+
+private:
+    friend class AssetFileCache;
+
+    std::unique_ptr<QFile> _file; // owns the mapping, which goes away when the file is closed
+    QByteArray _bytes;
+    const char* _data { nullptr };
+    qint64 _size { 0 };
+};
+
+using AssetFileDataPointer = std::shared_ptr<const AssetFileData>;
+
+// Shared by the asset-server's SendAssetTasks so that concurrent requests for the same assets don't each go to disk.
+// Recently requested files stay mapped (up to a maximum number of mappings), and files requested again while mapped
+// are copied into a hot cache that is bounded by a byte budget. Assets are content addressed, so entries never go stale.
+class AssetFileCache {
+public:
+    static const int DEFAULT_MAX_MAPPED_FILES = 128;
+    static const qint64 DEFAULT_HOT_CACHE_BYTES = 64 * 1024 * 1024;
+
+    // number of requests a mapped asset has to see before it is promoted to the hot cache
+    static const int HOT_REQUEST_THRESHOLD = 2;
+
+    void setMaxMappedFiles(int maxMappedFiles);
+    void setHotCacheBudget(qint64 hotCacheBytes);
+
+    // returns nullptr if the file doesn't exist or can't be read
+    AssetFileDataPointer getAsset(const QString& filePath);
+
+    struct Stats {
+        int numMappedFiles;
+        int numHotAssets;
+        qint64 hotCacheBytes;
+        quint64 numMappedHits;
+        quint64 numHotHits;
+        quint64 numMisses;
+    };
+    Stats sampleStats();
+
+private:
+    struct Entry {
+        AssetFileDataPointer data;
+        std::list<QString>::iterator lruPosition; // in _mappedLRU or _hotLRU depending on isHot
+        int numRequests;
+        bool isHot;
+    };
+
+    AssetFileDataPointer mapFile(const QString& filePath);
+    AssetFileDataPointer promote(const QString& filePath, const AssetFileDataPointer& mappedData);
+    void evict();
+
+    std::mutex _mutex;
+
+    QHash<QString, Entry> _entries;
+    std::list<QString> _mappedLRU; // most recently used first
+    std::list<QString> _hotLRU; // most recently used first
+
+    int _maxMappedFiles { DEFAULT_MAX_MAPPED_FILES };
+    qint64 _hotCacheBudget { DEFAULT_HOT_CACHE_BYTES };
+    qint64 _hotCacheBytes { 0 };
+
+    quint64 _numMappedHits { 0 };
+    quint64 _numHotHits { 0 };
+    quint64 _numMisses { 0 };
+};
+
+#endif // hifi_AssetFileCache_h
@@ -12,21 +12,39 @@
 
 #include "AssetServer.h"
 
+#include <algorithm>
+
+#include <QBuffer>
 #include <QCoreApplication>
 #include <QCryptographicHash>
 #include <QDateTime>
 #include <QDir>
+#include <QEventLoop>
 #include <QFile>
 #include <QFileInfo>
+#include <QJsonObject>
 #include <QString>
+#include <QTimer>
 
 #include "NetworkLogging.h"
 #include "NodeType.h"
+#include "NumericalConstants.h"
 #include "SendAssetTask.h"
 #include "UploadAssetTask.h"
+#include "UploadChunkTask.h"
 
 const QString ASSET_SERVER_LOGGING_TARGET_NAME = "asset-server";
 
+// sessions we haven't heard from are dropped from memory, their temporary file stays around to be resumed
+const quint64 IDLE_UPLOAD_SESSION_USECS = 10 * 60 * USECS_PER_SECOND;
+// completed sessions hang around for a bit so that a client that missed the last reply can still get the hash
+const quint64 COMPLETE_UPLOAD_SESSION_USECS = 60 * USECS_PER_SECOND;
+// temporary files from uploads nobody came back for are deleted after a day
+const qint64 ABANDONED_UPLOAD_SECS = 24 * 60 * 60;
+// what a single node can have going at once, so that one node can't fill up the disk with temporary files
+const size_t MAX_UPLOAD_SESSIONS_PER_NODE = 8;
+const DataOffset MAX_UPLOAD_BYTES_PER_NODE = 2 * (DataOffset) MAX_UPLOAD_SIZE;
+
 AssetServer::AssetServer(NLPacket& packet) :
     ThreadedAssignment(packet),
     _taskPool(this)
@@ -41,6 +59,7 @@ AssetServer::AssetServer(NLPacket& packet) :
     packetReceiver.registerListener(PacketType::AssetGet, this, "handleAssetGet");
     packetReceiver.registerListener(PacketType::AssetGetInfo, this, "handleAssetGetInfo");
     packetReceiver.registerMessageListener(PacketType::AssetUpload, this, "handleAssetUpload");
+    packetReceiver.registerMessageListener(PacketType::AssetUploadChunk, this, "handleAssetUploadChunk");
 }
 
 void AssetServer::run() {
@@ -49,6 +68,27 @@ void AssetServer::run() {
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->addNodeTypeToInterestSet(NodeType::Agent);
 
+    // wait until we have the domain-server settings, otherwise we bail
+    DomainHandler& domainHandler = nodeList->getDomainHandler();
+
+    qDebug() << "Waiting for domain settings from domain-server.";
+
+    // block until we get the settingsRequestComplete signal
+    QEventLoop loop;
+    connect(&domainHandler, &DomainHandler::settingsReceived, &loop, &QEventLoop::quit);
+    connect(&domainHandler, &DomainHandler::settingsReceiveFail, &loop, &QEventLoop::quit);
+    domainHandler.requestDomainSettings();
+    loop.exec();
+
+    if (domainHandler.getSettingsObject().isEmpty()) {
+        qDebug() << "Failed to retreive settings object from domain-server. Bailing on assignment.";
+        setFinished(true);
+        return;
+    }
+
+    // parse the settings to pull out the values we need
+    parseDomainServerSettings(domainHandler.getSettingsObject());
+
     _resourcesDirectory = QDir(QCoreApplication::applicationDirPath()).filePath("resources/assets");
     if (!_resourcesDirectory.exists()) {
         qDebug() << "Creating resources directory";
@@ -56,6 +96,18 @@ void AssetServer::run() {
     }
     qDebug() << "Serving files from: " << _resourcesDirectory.path();
 
+    _uploadsDirectory = QDir(_resourcesDirectory.filePath("uploads"));
+    if (!_uploadsDirectory.exists()) {
+        _uploadsDirectory.mkpath(".");
+    }
+
+    // periodically let go of upload sessions that are done or that nobody is sending to anymore
+    static const int PRUNE_UPLOAD_SESSIONS_INTERVAL_MSECS = 60 * 1000;
+    QTimer* pruneTimer = new QTimer(this);
+    connect(pruneTimer, &QTimer::timeout, this, &AssetServer::pruneUploadSessions);
+    pruneTimer->start(PRUNE_UPLOAD_SESSIONS_INTERVAL_MSECS);
+    pruneUploadSessions();
+
     // Scan for new files
     qDebug() << "Looking for new files in asset directory";
     auto files = _resourcesDirectory.entryInfoList(QDir::Files);
@@ -84,6 +136,33 @@ void AssetServer::run() {
     }
 }
 
+void AssetServer::parseDomainServerSettings(const QJsonObject& domainSettings) {
+    const QString ASSET_SERVER_SETTINGS_KEY = "asset_server";
+    const QString HOT_CACHE_SIZE_KEY = "hot_cache_size";
+    const QString MAX_MAPPED_FILES_KEY = "max_mapped_files";
+
+    const qint64 BYTES_PER_MEGABYTE = 1024 * 1024;
+
+    QJsonObject assetServerSettings = domainSettings[ASSET_SERVER_SETTINGS_KEY].toObject();
+
+    bool ok = false;
+    int hotCacheMegabytes = assetServerSettings[HOT_CACHE_SIZE_KEY].toVariant().toInt(&ok);
+    if (ok && hotCacheMegabytes >= 0) {
+        _fileCache.setHotCacheBudget(hotCacheMegabytes * BYTES_PER_MEGABYTE);
+        qDebug() << "Hot asset cache size set to" << hotCacheMegabytes << "MB";
+    } else {
+        qDebug() << HOT_CACHE_SIZE_KEY << "is not a valid size - will continue with default value";
+    }
+
+    int maxMappedFiles = assetServerSettings[MAX_MAPPED_FILES_KEY].toVariant().toInt(&ok);
+    if (ok && maxMappedFiles >= 0) {
+        _fileCache.setMaxMappedFiles(maxMappedFiles);
+        qDebug() << "Keeping up to" << maxMappedFiles << "asset files mapped";
+    } else {
+        qDebug() << MAX_MAPPED_FILES_KEY << "is not a valid number - will continue with default value";
+    }
+}
+
 void AssetServer::handleAssetGetInfo(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
     QByteArray assetHash;
     MessageID messageID;
@@ -132,7 +211,7 @@ void AssetServer::handleAssetGet(QSharedPointer<NLPacket> packet, SharedNodePoin
     }
 
     // Queue task
-    auto task = new SendAssetTask(packet, senderNode, _resourcesDirectory);
+    auto task = new SendAssetTask(packet, senderNode, _resourcesDirectory, _fileCache);
     _taskPool.start(task);
 }
 
@@ -163,6 +242,164 @@ void AssetServer::handleAssetUpload(QSharedPointer<NLPacketList> packetList, Sha
     }
 }
 
+void AssetServer::handleAssetUploadChunk(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode) {
+    auto data = packetList->getMessage();
+
+    QBuffer buffer { &data };
+    buffer.open(QIODevice::ReadOnly);
+
+    AssetUploadChunk chunk;
+    chunk.senderNode = senderNode;
+
+    buffer.read(reinterpret_cast<char*>(&chunk.messageID), sizeof(chunk.messageID));
+
+    if (!senderNode->getCanRez()) {
+        // same as for a regular upload, only nodes allowed to rez entities can add assets
+        sendUploadChunkError(chunk.messageID, AssetServerError::PermissionDenied, senderNode);
+        return;
+    }
+
+    QUuid uploadID = QUuid::fromRfc4122(buffer.read(NUM_BYTES_RFC4122_UUID));
+
+    uint8_t extensionLength;
+    buffer.read(reinterpret_cast<char*>(&extensionLength), sizeof(extensionLength));
+    chunk.extension = QString(buffer.read(extensionLength));
+
+    DataOffset chunkSize;
+    buffer.read(reinterpret_cast<char*>(&chunk.totalSize), sizeof(chunk.totalSize));
+    buffer.read(reinterpret_cast<char*>(&chunk.offset), sizeof(chunk.offset));
+    buffer.read(reinterpret_cast<char*>(&chunkSize), sizeof(chunkSize));
+
+    if (uploadID.isNull() || chunkSize < 0 || chunkSize != buffer.bytesAvailable()) {
+        qDebug() << "ERROR bad upload chunk from" << uuidStringWithoutCurlyBraces(senderNode->getUUID());
+        return;
+    }
+
+    chunk.data = buffer.read(chunkSize);
+
+    const QUuid& senderID = senderNode->getUUID();
+    auto& senderSessions = _uploadSessions[senderID];
+    auto it = senderSessions.find(uploadID);
+
+    if (it == senderSessions.end()) {
+        if (chunk.totalSize < 0 || (uint64_t) chunk.totalSize > MAX_UPLOAD_SIZE) {
+            sendUploadChunkError(chunk.messageID, AssetServerError::AssetTooLarge, senderNode);
+            return;
+        }
+
+        // completed sessions only stick around to repeat their last reply, they don't count against the node
+        auto numOpenSessions = std::count_if(senderSessions.begin(), senderSessions.end(),
+                                             [](const UploadSessions::value_type& session) {
+            return !session.second->isComplete();
+        });
+
+        if ((size_t) numOpenSessions >= MAX_UPLOAD_SESSIONS_PER_NODE
+            || getUploadBytesForNode(senderID, uploadID) + chunk.totalSize > MAX_UPLOAD_BYTES_PER_NODE) {
+            qDebug() << "Refusing upload" << uuidStringWithoutCurlyBraces(uploadID) << "of" << chunk.totalSize
+                << "bytes from" << uuidStringWithoutCurlyBraces(senderID) << "- it has too many uploads in progress";
+            sendUploadChunkError(chunk.messageID, AssetServerError::AssetTooLarge, senderNode);
+            return;
+        }
+
+        qDebug() << "Starting upload" << uuidStringWithoutCurlyBraces(uploadID) << "of" << chunk.totalSize
+            << "bytes and extension" << chunk.extension << "from" << uuidStringWithoutCurlyBraces(senderID);
+
+        auto newSession = std::make_shared<AssetUploadSession>(senderID, uploadID, chunk.totalSize,
+                                                               _resourcesDirectory, _uploadsDirectory);
+        it = senderSessions.emplace(uploadID, newSession).first;
+    }
+
+    auto& session = it->second;
+
+    if (session->queueChunk(std::move(chunk))) {
+        _taskPool.start(new UploadChunkTask(session));
+    }
+}
+
+void AssetServer::pruneUploadSessions() {
+    for (auto senderIt = _uploadSessions.begin(); senderIt != _uploadSessions.end();) {
+        auto& senderSessions = senderIt->second;
+
+        for (auto it = senderSessions.begin(); it != senderSessions.end();) {
+            auto& session = it->second;
+            auto timeout = session->isComplete() ? COMPLETE_UPLOAD_SESSION_USECS : IDLE_UPLOAD_SESSION_USECS;
+
+            if (session->isIdle(timeout)) {
+                it = senderSessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (senderSessions.empty()) {
+            senderIt = _uploadSessions.erase(senderIt);
+        } else {
+            ++senderIt;
+        }
+    }
+
+    // clean up after uploads that were never finished
+    auto partFiles = _uploadsDirectory.entryInfoList(QStringList() << "*.part", QDir::Files);
+    auto now = QDateTime::currentDateTime();
+
+    for (const auto& fileInfo : partFiles) {
+        if (fileInfo.lastModified().secsTo(now) <= ABANDONED_UPLOAD_SECS) {
+            continue;
+        }
+
+        // part files are named <sender>_<upload>.part
+        auto ids = fileInfo.baseName().split('_');
+        auto senderIt = (ids.size() == 2) ? _uploadSessions.find(QUuid(ids[0])) : _uploadSessions.end();
+        bool isOpen = senderIt != _uploadSessions.end() && senderIt->second.find(QUuid(ids[1])) != senderIt->second.end();
+
+        if (!isOpen) {
+            qDebug() << "Removing abandoned upload" << fileInfo.fileName();
+            QFile::remove(fileInfo.absoluteFilePath());
+        }
+    }
+}
+
+DataOffset AssetServer::getUploadBytesForNode(const QUuid& senderID, const QUuid& excludingUploadID) const {
+    DataOffset bytes = 0;
+
+    // open sessions can grow their temporary file up to the size they announced
+    auto senderIt = _uploadSessions.find(senderID);
+    if (senderIt != _uploadSessions.end()) {
+        for (const auto& session : senderIt->second) {
+            if (session.first != excludingUploadID && !session.second->isComplete()) {
+                bytes += session.second->getDeclaredSize();
+            }
+        }
+    }
+
+    // the ones we let go of leave their temporary file behind until it is resumed or pruned
+    auto senderPrefix = uuidStringWithoutCurlyBraces(senderID) + "_";
+    auto partFiles = _uploadsDirectory.entryInfoList(QStringList() << senderPrefix + "*.part", QDir::Files);
+
+    for (const auto& fileInfo : partFiles) {
+        QUuid uploadID(fileInfo.baseName().mid(senderPrefix.size()));
+
+        bool isOpen = senderIt != _uploadSessions.end() && senderIt->second.find(uploadID) != senderIt->second.end();
+        if (uploadID != excludingUploadID && !isOpen) {
+            bytes += fileInfo.size();
+        }
+    }
+
+    return bytes;
+}
+
+void AssetServer::sendUploadChunkError(MessageID messageID, AssetServerError error, const SharedNodePointer& senderNode) {
+    auto errorPacket = NLPacket::create(PacketType::AssetUploadChunkReply,
+                                        sizeof(MessageID) + sizeof(AssetServerError) + sizeof(DataOffset));
+
+    errorPacket->writePrimitive(messageID);
+    errorPacket->writePrimitive(error);
+    errorPacket->writePrimitive(DataOffset(0));
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->sendPacket(std::move(errorPacket), *senderNode);
+}
+
 void AssetServer::sendStatsPacket() {
     QJsonObject serverStats;
     
@@ -228,6 +465,23 @@ void AssetServer::sendStatsPacket() {
         serverStats[uuid] = nodeStats;
     }
     
+    auto cacheStats = _fileCache.sampleStats();
+
+    QJsonObject fileCacheStats;
+    fileCacheStats["1. Mapped Files"] = cacheStats.numMappedFiles;
+    fileCacheStats["2. Hot Assets"] = cacheStats.numHotAssets;
+    fileCacheStats["3. Hot Cache (MB)"] = (double) cacheStats.hotCacheBytes / (1024 * 1024);
+    fileCacheStats["4. Mapped Hits"] = (double) cacheStats.numMappedHits;
+    fileCacheStats["5. Hot Hits"] = (double) cacheStats.numHotHits;
+    fileCacheStats["6. Misses"] = (double) cacheStats.numMisses;
+    serverStats["File Cache"] = fileCacheStats;
+
+    int uploadsInProgress = 0;
+    for (const auto& senderSessions : _uploadSessions) {
+        uploadsInProgress += (int) senderSessions.second.size();
+    }
+    serverStats["Uploads In Progress"] = uploadsInProgress;
+    
     // send off the stats packets
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(serverStats);
 }
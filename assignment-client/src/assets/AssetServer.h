@@ -12,11 +12,16 @@
 #ifndef hifi_AssetServer_h
 #define hifi_AssetServer_h
 
+#include <unordered_map>
+
 #include <QDir>
 
 #include <ThreadedAssignment.h>
 #include <QThreadPool>
+#include <UUIDHasher.h>
 
+#include "AssetFileCache.h"
+#include "AssetUploadSession.h"
 #include "AssetUtils.h"
 
 class AssetServer : public ThreadedAssignment {
@@ -31,12 +36,25 @@ private slots:
     void handleAssetGetInfo(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
     void handleAssetGet(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
     void handleAssetUpload(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode);
+    void handleAssetUploadChunk(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode);
     
     void sendStatsPacket();
+    void pruneUploadSessions();
     
 private:
     static void writeError(NLPacketList* packetList, AssetServerError error);
+    static void sendUploadChunkError(MessageID messageID, AssetServerError error, const SharedNodePointer& senderNode);
+    void parseDomainServerSettings(const QJsonObject& domainSettings);
+
+    /// bytes the node's other uploads may take up on disk, open sessions and temporary files left behind by old ones
+    DataOffset getUploadBytesForNode(const QUuid& senderID, const QUuid& excludingUploadID) const;
+
     QDir _resourcesDirectory;
+    QDir _uploadsDirectory; // temporary files for chunked uploads that are still in progress
+    // keyed by the node that started them and then by the upload ID it picked, a node can only reach its own uploads
+    using UploadSessions = std::unordered_map<QUuid, AssetUploadSessionPointer, UUIDHasher>;
+    std::unordered_map<QUuid, UploadSessions, UUIDHasher> _uploadSessions;
+    AssetFileCache _fileCache; // declared before the task pool so that it outlives any running SendAssetTask
     QThreadPool _taskPool;
 };
 
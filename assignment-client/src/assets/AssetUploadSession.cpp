@@ -0,0 +1,211 @@
+//
+//  AssetUploadSession.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetUploadSession.h"
+
+#include <QtCore/QDebug>
+
+#include <NLPacket.h>
+#include <NodeList.h>
+#include <SharedUtil.h>
+#include <UUID.h>
+
+AssetUploadSession::AssetUploadSession(const QUuid& senderID, const QUuid& uploadID, DataOffset totalSize,
+                                       const QDir& resourcesDir, const QDir& uploadsDir) :
+    _uploadID(uploadID),
+    _declaredSize(totalSize),
+    _resourcesDir(resourcesDir),
+    _partFile(uploadsDir.filePath(partFileName(senderID, uploadID))),
+    _lastActivity(usecTimestampNow())
+{
+
+}
+
+QString AssetUploadSession::partFileName(const QUuid& senderID, const QUuid& uploadID) {
+    return uuidStringWithoutCurlyBraces(senderID) + "_" + uuidStringWithoutCurlyBraces(uploadID) + ".part";
+}
+
+bool AssetUploadSession::queueChunk(AssetUploadChunk chunk) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+
+    _queue.push_back(std::move(chunk));
+    _lastActivity = usecTimestampNow();
+
+    if (_isProcessing) {
+        // the running task will pick this one up
+        return false;
+    }
+
+    _isProcessing = true;
+    return true;
+}
+
+void AssetUploadSession::processQueuedChunks() {
+    while (true) {
+        AssetUploadChunk chunk;
+
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+
+            if (_queue.empty()) {
+                _isProcessing = false;
+                return;
+            }
+
+            chunk = std::move(_queue.front());
+            _queue.pop_front();
+        }
+
+        auto error = writeChunk(chunk);
+        sendReply(chunk, error);
+    }
+}
+
+bool AssetUploadSession::isIdle(quint64 usecs) {
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    return !_isProcessing && _queue.empty() && (usecTimestampNow() - _lastActivity) > usecs;
+}
+
+AssetServerError AssetUploadSession::writeChunk(const AssetUploadChunk& chunk) {
+    if (_isComplete) {
+        // a client resuming an upload we already finished, the reply tells it the hash
+        return AssetServerError::NoError;
+    }
+
+    if (chunk.totalSize < 0 || (uint64_t) chunk.totalSize > MAX_UPLOAD_SIZE) {
+        return AssetServerError::AssetTooLarge;
+    }
+
+    if (_totalSize < 0) {
+        _extension = chunk.extension;
+        _totalSize = chunk.totalSize;
+
+        auto error = openPartFile();
+        if (error != AssetServerError::NoError) {
+            _totalSize = -1;
+            return error;
+        }
+    } else if (chunk.totalSize != _totalSize || chunk.extension != _extension) {
+        return AssetServerError::InvalidByteRange;
+    }
+
+    DataOffset chunkSize = chunk.data.size();
+
+    // we can't take anything past what we have, the reply tells the client where to go back to
+    if (chunk.offset < 0 || chunk.offset > _bytesReceived || chunk.offset + chunkSize > _totalSize) {
+        return AssetServerError::InvalidByteRange;
+    }
+
+    // a resumed client can resend some of what we already have, skip over that part
+    DataOffset skip = _bytesReceived - chunk.offset;
+
+    if (chunkSize > skip) {
+        const char* data = chunk.data.constData() + skip;
+        DataOffset size = chunkSize - skip;
+
+        if (_partFile.write(data, size) != size) {
+            qWarning() << "Could not write to" << _partFile.fileName() << "-" << _partFile.errorString();
+
+            // put the file back where we know it is good
+            _partFile.resize(_bytesReceived);
+            _partFile.seek(_bytesReceived);
+            return AssetServerError::FileOperationFailed;
+        }
+
+        _hash.addData(data, size);
+        _bytesReceived += size;
+    }
+
+    if (_bytesReceived == _totalSize) {
+        return completeUpload();
+    }
+
+    return AssetServerError::NoError;
+}
+
+AssetServerError AssetUploadSession::openPartFile() {
+    if (!_partFile.open(QIODevice::ReadWrite)) {
+        qWarning() << "Could not open" << _partFile.fileName() << "for upload -" << _partFile.errorString();
+        return AssetServerError::FileOperationFailed;
+    }
+
+    if (_partFile.size() > _totalSize) {
+        // this isn't the upload we have a file for, start over
+        _partFile.resize(0);
+    }
+
+    // we're picking up an upload we already had part of, run what we have back through the hash
+    static const qint64 REHASH_BLOCK_SIZE = ASSET_TRANSFER_CHUNK_SIZE;
+
+    while (!_partFile.atEnd()) {
+        auto block = _partFile.read(REHASH_BLOCK_SIZE);
+
+        if (block.isEmpty()) {
+            qWarning() << "Could not read back" << _partFile.fileName() << "-" << _partFile.errorString();
+            _partFile.close();
+            _hash.reset();
+            _bytesReceived = 0;
+            return AssetServerError::FileOperationFailed;
+        }
+
+        _hash.addData(block);
+        _bytesReceived += block.size();
+    }
+
+    if (_bytesReceived > 0) {
+        qDebug() << "Resuming upload" << uuidStringWithoutCurlyBraces(_uploadID) << "at" << _bytesReceived
+            << "of" << _totalSize << "bytes";
+    }
+
+    return AssetServerError::NoError;
+}
+
+AssetServerError AssetUploadSession::completeUpload() {
+    auto hash = _hash.result();
+    auto hexHash = hash.toHex();
+
+    qDebug() << "Hash for upload" << uuidStringWithoutCurlyBraces(_uploadID) << "is: (" << hexHash << ") ";
+
+    _partFile.close();
+
+    QString filePath = _resourcesDir.filePath(QString(hexHash)) + "." + _extension;
+
+    if (QFile::exists(filePath)) {
+        qDebug() << "[WARNING] This file already exists: " << hexHash;
+        _partFile.remove();
+    } else if (!_partFile.rename(filePath)) {
+        qWarning() << "Could not move" << _partFile.fileName() << "to" << filePath << "-" << _partFile.errorString();
+
+        // re-open the part file so that the last chunk can be retried
+        _partFile.open(QIODevice::ReadWrite);
+        _partFile.seek(_partFile.size());
+        return AssetServerError::FileOperationFailed;
+    }
+
+    _finalHash = hash;
+    _isComplete = true;
+
+    return AssetServerError::NoError;
+}
+
+void AssetUploadSession::sendReply(const AssetUploadChunk& chunk, AssetServerError error) {
+    auto replyPacket = NLPacket::create(PacketType::AssetUploadChunkReply);
+
+    replyPacket->writePrimitive(chunk.messageID);
+    replyPacket->writePrimitive(error);
+    replyPacket->writePrimitive(_bytesReceived);
+
+    if (error == AssetServerError::NoError && _isComplete) {
+        replyPacket->write(_finalHash);
+    }
+
+    auto nodeList = DependencyManager::get<NodeList>();
+    nodeList->sendPacket(std::move(replyPacket), *chunk.senderNode);
+}
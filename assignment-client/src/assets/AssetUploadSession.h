@@ -0,0 +1,91 @@
+//
+//  AssetUploadSession.h
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetUploadSession_h
+#define hifi_AssetUploadSession_h
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QUuid>
+
+#include <AssetUtils.h>
+#include <Node.h>
+
+struct AssetUploadChunk {
+    MessageID messageID;
+    QString extension;
+    DataOffset totalSize;
+    DataOffset offset;
+    QByteArray data;
+    SharedNodePointer senderNode;
+};
+
+/// One chunked upload. Chunks are appended to a temporary file in the uploads directory and hashed as they arrive,
+/// once the last one is in the file is moved into place under its hash.
+/// The temporary file outlives the session so that a client can resume the upload after we have let go of it.
+/// Upload IDs are picked by the client, so a session and its temporary file belong to the node that started them.
+class AssetUploadSession {
+public:
+    AssetUploadSession(const QUuid& senderID, const QUuid& uploadID, DataOffset totalSize,
+                       const QDir& resourcesDir, const QDir& uploadsDir);
+
+    /// name of the temporary file in the uploads directory for an upload from the given node
+    static QString partFileName(const QUuid& senderID, const QUuid& uploadID);
+
+    const QUuid& getUploadID() const { return _uploadID; }
+
+    /// the size the first chunk announced, what the session may grow its temporary file to
+    DataOffset getDeclaredSize() const { return _declaredSize; }
+
+    /// queues a chunk, returns true if the caller needs to start an UploadChunkTask to process the queue
+    bool queueChunk(AssetUploadChunk chunk);
+
+    /// writes out every queued chunk in the order they arrived and replies to each of them
+    void processQueuedChunks();
+
+    bool isComplete() const { return _isComplete; }
+
+    /// true if nothing is queued for this session and it has not heard anything for the given time
+    bool isIdle(quint64 usecs);
+
+private:
+    AssetServerError writeChunk(const AssetUploadChunk& chunk);
+    AssetServerError openPartFile();
+    AssetServerError completeUpload();
+    void sendReply(const AssetUploadChunk& chunk, AssetServerError error);
+
+    const QUuid _uploadID;
+    const DataOffset _declaredSize;
+    const QDir _resourcesDir;
+
+    // only touched by the task processing the queue
+    QFile _partFile;
+    QCryptographicHash _hash { QCryptographicHash::Sha256 };
+    QString _extension;
+    DataOffset _totalSize { -1 }; // -1 until the first chunk tells us
+    DataOffset _bytesReceived { 0 };
+    QByteArray _finalHash;
+    std::atomic<bool> _isComplete { false };
+
+    std::mutex _queueMutex;
+    std::deque<AssetUploadChunk> _queue;
+    bool _isProcessing { false };
+    quint64 _lastActivity { 0 };
+};
+
+using AssetUploadSessionPointer = std::shared_ptr<AssetUploadSession>;
+
+#endif // hifi_AssetUploadSession_h
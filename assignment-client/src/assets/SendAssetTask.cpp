@@ -11,8 +11,6 @@
 
 #include "SendAssetTask.h"
 
-#include <QFile>
-
 #include <DependencyManager.h>
 #include <NetworkLogging.h>
 #include <NLPacket.h>
@@ -22,11 +20,13 @@
 
 #include "AssetUtils.h"
 
-SendAssetTask::SendAssetTask(QSharedPointer<NLPacket> packet, const SharedNodePointer& sendToNode, const QDir& resourcesDir) :
+SendAssetTask::SendAssetTask(QSharedPointer<NLPacket> packet, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                             AssetFileCache& fileCache) :
     QRunnable(),
     _packet(packet),
     _senderNode(sendToNode),
-    _resourcesDir(resourcesDir)
+    _resourcesDir(resourcesDir),
+    _fileCache(fileCache)
 {
     
 }
@@ -58,26 +58,26 @@ void SendAssetTask::run() {
 
     replyPacketList->writePrimitive(messageID);
 
-    if (end <= start) {
+    if (start < 0 || end <= start) {
         writeError(replyPacketList.get(), AssetServerError::InvalidByteRange);
     } else {
         QString filePath = _resourcesDir.filePath(QString(hexHash) + "." + QString(extension));
         
-        QFile file { filePath };
+        auto asset = _fileCache.getAsset(filePath);
 
-        if (file.open(QIODevice::ReadOnly)) {
-            if (file.size() < end) {
+        if (asset) {
+            if (!isValidByteRange(start, end, asset->getSize())) {
                 writeError(replyPacketList.get(), AssetServerError::InvalidByteRange);
                 qCDebug(networking) << "Bad byte range: " << hexHash << " " << start << ":" << end;
             } else {
                 auto size = end - start;
-                file.seek(start);
                 replyPacketList->writePrimitive(AssetServerError::NoError);
                 replyPacketList->writePrimitive(size);
-                replyPacketList->write(file.read(size));
+
+                // the range goes straight from the mapped (or hot) file into the packet payloads
+                replyPacketList->write(asset->getData() + start, size);
                 qCDebug(networking) << "Sending asset: " << hexHash;
             }
-            file.close();
         } else {
             qCDebug(networking) << "Asset not found: " << filePath << "(" << hexHash << ")";
             writeError(replyPacketList.get(), AssetServerError::AssetNotFound);
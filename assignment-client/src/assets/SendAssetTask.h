@@ -17,6 +17,7 @@
 #include <QtCore/QString>
 #include <QtCore/QRunnable>
 
+#include "AssetFileCache.h"
 #include "AssetUtils.h"
 #include "AssetServer.h"
 #include "Node.h"
@@ -25,7 +26,8 @@ class NLPacket;
 
 class SendAssetTask : public QRunnable {
 public:
-    SendAssetTask(QSharedPointer<NLPacket> packet, const SharedNodePointer& sendToNode, const QDir& resourcesDir);
+    SendAssetTask(QSharedPointer<NLPacket> packet, const SharedNodePointer& sendToNode, const QDir& resourcesDir,
+                  AssetFileCache& fileCache);
 
     void run();
 
@@ -33,6 +35,7 @@ private:
     QSharedPointer<NLPacket> _packet;
     SharedNodePointer _senderNode;
     QDir _resourcesDir;
+    AssetFileCache& _fileCache;
 };
 
 #endif
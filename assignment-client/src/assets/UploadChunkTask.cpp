@@ -0,0 +1,23 @@
+//
+//  UploadChunkTask.cpp
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "UploadChunkTask.h"
+
+UploadChunkTask::UploadChunkTask(AssetUploadSessionPointer session) :
+    QRunnable(),
+    _session(session)
+{
+    
+}
+
+void UploadChunkTask::run() {
+    // chunks of one upload have to hit the file in order, so a single task drains everything queued for the session
+    _session->processQueuedChunks();
+}
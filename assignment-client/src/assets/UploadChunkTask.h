@@ -0,0 +1,30 @@
+//
+//  UploadChunkTask.h
+//  assignment-client/src/assets
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_UploadChunkTask_h
+#define hifi_UploadChunkTask_h
+
+#include <QtCore/QRunnable>
+
+#include "AssetUploadSession.h"
+
+class UploadChunkTask : public QRunnable {
+public:
+    UploadChunkTask(AssetUploadSessionPointer session);
+    
+    void run();
+    
+private:
+    AssetUploadSessionPointer _session;
+};
+
+#endif // hifi_UploadChunkTask_h
@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <fstream>
@@ -40,6 +41,7 @@
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkReply>
 
+#include <GLMHelpers.h>
 #include <LogHandler.h>
 #include <NetworkAccessManager.h>
 #include <NodeList.h>
@@ -50,6 +52,7 @@
 #include <StDev.h>
 #include <UUID.h>
 
+#include "AudioMixKernels.h"
 #include "AudioRingBuffer.h"
 #include "AudioMixerClientData.h"
 #include "AvatarAudioStream.h"
@@ -60,6 +63,7 @@
 const float LOUDNESS_TO_DISTANCE_RATIO = 0.00001f;
 const float DEFAULT_ATTENUATION_PER_DOUBLING_IN_DISTANCE = 0.18f;
 const float DEFAULT_NOISE_MUTING_THRESHOLD = 0.003f;
+const float DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE = 30.0f; // degrees
 const QString AUDIO_MIXER_LOGGING_TARGET_NAME = "audio-mixer";
 const QString AUDIO_ENV_GROUP_KEY = "audio_env";
 const QString AUDIO_BUFFER_GROUP_KEY = "audio_buffer";
@@ -84,6 +88,13 @@ AudioMixer::AudioMixer(NLPacket& packet) :
     _numStatFrames(0),
     _sumListeners(0),
     _sumMixes(0),
+    _sumActiveStreams(0),
+    _sumEncodeUsecs(0),
+    _enableAudioCodecs(true),
+    _numMixerThreads(1),
+    _sharedMixPositionTolerance(0.0f),
+    _sharedMixOrientationTolerance(DEFAULT_SHARED_MIX_ORIENTATION_TOLERANCE),
+    _sumSharedMixListeners(0),
     _lastPerSecondCallbackTime(usecTimestampNow()),
     _sendAudioStreamStats(false),
     _datagramsReadPerCallStats(0, READ_DATAGRAMS_STATS_WINDOW_SECONDS),
@@ -97,51 +108,80 @@ AudioMixer::AudioMixer(NLPacket& packet) :
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
 
-    packetReceiver.registerListenerForTypes({ PacketType::MicrophoneAudioNoEcho, PacketType::MicrophoneAudioWithEcho,
-                                              PacketType::InjectAudio, PacketType::SilentAudioFrame,
-                                              PacketType::AudioStreamStats },
-                                            this, "handleNodeAudioPacket");
+    packetReceiver.registerQueuedListenerForTypes({ PacketType::MicrophoneAudioNoEcho, PacketType::MicrophoneAudioWithEcho,
+                                                    PacketType::InjectAudio, PacketType::SilentAudioFrame,
+                                                    PacketType::AudioStreamStats },
+                                                  this, &_audioPacketQueue);
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
+    packetReceiver.registerListener(PacketType::NegotiateAudioFormat, this, "handleNegotiateAudioFormat");
 }
 
 const float ATTENUATION_BEGINS_AT_DISTANCE = 1.0f;
 const float RADIUS_OF_HEAD = 0.076f;
 
-int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                         const QUuid& streamUUID,
-                                                         PositionalAudioStream* streamToAdd,
-                                                         AvatarAudioStream* listeningNodeStream) {
+bool AudioMixer::isStreamActive(PositionalAudioStream* stream, float& repeatedFrameFadeFactor) {
     // If repetition with fade is enabled:
-    // If streamToAdd could not provide a frame (it was starved), then we'll mix its previously-mixed frame
+    // If stream could not provide a frame (it was starved), then we'll mix its previously-mixed frame
     // This is preferable to not mixing it at all since that's equivalent to inserting silence.
     // Basically, we'll repeat that last frame until it has a frame to mix.  Depending on how many times
     // we've repeated that frame in a row, we'll gradually fade that repeated frame into silence.
     // This improves the perceived quality of the audio slightly.
 
-    bool showDebug = false;  // (randFloat() < 0.05f);
-
-    float repeatedFrameFadeFactor = 1.0f;
+    repeatedFrameFadeFactor = 1.0f;
 
-    if (!streamToAdd->lastPopSucceeded()) {
-        if (_streamSettings._repetitionWithFade && !streamToAdd->getLastPopOutput().isNull()) {
+    if (!stream->lastPopSucceeded()) {
+        if (_streamSettings._repetitionWithFade && !stream->getLastPopOutput().isNull()) {
             // reptition with fade is enabled, and we do have a valid previous frame to repeat.
             // calculate its fade factor, which depends on how many times it's already been repeated.
-            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(streamToAdd->getConsecutiveNotMixedCount() - 1);
+            repeatedFrameFadeFactor = calculateRepeatedFrameFadeFactor(stream->getConsecutiveNotMixedCount() - 1);
             if (repeatedFrameFadeFactor == 0.0f) {
-                return 0;
+                return false;
             }
         } else {
-            return 0;
+            return false;
         }
     }
 
-    // at this point, we know streamToAdd's last pop output is valid
+    // at this point, we know stream's last pop output is valid
 
-    // if the frame we're about to mix is silent, bail
-    if (streamToAdd->getLastPopOutputLoudness() == 0.0f) {
-        return 0;
+    // if the frame we're about to mix is silent, there's nothing for anyone to hear
+    return stream->getLastPopOutputLoudness() != 0.0f;
+}
+
+void AudioMixer::gatherActiveStreams() {
+    _activeStreams.clear();
+
+    for (size_t n = 0; n < _frameNodes.size(); ++n) {
+        const SharedNodePointer& node = _frameNodes[n];
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+
+        const QHash<QUuid, PositionalAudioStream*>& audioStreams = nodeData->getAudioStreams();
+        QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
+        for (i = audioStreams.constBegin(); i != audioStreams.constEnd(); i++) {
+            PositionalAudioStream* stream = i.value();
+
+            float repeatedFrameFadeFactor;
+            if (isStreamActive(stream, repeatedFrameFadeFactor)) {
+                // microphone streams are known by their node's UUID, injected streams by their own
+                QUuid streamUUID = (stream->getType() == PositionalAudioStream::Microphone) ? node->getUUID() : i.key();
+                _activeStreams.push_back({ node.data(), (int) n, streamUUID, stream, repeatedFrameFadeFactor });
+            }
+        }
     }
 
+    _sumActiveStreams += (int) _activeStreams.size();
+}
+
+int AudioMixer::addStreamToMixForListeningNodeWithStream(MixBuffers& buffers,
+                                                         AudioMixerClientData* listenerNodeData,
+                                                         const ActiveStream& activeStream,
+                                                         AvatarAudioStream* listeningNodeStream) {
+    PositionalAudioStream* streamToAdd = activeStream.stream;
+    const QUuid& streamUUID = activeStream.streamUUID;
+    float repeatedFrameFadeFactor = activeStream.repeatedFrameFadeFactor;
+
+    bool showDebug = false;  // (randFloat() < 0.05f);
+
     float bearingRelativeAngleToSource = 0.0f;
     float attenuationCoefficient = 1.0f;
     int numSamplesDelay = 0;
@@ -164,7 +204,7 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         return 0;
     }
 
-    ++_sumMixes;
+    ++buffers.sumMixes;
 
     if (streamToAdd->getType() == PositionalAudioStream::Injector) {
         attenuationCoefficient *= reinterpret_cast<InjectedAudioStream*>(streamToAdd)->getAttenuationRatio();
@@ -203,8 +243,9 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
     float attenuationPerDoublingInDistance = _attenuationPerDoublingInDistance;
     for (int i = 0; i < _zonesSettings.length(); ++i) {
-        if (_audioZones[_zonesSettings[i].source].contains(streamToAdd->getPosition()) &&
-            _audioZones[_zonesSettings[i].listener].contains(listeningNodeStream->getPosition())) {
+        // use const lookups here - this can run on several mixing threads at once
+        if (_audioZones.value(_zonesSettings[i].source).contains(streamToAdd->getPosition()) &&
+            _audioZones.value(_zonesSettings[i].listener).contains(listeningNodeStream->getPosition())) {
             attenuationPerDoublingInDistance = _zonesSettings[i].coefficient;
             break;
         }
@@ -260,107 +301,62 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
 
     AudioRingBuffer::ConstIterator streamPopOutput = streamToAdd->getLastPopOutput();
 
+    // attenuation and fade applied to all samples
+    float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+
+    // a stream that gets the penumbra filter is mixed on its own first so that the filter only touches this stream,
+    // everything else is accumulated straight into the listener's mix
+    bool shouldFilter = !sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter();
+    float* streamMixSamples = shouldFilter ? buffers.preMixSamples : buffers.mixSamples;
+
+    if (shouldFilter) {
+        memset(buffers.preMixSamples, 0, sizeof(buffers.preMixSamples));
+    }
+
     if (!streamToAdd->isStereo()) {
         // this is a mono stream, which means it gets full attenuation and spatialization
 
         // we need to do several things in this process:
         //    1) convert from mono to stereo by copying each input sample into the left and right output samples
-        //    2)
         //    2) apply an attenuation AND fade to all samples (left and right)
         //    3) based on the bearing relative angle to the source we will weaken and delay either the left or
         //       right channel of the input into the output
         //    4) because one of these channels is delayed, we will need to use historical samples from
         //       the input stream for that delayed channel
 
-        // Mono input to stereo output (item 1 above)
-        int OUTPUT_SAMPLES_PER_INPUT_SAMPLE = 2;
-        int inputSampleCount = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-        int maxOutputIndex = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-
-        // attenuation and fade applied to all samples (item 2 above)
-        float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
-
-        // determine which side is weak and delayed (item 3 above)
-        bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
-
-        // since we're converting from mono to stereo, we'll use these two indices to step through
-        // the output samples. we'll increment each index independently in the loop
-        int leftDestinationIndex = 0;
-        int rightDestinationIndex = 1;
+        // copy the frame out of the ring buffer along with the historical samples the delayed channel reads,
+        // so that the mixing kernel can work on contiguous samples (item 4 above)
+        // TODO: the historical samples may be inside the last frame written if the ringbuffer is completely full
+        // maybe make AudioRingBuffer have 1 extra frame in its buffer
+        (streamPopOutput - numSamplesDelay).readSamples(buffers.streamSamples,
+                                                        numSamplesDelay + AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
 
-        // One of our two channels will be delayed (determined below). We'll use this index to step
-        // through filling in our output with the historical samples for the delayed channel.  (item 4 above)
-        int delayedChannelHistoricalAudioOutputIndex;
-
-        // All samples will be attenuated by at least this much
-        float leftSideAttenuation = attenuationAndFade;
-        float rightSideAttenuation = attenuationAndFade;
+        const int16_t* delayedSamples = buffers.streamSamples;
+        const int16_t* frameSamples = buffers.streamSamples + numSamplesDelay;
 
         // The weak/delayed channel will be attenuated by this additional amount
         float attenuationAndWeakChannelRatioAndFade = attenuationAndFade * weakChannelAmplitudeRatio;
 
-        // Now, based on the determination of which side is weak and delayed, set up our true starting point
-        // for our indexes, as well as the appropriate attenuation for each channel
+        // determine which side is weak and delayed (item 3 above), then mix mono to stereo (items 1 and 2 above)
+        bool rightSideWeakAndDelayed = (bearingRelativeAngleToSource > 0.0f);
+
         if (rightSideWeakAndDelayed) {
-            delayedChannelHistoricalAudioOutputIndex = rightDestinationIndex;
-            rightSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            rightDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
+            mixMonoToStereo(streamMixSamples, frameSamples, delayedSamples,
+                            attenuationAndFade, attenuationAndWeakChannelRatioAndFade,
+                            AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
         } else {
-            delayedChannelHistoricalAudioOutputIndex = leftDestinationIndex;
-            leftSideAttenuation = attenuationAndWeakChannelRatioAndFade;
-            leftDestinationIndex += (numSamplesDelay * OUTPUT_SAMPLES_PER_INPUT_SAMPLE);
-        }
-
-        // If there was a sample delay for this stream, we need to pull samples prior to the official start of the input
-        // and stick those samples at the beginning of the output. We only need to loop through this for the weak/delayed
-        // side, since the normal side is fully handled below. (item 4 above)
-        if (numSamplesDelay > 0) {
-
-            // TODO: delayStreamSourceSamples may be inside the last frame written if the ringbuffer is completely full
-            // maybe make AudioRingBuffer have 1 extra frame in its buffer
-            AudioRingBuffer::ConstIterator delayStreamSourceSamples = streamPopOutput - numSamplesDelay;
-
-            for (int i = 0; i < numSamplesDelay; i++) {
-                int16_t originalHistoricalSample = *delayStreamSourceSamples;
-
-                _preMixSamples[delayedChannelHistoricalAudioOutputIndex] += originalHistoricalSample
-                                                                                 * attenuationAndWeakChannelRatioAndFade;
-                ++delayStreamSourceSamples; // move our input pointer
-                delayedChannelHistoricalAudioOutputIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE; // move our output sample
-            }
-        }
-
-        // Here's where we copy the MONO input to the STEREO output, and account for delay and weak side attenuation
-        for (int inputSample = 0; inputSample < inputSampleCount; inputSample++) {
-            int16_t originalSample = streamPopOutput[inputSample];
-            int16_t leftSideSample = originalSample * leftSideAttenuation;
-            int16_t rightSideSample = originalSample * rightSideAttenuation;
-
-            // since we might be delayed, don't write beyond our maxOutputIndex
-            if (leftDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[leftDestinationIndex] += leftSideSample;
-            }
-            if (rightDestinationIndex <= maxOutputIndex) {
-                _preMixSamples[rightDestinationIndex] += rightSideSample;
-            }
-
-            leftDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
-            rightDestinationIndex += OUTPUT_SAMPLES_PER_INPUT_SAMPLE;
+            mixMonoToStereo(streamMixSamples, delayedSamples, frameSamples,
+                            attenuationAndWeakChannelRatioAndFade, attenuationAndFade,
+                            AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL);
         }
 
     } else {
-        int stereoDivider = streamToAdd->isStereo() ? 1 : 2;
-
-       float attenuationAndFade = attenuationCoefficient * repeatedFrameFadeFactor;
+        streamPopOutput.readSamples(buffers.streamSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
 
-        for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-            _preMixSamples[s] = glm::clamp(_preMixSamples[s] + (int)(streamPopOutput[s / stereoDivider] * attenuationAndFade),
-                                            AudioConstants::MIN_SAMPLE_VALUE,
-                                           AudioConstants::MAX_SAMPLE_VALUE);
-        }
+        mixStereo(streamMixSamples, buffers.streamSamples, attenuationAndFade, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
     }
 
-    if (!sourceIsSelf && _enableFilter && !streamToAdd->ignorePenumbraFilter()) {
+    if (shouldFilter) {
 
         const float TWO_OVER_PI = 2.0f / PI;
 
@@ -420,54 +416,162 @@ int AudioMixer::addStreamToMixForListeningNodeWithStream(AudioMixerClientData* l
         // set the gain on both filter channels
         penumbraFilter.setParameters(0, 0, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainL, penumbraFilterSlope);
         penumbraFilter.setParameters(0, 1, AudioConstants::SAMPLE_RATE, penumbraFilterFrequency, penumbraFilterGainR, penumbraFilterSlope);
-        penumbraFilter.render(_preMixSamples, _preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
-    }
+        penumbraFilter.render(buffers.preMixSamples, buffers.preMixSamples,
+                              AudioConstants::NETWORK_FRAME_SAMPLES_STEREO / 2);
 
-    // Actually mix the _preMixSamples into the _mixSamples here.
-    for (int s = 0; s < AudioConstants::NETWORK_FRAME_SAMPLES_STEREO; s++) {
-        _mixSamples[s] = glm::clamp(_mixSamples[s] + _preMixSamples[s], AudioConstants::MIN_SAMPLE_VALUE,
-                                    AudioConstants::MAX_SAMPLE_VALUE);
+        // Actually mix the preMixSamples into the mixSamples here.
+        accumulateMix(buffers.mixSamples, buffers.preMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
     }
 
     return 1;
 }
 
-int AudioMixer::prepareMixForListeningNode(Node* node) {
+int AudioMixer::addStreamsToMixForListeningNode(MixBuffers& buffers, Node* node, MixSources sources, int sharedMixIndex) {
     AvatarAudioStream* nodeAudioStream = static_cast<AudioMixerClientData*>(node->getLinkedData())->getAvatarAudioStream();
     AudioMixerClientData* listenerNodeData = static_cast<AudioMixerClientData*>(node->getLinkedData());
 
+    // loop through the streams that have audio to mix this frame
+    int streamsMixed = 0;
+
+    for (const ActiveStream& activeStream : _activeStreams) {
+        bool isInsideSharedMix = (_frameNodeSharedMixIndexes[activeStream.frameNodeIndex] == sharedMixIndex);
+        if ((sources == MixSources::InsideSharedMix && !isInsideSharedMix)
+            || (sources == MixSources::OutsideSharedMix && isInsideSharedMix)) {
+            continue;
+        }
+
+        if (activeStream.node != node || activeStream.stream->shouldLoopbackForNode()) {
+            streamsMixed += addStreamToMixForListeningNodeWithStream(buffers, listenerNodeData, activeStream, nodeAudioStream);
+        }
+    }
+
+    return streamsMixed;
+}
+
+int AudioMixer::prepareMixForListeningNode(MixBuffers& buffers, const FrameListener& listener) {
+    if (listener.sharedMixIndex >= 0) {
+        // start from the mix shared with the co-located listeners, only their own streams are mixed for this listener
+        const SharedMix& sharedMix = _sharedMixes[listener.sharedMixIndex];
+        memcpy(buffers.mixSamples, sharedMix.mixSamples, sizeof(buffers.mixSamples));
+
+        return sharedMix.streamsMixed + addStreamsToMixForListeningNode(buffers, listener.node.data(),
+                                                                        MixSources::InsideSharedMix,
+                                                                        listener.sharedMixIndex);
+    }
+
     // zero out the client mix for this node
-    memset(_preMixSamples, 0, sizeof(_preMixSamples));
-    memset(_mixSamples, 0, sizeof(_mixSamples));
+    memset(buffers.mixSamples, 0, sizeof(buffers.mixSamples));
 
-    // loop through all other nodes that have sufficient audio to mix
-    int streamsMixed = 0;
+    return addStreamsToMixForListeningNode(buffers, listener.node.data(), MixSources::All, -1);
+}
 
-    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode){
-        if (otherNode->getLinkedData()) {
-            AudioMixerClientData* otherNodeClientData = (AudioMixerClientData*) otherNode->getLinkedData();
+void AudioMixer::assignSharedMixes() {
+    _sharedMixes.clear();
+    _frameNodeSharedMixIndexes.assign(_frameNodes.size(), -1);
 
-            // enumerate the ARBs attached to the otherNode and add all that should be added to mix
+    if (_sharedMixPositionTolerance <= 0.0f) {
+        return;
+    }
 
-            const QHash<QUuid, PositionalAudioStream*>& otherNodeAudioStreams = otherNodeClientData->getAudioStreams();
-            QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
-            for (i = otherNodeAudioStreams.constBegin(); i != otherNodeAudioStreams.constEnd(); i++) {
-                PositionalAudioStream* otherNodeStream = i.value();
-                QUuid streamUUID = i.key();
+    // bucket listeners by position cell and by the way they are facing, listeners in the same bucket share a mix
+    typedef std::tuple<int, int, int, int> SharedMixKey;
+    std::map<SharedMixKey, std::vector<int>> buckets;
 
-                if (otherNodeStream->getType() == PositionalAudioStream::Microphone) {
-                    streamUUID = otherNode->getUUID();
-                }
+    const float yawTolerance = glm::radians(_sharedMixOrientationTolerance);
 
-                if (*otherNode != *node || otherNodeStream->shouldLoopbackForNode()) {
-                    streamsMixed += addStreamToMixForListeningNodeWithStream(listenerNodeData, streamUUID,
-                                                                             otherNodeStream, nodeAudioStream);
-                }
-            }
+    for (int i = 0; i < (int) _frameListeners.size(); ++i) {
+        AvatarAudioStream* stream = static_cast<AudioMixerClientData*>(_frameListeners[i].node->getLinkedData())
+                                        ->getAvatarAudioStream();
+
+        glm::vec3 cell = glm::floor(stream->getPosition() / _sharedMixPositionTolerance);
+
+        // only the yaw is considered, pitch and roll barely change the phase panning
+        glm::vec3 front = stream->getOrientation() * IDENTITY_FRONT;
+        float yaw = atan2f(front.x, front.z);
+
+        SharedMixKey key((int) cell.x, (int) cell.y, (int) cell.z, (int) floorf(yaw / yawTolerance));
+        buckets[key].push_back(i);
+    }
+
+    for (auto& bucket : buckets) {
+        const std::vector<int>& listenerIndexes = bucket.second;
+
+        if (listenerIndexes.size() < 2) {
+            // a lone listener just gets a regular mix
+            continue;
         }
-    });
 
-    return streamsMixed;
+        int sharedMixIndex = (int) _sharedMixes.size();
+        _sharedMixes.push_back(SharedMix());
+        _sharedMixes.back().representative = _frameListeners[listenerIndexes.front()].node;
+
+        for (int listenerIndex : listenerIndexes) {
+            FrameListener& listener = _frameListeners[listenerIndex];
+            listener.sharedMixIndex = sharedMixIndex;
+            _frameNodeSharedMixIndexes[listener.frameNodeIndex] = sharedMixIndex;
+        }
+
+        _sumSharedMixListeners += (int) listenerIndexes.size();
+    }
+}
+
+void AudioMixer::prepareSharedMix(MixBuffers& buffers, int sharedMixIndex) {
+    SharedMix& sharedMix = _sharedMixes[sharedMixIndex];
+
+    // every stream outside of the group is mixed once, as heard by the representative listener
+    memset(buffers.mixSamples, 0, sizeof(buffers.mixSamples));
+
+    sharedMix.streamsMixed = addStreamsToMixForListeningNode(buffers, sharedMix.representative.data(),
+                                                             MixSources::OutsideSharedMix, sharedMixIndex);
+
+    memcpy(sharedMix.mixSamples, buffers.mixSamples, sizeof(sharedMix.mixSamples));
+}
+
+std::unique_ptr<NLPacket> AudioMixer::prepareMixPacketForListeningNode(MixBuffers& buffers,
+                                                                       const FrameListener& listener) {
+    AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(listener.node->getLinkedData());
+
+    int streamsMixed = prepareMixForListeningNode(buffers, listener);
+
+    std::unique_ptr<NLPacket> mixPacket;
+
+    if (streamsMixed > 0) {
+        const AudioCodec* codec = nodeData->getCodec();
+        const int MIX_CHANNELS = 2;
+        int encodedMixBytes = codec->getEncodedBytes(AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, MIX_CHANNELS);
+
+        int mixPacketBytes = sizeof(quint16) + sizeof(quint8) + encodedMixBytes;
+        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
+
+        // pack sequence number
+        quint16 sequence = nodeData->getOutgoingSequenceNumber();
+        mixPacket->writePrimitive(sequence);
+
+        // pack the ID of the codec the listener negotiated
+        mixPacket->writePrimitive(codec->getID());
+
+        // round and clamp the mix, then encode it straight into the packet
+        convertMixToInt16(buffers.mixSamples, buffers.clampedMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO);
+
+        quint64 encodeStart = usecTimestampNow();
+        codec->encode(buffers.clampedMixSamples, AudioConstants::NETWORK_FRAME_SAMPLES_STEREO, MIX_CHANNELS,
+                      mixPacket->getPayload() + mixPacket->pos());
+        mixPacket->setPayloadSize(mixPacket->getPayloadSize() + encodedMixBytes);
+        buffers.encodeUsecs += usecTimestampNow() - encodeStart;
+    } else {
+        int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
+        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
+
+        // pack sequence number
+        quint16 sequence = nodeData->getOutgoingSequenceNumber();
+        mixPacket->writePrimitive(sequence);
+
+        // pack number of silent audio samples
+        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+        mixPacket->writePrimitive(numSilentSamples);
+    }
+
+    return mixPacket;
 }
 
 void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
@@ -541,7 +645,14 @@ void AudioMixer::sendAudioEnvironmentPacket(SharedNodePointer node) {
     }
 }
 
-void AudioMixer::handleNodeAudioPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
+void AudioMixer::processQueuedAudioPackets() {
+    PacketReceiver::QueuedPacket queuedPacket;
+    while (_audioPacketQueue.pop(queuedPacket)) {
+        handleNodeAudioPacket(*queuedPacket.packet, queuedPacket.sendingNode);
+    }
+}
+
+void AudioMixer::handleNodeAudioPacket(NLPacket& packet, const SharedNodePointer& sendingNode) {
     DependencyManager::get<NodeList>()->updateNodeWithDataFromPacket(packet, sendingNode);
 }
 
@@ -562,23 +673,75 @@ void AudioMixer::handleMuteEnvironmentPacket(QSharedPointer<NLPacket> packet, Sh
     }
 }
 
+void AudioMixer::handleNegotiateAudioFormat(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
+    QStringList offeredCodecs;
+    QDataStream packetStream(packet.data());
+    packetStream >> offeredCodecs;
+
+    const AudioCodec* selectedCodec = _enableAudioCodecs ? AudioCodec::selectFrom(offeredCodecs) : AudioCodec::getPCM();
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    {
+        // negotiating is the first thing a client does, so it usually doesn't have its data yet
+        QMutexLocker locker(&sendingNode->getMutex());
+        if (!sendingNode->getLinkedData()) {
+            nodeList->linkedDataCreateCallback(sendingNode.data());
+        }
+
+        AudioMixerClientData* nodeData = static_cast<AudioMixerClientData*>(sendingNode->getLinkedData());
+        nodeData->setCodec(selectedCodec);
+    }
+
+    qDebug() << "Selected the" << selectedCodec->getName() << "codec for" << uuidStringWithoutCurlyBraces(sendingNode->getUUID());
+
+    auto selectedPacket = NLPacket::create(PacketType::SelectedAudioFormat, -1, true);
+    QDataStream selectedStream(selectedPacket.get());
+    selectedStream << selectedCodec->getName();
+
+    nodeList->sendPacket(std::move(selectedPacket), *sendingNode);
+}
+
 void AudioMixer::sendStatsPacket() {
     static QJsonObject statsObject;
 
     statsObject["useDynamicJitterBuffers"] = _streamSettings._dynamicJitterBuffers;
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100.0f;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
+    statsObject["mixer_threads"] = _workerPool ? _workerPool->getNumWorkers() : 1;
 
     statsObject["average_listeners_per_frame"] = (float) _sumListeners / (float) _numStatFrames;
+    statsObject["average_active_streams_per_frame"] = (float) _sumActiveStreams / (float) _numStatFrames;
 
     if (_sumListeners > 0) {
         statsObject["average_mixes_per_listener"] = (float) _sumMixes / (float) _sumListeners;
+        statsObject["shared_mix_listeners_prct"] = (float) _sumSharedMixListeners / (float) _sumListeners * 100.0f;
     } else {
         statsObject["average_mixes_per_listener"] = 0.0;
+        statsObject["shared_mix_listeners_prct"] = 0.0;
+    }
+
+    quint64 sumDecodeUsecs = 0;
+    DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& node) {
+        AudioMixerClientData* clientData = static_cast<AudioMixerClientData*>(node->getLinkedData());
+        if (clientData) {
+            sumDecodeUsecs += clientData->collectDecodeUsecs();
+        }
+    });
+
+    if (_numStatFrames > 0) {
+        statsObject["codec_encode_usecs_per_frame"] = (double) _sumEncodeUsecs / (double) _numStatFrames;
+        statsObject["codec_decode_usecs_per_frame"] = (double) sumDecodeUsecs / (double) _numStatFrames;
+    } else {
+        statsObject["codec_encode_usecs_per_frame"] = 0.0;
+        statsObject["codec_decode_usecs_per_frame"] = 0.0;
     }
 
     _sumListeners = 0;
     _sumMixes = 0;
+    _sumSharedMixListeners = 0;
+    _sumActiveStreams = 0;
+    _sumEncodeUsecs = 0;
     _numStatFrames = 0;
 
     QJsonObject readPendingDatagramStats;
@@ -628,6 +791,7 @@ void AudioMixer::sendStatsPacket() {
             QString uuidString = uuidStringWithoutCurlyBraces(node->getUUID());
 
             nodeStats["outbound_kbps"] = node->getOutboundBandwidth();
+            nodeStats["codec"] = clientData->getCodec()->getName();
             nodeStats[USERNAME_UUID_REPLACEMENT_STATS_KEY] = uuidString;
 
             nodeStats["jitter"] = clientData->getAudioStreamStats();
@@ -678,6 +842,12 @@ void AudioMixer::run() {
     // check the settings object to see if we have anything we can parse out
     parseSettingsObject(settingsObject);
 
+    // spin up the threads we mix listeners on - with a single thread everything is mixed right here in run()
+    _workerPool.reset(new MixerWorkerPool(_numMixerThreads));
+    _mixBuffers.resize(_workerPool->getNumWorkers());
+
+    const int FRAMES_PER_EVENT_PROCESSING = 5;
+
     int nextFrame = 0;
     QElapsedTimer timer;
     timer.start();
@@ -746,6 +916,12 @@ void AudioMixer::run() {
             _lastPerSecondCallbackTime = now;
         }
 
+        // take in everything that arrived since the last frame before any stream pops one
+        processQueuedAudioPackets();
+
+        _frameNodes.clear();
+        _frameListeners.clear();
+
         nodeList->eachNode([&](const SharedNodePointer& node) {
 
             if (node->getLinkedData()) {
@@ -765,57 +941,78 @@ void AudioMixer::run() {
 
                 if (node->getType() == NodeType::Agent && node->getActiveSocket()
                     && nodeData->getAvatarAudioStream()) {
+                    _frameListeners.push_back({ node, (int) _frameNodes.size(), -1, nullptr });
+                }
 
-                    int streamsMixed = prepareMixForListeningNode(node.data());
+                _frameNodes.push_back(node);
+            }
+        });
 
-                    std::unique_ptr<NLPacket> mixPacket;
+        // find the streams that anyone could hear this frame, listeners only walk those
+        gatherActiveStreams();
 
-                    if (streamsMixed > 0) {
-                        int mixPacketBytes = sizeof(quint16) + AudioConstants::NETWORK_FRAME_BYTES_STEREO;
-                        mixPacket = NLPacket::create(PacketType::MixedAudio, mixPacketBytes);
+        // group co-located listeners, each group's mix of everything outside the group is computed once
+        assignSharedMixes();
 
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
+        if (!_sharedMixes.empty()) {
+            _workerPool->run((int) _sharedMixes.size(), [this](int workerIndex, int sharedMixIndex) {
+                prepareSharedMix(_mixBuffers[workerIndex], sharedMixIndex);
+            });
+        }
 
-                        // pack mixed audio samples
-                        mixPacket->write(reinterpret_cast<char*>(_mixSamples),
-                                         AudioConstants::NETWORK_FRAME_BYTES_STEREO);
-                    } else {
-                        int silentPacketBytes = sizeof(quint16) + sizeof(quint16);
-                        mixPacket = NLPacket::create(PacketType::SilentAudioFrame, silentPacketBytes);
+        // every stream has popped its frame for this network frame, mix all of the listeners across the worker pool
+        // the pool returns once every listener has its mix packet ready
+        _workerPool->run((int) _frameListeners.size(), [this](int workerIndex, int listenerIndex) {
+            FrameListener& listener = _frameListeners[listenerIndex];
+            listener.mixPacket = prepareMixPacketForListeningNode(_mixBuffers[workerIndex], listener);
+        });
 
-                        // pack sequence number
-                        quint16 sequence = nodeData->getOutgoingSequenceNumber();
-                        mixPacket->writePrimitive(sequence);
+        for (MixBuffers& buffers : _mixBuffers) {
+            _sumMixes += buffers.sumMixes;
+            buffers.sumMixes = 0;
+            _sumEncodeUsecs += buffers.encodeUsecs;
+            buffers.encodeUsecs = 0;
+        }
 
-                        // pack number of silent audio samples
-                        quint16 numSilentSamples = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
-                        mixPacket->writePrimitive(numSilentSamples);
-                    }
+        // packets are sent from this thread since it is the one that owns the node socket
+        // they are batched up so that the whole frame goes out to the socket together
+        nodeList->beginSendBatch();
 
-                    // Send audio environment
-                    sendAudioEnvironmentPacket(node);
+        for (FrameListener& listener : _frameListeners) {
+            const SharedNodePointer& node = listener.node;
+            AudioMixerClientData* nodeData = (AudioMixerClientData*)node->getLinkedData();
 
-                    // send mixed audio packet
-                    nodeList->sendPacket(std::move(mixPacket), *node);
-                    nodeData->incrementOutgoingMixedAudioSequenceNumber();
+            // Send audio environment
+            sendAudioEnvironmentPacket(node);
 
-                    // send an audio stream stats packet if it's time
-                    if (_sendAudioStreamStats) {
-                        nodeData->sendAudioStreamStatsPackets(node);
-                        _sendAudioStreamStats = false;
-                    }
+            // send mixed audio packet
+            nodeList->sendPacket(std::move(listener.mixPacket), *node);
+            nodeData->incrementOutgoingMixedAudioSequenceNumber();
 
-                    ++_sumListeners;
-                }
+            // send an audio stream stats packet if it's time
+            if (_sendAudioStreamStats) {
+                nodeData->sendAudioStreamStatsPackets(node);
+                _sendAudioStreamStats = false;
             }
-        });
+
+            ++_sumListeners;
+        }
+
+        nodeList->flushSendBatch();
+
+        // don't hold on to nodes past this frame
+        _frameNodes.clear();
+        _frameListeners.clear();
+        _activeStreams.clear();
+        _sharedMixes.clear();
 
         ++_numStatFrames;
 
         // since we're a while loop we need to help Qt's event processing
-        QCoreApplication::processEvents();
+        // audio doesn't come through it, so what's left (codec negotiation, settings, stats, finishing) can wait a few frames
+        if (nextFrame % FRAMES_PER_EVENT_PROCESSING == 0 || _isFinished) {
+            QCoreApplication::processEvents();
+        }
 
         if (_isFinished) {
             // at this point the audio-mixer is done
@@ -985,6 +1182,48 @@ void AudioMixer::parseSettingsObject(const QJsonObject &settingsObject) {
             }
         }
 
+        const QString MIXER_THREADS_KEY = "mixer_threads";
+        if (audioEnvGroupObject[MIXER_THREADS_KEY].isString()) {
+            bool ok = false;
+            int numMixerThreads = audioEnvGroupObject[MIXER_THREADS_KEY].toString().toInt(&ok);
+            if (ok && numMixerThreads >= 0) {
+                // zero means use every core we've got
+                _numMixerThreads = (numMixerThreads == 0) ? std::max(QThread::idealThreadCount(), 1) : numMixerThreads;
+            }
+        }
+        qDebug() << "Mixing listeners on" << _numMixerThreads << "thread(s)";
+
+        const QString SHARED_MIX_POSITION_TOLERANCE_KEY = "shared_mix_position_tolerance";
+        if (audioEnvGroupObject[SHARED_MIX_POSITION_TOLERANCE_KEY].isString()) {
+            bool ok = false;
+            float tolerance = audioEnvGroupObject[SHARED_MIX_POSITION_TOLERANCE_KEY].toString().toFloat(&ok);
+            if (ok && tolerance >= 0.0f) {
+                _sharedMixPositionTolerance = tolerance;
+            }
+        }
+
+        const QString SHARED_MIX_ORIENTATION_TOLERANCE_KEY = "shared_mix_orientation_tolerance";
+        if (audioEnvGroupObject[SHARED_MIX_ORIENTATION_TOLERANCE_KEY].isString()) {
+            bool ok = false;
+            float tolerance = audioEnvGroupObject[SHARED_MIX_ORIENTATION_TOLERANCE_KEY].toString().toFloat(&ok);
+            if (ok && tolerance > 0.0f) {
+                _sharedMixOrientationTolerance = tolerance;
+            }
+        }
+
+        if (_sharedMixPositionTolerance > 0.0f) {
+            qDebug() << "Listeners within" << _sharedMixPositionTolerance << "m and"
+                << _sharedMixOrientationTolerance << "degrees of each other will share a mix";
+        }
+
+        const QString AUDIO_CODECS_KEY = "enable_audio_codecs";
+        if (audioEnvGroupObject[AUDIO_CODECS_KEY].isBool()) {
+            _enableAudioCodecs = audioEnvGroupObject[AUDIO_CODECS_KEY].toBool();
+        }
+        if (!_enableAudioCodecs) {
+            qDebug() << "Audio codecs disabled, every client will send and receive PCM";
+        }
+
         const QString FILTER_KEY = "enable_filter";
         if (audioEnvGroupObject[FILTER_KEY].isBool()) {
             _enableFilter = audioEnvGroupObject[FILTER_KEY].toBool();
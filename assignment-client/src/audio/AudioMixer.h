@@ -12,10 +12,18 @@
 #ifndef hifi_AudioMixer_h
 #define hifi_AudioMixer_h
 
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
 #include <AABox.h>
 #include <AudioRingBuffer.h>
+#include <PacketReceiver.h>
 #include <ThreadedAssignment.h>
 
+#include "../MixerWorkerPool.h"
+
 class PositionalAudioStream;
 class AvatarAudioStream;
 class AudioMixerClientData;
@@ -24,6 +32,9 @@ const int SAMPLE_PHASE_DELAY_AT_90 = 20;
 
 const int READ_DATAGRAMS_STATS_WINDOW_SECONDS = 30;
 
+// room for several frames of audio from every agent in a busy domain
+const int AUDIO_PACKET_QUEUE_CAPACITY = 8192;
+
 /// Handles assignments of type AudioMixer - mixing streams of audio and re-distributing to various clients.
 class AudioMixer : public ThreadedAssignment {
     Q_OBJECT
@@ -40,29 +51,108 @@ public slots:
     static const InboundAudioStream::Settings& getStreamSettings() { return _streamSettings; }
 
 private slots:
-    void handleNodeAudioPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
     void handleMuteEnvironmentPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
+    void handleNegotiateAudioFormat(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode);
 
 private:
+    /// scratch space owned by a single mixing thread, so that listeners can be mixed concurrently
+    struct MixBuffers {
+        // contiguous copy of the frame being mixed, with room in front for the historical samples a phase delay reads
+        int16_t streamSamples[SAMPLE_PHASE_DELAY_AT_90 + AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+        // used on a per stream basis to run the filter on before mixing
+        float preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+        // the listener's mix, accumulated in float and only rounded and clamped once every stream is in
+        float mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        int16_t clampedMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+
+        int sumMixes { 0 };
+        quint64 encodeUsecs { 0 };
+    };
+
+    /// a listener that gets a mix this frame, and the packet the mixing thread prepared for it
+    struct FrameListener {
+        SharedNodePointer node;
+        int frameNodeIndex;
+        int sharedMixIndex;
+        std::unique_ptr<NLPacket> mixPacket;
+    };
+
+    /// mix of every stream outside a group of co-located listeners, computed once for the group from one of them
+    struct SharedMix {
+        SharedNodePointer representative;
+        float mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO];
+        int streamsMixed;
+    };
+
+    /// a stream with audio to mix this frame, found once per frame so listeners skip everyone who is quiet
+    struct ActiveStream {
+        Node* node;
+        int frameNodeIndex;
+        QUuid streamUUID;
+        PositionalAudioStream* stream;
+        float repeatedFrameFadeFactor;
+    };
+
+    /// which of the frame's nodes to take streams from when mixing
+    enum class MixSources {
+        All,
+        InsideSharedMix,
+        OutsideSharedMix
+    };
+
+    /// returns true if the stream has a frame that isn't silent to mix this frame, and the fade to mix it with
+    bool isStreamActive(PositionalAudioStream* stream, float& repeatedFrameFadeFactor);
+
+    /// fills _activeStreams from the streams of this frame's nodes
+    void gatherActiveStreams();
+
     /// adds one stream to the mix for a listening node
-    int addStreamToMixForListeningNodeWithStream(AudioMixerClientData* listenerNodeData,
-                                                    const QUuid& streamUUID,
-                                                    PositionalAudioStream* streamToAdd,
-                                                    AvatarAudioStream* listeningNodeStream);
+    int addStreamToMixForListeningNodeWithStream(MixBuffers& buffers,
+                                                 AudioMixerClientData* listenerNodeData,
+                                                 const ActiveStream& activeStream,
+                                                 AvatarAudioStream* listeningNodeStream);
+
+    /// adds the streams of this frame's nodes picked by sources to the mix for a listening node
+    int addStreamsToMixForListeningNode(MixBuffers& buffers, Node* node, MixSources sources, int sharedMixIndex);
 
-    /// prepares and sends a mix to one Node
-    int prepareMixForListeningNode(Node* node);
+    /// prepares a mix for one listener in the given buffers, starting from its shared mix if it has one
+    int prepareMixForListeningNode(MixBuffers& buffers, const FrameListener& listener);
+
+    /// mixes for one listener and packs the result into a MixedAudio or SilentAudioFrame packet
+    std::unique_ptr<NLPacket> prepareMixPacketForListeningNode(MixBuffers& buffers, const FrameListener& listener);
+
+    /// groups this frame's listeners that are within the shared mix tolerances of each other
+    void assignSharedMixes();
+
+    /// computes the mix for one group of co-located listeners
+    void prepareSharedMix(MixBuffers& buffers, int sharedMixIndex);
 
     /// Send Audio Environment packet for a single node
     void sendAudioEnvironmentPacket(SharedNodePointer node);
 
-    // used on a per stream basis to run the filter on before mixing, large enough to handle the historical
-    // data from a phase delay as well as an entire network buffer
-    int16_t _preMixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    // parses the audio the node thread has queued up since the last frame into the streams of the nodes that sent it
+    void processQueuedAudioPackets();
+    void handleNodeAudioPacket(NLPacket& packet, const SharedNodePointer& sendingNode);
+
+    // audio and stream stats packets bypass our event loop, the node thread pushes them here and each frame drains it
+    PacketReceiver::PacketQueue _audioPacketQueue { AUDIO_PACKET_QUEUE_CAPACITY };
+
+    // nodes with linked data this frame, snapshotted once so mixing threads don't need the node list lock
+    std::vector<SharedNodePointer> _frameNodes;
+    std::vector<FrameListener> _frameListeners;
+    std::vector<ActiveStream> _activeStreams;
+
+    std::vector<int> _frameNodeSharedMixIndexes; // parallel to _frameNodes, -1 for nodes not on a shared mix
+    std::vector<SharedMix> _sharedMixes;
+    float _sharedMixPositionTolerance;
+    float _sharedMixOrientationTolerance;
+    int _sumSharedMixListeners;
 
-    // client samples capacity is larger than what will be sent to optimize mixing
-    // we are MMX adding 4 samples at a time so we need client samples to have an extra 4
-    int16_t _mixSamples[AudioConstants::NETWORK_FRAME_SAMPLES_STEREO + (SAMPLE_PHASE_DELAY_AT_90 * 2)];
+    int _numMixerThreads;
+    std::unique_ptr<MixerWorkerPool> _workerPool;
+    std::vector<MixBuffers> _mixBuffers; // one per worker in _workerPool
 
     void perSecondActions();
 
@@ -78,6 +168,9 @@ private:
     int _numStatFrames;
     int _sumListeners;
     int _sumMixes;
+    int _sumActiveStreams;
+    quint64 _sumEncodeUsecs;
+    bool _enableAudioCodecs; // if false every client gets PCM, whatever it offers
 
     QHash<QString, AABox> _audioZones;
     struct ZonesSettings {
@@ -24,6 +24,7 @@
 AudioMixerClientData::AudioMixerClientData() :
     _audioStreams(),
     _outgoingMixedAudioSequenceNumber(0),
+    _codec(AudioCodec::getPCM()),
     _downstreamAudioStreamStats()
 {
 }
@@ -279,6 +280,18 @@ QJsonObject AudioMixerClientData::getAudioStreamStats() const {
     return result;
 }
 
+quint64 AudioMixerClientData::collectDecodeUsecs() {
+    quint64 decodeUsecs = 0;
+
+    QHash<QUuid, PositionalAudioStream*>::ConstIterator i;
+    for (i = _audioStreams.constBegin(); i != _audioStreams.constEnd(); i++) {
+        decodeUsecs += i.value()->getDecodeUsecs();
+        i.value()->resetDecodeUsecs();
+    }
+
+    return decodeUsecs;
+}
+
 void AudioMixerClientData::printUpstreamDownstreamStats() const {
     // print the upstream (mic stream) stats if the mic stream exists
     if (_audioStreams.contains(QUuid())) {
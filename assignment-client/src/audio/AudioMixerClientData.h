@@ -15,6 +15,7 @@
 #include <QtCore/QJsonObject>
 
 #include <AABox.h>
+#include <AudioCodec.h>
 #include <AudioFormat.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioBuffer.h> // For AudioFilterHSF1s and _penumbraFilter
 #include <AudioFilter.h> // For AudioFilterHSF1s and _penumbraFilter
@@ -58,6 +59,13 @@ public:
     void printUpstreamDownstreamStats() const;
 
     PerListenerSourcePairData* getListenerSourcePairData(const QUuid& sourceUUID);
+
+    /// the codec this client's mix is encoded with, PCM unless the client negotiated something else
+    const AudioCodec* getCodec() const { return _codec; }
+    void setCodec(const AudioCodec* codec) { _codec = codec; }
+
+    /// returns the time all of this client's streams spent decoding since the last call
+    quint64 collectDecodeUsecs();
 private:
     void printAudioStreamStats(const AudioStreamStats& streamStats) const;
 
@@ -69,6 +77,8 @@ private:
 
     quint16 _outgoingMixedAudioSequenceNumber;
 
+    const AudioCodec* _codec;
+
     AudioStreamStats _downstreamAudioStreamStats;
 };
 
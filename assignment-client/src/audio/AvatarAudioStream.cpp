@@ -16,6 +16,8 @@
 AvatarAudioStream::AvatarAudioStream(bool isStereo, const InboundAudioStream::Settings& settings) :
     PositionalAudioStream(PositionalAudioStream::Microphone, isStereo, settings)
 {
+    // while the microphone is quiet the client only sends a silent frame every so often
+    _senderUsesDTX = true;
 }
 
 int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray& packetAfterSeqNum, int& numAudioSamples) {
@@ -48,10 +50,9 @@ int AvatarAudioStream::parseStreamProperties(PacketType type, const QByteArray&
 
         // read the positional data
         readBytes += parsePositionalData(packetAfterSeqNum.mid(readBytes));
-        
-        // calculate how many samples are in this packet
-        int numAudioBytes = packetAfterSeqNum.size() - readBytes;
-        numAudioSamples = numAudioBytes / sizeof(int16_t);
+
+        // read the codec the audio was encoded with and calculate how many samples are in this packet
+        readBytes += parseCodecID(packetAfterSeqNum.mid(readBytes), isStereo ? 2 : 1, numAudioSamples);
     }
 
     return readBytes;
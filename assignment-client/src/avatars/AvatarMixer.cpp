@@ -9,6 +9,7 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <algorithm>
 #include <cfloat>
 #include <random>
 
@@ -33,6 +34,8 @@ const QString AVATAR_MIXER_LOGGING_NAME = "avatar-mixer";
 const int AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND = 60;
 const unsigned int AVATAR_DATA_SEND_INTERVAL_MSECS = (1.0f / (float) AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) * 1000;
 
+const float AVATAR_GRID_CELL_SIZE = 10.0f; // meters
+
 AvatarMixer::AvatarMixer(NLPacket& packet) :
     ThreadedAssignment(packet),
     _broadcastThread(),
@@ -42,10 +45,13 @@ AvatarMixer::AvatarMixer(NLPacket& packet) :
     _sumListeners(0),
     _numStatFrames(0),
     _sumBillboardPackets(0),
-    _sumIdentityPackets(0)
+    _sumIdentityPackets(0),
+    _grid(AVATAR_GRID_CELL_SIZE)
 {
     // make sure we hear about node kills so we can tell the other nodes
     connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeKilled, this, &AvatarMixer::nodeKilled);
+    // and about new nodes, so that the others get their identity and billboard
+    connect(DependencyManager::get<NodeList>().data(), &NodeList::nodeAdded, this, &AvatarMixer::nodeAdded);
 
     auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AvatarData, this, "handleAvatarDataPacket");
@@ -130,262 +136,399 @@ void AvatarMixer::broadcastAvatarData() {
 
     auto nodeList = DependencyManager::get<NodeList>();
 
-    // setup for distributed random floating point values
-    std::random_device randomDevice;
-    std::mt19937 generator(randomDevice());
-    std::uniform_real_distribution<float> distribution;
+    // gather everything listeners need about each avatar once, so listeners can be handled in parallel without
+    // having to lock the avatars they are sent
+    nodeList->eachNode([&](const SharedNodePointer& node) {
+        if (node->getLinkedData()) {
+            _frameAvatars.push_back(FrameAvatar());
+            _frameAvatars.back().node = node;
+
+            if (node->getType() == NodeType::Agent && node->getActiveSocket()) {
+                _frameListeners.push_back(FrameListener());
+                _frameListeners.back().node = node;
+            }
+        }
+    });
+
+    _workerPool->run((int) _frameAvatars.size(), [this](int workerIndex, int avatarIndex) {
+        prepareFrameAvatar(_frameAvatars[avatarIndex], _workerGenerators[workerIndex]);
+    });
+
+    for (int i = 0; i < (int) _frameAvatars.size(); ++i) {
+        const FrameAvatar& frameAvatar = _frameAvatars[i];
+        // an avatar with a position we can't place isn't sent this frame
+        if (frameAvatar.isPrepared && _grid.insert(i, frameAvatar.position)) {
+            if (frameAvatar.wasCached) {
+                ++_sumAvatarDataCacheHits;
+            } else {
+                ++_sumAvatarDataEncodes;
+            }
+
+            _frameAvatarIndexes[frameAvatar.node->getUUID()] = i;
+
+            // every listener gets these, near or far
+            if (frameAvatar.billboardChangeTimestamp > _lastFrameTimestamp
+                || frameAvatar.identityChangeTimestamp > _lastFrameTimestamp) {
+                _changedFrameAvatars.push_back(i);
+            }
+        }
+    }
+
+    // build the packets for every listener across the worker pool
+    _workerPool->run((int) _frameListeners.size(), [this](int workerIndex, int listenerIndex) {
+        prepareAvatarPacketsForListener(_frameListeners[listenerIndex], _workerGenerators[workerIndex]);
+    });
+
+    // packets are sent from this thread since it is the one that owns the node socket
+    // collect the packets for every listener and write them out to the socket together once we're done
+    nodeList->beginSendBatch();
+
+    for (FrameListener& listener : _frameListeners) {
+        if (!listener.avatarPacketList) {
+            // we couldn't get at this listener's data this frame
+            continue;
+        }
+        ++_sumListeners;
+
+        for (auto& packet : listener.packets) {
+            nodeList->sendPacket(std::move(packet), *listener.node);
+        }
 
+        // send the avatar data PacketList
+        nodeList->sendPacketList(std::move(listener.avatarPacketList), *listener.node);
+
+        _sumBillboardPackets += listener.numBillboardPackets;
+        _sumIdentityPackets += listener.numIdentityPackets;
+    }
+
+    nodeList->flushSendBatch();
+
+    // We're done encoding this version of the otherAvatars.  Update their "lastSent" joint-states so
+    // that we can notice differences, next time around.
     nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
-            if (!node->getLinkedData()) {
+        [&](const SharedNodePointer& otherNode)->bool {
+            if (!otherNode->getLinkedData()) {
                 return false;
             }
-            if (node->getType() != NodeType::Agent) {
+            if (otherNode->getType() != NodeType::Agent) {
                 return false;
             }
-            if (!node->getActiveSocket()) {
+            if (!otherNode->getActiveSocket()) {
                 return false;
             }
             return true;
         },
-        [&](const SharedNodePointer& node) {
-            AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
-            MutexTryLocker lock(nodeData->getMutex());
+        [&](const SharedNodePointer& otherNode) {
+            AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
+            MutexTryLocker lock(otherNodeData->getMutex());
             if (!lock.isLocked()) {
                 return;
             }
-            ++_sumListeners;
-
-            AvatarData& avatar = nodeData->getAvatar();
-            glm::vec3 myPosition = avatar.getPosition();
+            AvatarData& otherAvatar = otherNodeData->getAvatar();
+            otherAvatar.doneEncoding(false);
+            otherNodeData->clearEncodedAvatarData();
+        });
 
-            // reset the internal state for correct random number distribution
-            distribution.reset();
+    // don't hold on to nodes past this frame
+    _frameAvatars.clear();
+    _frameListeners.clear();
+    _grid.clear();
+    _frameAvatarIndexes.clear();
+    _changedFrameAvatars.clear();
 
-            // reset the max distance for this frame
-            float maxAvatarDistanceThisFrame = 0.0f;
+    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+}
 
-            // reset the number of sent avatars
-            nodeData->resetNumAvatarsSentLastFrame();
+void AvatarMixer::prepareFrameAvatar(FrameAvatar& frameAvatar, std::mt19937& generator) {
+    AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(frameAvatar.node->getLinkedData());
+    MutexTryLocker lock(nodeData->getMutex());
+    if (!lock.isLocked()) {
+        return;
+    }
 
-            // keep a counter of the number of considered avatars
-            int numOtherAvatars = 0;
+    AvatarData& avatar = nodeData->getAvatar();
+    frameAvatar.rfcUUID = frameAvatar.node->getUUID().toRfc4122();
+    frameAvatar.position = avatar.getPosition();
+    frameAvatar.sequenceNumber = nodeData->getLastReceivedSequenceNumber();
 
-            // keep track of outbound data rate specifically for avatar data
-            int numAvatarDataBytes = 0;
+    // every listener gets the same encoding of this avatar this frame, so it is only encoded once
+    std::uniform_real_distribution<float> distribution;
+    frameAvatar.avatarData = nodeData->getEncodedAvatarData(distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO,
+                                                            frameAvatar.wasCached);
 
-            // keep track of the number of other avatars held back in this frame
-            int numAvatarsHeldBack = 0;
+    frameAvatar.billboardChangeTimestamp = nodeData->getBillboardChangeTimestamp();
+    if (frameAvatar.billboardChangeTimestamp > 0) {
+        frameAvatar.billboard = avatar.getBillboard();
+    }
 
-            // keep track of the number of other avatar frames skipped
-            int numAvatarsWithSkippedFrames = 0;
+    frameAvatar.identityChangeTimestamp = nodeData->getIdentityChangeTimestamp();
+    if (frameAvatar.identityChangeTimestamp > 0) {
+        frameAvatar.identity = avatar.identityByteArray();
+        frameAvatar.identity.replace(0, NUM_BYTES_RFC4122_UUID, frameAvatar.rfcUUID);
+    }
 
-            // use the data rate specifically for avatar data for FRD adjustment checks
-            float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
+    frameAvatar.isPrepared = true;
+}
 
-            // Check if it is time to adjust what we send this client based on the observed
-            // bandwidth to this node. We do this once a second, which is also the window for
-            // the bandwidth reported by node->getOutboundBandwidth();
-            if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
+void AvatarMixer::prepareAvatarPacketsForListener(FrameListener& listener, std::mt19937& generator) {
+    const SharedNodePointer& node = listener.node;
+    AvatarMixerClientData* nodeData = reinterpret_cast<AvatarMixerClientData*>(node->getLinkedData());
+    MutexTryLocker lock(nodeData->getMutex());
+    if (!lock.isLocked()) {
+        return;
+    }
 
-                const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
-                const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
-                const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
+    AvatarData& avatar = nodeData->getAvatar();
+    glm::vec3 myPosition = avatar.getPosition();
 
-                // get the current full rate distance so we can work with it
-                float currentFullRateDistance = nodeData->getFullRateDistance();
+    // setup for distributed random floating point values
+    std::uniform_real_distribution<float> distribution;
 
-                if (avatarDataRateLastSecond > _maxKbpsPerNode) {
+    // reset the max distance for this frame
+    float maxAvatarDistanceThisFrame = 0.0f;
 
-                    // is the FRD greater than the farthest avatar?
-                    // if so, before we calculate anything, set it to that distance
-                    currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
+    // reset the number of sent avatars
+    nodeData->resetNumAvatarsSentLastFrame();
 
-                    // we're adjusting the full rate distance to target a bandwidth in the middle
-                    // of the hysterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+    // keep a counter of the number of considered avatars
+    int numOtherAvatars = 0;
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
-                           && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
-                    // we are constrained AND we've recovered to below the acceptable ratio
-                    // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
-                    currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
+    // keep track of outbound data rate specifically for avatar data
+    int numAvatarDataBytes = 0;
 
-                    nodeData->setFullRateDistance(currentFullRateDistance);
-                    nodeData->resetNumFramesSinceFRDAdjustment();
-                }
-            } else {
-                nodeData->incrementNumFramesSinceFRDAdjustment();
-            }
+    // keep track of the number of other avatars held back in this frame
+    int numAvatarsHeldBack = 0;
 
-            // setup a PacketList for the avatarPackets
-            auto avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
+    // keep track of the number of other avatar frames skipped
+    int numAvatarsWithSkippedFrames = 0;
 
-            // this is an AGENT we have received head data from
-            // send back a packet with other active node data to this node
-            nodeList->eachMatchingNode(
-                [&](const SharedNodePointer& otherNode)->bool {
-                    if (!otherNode->getLinkedData()) {
-                        return false;
-                    }
-                    if (otherNode->getUUID() == node->getUUID()) {
-                        return false;
-                    }
+    // use the data rate specifically for avatar data for FRD adjustment checks
+    float avatarDataRateLastSecond = nodeData->getOutboundAvatarDataKbps();
 
-                    return true;
-                },
-                [&](const SharedNodePointer& otherNode) {
-                    ++numOtherAvatars;
+    // Check if it is time to adjust what we send this client based on the observed
+    // bandwidth to this node. We do this once a second, which is also the window for
+    // the bandwidth reported by node->getOutboundBandwidth();
+    if (nodeData->getNumFramesSinceFRDAdjustment() > AVATAR_MIXER_BROADCAST_FRAMES_PER_SECOND) {
 
-                    AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-                    MutexTryLocker lock(otherNodeData->getMutex());
-                    if (!lock.isLocked()) {
-                        return;
-                    }
+        const float FRD_ADJUSTMENT_ACCEPTABLE_RATIO = 0.8f;
+        const float HYSTERISIS_GAP = (1 - FRD_ADJUSTMENT_ACCEPTABLE_RATIO);
+        const float HYSTERISIS_MIDDLE_PERCENTAGE =  (1 - (HYSTERISIS_GAP * 0.5f));
 
-                    // make sure we send out identity and billboard packets to and from new arrivals.
-                    bool forceSend = !otherNodeData->checkAndSetHasReceivedFirstPacketsFrom(node->getUUID());
+        // get the current full rate distance so we can work with it
+        float currentFullRateDistance = nodeData->getFullRateDistance();
 
-                    // we will also force a send of billboard or identity packet
-                    // if either has changed in the last frame
-                    if (otherNodeData->getBillboardChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getBillboardChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+        if (avatarDataRateLastSecond > _maxKbpsPerNode) {
 
-                        QByteArray rfcUUID = otherNode->getUUID().toRfc4122();
-                        QByteArray billboard = otherNodeData->getAvatar().getBillboard();
+            // is the FRD greater than the farthest avatar?
+            // if so, before we calculate anything, set it to that distance
+            currentFullRateDistance = std::min(currentFullRateDistance, nodeData->getMaxAvatarDistance());
 
-                        auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard, rfcUUID.size() + billboard.size());
-                        billboardPacket->write(rfcUUID);
-                        billboardPacket->write(billboard);
+            // we're adjusting the full rate distance to target a bandwidth in the middle
+            // of the hysterisis gap
+            currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
 
-                        nodeList->sendPacket(std::move(billboardPacket), *node);
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        } else if (currentFullRateDistance < nodeData->getMaxAvatarDistance()
+                   && avatarDataRateLastSecond < _maxKbpsPerNode * FRD_ADJUSTMENT_ACCEPTABLE_RATIO) {
+            // we are constrained AND we've recovered to below the acceptable ratio
+            // lets adjust the full rate distance to target a bandwidth in the middle of the hyterisis gap
+            currentFullRateDistance *= (_maxKbpsPerNode * HYSTERISIS_MIDDLE_PERCENTAGE) / avatarDataRateLastSecond;
 
-                        ++_sumBillboardPackets;
-                    }
+            nodeData->setFullRateDistance(currentFullRateDistance);
+            nodeData->resetNumFramesSinceFRDAdjustment();
+        }
+    } else {
+        nodeData->incrementNumFramesSinceFRDAdjustment();
+    }
 
-                    if (otherNodeData->getIdentityChangeTimestamp() > 0
-                        && (forceSend
-                            || otherNodeData->getIdentityChangeTimestamp() > _lastFrameTimestamp
-                            || distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY)) {
+    float fullRateDistance = nodeData->getFullRateDistance();
 
-                        QByteArray individualData = otherNodeData->getAvatar().identityByteArray();
+    // setup a PacketList for the avatarPackets
+    listener.avatarPacketList = NLPacketList::create(PacketType::BulkAvatarData);
 
-                        auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, individualData.size());
+    // sends the billboard and identity of another avatar, or only the ones that changed since last frame
+    auto sendBillboardAndIdentity = [&](const FrameAvatar& otherAvatar, bool onlyChanges) {
+        if (otherAvatar.billboardChangeTimestamp > 0
+            && (!onlyChanges || otherAvatar.billboardChangeTimestamp > _lastFrameTimestamp)) {
 
-                        individualData.replace(0, NUM_BYTES_RFC4122_UUID, otherNode->getUUID().toRfc4122());
+            auto billboardPacket = NLPacket::create(PacketType::AvatarBillboard,
+                                                    otherAvatar.rfcUUID.size() + otherAvatar.billboard.size());
+            billboardPacket->write(otherAvatar.rfcUUID);
+            billboardPacket->write(otherAvatar.billboard);
 
-                        identityPacket->write(individualData);
+            listener.packets.push_back(std::move(billboardPacket));
 
-                        nodeList->sendPacket(std::move(identityPacket), *node);
+            ++listener.numBillboardPackets;
+        }
 
-                        ++_sumIdentityPackets;
-                    }
+        if (otherAvatar.identityChangeTimestamp > 0
+            && (!onlyChanges || otherAvatar.identityChangeTimestamp > _lastFrameTimestamp)) {
 
-                    AvatarData& otherAvatar = otherNodeData->getAvatar();
-                    //  Decide whether to send this avatar's data based on it's distance from us
+            auto identityPacket = NLPacket::create(PacketType::AvatarIdentity, otherAvatar.identity.size());
+            identityPacket->write(otherAvatar.identity);
 
-                    //  The full rate distance is the distance at which EVERY update will be sent for this avatar
-                    //  at twice the full rate distance, there will be a 50% chance of sending this avatar's update
-                    glm::vec3 otherPosition = otherAvatar.getPosition();
-                    float distanceToAvatar = glm::length(myPosition - otherPosition);
+            listener.packets.push_back(std::move(identityPacket));
 
-                    // potentially update the max full rate distance for this frame
-                    maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
+            ++listener.numIdentityPackets;
+        }
+    };
 
-                    if (distanceToAvatar != 0.0f
-                        && distribution(generator) > (nodeData->getFullRateDistance() / distanceToAvatar)) {
-                        return;
-                    }
+    // identities and billboards aren't distance culled, but none of them needs a walk over every avatar either -
+    // new arrivals come from the listener's pending set, changes from the frame's list of them,
+    // and the occasional resend goes out a whole cell at a time below
+    auto& pendingFirstPackets = nodeData->getPendingFirstPacketsFrom();
 
-                    AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherNode->getUUID());
-                    AvatarDataSequenceNumber lastSeqFromSender = otherNodeData->getLastReceivedSequenceNumber();
+    if (nodeData->needsEveryOtherAvatar()) {
+        // this listener is new, it is owed every avatar that was here before it
+        DependencyManager::get<NodeList>()->eachNode([&](const SharedNodePointer& otherNode) {
+            if (otherNode->getType() == NodeType::Agent && otherNode != node) {
+                pendingFirstPackets.insert(otherNode->getUUID());
+            }
+        });
+        nodeData->setNeedsEveryOtherAvatar(false);
+    }
 
-                    if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
-                        // we got out out of order packets from the sender, track it
-                        otherNodeData->incrementNumOutOfOrderSends();
-                    }
+    std::vector<int> firstPacketsSent;
 
-                    // make sure we haven't already sent this data from this sender to this receiver
-                    // or that somehow we haven't sent
-                    if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
-                        ++numAvatarsHeldBack;
-                        return;
-                    } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
-                        // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
-                        ++numAvatarsWithSkippedFrames;
-                    }
+    for (auto it = pendingFirstPackets.begin(); it != pendingFirstPackets.end();) {
+        auto indexIt = _frameAvatarIndexes.find(*it);
 
-                    // we're going to send this avatar
+        if (indexIt == _frameAvatarIndexes.end()) {
+            // this one doesn't have anything for us to send yet, it stays owed
+            ++it;
+            continue;
+        }
 
-                    // increment the number of avatars sent to this reciever
-                    nodeData->incrementNumAvatarsSentLastFrame();
+        sendBillboardAndIdentity(_frameAvatars[indexIt->second], false);
+        firstPacketsSent.push_back(indexIt->second);
+        it = pendingFirstPackets.erase(it);
+    }
 
-                    // set the last sent sequence number for this sender on the receiver
-                    nodeData->setLastBroadcastSequenceNumber(otherNode->getUUID(),
-                                                             otherNodeData->getLastReceivedSequenceNumber());
+    for (int avatarIndex : _changedFrameAvatars) {
+        if (_frameAvatars[avatarIndex].node != node
+            && std::find(firstPacketsSent.begin(), firstPacketsSent.end(), avatarIndex) == firstPacketsSent.end()) {
+            sendBillboardAndIdentity(_frameAvatars[avatarIndex], true);
+        }
+    }
 
-                    // start a new segment in the PacketList for this avatar
-                    avatarPacketList->startSegment();
+    //  Decide whether to send each avatar's data based on it's distance from us
+
+    //  The full rate distance is the distance at which EVERY update will be sent for an avatar
+    //  at twice the full rate distance, there will be a 50% chance of sending the avatar's update.
+    //  Beyond the full rate distance a whole grid cell is first kept with the chance of its nearest point,
+    //  then each avatar in it with the rest of its own chance - so only some of the far cells are visited at all.
+    for (const AvatarSpatialGrid::Cell& cell : _grid.getCells()) {
+        // now and then resend the billboards and identities of a whole cell, whether or not its avatars are sent
+        if (distribution(generator) < BILLBOARD_AND_IDENTITY_SEND_PROBABILITY) {
+            for (int avatarIndex : cell.avatars) {
+                if (_frameAvatars[avatarIndex].node != node) {
+                    sendBillboardAndIdentity(_frameAvatars[avatarIndex], false);
+                }
+            }
+        }
 
-                    numAvatarDataBytes += avatarPacketList->write(otherNode->getUUID().toRfc4122());
-                    numAvatarDataBytes +=
-                        avatarPacketList->write(otherAvatar.toByteArray(false, distribution(generator) < AVATAR_SEND_FULL_UPDATE_RATIO));
+        float minimumCellDistance = cell.getMinimumDistance(myPosition);
+        float cellSendRatio = minimumCellDistance > fullRateDistance ? fullRateDistance / minimumCellDistance : 1.0f;
 
-                    avatarPacketList->endSegment();
-            });
+        if (distribution(generator) > cellSendRatio) {
+            // none of these avatars are sent this frame
+            // our own cell is always visited, so every avatar in this one is another avatar
+            numOtherAvatars += (int) cell.avatars.size();
+            maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, cell.getMaximumDistance(myPosition));
+            continue;
+        }
 
-            // close the current packet so that we're always sending something
-            avatarPacketList->closeCurrentPacket(true);
+        for (int avatarIndex : cell.avatars) {
+            const FrameAvatar& otherAvatar = _frameAvatars[avatarIndex];
+            if (otherAvatar.node == node) {
+                continue;
+            }
 
-            // send the avatar data PacketList
-            nodeList->sendPacketList(std::move(avatarPacketList), *node);
+            ++numOtherAvatars;
 
-            // record the bytes sent for other avatar data in the AvatarMixerClientData
-            nodeData->recordSentAvatarData(numAvatarDataBytes);
+            float distanceToAvatar = glm::length(myPosition - otherAvatar.position);
 
-            // record the number of avatars held back this frame
-            nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
-            nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+            // potentially update the max full rate distance for this frame
+            maxAvatarDistanceThisFrame = std::max(maxAvatarDistanceThisFrame, distanceToAvatar);
 
-            if (numOtherAvatars == 0) {
-                // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
-                nodeData->setMaxAvatarDistance(FLT_MAX);
-            } else {
-                nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
+            if (distanceToAvatar != 0.0f
+                && distribution(generator) * cellSendRatio > (fullRateDistance / distanceToAvatar)) {
+                continue;
             }
-        }
-    );
 
-    // We're done encoding this version of the otherAvatars.  Update their "lastSent" joint-states so
-    // that we can notice differences, next time around.
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& otherNode)->bool {
-            if (!otherNode->getLinkedData()) {
-                return false;
-            }
-            if (otherNode->getType() != NodeType::Agent) {
-                return false;
-            }
-            if (!otherNode->getActiveSocket()) {
-                return false;
+            const QUuid& otherUUID = otherAvatar.node->getUUID();
+            AvatarDataSequenceNumber lastSeqToReceiver = nodeData->getLastBroadcastSequenceNumber(otherUUID);
+            AvatarDataSequenceNumber lastSeqFromSender = otherAvatar.sequenceNumber;
+
+            if (lastSeqToReceiver > lastSeqFromSender && lastSeqToReceiver != UINT16_MAX) {
+                // we got out out of order packets from the sender, track it
+                reinterpret_cast<AvatarMixerClientData*>(otherAvatar.node->getLinkedData())->incrementNumOutOfOrderSends();
             }
-            return true;
-        },
-        [&](const SharedNodePointer& otherNode) {
-            AvatarMixerClientData* otherNodeData = reinterpret_cast<AvatarMixerClientData*>(otherNode->getLinkedData());
-            MutexTryLocker lock(otherNodeData->getMutex());
-            if (!lock.isLocked()) {
-                return;
+
+            // make sure we haven't already sent this data from this sender to this receiver
+            // or that somehow we haven't sent
+            if (lastSeqToReceiver == lastSeqFromSender && lastSeqToReceiver != 0) {
+                ++numAvatarsHeldBack;
+                continue;
+            } else if (lastSeqFromSender - lastSeqToReceiver > 1) {
+                // this is a skip - we still send the packet but capture the presence of the skip so we see it happening
+                ++numAvatarsWithSkippedFrames;
             }
-            AvatarData& otherAvatar = otherNodeData->getAvatar();
-            otherAvatar.doneEncoding(false);
-        });
 
-    _lastFrameTimestamp = QDateTime::currentMSecsSinceEpoch();
+            // we're going to send this avatar
+
+            // increment the number of avatars sent to this reciever
+            nodeData->incrementNumAvatarsSentLastFrame();
+
+            // set the last sent sequence number for this sender on the receiver
+            nodeData->setLastBroadcastSequenceNumber(otherUUID, lastSeqFromSender);
+
+            // start a new segment in the PacketList for this avatar
+            listener.avatarPacketList->startSegment();
+
+            numAvatarDataBytes += listener.avatarPacketList->write(otherAvatar.rfcUUID);
+            numAvatarDataBytes += listener.avatarPacketList->write(otherAvatar.avatarData);
+
+            listener.avatarPacketList->endSegment();
+        }
+    }
+
+    // close the current packet so that we're always sending something
+    listener.avatarPacketList->closeCurrentPacket(true);
+
+    // record the bytes sent for other avatar data in the AvatarMixerClientData
+    nodeData->recordSentAvatarData(numAvatarDataBytes);
+
+    // record the number of avatars held back this frame
+    nodeData->recordNumOtherAvatarStarves(numAvatarsHeldBack);
+    nodeData->recordNumOtherAvatarSkips(numAvatarsWithSkippedFrames);
+
+    if (numOtherAvatars == 0) {
+        // update the full rate distance to FLOAT_MAX since we didn't have any other avatars to send
+        nodeData->setMaxAvatarDistance(FLT_MAX);
+    } else {
+        nodeData->setMaxAvatarDistance(maxAvatarDistanceThisFrame);
+    }
+}
+
+void AvatarMixer::nodeAdded(SharedNodePointer addedNode) {
+    if (addedNode->getType() == NodeType::Agent) {
+        // the listeners that are already here are owed the identity and billboard of this avatar -
+        // it will fill in what it is owed itself on its first frame as a listener
+        auto nodeList = DependencyManager::get<NodeList>();
+        nodeList->eachMatchingNode(
+            [&](const SharedNodePointer& node)->bool {
+                return node->getLinkedData() && node != addedNode;
+            },
+            [&](const SharedNodePointer& node) {
+                QMetaObject::invokeMethod(node->getLinkedData(),
+                                          "addOtherAvatar",
+                                          Qt::AutoConnection,
+                                          Q_ARG(const QUuid&, QUuid(addedNode->getUUID())));
+            }
+        );
+    }
 }
 
 void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
@@ -416,7 +559,7 @@ void AvatarMixer::nodeKilled(SharedNodePointer killedNode) {
             },
             [&](const SharedNodePointer& node) {
                 QMetaObject::invokeMethod(node->getLinkedData(),
-                                          "removeLastBroadcastSequenceNumber",
+                                          "removeOtherAvatar",
                                           Qt::AutoConnection,
                                           Q_ARG(const QUuid&, QUuid(killedNode->getUUID())));
             }
@@ -469,6 +612,13 @@ void AvatarMixer::sendStatsPacket() {
     statsObject["average_billboard_packets_per_frame"] = (float) _sumBillboardPackets / (float) _numStatFrames;
     statsObject["average_identity_packets_per_frame"] = (float) _sumIdentityPackets / (float) _numStatFrames;
 
+    int numAvatarDataSends = _sumAvatarDataEncodes + _sumAvatarDataCacheHits;
+    statsObject["average_avatar_data_encodes_per_frame"] = (float) _sumAvatarDataEncodes / (float) _numStatFrames;
+    statsObject["avatar_data_cache_hit_rate"] =
+        numAvatarDataSends > 0 ? (float) _sumAvatarDataCacheHits / (float) numAvatarDataSends : 0.0f;
+
+    statsObject["broadcast_threads"] = _workerPool ? _workerPool->getNumWorkers() : 1;
+
     statsObject["trailing_sleep_percentage"] = _trailingSleepRatio * 100;
     statsObject["performance_throttling_ratio"] = _performanceThrottlingRatio;
 
@@ -509,6 +659,8 @@ void AvatarMixer::sendStatsPacket() {
     _sumListeners = 0;
     _sumBillboardPackets = 0;
     _sumIdentityPackets = 0;
+    _sumAvatarDataEncodes = 0;
+    _sumAvatarDataCacheHits = 0;
     _numStatFrames = 0;
 }
 
@@ -553,6 +705,14 @@ void AvatarMixer::run() {
     // parse the settings to pull out the values we need
     parseDomainServerSettings(domainHandler.getSettingsObject());
 
+    // spin up the threads listeners are handled on - with a single thread everything happens on the broadcast thread
+    _workerPool.reset(new MixerWorkerPool(_numBroadcastThreads));
+
+    std::random_device randomDevice;
+    for (int i = 0; i < _workerPool->getNumWorkers(); ++i) {
+        _workerGenerators.emplace_back(randomDevice());
+    }
+
     // start the broadcastThread
     _broadcastThread.start();
 }
@@ -569,4 +729,16 @@ void AvatarMixer::parseDomainServerSettings(const QJsonObject& domainSettings) {
 
     _maxKbpsPerNode = nodeBandwidthValue.toDouble(DEFAULT_NODE_SEND_BANDWIDTH) * KILO_PER_MEGA;
     qDebug() << "The maximum send bandwidth per node is" << _maxKbpsPerNode << "kbps.";
+
+    const QString BROADCAST_THREADS_KEY = "broadcast_threads";
+    QJsonValue broadcastThreadsValue = domainSettings[AVATAR_MIXER_SETTINGS_KEY].toObject()[BROADCAST_THREADS_KEY];
+    if (broadcastThreadsValue.isString()) {
+        bool ok = false;
+        int numBroadcastThreads = broadcastThreadsValue.toString().toInt(&ok);
+        if (ok && numBroadcastThreads >= 0) {
+            // zero means use every core we've got
+            _numBroadcastThreads = (numBroadcastThreads == 0) ? std::max(QThread::idealThreadCount(), 1) : numBroadcastThreads;
+        }
+    }
+    qDebug() << "Handling listeners on" << _numBroadcastThreads << "thread(s)";
 }
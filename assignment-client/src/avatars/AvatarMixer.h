@@ -15,7 +15,20 @@
 #ifndef hifi_AvatarMixer_h
 #define hifi_AvatarMixer_h
 
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <AvatarData.h>
+#include <NLPacketList.h>
 #include <ThreadedAssignment.h>
+#include <UUIDHasher.h>
+
+#include "../MixerWorkerPool.h"
+#include "AvatarSpatialGrid.h"
 
 /// Handles assignments of type AvatarMixer - distribution of avatar data to various clients
 class AvatarMixer : public ThreadedAssignment {
@@ -27,6 +40,7 @@ public slots:
     /// runs the avatar mixer
     void run();
 
+    void nodeAdded(SharedNodePointer addedNode);
     void nodeKilled(SharedNodePointer killedNode);
     
     void sendStatsPacket();
@@ -38,7 +52,35 @@ private slots:
     void handleKillAvatarPacket(QSharedPointer<NLPacket> packet);
     
 private:
+    // what every listener needs to know about an avatar, gathered once per frame before listeners are handled
+    class FrameAvatar {
+    public:
+        SharedNodePointer node;
+        bool isPrepared { false }; // false if we couldn't get at this avatar's data this frame
+        QByteArray rfcUUID;
+        glm::vec3 position;
+        AvatarDataSequenceNumber sequenceNumber { 0 };
+        QByteArray avatarData;
+        bool wasCached { false };
+        quint64 billboardChangeTimestamp { 0 };
+        QByteArray billboard;
+        quint64 identityChangeTimestamp { 0 };
+        QByteArray identity;
+    };
+
+    // the packets built for a listener by the worker pool, sent from the broadcast thread
+    class FrameListener {
+    public:
+        SharedNodePointer node;
+        std::vector<std::unique_ptr<NLPacket>> packets; // billboard and identity packets
+        std::unique_ptr<NLPacketList> avatarPacketList;
+        int numBillboardPackets { 0 };
+        int numIdentityPackets { 0 };
+    };
+
     void broadcastAvatarData();
+    void prepareFrameAvatar(FrameAvatar& frameAvatar, std::mt19937& generator);
+    void prepareAvatarPacketsForListener(FrameListener& listener, std::mt19937& generator);
     void parseDomainServerSettings(const QJsonObject& domainSettings);
     
     QThread _broadcastThread;
@@ -52,9 +94,21 @@ private:
     int _numStatFrames;
     int _sumBillboardPackets;
     int _sumIdentityPackets;
+    int _sumAvatarDataEncodes = 0;
+    int _sumAvatarDataCacheHits = 0;
 
     float _maxKbpsPerNode = 0.0f;
 
+    int _numBroadcastThreads = 1;
+    std::unique_ptr<MixerWorkerPool> _workerPool;
+    std::vector<std::mt19937> _workerGenerators; // one per worker, so they can draw random numbers without locking
+
+    std::vector<FrameAvatar> _frameAvatars;
+    std::vector<FrameListener> _frameListeners;
+    AvatarSpatialGrid _grid;
+    std::unordered_map<QUuid, int> _frameAvatarIndexes; // the avatars in the grid, by node UUID
+    std::vector<int> _changedFrameAvatars; // the avatars in the grid whose identity or billboard changed since last frame
+
     QTimer* _broadcastTimer = nullptr;
 };
 
@@ -21,12 +21,15 @@ int AvatarMixerClientData::parseData(NLPacket& packet) {
     return _avatar.parseDataFromBuffer(packet.readWithoutCopy(packet.bytesLeftToRead()));
 }
 
-bool AvatarMixerClientData::checkAndSetHasReceivedFirstPacketsFrom(const QUuid& uuid) {
-    if (_hasReceivedFirstPacketsFrom.find(uuid) == _hasReceivedFirstPacketsFrom.end()) {
-        _hasReceivedFirstPacketsFrom.insert(uuid);
-        return false;
-    }
-    return true;
+void AvatarMixerClientData::addOtherAvatar(const QUuid& nodeUUID) {
+    QMutexLocker locker(&getMutex());
+    _pendingFirstPacketsFrom.insert(nodeUUID);
+}
+
+void AvatarMixerClientData::removeOtherAvatar(const QUuid& nodeUUID) {
+    QMutexLocker locker(&getMutex());
+    _lastBroadcastSequenceNumbers.erase(nodeUUID);
+    _pendingFirstPacketsFrom.erase(nodeUUID);
 }
 
 uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const {
@@ -39,6 +42,20 @@ uint16_t AvatarMixerClientData::getLastBroadcastSequenceNumber(const QUuid& node
     }
 }
 
+const QByteArray& AvatarMixerClientData::getEncodedAvatarData(bool sendAll, bool& wasCached) {
+    EncodedAvatarData& encoded = _encodedAvatarData[sendAll ? 1 : 0];
+
+    // a new packet from this avatar changes its data, so the sequence number tells us if the encoding is still current
+    wasCached = encoded.isValid && encoded.sequenceNumber == _lastReceivedSequenceNumber;
+    if (!wasCached) {
+        encoded.data = _avatar.toByteArray(false, sendAll);
+        encoded.sequenceNumber = _lastReceivedSequenceNumber;
+        encoded.isValid = true;
+    }
+
+    return encoded.data;
+}
+
 void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["display_name"] = _avatar.getDisplayName();
     jsonObject["full_rate_distance"] = _fullRateDistance;
@@ -46,7 +63,7 @@ void AvatarMixerClientData::loadJSONStats(QJsonObject& jsonObject) const {
     jsonObject["num_avs_sent_last_frame"] = _numAvatarsSentLastFrame;
     jsonObject["avg_other_av_starves_per_second"] = getAvgNumOtherAvatarStarvesPerSecond();
     jsonObject["avg_other_av_skips_per_second"] = getAvgNumOtherAvatarSkipsPerSecond();
-    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends;
+    jsonObject["total_num_out_of_order_sends"] = _numOutOfOrderSends.load();
 
     jsonObject[OUTBOUND_AVATAR_DATA_STATS_KEY] = getOutboundAvatarDataKbps();
     jsonObject[INBOUND_AVATAR_DATA_STATS_KEY] = _avatar.getAverageBytesReceivedPerSecond() / (float) BYTES_PER_KILOBIT;
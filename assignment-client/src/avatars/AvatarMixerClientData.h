@@ -13,6 +13,7 @@
 #define hifi_AvatarMixerClientData_h
 
 #include <algorithm>
+#include <atomic>
 #include <cfloat>
 #include <unordered_map>
 #include <unordered_set>
@@ -36,12 +37,19 @@ public:
     int parseData(NLPacket& packet);
     AvatarData& getAvatar() { return _avatar; }
 
-    bool checkAndSetHasReceivedFirstPacketsFrom(const QUuid& uuid);
+    /// the avatars this listener is still owed a first identity and billboard from, sent once they have data to send
+    std::unordered_set<QUuid>& getPendingFirstPacketsFrom() { return _pendingFirstPacketsFrom; }
+    /// a listener starts out owed every avatar that was there before it, the mixer fills those in on its first frame
+    bool needsEveryOtherAvatar() const { return _needsEveryOtherAvatar; }
+    void setNeedsEveryOtherAvatar(bool needsEveryOtherAvatar) { _needsEveryOtherAvatar = needsEveryOtherAvatar; }
+    /// owes this listener the first identity and billboard of an avatar that just arrived
+    Q_INVOKABLE void addOtherAvatar(const QUuid& nodeUUID);
 
     uint16_t getLastBroadcastSequenceNumber(const QUuid& nodeUUID) const;
     void setLastBroadcastSequenceNumber(const QUuid& nodeUUID, uint16_t sequenceNumber)
         { _lastBroadcastSequenceNumbers[nodeUUID] = sequenceNumber; }
-    Q_INVOKABLE void removeLastBroadcastSequenceNumber(const QUuid& nodeUUID) { _lastBroadcastSequenceNumbers.erase(nodeUUID); }
+    /// forgets what was sent to this node about another avatar, call once that avatar is gone
+    Q_INVOKABLE void removeOtherAvatar(const QUuid& nodeUUID);
 
     uint16_t getLastReceivedSequenceNumber() const { return _lastReceivedSequenceNumber; }
 
@@ -67,6 +75,7 @@ public:
     void recordNumOtherAvatarSkips(int numOtherAvatarSkips) { _otherAvatarSkips.updateAverage((float) numOtherAvatarSkips); }
     float getAvgNumOtherAvatarSkipsPerSecond() const { return _otherAvatarSkips.getAverageSampleValuePerSecond(); }
 
+    // called by whichever broadcast worker is handling a listener this avatar is sent to
     void incrementNumOutOfOrderSends() { ++_numOutOfOrderSends; }
 
     int getNumFramesSinceFRDAdjustment() const { return _numFramesSinceAdjustment; }
@@ -78,13 +87,26 @@ public:
     float getOutboundAvatarDataKbps() const
         { return _avgOtherAvatarDataRate.getAverageSampleValuePerSecond() / (float) BYTES_PER_KILOBIT; }
 
+    /// this avatar's data as broadcast to listeners, encoded once per received packet and shared by every listener
+    const QByteArray& getEncodedAvatarData(bool sendAll, bool& wasCached);
+    /// call whenever the avatar is done encoding, which moves the joint data the partial encoding is relative to
+    void clearEncodedAvatarData() { _encodedAvatarData[0].isValid = _encodedAvatarData[1].isValid = false; }
+
     void loadJSONStats(QJsonObject& jsonObject) const;
 private:
+    class EncodedAvatarData {
+    public:
+        QByteArray data;
+        uint16_t sequenceNumber { 0 };
+        bool isValid { false };
+    };
+
     AvatarData _avatar;
 
     uint16_t _lastReceivedSequenceNumber { 0 };
     std::unordered_map<QUuid, uint16_t> _lastBroadcastSequenceNumbers;
-    std::unordered_set<QUuid> _hasReceivedFirstPacketsFrom;
+    std::unordered_set<QUuid> _pendingFirstPacketsFrom;
+    bool _needsEveryOtherAvatar { true };
 
     quint64 _billboardChangeTimestamp = 0;
     quint64 _identityChangeTimestamp = 0;
@@ -97,9 +119,11 @@ private:
 
     SimpleMovingAverage _otherAvatarStarves;
     SimpleMovingAverage _otherAvatarSkips;
-    int _numOutOfOrderSends = 0;
+    std::atomic<int> _numOutOfOrderSends { 0 };
 
     SimpleMovingAverage _avgOtherAvatarDataRate;
+
+    EncodedAvatarData _encodedAvatarData[2]; // partial and full (sendAll) encodings
 };
 
 #endif // hifi_AvatarMixerClientData_h
@@ -0,0 +1,61 @@
+//
+//  AvatarSpatialGrid.cpp
+//  assignment-client/src/avatars
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <cmath>
+
+#include "AvatarSpatialGrid.h"
+
+float AvatarSpatialGrid::Cell::getMinimumDistance(const glm::vec3& point) const {
+    // zero along each axis the point is within the cell on
+    glm::vec3 offset = glm::max(glm::max(minimum - point, point - maximum), glm::vec3(0.0f));
+    return glm::length(offset);
+}
+
+float AvatarSpatialGrid::Cell::getMaximumDistance(const glm::vec3& point) const {
+    glm::vec3 offset = glm::max(glm::abs(point - minimum), glm::abs(point - maximum));
+    return glm::length(offset);
+}
+
+void AvatarSpatialGrid::clear() {
+    _cells.clear();
+    _cellIndexes.clear();
+}
+
+bool AvatarSpatialGrid::insert(int avatarIndex, const glm::vec3& position) {
+    // positions come off the network, converting a NaN or an out of range float to int is undefined
+    if (!std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(position.z)) {
+        return false;
+    }
+
+    // 21 bits per axis covers more space than a domain has, anything further out shares the outermost cells
+    const int AXIS_BITS = 21;
+    const float MAX_CELL_COORDINATE = (float) ((1 << (AXIS_BITS - 1)) - 1);
+    glm::ivec3 cellCoordinates = glm::ivec3(glm::clamp(glm::floor(position / _cellSize),
+                                                       -MAX_CELL_COORDINATE, MAX_CELL_COORDINATE));
+
+    const quint64 AXIS_MASK = (1 << AXIS_BITS) - 1;
+    quint64 key = ((quint64) (cellCoordinates.x & AXIS_MASK) << (2 * AXIS_BITS))
+        | ((quint64) (cellCoordinates.y & AXIS_MASK) << AXIS_BITS)
+        | (quint64) (cellCoordinates.z & AXIS_MASK);
+
+    auto it = _cellIndexes.find(key);
+    if (it == _cellIndexes.end()) {
+        it = _cellIndexes.insert({ key, (int) _cells.size() }).first;
+
+        Cell cell;
+        cell.minimum = glm::vec3(cellCoordinates) * _cellSize;
+        cell.maximum = cell.minimum + glm::vec3(_cellSize);
+        _cells.push_back(cell);
+    }
+
+    _cells[it->second].avatars.push_back(avatarIndex);
+    return true;
+}
@@ -0,0 +1,50 @@
+//
+//  AvatarSpatialGrid.h
+//  assignment-client/src/avatars
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AvatarSpatialGrid_h
+#define hifi_AvatarSpatialGrid_h
+
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <QtCore/QtGlobal>
+
+/// Uniform grid of the avatar positions of a single broadcast frame.
+/// It is filled before listeners are handled and only read while they are, so it needs no locking.
+class AvatarSpatialGrid {
+public:
+    class Cell {
+    public:
+        glm::vec3 minimum;
+        glm::vec3 maximum;
+        std::vector<int> avatars; // indexes passed to insert
+
+        float getMinimumDistance(const glm::vec3& point) const;
+        float getMaximumDistance(const glm::vec3& point) const;
+    };
+
+    AvatarSpatialGrid(float cellSize) : _cellSize(cellSize) { }
+
+    void clear();
+    /// returns false, and leaves the avatar out, if its position isn't finite
+    bool insert(int avatarIndex, const glm::vec3& position);
+
+    /// the cells that have at least one avatar in them
+    const std::vector<Cell>& getCells() const { return _cells; }
+
+private:
+    float _cellSize;
+    std::vector<Cell> _cells;
+    std::unordered_map<quint64, int> _cellIndexes; // cell key to index in _cells
+};
+
+#endif // hifi_AvatarSpatialGrid_h
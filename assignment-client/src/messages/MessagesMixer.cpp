@@ -11,10 +11,13 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QJsonObject>
-#include <QBuffer>
+
+#include <algorithm>
+#include <cstring>
 
 #include <LogHandler.h>
 #include <NodeList.h>
+#include <NumericalConstants.h>
 #include <udt/PacketHeaders.h>
 
 #include "MessagesMixer.h"
@@ -37,8 +40,14 @@ MessagesMixer::~MessagesMixer() {
 }
 
 void MessagesMixer::nodeKilled(SharedNodePointer killedNode) {
-    for (auto& channel : _channelSubscribers) {
-        channel.remove(killedNode->getUUID());
+    auto it = _channelSubscribers.begin();
+    while (it != _channelSubscribers.end()) {
+        it->remove(killedNode->getUUID());
+        if (it->isEmpty()) {
+            it = _channelSubscribers.erase(it);
+        } else {
+            ++it;
+        }
     }
 }
 
@@ -46,63 +55,76 @@ void MessagesMixer::handleMessages(QSharedPointer<NLPacketList> packetList, Shar
     Q_ASSERT(packetList->getType() == PacketType::MessagesData);
 
     QByteArray packetData = packetList->getMessage();
-    QBuffer packet{ &packetData };
-    packet.open(QIODevice::ReadOnly);
 
+    // subscribers receive the payload exactly as it was sent, so only read far enough to find the channel
+    // and make sure both lengths fit in what we received
     quint16 channelLength;
-    packet.read(reinterpret_cast<char*>(&channelLength), sizeof(channelLength));
-    auto channelData = packet.read(channelLength);
-    QString channel = QString::fromUtf8(channelData);
-
     quint16 messageLength;
-    packet.read(reinterpret_cast<char*>(&messageLength), sizeof(messageLength));
-    auto messageData = packet.read(messageLength);
-    QString message = QString::fromUtf8(messageData);
-    
-    auto nodeList = DependencyManager::get<NodeList>();
+    if (packetData.size() < (int)sizeof(channelLength)) {
+        return;
+    }
+    memcpy(&channelLength, packetData.constData(), sizeof(channelLength));
 
-    nodeList->eachMatchingNode(
-        [&](const SharedNodePointer& node)->bool {
+    int messageLengthOffset = sizeof(channelLength) + channelLength;
+    if (packetData.size() < messageLengthOffset + (int)sizeof(messageLength)) {
+        return;
+    }
+    memcpy(&messageLength, packetData.constData() + messageLengthOffset, sizeof(messageLength));
 
-        return node->getType() == NodeType::Agent && node->getActiveSocket() &&
-                _channelSubscribers[channel].contains(node->getUUID());
-    },
-        [&](const SharedNodePointer& node) {
+    int payloadSize = messageLengthOffset + sizeof(messageLength) + messageLength;
+    if (packetData.size() < payloadSize) {
+        qDebug() << "Dropping truncated message from node" << senderNode->getUUID();
+        return;
+    }
 
-        auto packetList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    QByteArray channel = packetData.mid(sizeof(channelLength), channelLength);
 
-        auto channelUtf8 = channel.toUtf8();
-        quint16 channelLength = channelUtf8.length();
-        packetList->writePrimitive(channelLength);
-        packetList->write(channelUtf8);
+    ChannelStats& stats = _channelStats[channel];
+    stats.messages++;
+    stats.inboundBytes += payloadSize;
 
-        auto messageUtf8 = message.toUtf8();
-        quint16 messageLength = messageUtf8.length();
-        packetList->writePrimitive(messageLength);
-        packetList->write(messageUtf8);
+    auto subscribers = _channelSubscribers.constFind(channel);
+    if (subscribers == _channelSubscribers.constEnd()) {
+        return;
+    }
 
-        nodeList->sendPacketList(std::move(packetList), *node);
-    });
+    // write the message once, then hand each subscriber its own copy of the packets
+    auto messagePacketList = NLPacketList::create(PacketType::MessagesData, QByteArray(), true, true);
+    messagePacketList->write(packetData.constData(), payloadSize);
+    messagePacketList->closeCurrentPacket();
+
+    auto nodeList = DependencyManager::get<NodeList>();
+
+    for (const QUuid& subscriberID : *subscribers) {
+        SharedNodePointer node = nodeList->nodeWithUUID(subscriberID);
+        if (node && node->getType() == NodeType::Agent && node->getActiveSocket()) {
+            nodeList->sendPacketList(NLPacketList::createCopy(*messagePacketList), *node);
+            stats.outboundBytes += payloadSize;
+        }
+    }
 }
 
 void MessagesMixer::handleMessagesSubscribe(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode) {
     Q_ASSERT(packetList->getType() == PacketType::MessagesSubscribe);
-    QString channel = QString::fromUtf8(packetList->getMessage());
-    qDebug() << "Node [" << senderNode->getUUID() << "] subscribed to channel:" << channel;
+    QByteArray channel = packetList->getMessage();
+    qDebug() << "Node [" << senderNode->getUUID() << "] subscribed to channel:" << QString::fromUtf8(channel);
     _channelSubscribers[channel] << senderNode->getUUID();
 }
 
 void MessagesMixer::handleMessagesUnsubscribe(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode) {
     Q_ASSERT(packetList->getType() == PacketType::MessagesUnsubscribe);
-    QString channel = QString::fromUtf8(packetList->getMessage());
-    qDebug() << "Node [" << senderNode->getUUID() << "] unsubscribed from channel:" << channel;
-
-    if (_channelSubscribers.contains(channel)) {
-        _channelSubscribers[channel].remove(senderNode->getUUID());
+    QByteArray channel = packetList->getMessage();
+    qDebug() << "Node [" << senderNode->getUUID() << "] unsubscribed from channel:" << QString::fromUtf8(channel);
+
+    auto it = _channelSubscribers.find(channel);
+    if (it != _channelSubscribers.end()) {
+        it->remove(senderNode->getUUID());
+        if (it->isEmpty()) {
+            _channelSubscribers.erase(it);
+        }
     }
 }
 
-// FIXME - make these stats relevant
 void MessagesMixer::sendStatsPacket() {
     QJsonObject statsObject;
     QJsonObject messagesObject;
@@ -120,6 +142,26 @@ void MessagesMixer::sendStatsPacket() {
     });
 
     statsObject["messages"] = messagesObject;
+
+    // add rates for each channel that has subscribers or saw traffic since the last stats packet
+    float secondsSinceLastStats = std::max(_statsTimer.restart(), (qint64)1) / (float)MSECS_PER_SECOND;
+
+    QSet<QByteArray> channels = QSet<QByteArray>::fromList(_channelSubscribers.keys());
+    channels.unite(QSet<QByteArray>::fromList(_channelStats.keys()));
+
+    QJsonObject channelsObject;
+    for (const QByteArray& channel : channels) {
+        ChannelStats stats = _channelStats.value(channel);
+        QJsonObject channelStats;
+        channelStats["subscribers"] = _channelSubscribers.value(channel).size();
+        channelStats["messages_per_second"] = stats.messages / secondsSinceLastStats;
+        channelStats["inbound_kbps"] = stats.inboundBytes / (BYTES_PER_KILOBIT * secondsSinceLastStats);
+        channelStats["outbound_kbps"] = stats.outboundBytes / (BYTES_PER_KILOBIT * secondsSinceLastStats);
+        channelsObject[QString::fromUtf8(channel)] = channelStats;
+    }
+    _channelStats.clear();
+
+    statsObject["channels"] = channelsObject;
     ThreadedAssignment::addPacketStatsAndSendStatsPacket(statsObject);
 }
 
@@ -128,6 +170,8 @@ void MessagesMixer::run() {
 
     auto nodeList = DependencyManager::get<NodeList>();
     nodeList->addNodeTypeToInterestSet(NodeType::Agent);
+
+    _statsTimer.start();
     
     // The messages-mixer currently does currently have any domain settings. If it did, they would be
     // synchronously grabbed here.
@@ -15,6 +15,8 @@
 #ifndef hifi_MessagesMixer_h
 #define hifi_MessagesMixer_h
 
+#include <QtCore/QElapsedTimer>
+
 #include <ThreadedAssignment.h>
 
 /// Handles assignments of type MessagesMixer - distribution of avatar data to various clients
@@ -35,7 +37,18 @@ private slots:
     void handleMessagesUnsubscribe(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode);
 
 private:
-    QHash<QString,QSet<QUuid>> _channelSubscribers;
+    struct ChannelStats {
+        quint64 messages { 0 };
+        quint64 inboundBytes { 0 };
+        quint64 outboundBytes { 0 };
+    };
+
+    // channels are kept as the UTF-8 bytes they arrive as, so forwarding a message never decodes it
+    QHash<QByteArray, QSet<QUuid>> _channelSubscribers;
+
+    // counted since the last stats packet
+    QHash<QByteArray, ChannelStats> _channelStats;
+    QElapsedTimer _statsTimer;
 };
 
 #endif // hifi_MessagesMixer_h
@@ -18,7 +18,9 @@
 #include <SharedUtil.h>
 #include <UUID.h>
 
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
+#include "OctreeServer.h"
 
 OctreeQueryNode::OctreeQueryNode() :
     _viewSent(false),
@@ -61,8 +63,8 @@ void OctreeQueryNode::nodeKilled() {
     _isShuttingDown = true;
     elementBag.unhookNotifications(); // if our node is shutting down, then we no longer need octree element notifications
     if (_octreeSendThread) {
-        // just tell our thread we want to shutdown, this is asynchronous, and fast, we don't need or want it to block
-        // while the thread actually shuts down
+        // just tell our sender we want to shutdown, this is asynchronous, and fast, we don't need or want it to block
+        // while the sender actually shuts down
         _octreeSendThread->setIsShuttingDown();
     }
 }
@@ -71,12 +73,11 @@ void OctreeQueryNode::forceNodeShutdown() {
     _isShuttingDown = true;
     elementBag.unhookNotifications(); // if our node is shutting down, then we no longer need octree element notifications
     if (_octreeSendThread) {
-        // we really need to force our thread to shutdown, this is synchronous, we will block while the thread actually
-        // shuts down because we really need it to shutdown, and it's ok if we wait for it to complete
+        // we really need to force our sender to shutdown, this is synchronous, deleting it blocks while a scheduler
+        // worker finishes any send it is in the middle of, and it's ok if we wait for it to complete
         OctreeSendThread* sendThread = _octreeSendThread;
         _octreeSendThread = NULL;
         sendThread->setIsShuttingDown();
-        sendThread->terminate();
         delete sendThread;
     }
 }
@@ -95,9 +96,10 @@ void OctreeQueryNode::sendThreadFinished() {
 void OctreeQueryNode::initializeOctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node) {
     _octreeSendThread = new OctreeSendThread(myServer, node);
 
-    // we want to be notified when the thread finishes
-    connect(_octreeSendThread, &GenericThread::finished, this, &OctreeQueryNode::sendThreadFinished);
-    _octreeSendThread->initialize(true);
+    // we want to be notified when the sender finishes, this is emitted from a scheduler worker
+    connect(_octreeSendThread, &OctreeSendThread::finished, this, &OctreeQueryNode::sendThreadFinished,
+            Qt::QueuedConnection);
+    myServer->getSendScheduler()->add(_octreeSendThread);
 }
 
 bool OctreeQueryNode::packetIsDuplicate() const {
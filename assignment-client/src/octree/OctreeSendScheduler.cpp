@@ -0,0 +1,237 @@
+//
+//  OctreeSendScheduler.cpp
+//  assignment-client/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <chrono>
+
+#include <QThread>
+
+#include <SharedUtil.h>
+
+#include "OctreeSendThread.h"
+#include "OctreeServerConsts.h"
+
+#include "OctreeSendScheduler.h"
+
+// a worker whose next client has been due for this long is behind, and wakes a sleeping worker to steal from it
+const quint64 BEHIND_USECS = 1000;
+
+OctreeSendScheduler::OctreeSendScheduler(int numWorkers) {
+    if (numWorkers <= 0) {
+        numWorkers = std::max(1, QThread::idealThreadCount());
+    }
+
+    for (int i = 0; i < numWorkers; i++) {
+        _workers.emplace_back(new Worker());
+    }
+    for (int i = 0; i < numWorkers; i++) {
+        _workers[i]->thread = std::thread(&OctreeSendScheduler::workerLoop, this, i);
+    }
+}
+
+OctreeSendScheduler::~OctreeSendScheduler() {
+    _isStopping = true;
+    for (auto& worker : _workers) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->wake.notify_all();
+    }
+    for (auto& worker : _workers) {
+        worker->thread.join();
+    }
+}
+
+void OctreeSendScheduler::add(OctreeSendThread* sender) {
+    JobPointer job = std::make_shared<Job>();
+    job->sender = sender;
+    job->dueAt = usecTimestampNow();
+    {
+        std::lock_guard<std::mutex> lock(_jobsMutex);
+        _jobs[sender] = job;
+    }
+    schedule(_nextWorker++ % getNumWorkers(), job);
+}
+
+void OctreeSendScheduler::remove(OctreeSendThread* sender) {
+    JobPointer job;
+    {
+        std::lock_guard<std::mutex> lock(_jobsMutex);
+        auto found = _jobs.find(sender);
+        if (found == _jobs.end()) {
+            return;
+        }
+        job = found->second;
+        _jobs.erase(found);
+    }
+
+    // the job is dropped from its queue the next time a worker comes across it
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->isRemoved = true;
+    job->idle.wait(lock, [&]{ return !job->isRunning; });
+}
+
+void OctreeSendScheduler::schedule(int workerIndex, const JobPointer& job) {
+    Worker& worker = *_workers[workerIndex];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+
+    // keep the queue in due order so the front is what the worker sleeps until, nearly always this is the back
+    auto position = worker.queue.end();
+    while (position != worker.queue.begin() && (*std::prev(position))->dueAt > job->dueAt) {
+        --position;
+    }
+    worker.queue.insert(position, job);
+    worker.wake.notify_one();
+}
+
+// drops removed jobs from the front of the queue and pops the front one if it is due, the caller locks the worker.
+// hasMoreDue is set if the job after it is already behind
+OctreeSendScheduler::JobPointer OctreeSendScheduler::popDueJob(std::deque<JobPointer>& queue, quint64 now,
+                                                               bool& hasMoreDue) {
+    while (!queue.empty() && queue.front()->isRemoved) {
+        queue.pop_front();
+    }
+    if (queue.empty() || queue.front()->dueAt > now) {
+        return JobPointer();
+    }
+
+    JobPointer job = queue.front();
+    queue.pop_front();
+    hasMoreDue = !queue.empty() && queue.front()->dueAt + BEHIND_USECS <= now;
+    return job;
+}
+
+OctreeSendScheduler::JobPointer OctreeSendScheduler::takeDueJob(int workerIndex, quint64 now, bool& hasMoreDue) {
+    Worker& worker = *_workers[workerIndex];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    return popDueJob(worker.queue, now, hasMoreDue);
+}
+
+OctreeSendScheduler::JobPointer OctreeSendScheduler::stealDueJob(int workerIndex, quint64 now, bool& hasMoreDue) {
+    int numWorkers = getNumWorkers();
+    for (int i = 1; i < numWorkers; i++) {
+        Worker& victim = *_workers[(workerIndex + i) % numWorkers];
+
+        // don't wait on a busy queue, move on to the next one
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            continue;
+        }
+
+        JobPointer job = popDueJob(victim.queue, now, hasMoreDue);
+        if (job) {
+            return job;
+        }
+    }
+    return JobPointer();
+}
+
+void OctreeSendScheduler::wakeIdleWorker(int workerIndex) {
+    int numWorkers = getNumWorkers();
+    for (int i = 1; i < numWorkers; i++) {
+        Worker& worker = *_workers[(workerIndex + i) % numWorkers];
+
+        std::unique_lock<std::mutex> lock(worker.mutex, std::try_to_lock);
+        if (lock.owns_lock() && worker.isWaiting) {
+            worker.wake.notify_one();
+            return;
+        }
+    }
+}
+
+void OctreeSendScheduler::runJob(int workerIndex, const JobPointer& job) {
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (job->isRemoved) {
+            return;
+        }
+        job->isRunning = true;
+    }
+
+    quint64 start = usecTimestampNow();
+    if (start - job->dueAt > (quint64)OCTREE_SEND_INTERVAL_USECS) {
+        ++_lateSlices;
+    }
+    ++_slices;
+
+    bool keepSending = job->sender->process();
+
+    if (!keepSending) {
+        {
+            std::lock_guard<std::mutex> lock(_jobsMutex);
+            auto found = _jobs.find(job->sender);
+            if (found != _jobs.end() && found->second == job) {
+                _jobs.erase(found);
+            }
+        }
+
+        // the sender is deleted in response to finished(), it must not be touched after this
+        if (!job->isRemoved.exchange(true)) {
+            emit job->sender->finished();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->isRunning = false;
+    }
+    job->idle.notify_all();
+
+    if (keepSending && !job->isRemoved) {
+        // the client keeps its place on this worker, whichever worker it came from
+        job->dueAt = start + OCTREE_SEND_INTERVAL_USECS;
+        schedule(workerIndex, job);
+    }
+}
+
+void OctreeSendScheduler::workerLoop(int workerIndex) {
+    Worker& worker = *_workers[workerIndex];
+
+    while (!_isStopping) {
+        quint64 now = usecTimestampNow();
+        bool hasMoreDue = false;
+
+        JobPointer job = takeDueJob(workerIndex, now, hasMoreDue);
+        if (!job) {
+            job = stealDueJob(workerIndex, now, hasMoreDue);
+            if (job) {
+                ++_steals;
+            }
+        }
+
+        if (job) {
+            if (hasMoreDue) {
+                // that queue is falling behind, get a waiting worker to come and steal from it
+                wakeIdleWorker(workerIndex);
+            }
+            runJob(workerIndex, job);
+            continue;
+        }
+
+        // nothing is due, sleep until the next client on this worker is, or until we're woken up because a client
+        // was added here or another worker has more due than it can keep up with
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        while (!worker.queue.empty() && worker.queue.front()->isRemoved) {
+            worker.queue.pop_front();
+        }
+        now = usecTimestampNow();
+        if (_isStopping || (!worker.queue.empty() && worker.queue.front()->dueAt <= now)) {
+            continue;
+        }
+
+        worker.isWaiting = true;
+        if (worker.queue.empty()) {
+            worker.wake.wait(lock);
+        } else {
+            worker.wake.wait_for(lock, std::chrono::microseconds(worker.queue.front()->dueAt - now));
+        }
+        worker.isWaiting = false;
+
+        OctreeSendThread::_usleepTime += usecTimestampNow() - now;
+        ++OctreeSendThread::_usleepCalls;
+    }
+}
@@ -0,0 +1,91 @@
+//
+//  OctreeSendScheduler.h
+//  assignment-client/src/octree
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeSendScheduler_h
+#define hifi_OctreeSendScheduler_h
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <QtGlobal>
+
+class OctreeSendThread;
+
+/// Runs the OctreeSendThreads of every client on a fixed set of worker threads instead of one thread per client.
+/// Each worker keeps its own queue of clients, ordered by when their next send interval starts, and runs one
+/// process() slice per client per interval. A worker sleeps until its next client is due. A worker that falls behind
+/// wakes a sleeping one, which steals overdue clients from the front of the other workers' queues.
+class OctreeSendScheduler {
+public:
+    /// numWorkers of 0 uses one worker per core
+    OctreeSendScheduler(int numWorkers = 0);
+    ~OctreeSendScheduler();
+
+    int getNumWorkers() const { return (int) _workers.size(); }
+
+    /// starts sending to a client, the sender emits finished() on a worker thread once its process() returns false
+    void add(OctreeSendThread* sender);
+
+    /// stops scheduling a sender, waits for a slice that is running on a worker to return
+    void remove(OctreeSendThread* sender);
+
+    quint64 getSlices() const { return _slices; }
+    quint64 getSteals() const { return _steals; }
+    quint64 getLateSlices() const { return _lateSlices; }
+
+private:
+    class Job {
+    public:
+        OctreeSendThread* sender;
+        quint64 dueAt { 0 };
+
+        std::mutex mutex;
+        std::condition_variable idle;
+        bool isRunning { false }; // guarded by mutex, remove() waits on idle for it to clear
+        std::atomic<bool> isRemoved { false };
+    };
+    using JobPointer = std::shared_ptr<Job>;
+
+    class Worker {
+    public:
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<JobPointer> queue;
+        bool isWaiting { false }; // guarded by mutex, true while the worker sleeps with nothing due
+        std::thread thread;
+    };
+
+    void workerLoop(int workerIndex);
+    static JobPointer popDueJob(std::deque<JobPointer>& queue, quint64 now, bool& hasMoreDue);
+    JobPointer takeDueJob(int workerIndex, quint64 now, bool& hasMoreDue);
+    JobPointer stealDueJob(int workerIndex, quint64 now, bool& hasMoreDue);
+    void wakeIdleWorker(int workerIndex);
+    void runJob(int workerIndex, const JobPointer& job);
+    void schedule(int workerIndex, const JobPointer& job);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<bool> _isStopping { false };
+    std::atomic<int> _nextWorker { 0 };
+
+    std::mutex _jobsMutex;
+    std::unordered_map<OctreeSendThread*, JobPointer> _jobs;
+
+    std::atomic<quint64> _slices { 0 };
+    std::atomic<quint64> _steals { 0 };
+    std::atomic<quint64> _lateSlices { 0 };
+};
+
+#endif // hifi_OctreeSendScheduler_h
@@ -40,7 +40,7 @@ OctreeSendThread::OctreeSendThread(OctreeServer* myServer, const SharedNodePoint
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client connected "
-                                            "- starting sending thread [" << this << "]";
+                                            "- starting sender [" << this << "]";
 
     OctreeServer::clientConnected();
 }
@@ -52,7 +52,12 @@ OctreeSendThread::~OctreeSendThread() {
     }
 
     qDebug() << qPrintable(safeServerName)  << "server [" << _myServer << "]: client disconnected "
-                                            "- ending sending thread [" << this << "]";
+                                            "- ending sender [" << this << "]";
+
+    // make sure a worker isn't still running us
+    if (_myServer && _myServer->getSendScheduler()) {
+        _myServer->getSendScheduler()->remove(this);
+    }
 
     OctreeServer::clientDisconnected();
     OctreeServer::stopTrackingThread(this);
@@ -72,8 +77,6 @@ bool OctreeSendThread::process() {
 
     OctreeServer::didProcess(this);
 
-    quint64  start = usecTimestampNow();
-
     // we'd better have a server at this point, or we're in trouble
     assert(_myServer);
 
@@ -91,26 +94,8 @@ bool OctreeSendThread::process() {
         }
     }
 
-    if (_isShuttingDown) {
-        return false; // exit early if we're shutting down
-    }
-
-    // Only sleep if we're still running and we got the lock last time we tried, otherwise try to get the lock asap
-    if (isStillRunning()) {
-        // dynamically sleep until we need to fire off the next set of octree elements
-        int elapsed = (usecTimestampNow() - start);
-        int usecToSleep =  OCTREE_SEND_INTERVAL_USECS - elapsed;
-
-        if (usecToSleep > 0) {
-            PerformanceWarning warn(false,"OctreeSendThread... usleep()",false,&_usleepTime,&_usleepCalls);
-            usleep(usecToSleep);
-        } else {
-            const int MIN_USEC_TO_SLEEP = 1;
-            usleep(MIN_USEC_TO_SLEEP);
-        }
-    }
-
-    return isStillRunning();  // keep running till they terminate us
+    // the OctreeSendScheduler calls us again at the start of our next interval
+    return !_isShuttingDown;
 }
 
 AtomicUIntStat OctreeSendThread::_usleepTime { 0 };
@@ -463,6 +448,7 @@ int OctreeSendThread::packetDistributor(OctreeQueryNode* nodeData, bool viewFrus
                                                  nodeData->getLastTimeBagEmpty(),
                                                  isFullScene, &nodeData->stats, _myServer->getJurisdiction(),
                                                  &nodeData->extraEncodeData);
+                    params.encodeCache = _myServer->getEncodeCache();
 
                     // TODO: should this include the lock time or not? This stat is sent down to the client,
                     // it seems like it may be a good idea to include the lock time as part of the encode time
@@ -16,7 +16,8 @@
 
 #include <atomic>
 
-#include <GenericThread.h>
+#include <QObject>
+
 #include <OctreeElementBag.h>
 
 #include "OctreeQueryNode.h"
@@ -25,8 +26,9 @@ class OctreeServer;
 
 using AtomicUIntStat = std::atomic<uintmax_t>;
 
-/// Threaded processor for sending octree packets to a single client
-class OctreeSendThread : public GenericThread {
+/// Sends octree packets to a single client. Runs one interval's worth of sending per call to process(), on the
+/// OctreeServer's OctreeSendScheduler rather than on a thread of its own.
+class OctreeSendThread : public QObject {
     Q_OBJECT
 public:
     OctreeSendThread(OctreeServer* myServer, const SharedNodePointer& node);
@@ -34,6 +36,9 @@ public:
 
     void setIsShuttingDown();
 
+    /// sends to the client for one interval, returns false once the client is shutting down
+    bool process();
+
     static AtomicUIntStat _totalBytes;
     static AtomicUIntStat _totalWastedBytes;
     static AtomicUIntStat _totalPackets;
@@ -41,12 +46,12 @@ public:
     static AtomicUIntStat _totalSpecialBytes;
     static AtomicUIntStat _totalSpecialPackets;
 
+    // time the OctreeSendScheduler workers spent idle
     static AtomicUIntStat _usleepTime;
     static AtomicUIntStat _usleepCalls;
 
-protected:
-    /// Implements generic processing behavior for this thread.
-    virtual bool process();
+signals:
+    void finished();
 
 private:
     OctreeServer* _myServer;
@@ -59,7 +64,7 @@ private:
     OctreePacketData _packetData;
 
     int _nodeMissingCount;
-    bool _isShuttingDown;
+    std::atomic<bool> _isShuttingDown;
 };
 
 #endif // hifi_OctreeSendThread_h
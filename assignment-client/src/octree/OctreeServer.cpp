@@ -228,6 +228,8 @@ OctreeServer::OctreeServer(NLPacket& packet) :
     _jurisdictionSender(NULL),
     _octreeInboundPacketProcessor(NULL),
     _persistThread(NULL),
+    _sendScheduler(NULL),
+    _encodeCache(DEFAULT_ENCODE_CACHE_MEGABYTES * BYTES_PER_KILOBYTE * KILO_PER_MEGA),
     _started(time(0)),
     _startedUSecs(usecTimestampNow())
 {
@@ -273,6 +275,10 @@ OctreeServer::~OctreeServer() {
         _persistThread->deleteLater();
     }
 
+    // any senders still around are no longer run, and no longer need to wait on a worker when deleted
+    delete _sendScheduler;
+    _sendScheduler = NULL;
+
     delete _jurisdiction;
     _jurisdiction = NULL;
 
@@ -421,6 +427,19 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
         statsString += QString("          Total Clients Connected: %1 clients\r\n")
             .arg(locale.toString((uint)getCurrentClientCount()).rightJustified(COLUMN_WIDTH, ' '));
 
+        if (_sendScheduler) {
+            statsString += QString("                     Send Workers: %1 threads\r\n")
+                .arg(locale.toString((uint)_sendScheduler->getNumWorkers()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                      Send Slices: %1 slices\r\n")
+                .arg(locale.toString((qulonglong)_sendScheduler->getSlices()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                      Late Slices: %1 slices\r\n")
+                .arg(locale.toString((qulonglong)_sendScheduler->getLateSlices()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                    Stolen Slices: %1 slices\r\n")
+                .arg(locale.toString((qulonglong)_sendScheduler->getSteals()).rightJustified(COLUMN_WIDTH, ' '));
+            statsString += QString("                     Workers Idle: %1 usecs\r\n")
+                .arg(locale.toString((qulonglong)OctreeSendThread::_usleepTime).rightJustified(COLUMN_WIDTH, ' '));
+        }
+
         quint64 oneSecondAgo = usecTimestampNow() - USECS_PER_SECOND;
 
         statsString += QString("            process() last second: %1 clients\r\n")
@@ -566,6 +585,24 @@ bool OctreeServer::handleHTTPRequest(HTTPConnection* connection, const QUrl& url
                                          (double)_averageExtraLongCompressTime.getAverage(),
                                          (double)(extraLongVsTotalCompress * AS_PERCENT), _extraLongCompress);
 
+        OctreeEncodeCache* encodeCache = getEncodeCache();
+        if (encodeCache) {
+            quint64 cacheHits = encodeCache->getHits();
+            quint64 cacheLookups = cacheHits + encodeCache->getMisses();
+            float hitRate = (cacheLookups > 0) ? ((float)cacheHits / (float)cacheLookups) : 0.0f;
+            statsString += QString().sprintf("                   Encode cache size:    %9d bytes of %d, %d items\r\n",
+                                             encodeCache->getBytes(), encodeCache->getMaxBytes(),
+                                             encodeCache->getEntryCount());
+            statsString += QString().sprintf("                   Encode cache hits:"
+                                             "                          (%6.2f%%) lookups: %12llu \r\n",
+                                             (double)(hitRate * AS_PERCENT), (unsigned long long)cacheLookups);
+            statsString += QString().sprintf("                 Encode cache misses:    %12llu evictions: %12llu\r\n\r\n",
+                                             (unsigned long long)encodeCache->getMisses(),
+                                             (unsigned long long)encodeCache->getEvictions());
+        } else {
+            statsString += "                        Encode cache:    disabled\r\n\r\n";
+        }
+
         float averagePacketSendingTime = getAveragePacketSendingTime();
         statsString += QString().sprintf("         Average packet sending time:    %9.2f usecs (includes node lock)\r\n",
                                          (double)averagePacketSendingTime);
@@ -862,7 +899,7 @@ void OctreeServer::handleOctreeQueryPacket(QSharedPointer<NLPacket> packet, Shar
         nodeList->updateNodeWithDataFromPacket(packet, senderNode);
         
         OctreeQueryNode* nodeData = dynamic_cast<OctreeQueryNode*>(senderNode->getLinkedData());
-        if (nodeData && !nodeData->isOctreeSendThreadInitalized()) {
+        if (nodeData && !nodeData->isOctreeSendThreadInitalized() && _sendScheduler) {
             nodeData->initializeOctreeSendThread(this, senderNode);
         }
     }
@@ -1016,6 +1053,15 @@ bool OctreeServer::readConfiguration() {
         qDebug("persistFilename=%s", _persistFilename);
 
         _persistAsFileType = "json.gz";
+        QString persistFileType;
+        if (readOptionString(QString("persistFileType"), settingsSectionObject, persistFileType)) {
+            if (persistFileType == "json.gz" || persistFileType == "bin") {
+                _persistAsFileType = persistFileType;
+            } else {
+                qDebug() << "Unknown persistFileType" << persistFileType << "- using" << _persistAsFileType;
+            }
+        }
+        qDebug() << "persistFileType=" << _persistAsFileType;
 
         _persistInterval = OctreePersistThread::DEFAULT_PERSIST_INTERVAL;
         readOptionInt(QString("persistInterval"), settingsSectionObject, _persistInterval);
@@ -1041,6 +1087,11 @@ bool OctreeServer::readConfiguration() {
         qDebug("clockSkew=%d", clockSkew);
     }
 
+    int encodeCacheMegabytes = DEFAULT_ENCODE_CACHE_MEGABYTES;
+    readOptionInt(QString("encodeCacheSize"), settingsSectionObject, encodeCacheMegabytes);
+    _encodeCache.setMaxBytes(std::max(0, encodeCacheMegabytes) * BYTES_PER_KILOBYTE * KILO_PER_MEGA);
+    qDebug() << "encodeCacheSize=" << encodeCacheMegabytes << "MB";
+
     // Check to see if the user passed in a command line option for setting packet send rate
     int packetsPerSecondPerClientMax = -1;
     if (readOptionInt(QString("packetsPerSecondPerClientMax"), settingsSectionObject, packetsPerSecondPerClientMax)) {
@@ -1098,6 +1149,10 @@ void OctreeServer::run() {
         return; // bailing on run, because readConfiguration failed
     }
 
+    // every client's sender is run on this fixed set of workers
+    _sendScheduler = new OctreeSendScheduler();
+    qDebug() << "Sending to clients on" << _sendScheduler->getNumWorkers() << "workers";
+
     beforeRun(); // after payload has been processed
 
     connect(nodeList.data(), SIGNAL(nodeAdded(SharedNodePointer)), SLOT(nodeAdded(SharedNodePointer)));
@@ -20,8 +20,10 @@
 
 #include <ThreadedAssignment.h>
 #include <EnvironmentData.h>
+#include <OctreeEncodeCache.h>
 
 #include "OctreePersistThread.h"
+#include "OctreeSendScheduler.h"
 #include "OctreeSendThread.h"
 #include "OctreeServerConsts.h"
 #include "OctreeInboundPacketProcessor.h"
@@ -45,6 +47,12 @@ public:
     OctreePointer getOctree() { return _tree; }
     JurisdictionMap* getJurisdiction() { return _jurisdiction; }
 
+    /// runs the senders of all clients, NULL until the server is running
+    OctreeSendScheduler* getSendScheduler() { return _sendScheduler; }
+
+    /// items encoded by any of the send threads, or NULL when the cache is disabled
+    OctreeEncodeCache* getEncodeCache() { return (_encodeCache.getMaxBytes() > 0) ? &_encodeCache : NULL; }
+
     int getPacketsPerClientPerInterval() const { return std::min(_packetsPerClientPerInterval,
                                 std::max(1, getPacketsTotalPerInterval() / std::max(1, getCurrentClientCount()))); }
 
@@ -170,6 +178,8 @@ protected:
     JurisdictionSender* _jurisdictionSender;
     OctreeInboundPacketProcessor* _octreeInboundPacketProcessor;
     OctreePersistThread* _persistThread;
+    OctreeSendScheduler* _sendScheduler;
+    OctreeEncodeCache _encodeCache;
 
     int _persistInterval;
     bool _wantBackup;
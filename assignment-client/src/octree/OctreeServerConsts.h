@@ -27,4 +27,7 @@ const int MAX_FILENAME_LENGTH = 1024;
 const int INTERVALS_PER_SECOND = 90;
 const int OCTREE_SEND_INTERVAL_USECS = (1000 * 1000)/INTERVALS_PER_SECOND;
 
+/// Megabytes of encoded items shared between the send threads, 0 turns the cache off
+const int DEFAULT_ENCODE_CACHE_MEGABYTES = 32;
+
 #endif // hifi_OctreeServerConsts_h
@@ -0,0 +1,43 @@
+//
+//  DomainListHistory.cpp
+//  domain-server/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "DomainListHistory.h"
+
+// enough to cover a burst of joins and leaves between two check-ins of a large domain
+const size_t MAX_DOMAIN_LIST_HISTORY_ENTRIES = 4096;
+
+void DomainListHistory::addChange(const QUuid& nodeUUID, NodeType_t nodeType, bool isRemoval) {
+    Entry entry;
+    entry.version = ++_version;
+    entry.nodeUUID = nodeUUID;
+    entry.change.nodeType = nodeType;
+    entry.change.isRemoval = isRemoval;
+    _entries.push_back(entry);
+
+    if (_entries.size() > MAX_DOMAIN_LIST_HISTORY_ENTRIES) {
+        _oldestVersion = _entries.front().version;
+        _entries.pop_front();
+    }
+}
+
+bool DomainListHistory::getChangesSince(quint32 version, QHash<QUuid, Change>& changes) const {
+    if (version < _oldestVersion || version > _version) {
+        return false;
+    }
+
+    // entries are in version order, so the first one we want is this many from the end
+    size_t numChanges = _version - version;
+    for (auto it = _entries.end() - numChanges; it != _entries.end(); ++it) {
+        // a later change to the same node replaces an earlier one
+        changes[it->nodeUUID] = it->change;
+    }
+
+    return true;
+}
@@ -0,0 +1,59 @@
+//
+//  DomainListHistory.h
+//  domain-server/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_DomainListHistory_h
+#define hifi_DomainListHistory_h
+
+#include <deque>
+
+#include <QtCore/QHash>
+#include <QtCore/QUuid>
+
+#include <NodeType.h>
+
+/// Numbers every change to the set of nodes in the domain, so that a node which tells us the last version of the
+/// domain list it has seen can be sent only what changed since then.
+class DomainListHistory {
+public:
+    struct Change {
+        NodeType_t nodeType;
+        bool isRemoval;
+    };
+
+    quint32 getVersion() const { return _version; }
+
+    // a node joined, or its sockets changed
+    void nodeUpdated(const QUuid& nodeUUID, NodeType_t nodeType) { addChange(nodeUUID, nodeType, false); }
+    void nodeRemoved(const QUuid& nodeUUID, NodeType_t nodeType) { addChange(nodeUUID, nodeType, true); }
+
+    /// fills changes with the latest change to each node after the given version, returns false if we no longer
+    /// remember that far back (or never had that version) and a full list is needed instead
+    bool getChangesSince(quint32 version, QHash<QUuid, Change>& changes) const;
+
+private:
+    struct Entry {
+        quint32 version;
+        QUuid nodeUUID;
+        Change change;
+    };
+
+    void addChange(const QUuid& nodeUUID, NodeType_t nodeType, bool isRemoval);
+
+    // 0 is what a node that has never had a list from us reports, so we never hand it out
+    quint32 _version { 1 };
+
+    // the oldest version we can still describe the changes since
+    quint32 _oldestVersion { 1 };
+    std::deque<Entry> _entries;
+};
+
+#endif // hifi_DomainListHistory_h
@@ -485,6 +485,7 @@ void DomainServer::populateStaticScriptedAssignmentsFromSettings() {
             const QString PERSISTENT_SCRIPT_URL_KEY = "url";
             const QString PERSISTENT_SCRIPT_NUM_INSTANCES_KEY = "num_instances";
             const QString PERSISTENT_SCRIPT_POOL_KEY = "pool";
+            const QString PERSISTENT_SCRIPT_INSTANCES_PER_AGENT_KEY = "instances_per_agent";
 
             if (persistentScript.contains(PERSISTENT_SCRIPT_URL_KEY)) {
                 // check how many instances of this script to add
@@ -494,14 +495,24 @@ void DomainServer::populateStaticScriptedAssignmentsFromSettings() {
 
                 QString scriptPool = persistentScript.value(PERSISTENT_SCRIPT_POOL_KEY).toString();
 
-                qDebug() << "Adding" << numInstances << "of persistent script at URL" << scriptURL << "- pool" << scriptPool;
+                // several instances can be hosted by one agent, which runs them on a shared set of threads
+                int instancesPerAgent = qMax(persistentScript.value(PERSISTENT_SCRIPT_INSTANCES_PER_AGENT_KEY).toInt(), 1);
 
-                for (int i = 0; i < numInstances; ++i) {
-                    // add a scripted assignment to the queue for this instance
+                qDebug() << "Adding" << numInstances << "of persistent script at URL" << scriptURL << "- pool" << scriptPool
+                    << "-" << instancesPerAgent << "per agent";
+
+                for (int i = 0; i < numInstances; i += instancesPerAgent) {
+                    // add a scripted assignment to the queue for these instances
                     Assignment* scriptAssignment = new Assignment(Assignment::CreateCommand,
                                                                   Assignment::AgentType,
                                                                   scriptPool);
-                    scriptAssignment->setPayload(scriptURL.toUtf8());
+
+                    int agentInstances = qMin(instancesPerAgent, numInstances - i);
+                    if (agentInstances > 1) {
+                        scriptAssignment->setPayload(QString("%1 %2").arg(scriptURL).arg(agentInstances).toUtf8());
+                    } else {
+                        scriptAssignment->setPayload(scriptURL.toUtf8());
+                    }
 
                     // add it to static hash so we know we have to keep giving it back out
                     addStaticAssignmentToAssignmentHash(scriptAssignment);
@@ -581,15 +592,31 @@ void DomainServer::processListRequestPacket(QSharedPointer<NLPacket> packet, Sha
     QDataStream packetStream(packet.data());
     NodeConnectionData nodeRequestData = NodeConnectionData::fromDataStream(packetStream, packet->getSenderSockAddr(), false);
 
-    // update this node's sockets in case they have changed
-    sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
-    sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+    // the last version of the domain list this node has, if it is new enough to tell us
+    quint32 knownListVersion = 0;
+    if (!packetStream.atEnd()) {
+        packetStream >> knownListVersion;
+    }
+
+    // update this node's sockets in case they have changed, and let the other nodes hear about it if they have
+    if (sendingNode->getPublicSocket() != nodeRequestData.publicSockAddr
+        || sendingNode->getLocalSocket() != nodeRequestData.localSockAddr) {
+        sendingNode->setPublicSocket(nodeRequestData.publicSockAddr);
+        sendingNode->setLocalSocket(nodeRequestData.localSockAddr);
+
+        _domainListHistory.nodeUpdated(sendingNode->getUUID(), sendingNode->getType());
+    }
     
     // update the NodeInterestSet in case there have been any changes
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(sendingNode->getLinkedData());
-    nodeData->setNodeInterestSet(nodeRequestData.interestList.toSet());
+    NodeSet nodeInterestSet = nodeRequestData.interestList.toSet();
+    if (nodeInterestSet != nodeData->getNodeInterestSet()) {
+        // the changes since its version don't cover the node types it has just become interested in
+        nodeData->setNodeInterestSet(nodeInterestSet);
+        knownListVersion = 0;
+    }
 
-    sendDomainListToNode(sendingNode, packet->getSenderSockAddr());
+    sendDomainListToNode(sendingNode, packet->getSenderSockAddr(), knownListVersion);
 }
 
 unsigned int DomainServer::countConnectedUsers() {
@@ -641,6 +668,8 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     
     DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(newNode->getLinkedData());
     
+    _domainListHistory.nodeUpdated(newNode->getUUID(), newNode->getType());
+
     // reply back to the user with a PacketType::DomainList
     sendDomainListToNode(newNode, nodeData->getSendingSockAddr());
     
@@ -648,8 +677,27 @@ void DomainServer::handleConnectedNode(SharedNodePointer newNode) {
     broadcastNewNode(newNode);
 }
 
-void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr) {
-    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2;
+// even when every change list arrives, send a full list this often to repair anything lost on the way
+const int MAX_CHANGE_LISTS_BETWEEN_FULL_LISTS = 10;
+
+void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr &senderSockAddr,
+                                        quint32 knownListVersion) {
+    const int NUM_DOMAIN_LIST_EXTENDED_HEADER_BYTES = NUM_BYTES_RFC4122_UUID + NUM_BYTES_RFC4122_UUID + 2
+        + 2 * sizeof(quint32);
+
+    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
+
+    // if we know which version of the list this node has, only send it what has changed since
+    QHash<QUuid, DomainListHistory::Change> changes;
+    bool sendChanges = knownListVersion != 0
+        && nodeData->getNumChangeListsSinceFullList() < MAX_CHANGE_LISTS_BETWEEN_FULL_LISTS
+        && _domainListHistory.getChangesSince(knownListVersion, changes);
+
+    if (sendChanges) {
+        nodeData->setNumChangeListsSinceFullList(nodeData->getNumChangeListsSinceFullList() + 1);
+    } else {
+        nodeData->setNumChangeListsSinceFullList(0);
+    }
     
     // setup the extended header for the domain list packets
     // this data is at the beginning of each of the domain list packets
@@ -663,37 +711,62 @@ void DomainServer::sendDomainListToNode(const SharedNodePointer& node, const Hif
     extendedHeaderStream << (quint8) node->getCanAdjustLocks();
     extendedHeaderStream << (quint8) node->getCanRez();
 
+    // the version this list brings the node to, and the version it applies on top of (0 for a full list)
+    extendedHeaderStream << _domainListHistory.getVersion();
+    extendedHeaderStream << (sendChanges ? knownListVersion : (quint32) 0);
+
     auto domainListPackets = NLPacketList::create(PacketType::DomainList, extendedHeader);
 
     // always send the node their own UUID back
     QDataStream domainListStream(domainListPackets.get());
 
-    DomainServerNodeData* nodeData = reinterpret_cast<DomainServerNodeData*>(node->getLinkedData());
-
     // store the nodeInterestSet on this DomainServerNodeData, in case it has changed
     auto& nodeInterestSet = nodeData->getNodeInterestSet();
 
+    auto addNodeEntry = [&](const SharedNodePointer& otherNode) {
+        // since we're about to add a node to the packet we start a segment
+        domainListPackets->startSegment();
+
+        // don't send avatar nodes to other avatars, that will come from avatar mixer
+        domainListStream << DomainListEntry::AddedNode;
+        domainListStream << *otherNode.data();
+
+        // pack the secret that these two nodes will use to communicate with each other
+        domainListStream << connectionSecretForNodes(node, otherNode);
+
+        // we've added the node we wanted so end the segment now
+        domainListPackets->endSegment();
+    };
+
     if (nodeInterestSet.size() > 0) {
 
         // DTLSServerSession* dtlsSession = _isUsingDTLS ? _dtlsSessions[senderSockAddr] : NULL;
         if (nodeData->isAuthenticated()) {
-            // if this authenticated node has any interest types, send back those nodes as well
-            limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
-                if (otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())) {
-                    
-                    // since we're about to add a node to the packet we start a segment
-                    domainListPackets->startSegment();
-
-                    // don't send avatar nodes to other avatars, that will come from avatar mixer
-                    domainListStream << *otherNode.data();
+            if (sendChanges) {
+                for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+                    if (it.key() == node->getUUID() || !nodeInterestSet.contains(it->nodeType)) {
+                        continue;
+                    }
 
-                    // pack the secret that these two nodes will use to communicate with each other
-                    domainListStream << connectionSecretForNodes(node, otherNode);
+                    SharedNodePointer otherNode = it->isRemoval ? SharedNodePointer()
+                        : limitedNodeList->nodeWithUUID(it.key());
 
-                    // we've added the node we wanted so end the segment now
-                    domainListPackets->endSegment();
+                    if (otherNode) {
+                        addNodeEntry(otherNode);
+                    } else {
+                        domainListPackets->startSegment();
+                        domainListStream << DomainListEntry::RemovedNode << it.key();
+                        domainListPackets->endSegment();
+                    }
                 }
-            });
+            } else {
+                // if this authenticated node has any interest types, send back those nodes as well
+                limitedNodeList->eachNode([&](const SharedNodePointer& otherNode){
+                    if (otherNode->getUUID() != node->getUUID() && nodeInterestSet.contains(otherNode->getType())) {
+                        addNodeEntry(otherNode);
+                    }
+                });
+            }
         }
     }
     
@@ -1645,6 +1718,8 @@ void DomainServer::nodeAdded(SharedNodePointer node) {
 
 void DomainServer::nodeKilled(SharedNodePointer node) {
 
+    _domainListHistory.nodeRemoved(node->getUUID(), node->getType());
+
     // if this peer connected via ICE then remove them from our ICE peers hash
     _gatekeeper.removeICEPeer(node->getUUID());
 
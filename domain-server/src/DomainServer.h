@@ -26,6 +26,7 @@
 #include <LimitedNodeList.h>
 
 #include "DomainGatekeeper.h"
+#include "DomainListHistory.h"
 #include "DomainServerSettingsManager.h"
 #include "DomainServerWebSessionData.h"
 #include "WalletTransaction.h"
@@ -89,7 +90,9 @@ private:
 
     unsigned int countConnectedUsers();
 
-    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
+    /// sends the node what changed since the knownListVersion it reported, or the full list if that isn't possible
+    void sendDomainListToNode(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr,
+                              quint32 knownListVersion = 0);
 
     QUuid connectionSecretForNodes(const SharedNodePointer& nodeA, const SharedNodePointer& nodeB);
     void broadcastNewNode(const SharedNodePointer& node);
@@ -122,6 +125,8 @@ private:
     
     DomainGatekeeper _gatekeeper;
 
+    DomainListHistory _domainListHistory;
+
     HTTPManager _httpManager;
     HTTPSManager* _httpsManager;
 
@@ -51,6 +51,10 @@ public:
     const NodeSet& getNodeInterestSet() const { return _nodeInterestSet; }
     void setNodeInterestSet(const NodeSet& nodeInterestSet) { _nodeInterestSet = nodeInterestSet; }
     
+    // how many domain lists in a row this node has been sent that only held changes
+    int getNumChangeListsSinceFullList() const { return _numChangeListsSinceFullList; }
+    void setNumChangeListsSinceFullList(int numChangeLists) { _numChangeListsSinceFullList = numChangeLists; }
+
     void setNodeVersion(const QString& nodeVersion) { _nodeVersion = nodeVersion; }
     const QString& getNodeVersion() { return _nodeVersion; }
     
@@ -74,6 +78,7 @@ private:
     HifiSockAddr _sendingSockAddr;
     bool _isAuthenticated = true;
     NodeSet _nodeInterestSet;
+    int _numChangeListsSinceFullList { 0 };
     QString _nodeVersion;
 };
 
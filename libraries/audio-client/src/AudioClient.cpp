@@ -73,6 +73,9 @@ extern "C" {
 
 static const int RECEIVED_AUDIO_STREAM_CAPACITY_FRAMES = 100;
 
+// while the input is silent one frame in this many is sent to the audio-mixer
+static const int DTX_KEEPALIVE_INTERVAL_FRAMES = 10;
+
 Setting::Handle<bool> dynamicJitterBuffers("dynamicJitterBuffers", DEFAULT_DYNAMIC_JITTER_BUFFERS);
 Setting::Handle<int> maxFramesOverDesired("maxFramesOverDesired", DEFAULT_MAX_FRAMES_OVER_DESIRED);
 Setting::Handle<int> staticDesiredJitterBufferFrames("staticDesiredJitterBufferFrames",
@@ -127,6 +130,8 @@ AudioClient::AudioClient() :
     _noiseSourceEnabled(false),
     _toneSourceEnabled(true),
     _outgoingAvatarAudioSequenceNumber(0),
+    _consecutiveSilentFrames(0),
+    _selectedCodec(AudioCodec::getPCM()),
     _audioOutputIODevice(_receivedAudioStream, this),
     _stats(&_receivedAudioStream),
     _inputGate()
@@ -149,13 +154,17 @@ AudioClient::AudioClient() :
     _gverb = createGverbFilter();
     configureGverbFilter(_gverb);
 
-    auto& packetReceiver = DependencyManager::get<NodeList>()->getPacketReceiver();
+    auto nodeList = DependencyManager::get<NodeList>();
+    connect(nodeList.data(), &LimitedNodeList::nodeActivated, this, &AudioClient::nodeActivated);
+
+    auto& packetReceiver = nodeList->getPacketReceiver();
     packetReceiver.registerListener(PacketType::AudioStreamStats, &_stats, "processStreamStatsPacket");
     packetReceiver.registerListener(PacketType::AudioEnvironment, this, "handleAudioEnvironmentDataPacket");
     packetReceiver.registerListener(PacketType::SilentAudioFrame, this, "handleAudioDataPacket");
     packetReceiver.registerListener(PacketType::MixedAudio, this, "handleAudioDataPacket");
     packetReceiver.registerListener(PacketType::NoisyMute, this, "handleNoisyMutePacket");
     packetReceiver.registerListener(PacketType::MuteEnvironment, this, "handleMuteEnvironmentPacket");
+    packetReceiver.registerListener(PacketType::SelectedAudioFormat, this, "handleSelectedAudioFormat");
 }
 
 AudioClient::~AudioClient() {
@@ -180,10 +189,35 @@ void AudioClient::reset() {
 void AudioClient::audioMixerKilled() {
     _hasReceivedFirstPacket = false;
     _outgoingAvatarAudioSequenceNumber = 0;
+    _consecutiveSilentFrames = 0;
+    _selectedCodec = AudioCodec::getPCM();
     _stats.reset();
     emit disconnected();
 }
 
+void AudioClient::nodeActivated(SharedNodePointer node) {
+    if (node->getType() == NodeType::AudioMixer) {
+        // offer the audio-mixer our codecs, we send PCM until it tells us which one it selected
+        auto negotiatePacket = NLPacket::create(PacketType::NegotiateAudioFormat, -1, true);
+
+        QDataStream packetStream(negotiatePacket.get());
+        packetStream << AudioCodec::getSupportedNames();
+
+        DependencyManager::get<NodeList>()->sendPacket(std::move(negotiatePacket), *node);
+    }
+}
+
+void AudioClient::handleSelectedAudioFormat(QSharedPointer<NLPacket> packet) {
+    QString selectedName;
+    QDataStream packetStream(packet.data());
+    packetStream >> selectedName;
+
+    const AudioCodec* selectedCodec = AudioCodec::forName(selectedName);
+    _selectedCodec = selectedCodec ? selectedCodec : AudioCodec::getPCM();
+
+    qCDebug(audioclient) << "Audio mixer selected the" << _selectedCodec->getName() << "codec";
+}
+
 
 QAudioDeviceInfo getNamedAudioDeviceForMode(QAudio::Mode mode, const QString& deviceName) {
     QAudioDeviceInfo result;
@@ -845,12 +879,25 @@ void AudioClient::handleAudioInput() {
 
         if (_lastInputLoudness == 0) {
             packetType = PacketType::SilentAudioFrame;
+
+            // while we're quiet only every so many silent frames goes out (DTX), that keeps our position current
+            // at the audio-mixer without sending it a packet every frame
+            bool shouldSendKeepalive = (_consecutiveSilentFrames % DTX_KEEPALIVE_INTERVAL_FRAMES) == 0;
+            ++_consecutiveSilentFrames;
+
+            if (!shouldSendKeepalive) {
+                continue;
+            }
+        } else {
+            _consecutiveSilentFrames = 0;
         }
+
         Transform audioTransform;
         audioTransform.setTranslation(_positionGetter());
         audioTransform.setRotation(_orientationGetter());
         // FIXME find a way to properly handle both playback audio and user audio concurrently
-        emitAudioPacket(networkAudioSamples, numNetworkBytes, _outgoingAvatarAudioSequenceNumber, audioTransform, packetType);
+        emitAudioPacket(networkAudioSamples, numNetworkBytes, _outgoingAvatarAudioSequenceNumber, audioTransform, packetType,
+                        _selectedCodec);
         _stats.sentPacket();
     }
 }
@@ -860,7 +907,8 @@ void AudioClient::handleRecordedAudioInput(const QByteArray& audio) {
     audioTransform.setTranslation(_positionGetter());
     audioTransform.setRotation(_orientationGetter());
     // FIXME check a flag to see if we should echo audio?
-    emitAudioPacket(audio.data(), audio.size(), _outgoingAvatarAudioSequenceNumber, audioTransform, PacketType::MicrophoneAudioWithEcho);
+    emitAudioPacket(audio.data(), audio.size(), _outgoingAvatarAudioSequenceNumber, audioTransform,
+                    PacketType::MicrophoneAudioWithEcho, _selectedCodec);
 }
 
 void AudioClient::processReceivedSamples(const QByteArray& inputBuffer, QByteArray& outputBuffer) {
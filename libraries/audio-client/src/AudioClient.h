@@ -26,6 +26,7 @@
 
 #include <AbstractAudioInterface.h>
 #include <AudioBuffer.h>
+#include <AudioCodec.h>
 #include <AudioEffectOptions.h>
 #include <AudioFormat.h>
 #include <AudioGain.h>
@@ -145,6 +146,7 @@ public slots:
     void handleAudioDataPacket(QSharedPointer<NLPacket> packet);
     void handleNoisyMutePacket(QSharedPointer<NLPacket> packet);
     void handleMuteEnvironmentPacket(QSharedPointer<NLPacket> packet);
+    void handleSelectedAudioFormat(QSharedPointer<NLPacket> packet);
 
     void sendDownstreamAudioStatsPacket() { _stats.sendDownstreamAudioStatsPacket(); }
     void handleAudioInput();
@@ -204,6 +206,9 @@ signals:
 
     void muteEnvironmentRequested(glm::vec3 position, float radius);
 
+private slots:
+    void nodeActivated(SharedNodePointer node);
+
 protected:
     AudioClient();
     ~AudioClient();
@@ -304,6 +309,8 @@ private:
     AudioSourceTone _toneSource;
 
     quint16 _outgoingAvatarAudioSequenceNumber;
+    int _consecutiveSilentFrames;
+    const AudioCodec* _selectedCodec; // what the audio-mixer selected for our microphone stream, PCM until it replies
 
     AudioOutputIODevice _audioOutputIODevice;
 
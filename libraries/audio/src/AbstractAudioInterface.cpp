@@ -17,9 +17,11 @@
 #include <NLPacket.h>
 #include <Transform.h>
 
+#include "AudioCodec.h"
 #include "AudioConstants.h"
 
-void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform, PacketType packetType) {
+void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform,
+                                             PacketType packetType, const AudioCodec* codec) {
     static std::mutex _mutex;
     using Locker = std::unique_lock<std::mutex>;
     auto nodeList = DependencyManager::get<NodeList>();
@@ -50,10 +52,14 @@ void AbstractAudioInterface::emitAudioPacket(const void* audioData, size_t bytes
         audioPacket->writePrimitive(transform.getRotation());
 
         if (audioPacket->getType() != PacketType::SilentAudioFrame) {
-            // audio samples have already been packed (written to networkAudioSamples)
-            audioPacket->setPayloadSize(audioPacket->getPayloadSize() + bytes);
-            static const int leadingBytes = sizeof(quint16) + sizeof(glm::vec3) + sizeof(glm::quat) + sizeof(quint8);
-            memcpy(audioPacket->getPayload() + leadingBytes, audioData, bytes);
+            // pack the codec ID, then encode the samples straight into the packet
+            audioPacket->writePrimitive(codec->getID());
+
+            int numSamples = (int)(bytes / sizeof(int16_t));
+            int numChannels = isStereo ? 2 : 1;
+            int encodedBytes = codec->encode(reinterpret_cast<const int16_t*>(audioData), numSamples, numChannels,
+                                             audioPacket->getPayload() + audioPacket->pos());
+            audioPacket->setPayloadSize(audioPacket->getPayloadSize() + encodedBytes);
         }
         nodeList->flagTimeForConnectionStep(LimitedNodeList::ConnectionStep::SendAudioPacket);
         nodeList->sendUnreliablePacket(*audioPacket, *audioMixer);
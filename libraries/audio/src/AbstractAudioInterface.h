@@ -19,6 +19,7 @@
 
 #include "AudioInjectorOptions.h"
 
+class AudioCodec;
 class AudioInjector;
 class AudioInjectorLocalBuffer;
 class Transform;
@@ -28,7 +29,8 @@ class AbstractAudioInterface : public QObject {
 public:
     AbstractAudioInterface(QObject* parent = 0) : QObject(parent) {};
     
-    static void emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform, PacketType packetType);
+    static void emitAudioPacket(const void* audioData, size_t bytes, quint16& sequenceNumber, const Transform& transform,
+                                PacketType packetType, const AudioCodec* codec);
 
 public slots:
     virtual bool outputLocalInjector(bool isStereo, AudioInjector* injector) = 0;
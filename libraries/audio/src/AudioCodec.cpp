@@ -0,0 +1,286 @@
+//
+//  AudioCodec.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioCodec.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "AudioConstants.h"
+
+namespace {
+
+int clampSample(int sample) {
+    return std::min(std::max(sample, AudioConstants::MIN_SAMPLE_VALUE), AudioConstants::MAX_SAMPLE_VALUE);
+}
+
+class PCMCodec : public AudioCodec {
+public:
+    virtual uint8_t getID() const { return 0; }
+    virtual QString getName() const { return "pcm"; }
+
+    virtual int getEncodedBytes(int numSamples, int numChannels) const {
+        return numSamples * sizeof(int16_t);
+    }
+
+    virtual int getDecodedSamples(int numEncodedBytes, int numChannels) const {
+        return numEncodedBytes / sizeof(int16_t);
+    }
+
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* encoded) const {
+        memcpy(encoded, samples, numSamples * sizeof(int16_t));
+        return numSamples * sizeof(int16_t);
+    }
+
+    virtual int decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const {
+        int numSamples = getDecodedSamples(numEncodedBytes, numChannels);
+        memcpy(samples, encoded, numSamples * sizeof(int16_t));
+        return numSamples;
+    }
+};
+
+// IMA ADPCM, 4 bits per sample.
+// Each channel of a frame starts with a header carrying the predictor and step index the encoder started from,
+// so the decoder never depends on a previous frame. The nibbles that follow are in the same (interleaved) order
+// as the samples, low nibble first.
+class ADPCMCodec : public AudioCodec {
+public:
+    virtual uint8_t getID() const { return 1; }
+    virtual QString getName() const { return "ima-adpcm"; }
+
+    virtual int getEncodedBytes(int numSamples, int numChannels) const {
+        return numChannels * CHANNEL_HEADER_BYTES + (numSamples + 1) / 2;
+    }
+
+    virtual int getDecodedSamples(int numEncodedBytes, int numChannels) const {
+        return std::max(numEncodedBytes - numChannels * CHANNEL_HEADER_BYTES, 0) * 2;
+    }
+
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* encoded) const;
+    virtual int decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const;
+
+private:
+    struct ChannelState {
+        int predictor;
+        int stepIndex;
+    };
+
+    // int16 predictor, uint8 step index, one reserved byte
+    static const int CHANNEL_HEADER_BYTES = 4;
+    static const int MAX_CHANNELS = 2;
+    static const int NUM_STEPS = 89;
+    static const int16_t STEP_TABLE[NUM_STEPS];
+    static const int8_t INDEX_TABLE[16];
+
+    static int initialStepIndex(const int16_t* samples, int numSamples, int numChannels, int channel);
+    static void writeHeader(const ChannelState& state, char* header);
+    static void readHeader(const char* header, ChannelState& state);
+    static uint8_t encodeSample(ChannelState& state, int sample);
+    static int16_t decodeNibble(ChannelState& state, uint8_t nibble);
+};
+
+const int16_t ADPCMCodec::STEP_TABLE[NUM_STEPS] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107,
+    118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894,
+    6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+const int8_t ADPCMCodec::INDEX_TABLE[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+int ADPCMCodec::initialStepIndex(const int16_t* samples, int numSamples, int numChannels, int channel) {
+    // start with a step that can follow the opening of the frame, instead of ramping up from the smallest step
+    const int NUM_OPENING_SAMPLES = 8;
+    int largestDifference = 0;
+    for (int i = channel + numChannels; i < numSamples && i < NUM_OPENING_SAMPLES * numChannels; i += numChannels) {
+        largestDifference = std::max(largestDifference, std::abs(samples[i] - samples[i - numChannels]));
+    }
+
+    int stepIndex = 0;
+    while (stepIndex < NUM_STEPS - 1 && STEP_TABLE[stepIndex] * 2 < largestDifference) {
+        ++stepIndex;
+    }
+    return stepIndex;
+}
+
+void ADPCMCodec::writeHeader(const ChannelState& state, char* header) {
+    int16_t predictor = (int16_t)state.predictor;
+    memcpy(header, &predictor, sizeof(predictor));
+    header[2] = (char)state.stepIndex;
+    header[3] = 0;
+}
+
+void ADPCMCodec::readHeader(const char* header, ChannelState& state) {
+    int16_t predictor;
+    memcpy(&predictor, header, sizeof(predictor));
+    state.predictor = predictor;
+    state.stepIndex = std::min((int)(uint8_t)header[2], NUM_STEPS - 1);
+}
+
+uint8_t ADPCMCodec::encodeSample(ChannelState& state, int sample) {
+    int step = STEP_TABLE[state.stepIndex];
+    int difference = sample - state.predictor;
+
+    uint8_t nibble = 0;
+    if (difference < 0) {
+        nibble = 8;
+        difference = -difference;
+    }
+
+    // quantize the difference the same way decodeNibble will reconstruct it, so both sides track the same predictor
+    int delta = step >> 3;
+    if (difference >= step) {
+        nibble |= 4;
+        difference -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (difference >= step) {
+        nibble |= 2;
+        difference -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (difference >= step) {
+        nibble |= 1;
+        delta += step;
+    }
+
+    state.predictor += (nibble & 8) ? -delta : delta;
+    state.predictor = clampSample(state.predictor);
+    state.stepIndex = std::min(std::max(state.stepIndex + INDEX_TABLE[nibble], 0), NUM_STEPS - 1);
+
+    return nibble;
+}
+
+int16_t ADPCMCodec::decodeNibble(ChannelState& state, uint8_t nibble) {
+    int step = STEP_TABLE[state.stepIndex];
+
+    int delta = step >> 3;
+    if (nibble & 4) {
+        delta += step;
+    }
+    if (nibble & 2) {
+        delta += step >> 1;
+    }
+    if (nibble & 1) {
+        delta += step >> 2;
+    }
+
+    state.predictor += (nibble & 8) ? -delta : delta;
+    state.predictor = clampSample(state.predictor);
+    state.stepIndex = std::min(std::max(state.stepIndex + INDEX_TABLE[nibble], 0), NUM_STEPS - 1);
+
+    return (int16_t)state.predictor;
+}
+
+int ADPCMCodec::encode(const int16_t* samples, int numSamples, int numChannels, char* encoded) const {
+    ChannelState states[MAX_CHANNELS];
+    for (int channel = 0; channel < numChannels; channel++) {
+        states[channel].predictor = (numSamples > channel) ? samples[channel] : 0;
+        states[channel].stepIndex = initialStepIndex(samples, numSamples, numChannels, channel);
+        writeHeader(states[channel], encoded + channel * CHANNEL_HEADER_BYTES);
+    }
+
+    uint8_t* nibbles = reinterpret_cast<uint8_t*>(encoded + numChannels * CHANNEL_HEADER_BYTES);
+    int channel = 0;
+    for (int i = 0; i < numSamples; i++) {
+        uint8_t nibble = encodeSample(states[channel], samples[i]);
+        if (i & 1) {
+            nibbles[i >> 1] |= nibble << 4;
+        } else {
+            nibbles[i >> 1] = nibble;
+        }
+
+        if (++channel == numChannels) {
+            channel = 0;
+        }
+    }
+
+    return getEncodedBytes(numSamples, numChannels);
+}
+
+int ADPCMCodec::decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const {
+    int numSamples = getDecodedSamples(numEncodedBytes, numChannels);
+    if (numSamples == 0) {
+        return 0;
+    }
+
+    ChannelState states[MAX_CHANNELS];
+    for (int channel = 0; channel < numChannels; channel++) {
+        readHeader(encoded + channel * CHANNEL_HEADER_BYTES, states[channel]);
+    }
+
+    const uint8_t* nibbles = reinterpret_cast<const uint8_t*>(encoded + numChannels * CHANNEL_HEADER_BYTES);
+    int channel = 0;
+    for (int i = 0; i < numSamples; i++) {
+        uint8_t nibble = (i & 1) ? (nibbles[i >> 1] >> 4) : (nibbles[i >> 1] & 0x0F);
+        samples[i] = decodeNibble(states[channel], nibble);
+
+        if (++channel == numChannels) {
+            channel = 0;
+        }
+    }
+
+    return numSamples;
+}
+
+const PCMCodec PCM_CODEC {};
+const ADPCMCodec ADPCM_CODEC {};
+
+// most preferred first
+const AudioCodec* const SUPPORTED_CODECS[] = { &ADPCM_CODEC, &PCM_CODEC };
+
+}
+
+const AudioCodec* AudioCodec::getPCM() {
+    return &PCM_CODEC;
+}
+
+const AudioCodec* AudioCodec::forID(uint8_t id) {
+    for (const AudioCodec* codec : SUPPORTED_CODECS) {
+        if (codec->getID() == id) {
+            return codec;
+        }
+    }
+    return NULL;
+}
+
+const AudioCodec* AudioCodec::forName(const QString& name) {
+    for (const AudioCodec* codec : SUPPORTED_CODECS) {
+        if (codec->getName() == name) {
+            return codec;
+        }
+    }
+    return NULL;
+}
+
+QStringList AudioCodec::getSupportedNames() {
+    QStringList names;
+    for (const AudioCodec* codec : SUPPORTED_CODECS) {
+        names << codec->getName();
+    }
+    return names;
+}
+
+const AudioCodec* AudioCodec::selectFrom(const QStringList& offeredNames) {
+    for (const QString& name : offeredNames) {
+        const AudioCodec* codec = forName(name);
+        if (codec) {
+            return codec;
+        }
+    }
+    return getPCM();
+}
@@ -0,0 +1,61 @@
+//
+//  AudioCodec.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodec_h
+#define hifi_AudioCodec_h
+
+#include <stdint.h>
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+//
+// Encodes network frames of audio for the microphone and mix streams between agents and the audio-mixer.
+// An agent offers the codecs it supports by name when it connects to the audio-mixer, which selects one.
+// Every encoded frame is preceded on the wire by its codec ID, so a frame can always be decoded on its own,
+// whatever was selected or lost before it.
+//
+// Codecs are stateless and shared, so one codec can encode or decode any number of streams from any thread.
+// Samples are interleaved when numChannels is 2.
+//
+class AudioCodec {
+public:
+    virtual ~AudioCodec() {}
+
+    // stable ID written in front of each encoded frame
+    virtual uint8_t getID() const = 0;
+
+    // stable name used when negotiating
+    virtual QString getName() const = 0;
+
+    virtual int getEncodedBytes(int numSamples, int numChannels) const = 0;
+    virtual int getDecodedSamples(int numEncodedBytes, int numChannels) const = 0;
+
+    // returns the number of bytes written to encoded, which has room for getEncodedBytes
+    virtual int encode(const int16_t* samples, int numSamples, int numChannels, char* encoded) const = 0;
+
+    // returns the number of samples written to samples, which has room for getDecodedSamples
+    virtual int decode(const char* encoded, int numEncodedBytes, int numChannels, int16_t* samples) const = 0;
+
+    // raw 16-bit PCM, supported by everyone and used until something else is selected
+    static const AudioCodec* getPCM();
+
+    // returns NULL for a codec this build doesn't know
+    static const AudioCodec* forID(uint8_t id);
+    static const AudioCodec* forName(const QString& name);
+
+    // names of the codecs this build supports, most preferred first
+    static QStringList getSupportedNames();
+
+    // the first of the offered names this build supports, or PCM if there is none
+    static const AudioCodec* selectFrom(const QStringList& offeredNames);
+};
+
+#endif // hifi_AudioCodec_h
@@ -149,6 +149,34 @@ public:
         }
     }
 
+    // interleaved float version, samples are filtered in whatever units they are passed in
+    void render(const float32_t* in, float32_t* out, const uint32_t frameCount) {
+        if (frameCount > _frameCount) {
+            return;
+        }
+
+        // de-interleave
+        for (uint32_t i = 0; i < frameCount; ++i) {
+            for (uint32_t j = 0; j < _channelCount; ++j) {
+                _buffer[j][i] = *in++;
+            }
+        }
+
+        // now step through each filter
+        for (uint32_t i = 0; i < _channelCount; ++i) {
+            for (uint32_t j = 0; j < _filterCount; ++j) {
+                _filters[j][i].render( &_buffer[i][0], &_buffer[i][0], frameCount );
+            }
+        }
+
+        // interleave
+        for (uint32_t i = 0; i < frameCount; ++i) {
+            for (uint32_t j = 0; j < _channelCount; ++j) {
+                *out++ = _buffer[j][i];
+            }
+        }
+    }
+
     void render(AudioBufferFloat32& frameBuffer) {
         
         float32_t** samples = frameBuffer.getFrameData();
@@ -0,0 +1,237 @@
+//
+//  AudioMixKernels.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <algorithm>
+#include <math.h>
+
+#include "AudioMixKernels.h"
+#include "AudioSIMD.h"
+
+//
+// scalar versions, also used for the leftover samples of the SIMD versions
+//
+static inline void mixMonoToStereoScalar(float* mix, const int16_t* left, const int16_t* right,
+                                         float gainL, float gainR, int start, int numFrames) {
+    for (int i = start; i < numFrames; i++) {
+        mix[2*i + 0] += left[i] * gainL;
+        mix[2*i + 1] += right[i] * gainR;
+    }
+}
+
+static inline void mixStereoScalar(float* mix, const int16_t* input, float gain, int start, int numSamples) {
+    for (int i = start; i < numSamples; i++) {
+        mix[i] += input[i] * gain;
+    }
+}
+
+static inline void accumulateMixScalar(float* mix, const float* input, int start, int numSamples) {
+    for (int i = start; i < numSamples; i++) {
+        mix[i] += input[i];
+    }
+}
+
+static inline void convertMixToInt16Scalar(const float* mix, int16_t* output, int start, int numSamples) {
+    for (int i = start; i < numSamples; i++) {
+        float sample = std::min(std::max(mix[i], -32768.0f), 32767.0f);
+        output[i] = (int16_t)lrintf(sample);
+    }
+}
+
+//
+// on x86 architecture, assume that SSE2 is present and use AVX2 when the CPU has it
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#include <emmintrin.h>
+
+static void mixMonoToStereo_SSE2(float* mix, const int16_t* left, const int16_t* right,
+                                 float gainL, float gainR, int numFrames) {
+    __m128 gl = _mm_set1_ps(gainL);
+    __m128 gr = _mm_set1_ps(gainR);
+
+    int i = 0;
+    for (; i < numFrames - 3; i += 4) {
+        __m128i l0 = _mm_loadl_epi64((const __m128i*)&left[i]);
+        __m128i r0 = _mm_loadl_epi64((const __m128i*)&right[i]);
+
+        // sign-extend
+        l0 = _mm_srai_epi32(_mm_unpacklo_epi16(l0, l0), 16);
+        r0 = _mm_srai_epi32(_mm_unpacklo_epi16(r0, r0), 16);
+
+        __m128 fl = _mm_mul_ps(_mm_cvtepi32_ps(l0), gl);
+        __m128 fr = _mm_mul_ps(_mm_cvtepi32_ps(r0), gr);
+
+        // interleave
+        __m128 s0 = _mm_unpacklo_ps(fl, fr);
+        __m128 s1 = _mm_unpackhi_ps(fl, fr);
+
+        _mm_storeu_ps(&mix[2*i + 0], _mm_add_ps(_mm_loadu_ps(&mix[2*i + 0]), s0));
+        _mm_storeu_ps(&mix[2*i + 4], _mm_add_ps(_mm_loadu_ps(&mix[2*i + 4]), s1));
+    }
+    mixMonoToStereoScalar(mix, left, right, gainL, gainR, i, numFrames);
+}
+
+static void mixStereo_SSE2(float* mix, const int16_t* input, float gain, int numSamples) {
+    __m128 g = _mm_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m128i a0 = _mm_loadu_si128((const __m128i*)&input[i]);
+
+        // sign-extend
+        __m128i a1 = _mm_srai_epi32(_mm_unpackhi_epi16(a0, a0), 16);
+        a0 = _mm_srai_epi32(_mm_unpacklo_epi16(a0, a0), 16);
+
+        __m128 f0 = _mm_mul_ps(_mm_cvtepi32_ps(a0), g);
+        __m128 f1 = _mm_mul_ps(_mm_cvtepi32_ps(a1), g);
+
+        _mm_storeu_ps(&mix[i + 0], _mm_add_ps(_mm_loadu_ps(&mix[i + 0]), f0));
+        _mm_storeu_ps(&mix[i + 4], _mm_add_ps(_mm_loadu_ps(&mix[i + 4]), f1));
+    }
+    mixStereoScalar(mix, input, gain, i, numSamples);
+}
+
+static void accumulateMix_SSE2(float* mix, const float* input, int numSamples) {
+    int i = 0;
+    for (; i < numSamples - 3; i += 4) {
+        _mm_storeu_ps(&mix[i], _mm_add_ps(_mm_loadu_ps(&mix[i]), _mm_loadu_ps(&input[i])));
+    }
+    accumulateMixScalar(mix, input, i, numSamples);
+}
+
+static void convertMixToInt16_SSE2(const float* mix, int16_t* output, int numSamples) {
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        // round and saturate
+        __m128i a0 = _mm_cvtps_epi32(_mm_loadu_ps(&mix[i + 0]));
+        __m128i a1 = _mm_cvtps_epi32(_mm_loadu_ps(&mix[i + 4]));
+        a0 = _mm_packs_epi32(a0, a1);
+
+        _mm_storeu_si128((__m128i*)&output[i], a0);
+    }
+    convertMixToInt16Scalar(mix, output, i, numSamples);
+}
+
+//
+// AVX2 versions, compiled for AVX2 regardless of the compiler flags and only called when the CPU supports it
+//
+#include <immintrin.h>
+
+AVX2_TARGET static void mixMonoToStereo_AVX2(float* mix, const int16_t* left, const int16_t* right,
+                                             float gainL, float gainR, int numFrames) {
+    __m256 gl = _mm256_set1_ps(gainL);
+    __m256 gr = _mm256_set1_ps(gainR);
+
+    int i = 0;
+    for (; i < numFrames - 7; i += 8) {
+        // sign-extend and convert
+        __m256 fl = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&left[i])));
+        __m256 fr = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&right[i])));
+        fl = _mm256_mul_ps(fl, gl);
+        fr = _mm256_mul_ps(fr, gr);
+
+        // interleave, unpack works per 128-bit lane so the halves need to be swapped back into order
+        __m256 lo = _mm256_unpacklo_ps(fl, fr);
+        __m256 hi = _mm256_unpackhi_ps(fl, fr);
+        __m256 s0 = _mm256_permute2f128_ps(lo, hi, 0x20);
+        __m256 s1 = _mm256_permute2f128_ps(lo, hi, 0x31);
+
+        _mm256_storeu_ps(&mix[2*i + 0], _mm256_add_ps(_mm256_loadu_ps(&mix[2*i + 0]), s0));
+        _mm256_storeu_ps(&mix[2*i + 8], _mm256_add_ps(_mm256_loadu_ps(&mix[2*i + 8]), s1));
+    }
+    mixMonoToStereoScalar(mix, left, right, gainL, gainR, i, numFrames);
+}
+
+AVX2_TARGET static void mixStereo_AVX2(float* mix, const int16_t* input, float gain, int numSamples) {
+    __m256 g = _mm256_set1_ps(gain);
+
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        __m256 f0 = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&input[i])));
+        _mm256_storeu_ps(&mix[i], _mm256_add_ps(_mm256_loadu_ps(&mix[i]), _mm256_mul_ps(f0, g)));
+    }
+    mixStereoScalar(mix, input, gain, i, numSamples);
+}
+
+AVX2_TARGET static void accumulateMix_AVX2(float* mix, const float* input, int numSamples) {
+    int i = 0;
+    for (; i < numSamples - 7; i += 8) {
+        _mm256_storeu_ps(&mix[i], _mm256_add_ps(_mm256_loadu_ps(&mix[i]), _mm256_loadu_ps(&input[i])));
+    }
+    accumulateMixScalar(mix, input, i, numSamples);
+}
+
+AVX2_TARGET static void convertMixToInt16_AVX2(const float* mix, int16_t* output, int numSamples) {
+    int i = 0;
+    for (; i < numSamples - 15; i += 16) {
+        // round
+        __m256i a0 = _mm256_cvtps_epi32(_mm256_loadu_ps(&mix[i + 0]));
+        __m256i a1 = _mm256_cvtps_epi32(_mm256_loadu_ps(&mix[i + 8]));
+
+        // saturate, pack works per 128-bit lane so put the 64-bit quarters back in order
+        a0 = _mm256_packs_epi32(a0, a1);
+        a0 = _mm256_permute4x64_epi64(a0, _MM_SHUFFLE(3,1,2,0));
+
+        _mm256_storeu_si256((__m256i*)&output[i], a0);
+    }
+    convertMixToInt16Scalar(mix, output, i, numSamples);
+}
+
+void mixMonoToStereo(float* mix, const int16_t* left, const int16_t* right, float gainL, float gainR, int numFrames) {
+    if (cpuSupportsAVX2()) {
+        mixMonoToStereo_AVX2(mix, left, right, gainL, gainR, numFrames);
+    } else {
+        mixMonoToStereo_SSE2(mix, left, right, gainL, gainR, numFrames);
+    }
+}
+
+void mixStereo(float* mix, const int16_t* input, float gain, int numSamples) {
+    if (cpuSupportsAVX2()) {
+        mixStereo_AVX2(mix, input, gain, numSamples);
+    } else {
+        mixStereo_SSE2(mix, input, gain, numSamples);
+    }
+}
+
+void accumulateMix(float* mix, const float* input, int numSamples) {
+    if (cpuSupportsAVX2()) {
+        accumulateMix_AVX2(mix, input, numSamples);
+    } else {
+        accumulateMix_SSE2(mix, input, numSamples);
+    }
+}
+
+void convertMixToInt16(const float* mix, int16_t* output, int numSamples) {
+    if (cpuSupportsAVX2()) {
+        convertMixToInt16_AVX2(mix, output, numSamples);
+    } else {
+        convertMixToInt16_SSE2(mix, output, numSamples);
+    }
+}
+
+#else
+
+void mixMonoToStereo(float* mix, const int16_t* left, const int16_t* right, float gainL, float gainR, int numFrames) {
+    mixMonoToStereoScalar(mix, left, right, gainL, gainR, 0, numFrames);
+}
+
+void mixStereo(float* mix, const int16_t* input, float gain, int numSamples) {
+    mixStereoScalar(mix, input, gain, 0, numSamples);
+}
+
+void accumulateMix(float* mix, const float* input, int numSamples) {
+    accumulateMixScalar(mix, input, 0, numSamples);
+}
+
+void convertMixToInt16(const float* mix, int16_t* output, int numSamples) {
+    convertMixToInt16Scalar(mix, output, 0, numSamples);
+}
+
+#endif
@@ -0,0 +1,34 @@
+//
+//  AudioMixKernels.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioMixKernels_h
+#define hifi_AudioMixKernels_h
+
+#include <stdint.h>
+
+//
+// Inner loops used by the audio-mixer to build a listener's mix.
+// Sources are accumulated into a float mix (in int16 sample units) that is rounded and clamped once per listener.
+// Buffers are interleaved stereo and do not need to be aligned.
+//
+
+// accumulates a mono source into a stereo mix, left and right may point at different (delayed) starts in the source
+void mixMonoToStereo(float* mix, const int16_t* left, const int16_t* right, float gainL, float gainR, int numFrames);
+
+// accumulates an interleaved stereo source into a stereo mix
+void mixStereo(float* mix, const int16_t* input, float gain, int numSamples);
+
+// accumulates one float buffer into another
+void accumulateMix(float* mix, const float* input, int numSamples);
+
+// rounds and saturates a float mix to int16
+void convertMixToInt16(const float* mix, int16_t* output, int numSamples);
+
+#endif // hifi_AudioMixKernels_h
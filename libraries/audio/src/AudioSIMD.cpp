@@ -0,0 +1,48 @@
+//
+//  AudioSIMD.cpp
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSIMD.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+static bool checkCPUSupportsAVX2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // the CPU has AVX and the OS saves the YMM registers
+    const int OSXSAVE_AND_AVX = (1 << 27) | (1 << 28);
+    __cpuid(info, 1);
+    if ((info[2] & OSXSAVE_AND_AVX) != OSXSAVE_AND_AVX || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+bool cpuSupportsAVX2() {
+    static const bool supported = checkCPUSupportsAVX2();
+    return supported;
+}
+
+#endif
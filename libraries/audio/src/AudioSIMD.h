@@ -0,0 +1,35 @@
+//
+//  AudioSIMD.h
+//  libraries/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSIMD_h
+#define hifi_AudioSIMD_h
+
+//
+// The audio kernels assume SSE2 on x86 and pick AVX2 versions at runtime, so a build doesn't need -mavx2.
+// Functions marked AVX2_TARGET are compiled for AVX2 and must only be called when cpuSupportsAVX2() is true.
+//
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+
+#if defined(_MSC_VER)
+#define AVX2_TARGET
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+// checks the CPU (and that the OS saves the YMM registers) once, the first time it is called
+bool cpuSupportsAVX2();
+
+#else
+
+inline bool cpuSupportsAVX2() { return false; }
+
+#endif
+
+#endif // hifi_AudioSIMD_h
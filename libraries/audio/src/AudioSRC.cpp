@@ -13,6 +13,7 @@
 #include <string.h>
 #include <algorithm>
 
+#include "AudioSIMD.h"
 #include "AudioSRC.h"
 
 //
@@ -735,13 +736,13 @@ int AudioSRC::createIrrationalFilter(int upFactor, int downFactor, float gain) {
 }
 
 //
-// on x86 architecture, assume that SSE2 is present
+// on x86 architecture, assume that SSE2 is present and use AVX2 when the CPU has it
 //
 #if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
 
 #include <emmintrin.h>
 
-int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
+int AudioSRC::multirateFilter1_SSE2(const float* input0, float* output0, int inputFrames) {
     int outputFrames = 0;
 
     assert((_numTaps & 0x3) == 0);  // SIMD4
@@ -821,7 +822,7 @@ int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFra
     return outputFrames;
 }
 
-int AudioSRC::multirateFilter2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
+int AudioSRC::multirateFilter2_SSE2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
     int outputFrames = 0;
 
     assert((_numTaps & 0x3) == 0);  // SIMD4
@@ -912,7 +913,7 @@ int AudioSRC::multirateFilter2(const float* input0, const float* input1, float*
 }
 
 // convert int16_t to float, deinterleave stereo
-void AudioSRC::convertInputFromInt16(const int16_t* input, float** outputs, int numFrames) {
+void AudioSRC::convertInputFromInt16_SSE2(const int16_t* input, float** outputs, int numFrames) {
     __m128 scale = _mm_set1_ps(1/32768.0f);
 
     if (_numChannels == 1) {
@@ -991,7 +992,7 @@ static inline __m128 dither4() {
 }
 
 // convert float to int16_t, interleave stereo
-void AudioSRC::convertOutputToInt16(float** inputs, int16_t* output, int numFrames) {
+void AudioSRC::convertOutputToInt16_SSE2(float** inputs, int16_t* output, int numFrames) {
     __m128 scale = _mm_set1_ps(32768.0f);
 
     if (_numChannels == 1) {
@@ -1062,6 +1063,313 @@ void AudioSRC::convertOutputToInt16(float** inputs, int16_t* output, int numFram
     }
 }
 
+//
+// AVX2 versions, compiled for AVX2 regardless of the compiler flags and only called when the CPU supports it
+//
+#include <immintrin.h>
+
+// horizontal sum, into the low element
+AVX2_TARGET static inline __m128 horizontalSum(__m256 acc8, __m128 acc4) {
+    acc4 = _mm_add_ps(acc4, _mm_add_ps(_mm256_castps256_ps128(acc8), _mm256_extractf128_ps(acc8, 1)));
+    acc4 = _mm_add_ps(acc4, _mm_movehl_ps(acc4, acc4));
+    return _mm_add_ss(acc4, _mm_shuffle_ps(acc4, acc4, _MM_SHUFFLE(0,0,0,1)));
+}
+
+// the taps are a multiple of 4, so the filters run 8 at a time with a 4-wide tail
+AVX2_TARGET int AudioSRC::multirateFilter1_AVX2(const float* input0, float* output0, int inputFrames) {
+    int outputFrames = 0;
+
+    assert((_numTaps & 0x3) == 0);  // SIMD4
+    int numTaps8 = _numTaps & ~0x7;
+
+    if (_step == 0) {   // rational
+
+        int32_t i = hi32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m128 tail0 = _mm_setzero_ps();
+
+            int j = 0;
+            for (; j < numTaps8; j += 8) {
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+                acc0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input0[i + j]), coef0), acc0);
+            }
+            if (j < _numTaps) {
+                __m128 coef0 = _mm_loadu_ps(&c0[j]);
+                tail0 = _mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0);
+            }
+
+            _mm_store_ss(&output0[outputFrames], horizontalSum(acc0, tail0));
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (hi32(_offset) < inputFrames) {
+
+            int32_t i = hi32(_offset);
+            uint32_t f = lo32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            __m256 frac = _mm256_set1_ps((f & SRC_FRACMASK) * QFRAC_TO_FLOAT);
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m128 tail0 = _mm_setzero_ps();
+
+            int j = 0;
+            for (; j < numTaps8; j += 8) {
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+                __m256 coef1 = _mm256_loadu_ps(&c1[j]);
+                coef1 = _mm256_sub_ps(coef1, coef0);
+                coef0 = _mm256_add_ps(_mm256_mul_ps(coef1, frac), coef0);
+
+                acc0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input0[i + j]), coef0), acc0);
+            }
+            if (j < _numTaps) {
+                __m128 coef0 = _mm_loadu_ps(&c0[j]);
+                __m128 coef1 = _mm_loadu_ps(&c1[j]);
+                coef1 = _mm_sub_ps(coef1, coef0);
+                coef0 = _mm_add_ps(_mm_mul_ps(coef1, _mm256_castps256_ps128(frac)), coef0);
+
+                tail0 = _mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0);
+            }
+
+            _mm_store_ss(&output0[outputFrames], horizontalSum(acc0, tail0));
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+
+    return outputFrames;
+}
+
+AVX2_TARGET int AudioSRC::multirateFilter2_AVX2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
+    int outputFrames = 0;
+
+    assert((_numTaps & 0x3) == 0);  // SIMD4
+    int numTaps8 = _numTaps & ~0x7;
+
+    if (_step == 0) {   // rational
+
+        int32_t i = hi32(_offset);
+
+        while (i < inputFrames) {
+
+            const float* c0 = &_polyphaseFilter[_numTaps * _phase];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m128 tail0 = _mm_setzero_ps();
+            __m128 tail1 = _mm_setzero_ps();
+
+            int j = 0;
+            for (; j < numTaps8; j += 8) {
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+                acc0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input0[i + j]), coef0), acc0);
+                acc1 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input1[i + j]), coef0), acc1);
+            }
+            if (j < _numTaps) {
+                __m128 coef0 = _mm_loadu_ps(&c0[j]);
+                tail0 = _mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0);
+                tail1 = _mm_mul_ps(_mm_loadu_ps(&input1[i + j]), coef0);
+            }
+
+            _mm_store_ss(&output0[outputFrames], horizontalSum(acc0, tail0));
+            _mm_store_ss(&output1[outputFrames], horizontalSum(acc1, tail1));
+            outputFrames += 1;
+
+            i += _stepTable[_phase];
+            if (++_phase == _upFactor) {
+                _phase = 0;
+            }
+        }
+        _offset = (int64_t)(i - inputFrames) << 32;
+
+    } else {    // irrational
+
+        while (hi32(_offset) < inputFrames) {
+
+            int32_t i = hi32(_offset);
+            uint32_t f = lo32(_offset);
+
+            uint32_t phase = f >> SRC_FRACBITS;
+            __m256 frac = _mm256_set1_ps((f & SRC_FRACMASK) * QFRAC_TO_FLOAT);
+
+            const float* c0 = &_polyphaseFilter[_numTaps * (phase + 0)];
+            const float* c1 = &_polyphaseFilter[_numTaps * (phase + 1)];
+
+            __m256 acc0 = _mm256_setzero_ps();
+            __m256 acc1 = _mm256_setzero_ps();
+            __m128 tail0 = _mm_setzero_ps();
+            __m128 tail1 = _mm_setzero_ps();
+
+            int j = 0;
+            for (; j < numTaps8; j += 8) {
+                __m256 coef0 = _mm256_loadu_ps(&c0[j]);
+                __m256 coef1 = _mm256_loadu_ps(&c1[j]);
+                coef1 = _mm256_sub_ps(coef1, coef0);
+                coef0 = _mm256_add_ps(_mm256_mul_ps(coef1, frac), coef0);
+
+                acc0 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input0[i + j]), coef0), acc0);
+                acc1 = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(&input1[i + j]), coef0), acc1);
+            }
+            if (j < _numTaps) {
+                __m128 coef0 = _mm_loadu_ps(&c0[j]);
+                __m128 coef1 = _mm_loadu_ps(&c1[j]);
+                coef1 = _mm_sub_ps(coef1, coef0);
+                coef0 = _mm_add_ps(_mm_mul_ps(coef1, _mm256_castps256_ps128(frac)), coef0);
+
+                tail0 = _mm_mul_ps(_mm_loadu_ps(&input0[i + j]), coef0);
+                tail1 = _mm_mul_ps(_mm_loadu_ps(&input1[i + j]), coef0);
+            }
+
+            _mm_store_ss(&output0[outputFrames], horizontalSum(acc0, tail0));
+            _mm_store_ss(&output1[outputFrames], horizontalSum(acc1, tail1));
+            outputFrames += 1;
+
+            _offset += _step;
+        }
+        _offset -= (int64_t)inputFrames << 32;
+    }
+
+    return outputFrames;
+}
+
+// convert int16_t to float, deinterleave stereo, 8 frames at a time
+AVX2_TARGET void AudioSRC::convertInputFromInt16_AVX2(const int16_t* input, float** outputs, int numFrames) {
+    __m256 scale = _mm256_set1_ps(1/32768.0f);
+
+    int i = 0;
+    if (_numChannels == 1) {
+
+        for (; i < numFrames - 7; i += 8) {
+            // sign-extend
+            __m256i a0 = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i*)&input[i]));
+
+            __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), scale);
+
+            _mm256_storeu_ps(&outputs[0][i], f0);
+        }
+
+    } else if (_numChannels == 2) {
+
+        for (; i < numFrames - 7; i += 8) {
+            __m256i a0 = _mm256_loadu_si256((__m256i*)&input[2*i]);
+            __m256i a1 = a0;
+
+            // deinterleave and sign-extend
+            a0 = _mm256_madd_epi16(a0, _mm256_set1_epi32(0x00000001));
+            a1 = _mm256_madd_epi16(a1, _mm256_set1_epi32(0x00010000));
+
+            __m256 f0 = _mm256_mul_ps(_mm256_cvtepi32_ps(a0), scale);
+            __m256 f1 = _mm256_mul_ps(_mm256_cvtepi32_ps(a1), scale);
+
+            _mm256_storeu_ps(&outputs[0][i], f0);
+            _mm256_storeu_ps(&outputs[1][i], f1);
+        }
+    }
+
+    // leftover frames
+    float* leftovers[MAX_CHANNELS] = { outputs[0] + i, outputs[1] + i };
+    convertInputFromInt16_SSE2(input + _numChannels * i, leftovers, numFrames - i);
+}
+
+// convert float to int16_t, interleave stereo, 8 frames at a time
+AVX2_TARGET void AudioSRC::convertOutputToInt16_AVX2(float** inputs, int16_t* output, int numFrames) {
+    __m256 scale = _mm256_set1_ps(32768.0f);
+
+    int i = 0;
+    if (_numChannels == 1) {
+
+        for (; i < numFrames - 7; i += 8) {
+            __m256 f0 = _mm256_mul_ps(_mm256_loadu_ps(&inputs[0][i]), scale);
+
+            f0 = _mm256_add_ps(f0, _mm256_insertf128_ps(_mm256_castps128_ps256(dither4()), dither4(), 1));
+
+            // round and saturate, the pack works within each 128-bit lane
+            __m256i a0 = _mm256_cvtps_epi32(f0);
+            a0 = _mm256_packs_epi32(a0, a0);
+            a0 = _mm256_permute4x64_epi64(a0, _MM_SHUFFLE(3,1,2,0));
+
+            _mm_storeu_si128((__m128i*)&output[i], _mm256_castsi256_si128(a0));
+        }
+
+    } else if (_numChannels == 2) {
+
+        // within each 128-bit lane, interleave the four left samples with the four right samples
+        const __m256i INTERLEAVE = _mm256_setr_epi8(
+            0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+            0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+
+        for (; i < numFrames - 7; i += 8) {
+            __m256 f0 = _mm256_mul_ps(_mm256_loadu_ps(&inputs[0][i]), scale);
+            __m256 f1 = _mm256_mul_ps(_mm256_loadu_ps(&inputs[1][i]), scale);
+
+            __m256 d0 = _mm256_insertf128_ps(_mm256_castps128_ps256(dither4()), dither4(), 1);
+            f0 = _mm256_add_ps(f0, d0);
+            f1 = _mm256_add_ps(f1, d0);
+
+            // round and saturate
+            __m256i a0 = _mm256_cvtps_epi32(f0);
+            __m256i a1 = _mm256_cvtps_epi32(f1);
+            a0 = _mm256_packs_epi32(a0, a1);
+
+            // interleave
+            a0 = _mm256_shuffle_epi8(a0, INTERLEAVE);
+            _mm256_storeu_si256((__m256i*)&output[2*i], a0);
+        }
+    }
+
+    // leftover frames
+    float* leftovers[MAX_CHANNELS] = { inputs[0] + i, inputs[1] + i };
+    convertOutputToInt16_SSE2(leftovers, output + _numChannels * i, numFrames - i);
+}
+
+int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
+    if (cpuSupportsAVX2()) {
+        return multirateFilter1_AVX2(input0, output0, inputFrames);
+    }
+    return multirateFilter1_SSE2(input0, output0, inputFrames);
+}
+
+int AudioSRC::multirateFilter2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames) {
+    if (cpuSupportsAVX2()) {
+        return multirateFilter2_AVX2(input0, input1, output0, output1, inputFrames);
+    }
+    return multirateFilter2_SSE2(input0, input1, output0, output1, inputFrames);
+}
+
+void AudioSRC::convertInputFromInt16(const int16_t* input, float** outputs, int numFrames) {
+    if (cpuSupportsAVX2()) {
+        convertInputFromInt16_AVX2(input, outputs, numFrames);
+    } else {
+        convertInputFromInt16_SSE2(input, outputs, numFrames);
+    }
+}
+
+void AudioSRC::convertOutputToInt16(float** inputs, int16_t* output, int numFrames) {
+    if (cpuSupportsAVX2()) {
+        convertOutputToInt16_AVX2(inputs, output, numFrames);
+    } else {
+        convertOutputToInt16_SSE2(inputs, output, numFrames);
+    }
+}
+
 #else
 
 int AudioSRC::multirateFilter1(const float* input0, float* output0, int inputFrames) {
@@ -30,6 +30,8 @@ public:
     int getMaxInput(int outputFrames);
 
 private:
+    friend class AudioSRCTests;
+
     float* _polyphaseFilter;
     int* _stepTable;
 
@@ -60,6 +62,17 @@ private:
     void convertInputFromInt16(const int16_t* input, float** outputs, int numFrames);
     void convertOutputToInt16(float** inputs, int16_t* output, int numFrames);
 
+    // on x86, the kernels above select one of these at runtime
+    int multirateFilter1_SSE2(const float* input0, float* output0, int inputFrames);
+    int multirateFilter2_SSE2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames);
+    int multirateFilter1_AVX2(const float* input0, float* output0, int inputFrames);
+    int multirateFilter2_AVX2(const float* input0, const float* input1, float* output0, float* output1, int inputFrames);
+
+    void convertInputFromInt16_SSE2(const int16_t* input, float** outputs, int numFrames);
+    void convertOutputToInt16_SSE2(float** inputs, int16_t* output, int numFrames);
+    void convertInputFromInt16_AVX2(const int16_t* input, float** outputs, int numFrames);
+    void convertOutputToInt16_AVX2(float** inputs, int16_t* output, int numFrames);
+
     int processFloat(float** inputs, float** outputs, int inputFrames);
 };
 
@@ -29,6 +29,8 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _maxFramesOverDesired(settings._maxFramesOverDesired),
     _isStarved(true),
     _hasStarted(false),
+    _isInDTX(false),
+    _senderUsesDTX(false),
     _consecutiveNotMixedCount(0),
     _starveCount(0),
     _silentFramesDropped(0),
@@ -47,6 +49,10 @@ InboundAudioStream::InboundAudioStream(int numFrameSamples, int numFramesCapacit
     _currentJitterBufferFrames(0),
     _timeGapStatsForStatsPacket(0, STATS_FOR_STATS_PACKET_WINDOW_SECONDS),
     _repetitionWithFade(settings._repetitionWithFade),
+    _incomingCodec(AudioCodec::getPCM()),
+    _incomingCodecChannels(1),
+    _decodedAudioData(),
+    _decodeUsecs(0),
     _hasReverb(false)
 {
 }
@@ -57,6 +63,7 @@ void InboundAudioStream::reset() {
     _lastPopOutput = AudioRingBuffer::ConstIterator();
     _isStarved = true;
     _hasStarted = false;
+    _isInDTX = false;
     resetStats();
 }
 
@@ -106,7 +113,16 @@ int InboundAudioStream::parseData(NLPacket& packet) {
     SequenceNumberStats::ArrivalInfo arrivalInfo = _incomingSequenceNumberStats.sequenceNumberReceived(sequence,
                                                                                                        packet.getSourceID());
 
-    packetReceivedUpdateTimingStats();
+    // a sender that has gone quiet only sends the occasional silent frame as a keepalive (DTX)
+    bool wasInDTX = _isInDTX;
+    _isInDTX = _senderUsesDTX && (packet.getType() == PacketType::SilentAudioFrame);
+
+    if (wasInDTX) {
+        // the gap since the last packet is the sender being quiet, not network jitter
+        _lastPacketReceivedTime = usecTimestampNow();
+    } else {
+        packetReceivedUpdateTimingStats();
+    }
 
     int networkSamples;
     
@@ -171,14 +187,55 @@ int InboundAudioStream::parseStreamProperties(PacketType type, const QByteArray&
         numAudioSamples = numSilentSamples;
         return sizeof(quint16);
     } else {
-        // mixed audio packets do not have any info between the seq num and the audio data.
-        numAudioSamples = packetAfterSeqNum.size() / sizeof(int16_t);
-        return 0;
+        // mixed audio packets only have the codec ID between the seq num and the audio data, and are always stereo
+        const int MIXED_AUDIO_CHANNELS = 2;
+        return parseCodecID(packetAfterSeqNum, MIXED_AUDIO_CHANNELS, numAudioSamples);
     }
 }
 
 int InboundAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int numAudioSamples) {
-    return _ringBuffer.writeData(packetAfterStreamProperties.data(), numAudioSamples * sizeof(int16_t));
+    const QByteArray& decodedAudioData = decodeAudioData(packetAfterStreamProperties);
+    return _ringBuffer.writeData(decodedAudioData.data(), decodedAudioData.size());
+}
+
+int InboundAudioStream::parseCodecID(const QByteArray& codecIDAndAudioData, int numChannels, int& numAudioSamples) {
+    if (codecIDAndAudioData.isEmpty()) {
+        _incomingCodec = NULL;
+        numAudioSamples = 0;
+        return 0;
+    }
+
+    _incomingCodec = AudioCodec::forID((quint8)codecIDAndAudioData.at(0));
+    _incomingCodecChannels = numChannels;
+
+    int numEncodedBytes = codecIDAndAudioData.size() - sizeof(quint8);
+    numAudioSamples = _incomingCodec ? _incomingCodec->getDecodedSamples(numEncodedBytes, numChannels) : 0;
+
+    return sizeof(quint8);
+}
+
+const QByteArray& InboundAudioStream::decodeAudioData(const QByteArray& encodedAudioData) {
+    if (_incomingCodec == AudioCodec::getPCM()) {
+        // nothing to decode
+        return encodedAudioData;
+    }
+
+    if (!_incomingCodec) {
+        // we can't decode this, treat it like an empty packet
+        _decodedAudioData.clear();
+        return _decodedAudioData;
+    }
+
+    quint64 decodeStart = usecTimestampNow();
+
+    int numSamples = _incomingCodec->getDecodedSamples(encodedAudioData.size(), _incomingCodecChannels);
+    _decodedAudioData.resize(numSamples * sizeof(int16_t));
+    _incomingCodec->decode(encodedAudioData.data(), encodedAudioData.size(), _incomingCodecChannels,
+                           reinterpret_cast<int16_t*>(_decodedAudioData.data()));
+
+    _decodeUsecs += usecTimestampNow() - decodeStart;
+
+    return _decodedAudioData;
 }
 
 int InboundAudioStream::writeDroppableSilentSamples(int silentSamples) {
@@ -285,6 +342,14 @@ void InboundAudioStream::framesAvailableChanged() {
 }
 
 void InboundAudioStream::setToStarved() {
+    if (_isInDTX) {
+        // running dry between keepalives is expected, so it isn't counted as a starve.
+        // we still refill to the desired jitter buffer frames before the sender's audio is played again
+        _consecutiveNotMixedCount = 0;
+        _isStarved = (_ringBuffer.framesAvailable() < _desiredJitterBufferFrames);
+        return;
+    }
+
     _consecutiveNotMixedCount = 0;
     _starveCount++;
     // if we have more than the desired frames when setToStarved() is called, then we'll immediately
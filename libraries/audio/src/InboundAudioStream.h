@@ -17,6 +17,7 @@
 #include <udt/PacketHeaders.h>
 #include <StDev.h>
 
+#include "AudioCodec.h"
 #include "AudioRingBuffer.h"
 #include "MovingMinMaxAvg.h"
 #include "SequenceNumberStats.h"
@@ -156,6 +157,7 @@ public:
     double getFramesAvailableAverage() const { return _framesAvailableStat.getAverage(); }
 
     bool isStarved() const { return _isStarved; }
+    bool isInDTX() const { return _isInDTX; }
     bool hasStarted() const { return _hasStarted; }
 
     int getConsecutiveNotMixedCount() const { return _consecutiveNotMixedCount; }
@@ -170,6 +172,13 @@ public:
     float getWetLevel() const { return _wetLevel; }
     void setReverb(float reverbTime, float wetLevel);
     void clearReverb() { _hasReverb = false; }
+
+    /// the codec of the last audio packet parsed, PCM until one arrives
+    const AudioCodec* getIncomingCodec() const { return _incomingCodec; }
+
+    /// usecs spent decoding audio since the last reset
+    quint64 getDecodeUsecs() const { return _decodeUsecs; }
+    void resetDecodeUsecs() { _decodeUsecs = 0; }
     
 public slots:
     /// This function should be called every second for all the stats to function properly. If dynamic jitter buffers
@@ -200,6 +209,13 @@ protected:
     /// default implementation assumes packet contains raw audio samples after stream properties
     virtual int parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int networkSamples);
 
+    /// reads the codec ID in front of the encoded audio data and calculates how many samples it decodes to.
+    /// returns the number of bytes read
+    int parseCodecID(const QByteArray& codecIDAndAudioData, int numChannels, int& numAudioSamples);
+
+    /// decodes the audio data that followed the last codec ID parsed, returning raw samples
+    const QByteArray& decodeAudioData(const QByteArray& encodedAudioData);
+
     /// writes silent samples to the buffer that may be dropped to reduce latency caused by the buffer
     virtual int writeDroppableSilentSamples(int silentSamples);
 
@@ -229,6 +245,8 @@ protected:
 
     bool _isStarved;
     bool _hasStarted;
+    bool _isInDTX;  // true while the last packet from the sender was silent, it may be sending keepalives only
+    bool _senderUsesDTX; // only streams from senders that send silent keepalives while quiet (microphones) go into DTX
 
     // stats
 
@@ -259,6 +277,11 @@ protected:
     MovingMinMaxAvg<quint64> _timeGapStatsForStatsPacket;
 
     bool _repetitionWithFade;
+
+    const AudioCodec* _incomingCodec;   // NULL if the last codec ID parsed is unknown to this build
+    int _incomingCodecChannels;
+    QByteArray _decodedAudioData;
+    quint64 _decodeUsecs;
     
     // Reverb properties
     bool _hasReverb;
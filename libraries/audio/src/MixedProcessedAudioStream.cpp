@@ -44,10 +44,12 @@ int MixedProcessedAudioStream::writeLastFrameRepeatedWithFade(int samples) {
 
 int MixedProcessedAudioStream::parseAudioData(PacketType type, const QByteArray& packetAfterStreamProperties, int networkSamples) {
 
-    emit addedStereoSamples(packetAfterStreamProperties);
+    const QByteArray& decodedAudioData = decodeAudioData(packetAfterStreamProperties);
+
+    emit addedStereoSamples(decodedAudioData);
 
     QByteArray outputBuffer;
-    emit processSamples(packetAfterStreamProperties, outputBuffer);
+    emit processSamples(decodedAudioData, outputBuffer);
 
     _ringBuffer.writeData(outputBuffer.data(), outputBuffer.size());
     
@@ -43,6 +43,51 @@ using namespace std;
 const glm::vec3 DEFAULT_LOCAL_AABOX_CORNER(-0.5f);
 const glm::vec3 DEFAULT_LOCAL_AABOX_SCALE(1.0f);
 
+// joint translations are sent as signed fixed point, relative to the largest translation component in the packet
+const int JOINT_TRANSLATION_BITS_PER_COMPONENT = 12;
+const int JOINT_TRANSLATION_BITS = 3 * JOINT_TRANSLATION_BITS_PER_COMPONENT;
+
+// writes the low numBits of value to a zeroed buffer, starting bitOffset bits in
+static void writeJointBits(unsigned char* buffer, int bitOffset, uint64_t value, int numBits) {
+    for (int i = 0; i < numBits; i++, bitOffset++) {
+        if (value & ((uint64_t)1 << i)) {
+            buffer[bitOffset / BITS_IN_BYTE] |= (1 << (bitOffset % BITS_IN_BYTE));
+        }
+    }
+}
+
+static uint64_t readJointBits(const unsigned char* buffer, int bitOffset, int numBits) {
+    uint64_t value = 0;
+    for (int i = 0; i < numBits; i++, bitOffset++) {
+        if (buffer[bitOffset / BITS_IN_BYTE] & (1 << (bitOffset % BITS_IN_BYTE))) {
+            value |= ((uint64_t)1 << i);
+        }
+    }
+    return value;
+}
+
+static int bytesForJointBits(int numBits) {
+    return (numBits + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+}
+
+static bool shouldSendJointRotation(const JointData& data, const JointData& lastSent, bool cullSmallChanges) {
+    if (!data.rotationSet || lastSent.rotation == data.rotation) {
+        return false;
+    }
+    if (cullSmallChanges && fabsf(glm::dot(data.rotation, lastSent.rotation)) > AVATAR_MIN_ROTATION_DOT) {
+        return false;
+    }
+    // a change that doesn't survive quantization wouldn't be seen by the receiver
+    return packOrientationQuatToSmallestThree(data.rotation) != packOrientationQuatToSmallestThree(lastSent.rotation);
+}
+
+static bool shouldSendJointTranslation(const JointData& data, const JointData& lastSent, bool cullSmallChanges) {
+    if (!data.translationSet || lastSent.translation == data.translation) {
+        return false;
+    }
+    return !cullSmallChanges || glm::distance(data.translation, lastSent.translation) > AVATAR_MIN_TRANSLATION;
+}
+
 const QString AvatarData::FRAME_NAME = "com.highfidelity.recording.AvatarData";
 static std::once_flag frameTypeRegistration;
 
@@ -301,19 +346,13 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
 
     _lastSentJointData.resize(_jointData.size());
 
-    for (int i=0; i < _jointData.size(); i++) {
+    for (int i = 0; i < _jointData.size(); i++) {
         const JointData& data = _jointData.at(i);
-        if (sendAll || _lastSentJointData[i].rotation != data.rotation) {
-            if (sendAll ||
-                !cullSmallChanges ||
-                fabsf(glm::dot(data.rotation, _lastSentJointData[i].rotation)) <= AVATAR_MIN_ROTATION_DOT) {
-                if (data.rotationSet) {
-                    validity |= (1 << validityBit);
-                    #ifdef WANT_DEBUG
-                    rotationSentCount++;
-                    #endif
-                }
-            }
+        if (sendAll ? data.rotationSet : shouldSendJointRotation(data, _lastSentJointData[i], cullSmallChanges)) {
+            validity |= (1 << validityBit);
+            #ifdef WANT_DEBUG
+            rotationSentCount++;
+            #endif
         }
         if (++validityBit == BITS_IN_BYTE) {
             *destinationBuffer++ = validity;
@@ -324,18 +363,23 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
         *destinationBuffer++ = validity;
     }
 
+    // rotations are bit-packed back to back, using the smallest three components of each quat
+    int bitOffset = 0;
     validityBit = 0;
     validity = *validityPosition++;
     for (int i = 0; i < _jointData.size(); i ++) {
         const JointData& data = _jointData[ i ];
         if (validity & (1 << validityBit)) {
-            destinationBuffer += packOrientationQuatToBytes(destinationBuffer, data.rotation);
+            writeJointBits(destinationBuffer, bitOffset, packOrientationQuatToSmallestThree(data.rotation),
+                           SMALLEST_THREE_QUAT_BITS);
+            bitOffset += SMALLEST_THREE_QUAT_BITS;
         }
         if (++validityBit == BITS_IN_BYTE) {
             validityBit = 0;
             validity = *validityPosition++;
         }
     }
+    destinationBuffer += bytesForJointBits(bitOffset);
 
 
     // joint translation data
@@ -349,22 +393,16 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
     #endif
 
     float maxTranslationDimension = 0.0;
-    for (int i=0; i < _jointData.size(); i++) {
+    for (int i = 0; i < _jointData.size(); i++) {
         const JointData& data = _jointData.at(i);
-        if (sendAll || _lastSentJointData[i].translation != data.translation) {
-            if (sendAll ||
-                !cullSmallChanges ||
-                glm::distance(data.translation, _lastSentJointData[i].translation) > AVATAR_MIN_TRANSLATION) {
-                if (data.translationSet) {
-                    validity |= (1 << validityBit);
-                    #ifdef WANT_DEBUG
-                    translationSentCount++;
-                    #endif
-                    maxTranslationDimension = glm::max(fabsf(data.translation.x), maxTranslationDimension);
-                    maxTranslationDimension = glm::max(fabsf(data.translation.y), maxTranslationDimension);
-                    maxTranslationDimension = glm::max(fabsf(data.translation.z), maxTranslationDimension);
-                }
-            }
+        if (sendAll ? data.translationSet : shouldSendJointTranslation(data, _lastSentJointData[i], cullSmallChanges)) {
+            validity |= (1 << validityBit);
+            #ifdef WANT_DEBUG
+            translationSentCount++;
+            #endif
+            maxTranslationDimension = glm::max(fabsf(data.translation.x), maxTranslationDimension);
+            maxTranslationDimension = glm::max(fabsf(data.translation.y), maxTranslationDimension);
+            maxTranslationDimension = glm::max(fabsf(data.translation.z), maxTranslationDimension);
         }
         if (++validityBit == BITS_IN_BYTE) {
             *destinationBuffer++ = validity;
@@ -377,31 +415,33 @@ QByteArray AvatarData::toByteArray(bool cullSmallChanges, bool sendAll) {
         *destinationBuffer++ = validity;
     }
 
-    // TODO -- automatically pick translationCompressionRadix
-    int translationCompressionRadix = 12;
-
-    *destinationBuffer++ = translationCompressionRadix;
+    // every translation is quantized against the largest component being sent
+    memcpy(destinationBuffer, &maxTranslationDimension, sizeof(maxTranslationDimension));
+    destinationBuffer += sizeof(maxTranslationDimension);
 
+    bitOffset = 0;
     validityBit = 0;
     validity = *validityPosition++;
     for (int i = 0; i < _jointData.size(); i ++) {
         const JointData& data = _jointData[ i ];
         if (validity & (1 << validityBit)) {
-            destinationBuffer +=
-                packFloatVec3ToSignedTwoByteFixed(destinationBuffer, data.translation, translationCompressionRadix);
+            writeJointBits(destinationBuffer, bitOffset,
+                packFloatVec3ToSignedBits(data.translation, maxTranslationDimension, JOINT_TRANSLATION_BITS_PER_COMPONENT),
+                JOINT_TRANSLATION_BITS);
+            bitOffset += JOINT_TRANSLATION_BITS;
         }
         if (++validityBit == BITS_IN_BYTE) {
             validityBit = 0;
             validity = *validityPosition++;
         }
     }
+    destinationBuffer += bytesForJointBits(bitOffset);
 
     #ifdef WANT_DEBUG
     if (sendAll) {
         qDebug() << "AvatarData::toByteArray" << cullSmallChanges << sendAll
                  << "rotations:" << rotationSentCount << "translations:" << translationSentCount
                  << "largest:" << maxTranslationDimension
-                 << "radix:" << translationCompressionRadix
                  << "size:"
                  << (beforeRotations - startPosition) << "+"
                  << (beforeTranslations - beforeRotations) << "+"
@@ -418,21 +458,11 @@ void AvatarData::doneEncoding(bool cullSmallChanges) {
     _lastSentJointData.resize(_jointData.size());
     for (int i = 0; i < _jointData.size(); i ++) {
         const JointData& data = _jointData[ i ];
-        if (_lastSentJointData[i].rotation != data.rotation) {
-            if (!cullSmallChanges ||
-                fabsf(glm::dot(data.rotation, _lastSentJointData[i].rotation)) <= AVATAR_MIN_ROTATION_DOT) {
-                if (data.rotationSet) {
-                    _lastSentJointData[i].rotation = data.rotation;
-                }
-            }
+        if (shouldSendJointRotation(data, _lastSentJointData[i], cullSmallChanges)) {
+            _lastSentJointData[i].rotation = data.rotation;
         }
-        if (_lastSentJointData[i].translation != data.translation) {
-            if (!cullSmallChanges ||
-                glm::distance(data.translation, _lastSentJointData[i].translation) > AVATAR_MIN_TRANSLATION) {
-                if (data.translationSet) {
-                    _lastSentJointData[i].translation = data.translation;
-                }
-            }
+        if (shouldSendJointTranslation(data, _lastSentJointData[i], cullSmallChanges)) {
+            _lastSentJointData[i].translation = data.translation;
         }
     }
 }
@@ -694,9 +724,8 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
     } // 1 + bytesOfValidity bytes
 
-    // each joint rotation component is stored in two bytes (sizeof(uint16_t))
-    int COMPONENTS_PER_QUATERNION = 4;
-    minPossibleSize += numValidJointRotations * COMPONENTS_PER_QUATERNION * sizeof(uint16_t);
+    // each joint rotation is bit-packed into SMALLEST_THREE_QUAT_BITS
+    minPossibleSize += bytesForJointBits(numValidJointRotations * SMALLEST_THREE_QUAT_BITS);
     if (minPossibleSize > maxAvailableSize) {
         if (shouldLogError(now)) {
             qCDebug(avatars) << "Malformed AvatarData packet after JointData rotation validity;"
@@ -708,18 +737,33 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
     }
 
     { // joint data
+        int bitOffset = 0;
         for (int i = 0; i < numJoints; i++) {
             JointData& data = _jointData[i];
             if (validRotations[i]) {
                 _hasNewJointRotations = true;
                 data.rotationSet = true;
-                sourceBuffer += unpackOrientationQuatFromBytes(sourceBuffer, data.rotation);
+                data.rotation = unpackOrientationQuatFromSmallestThree(
+                    readJointBits(sourceBuffer, bitOffset, SMALLEST_THREE_QUAT_BITS));
+                bitOffset += SMALLEST_THREE_QUAT_BITS;
             }
         }
-    } // numJoints * 8 bytes
+        sourceBuffer += bytesForJointBits(bitOffset);
+    } // numValidJointRotations * 47 bits
 
     // joint translations
     // get translation validity bits -- these indicate which translations were packed
+    minPossibleSize += bytesOfValidity;
+    if (minPossibleSize > maxAvailableSize) {
+        if (shouldLogError(now)) {
+            qCDebug(avatars) << "Malformed AvatarData packet after JointData rotations;"
+                << " displayName = '" << _displayName << "'"
+                << " minPossibleSize = " << minPossibleSize
+                << " maxAvailableSize = " << maxAvailableSize;
+        }
+        return maxAvailableSize;
+    }
+
     int numValidJointTranslations = 0;
     QVector<bool> validTranslations;
     validTranslations.resize(numJoints);
@@ -740,8 +784,9 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         }
     } // 1 + bytesOfValidity bytes
 
-    // each joint translation component is stored in 6 bytes.  1 byte for translationCompressionRadix
-    minPossibleSize += numValidJointTranslations * 6 + 1;
+    // each joint translation is bit-packed into JOINT_TRANSLATION_BITS, after the float they're relative to
+    float maxTranslationDimension;
+    minPossibleSize += sizeof(maxTranslationDimension) + bytesForJointBits(numValidJointTranslations * JOINT_TRANSLATION_BITS);
     if (minPossibleSize > maxAvailableSize) {
         if (shouldLogError(now)) {
             qCDebug(avatars) << "Malformed AvatarData packet after JointData translation validity;"
@@ -752,25 +797,35 @@ int AvatarData::parseDataFromBuffer(const QByteArray& buffer) {
         return maxAvailableSize;
     }
 
-    int translationCompressionRadix = *sourceBuffer++;
+    memcpy(&maxTranslationDimension, sourceBuffer, sizeof(maxTranslationDimension));
+    sourceBuffer += sizeof(maxTranslationDimension);
+    if (glm::isnan(maxTranslationDimension) || glm::isinf(maxTranslationDimension) || maxTranslationDimension < 0.0f) {
+        if (shouldLogError(now)) {
+            qCDebug(avatars) << "Discard invalid AvatarData::maxTranslationDimension; displayName = '" << _displayName << "'";
+        }
+        return maxAvailableSize;
+    }
 
     { // joint data
+        int bitOffset = 0;
         for (int i = 0; i < numJoints; i++) {
             JointData& data = _jointData[i];
             if (validTranslations[i]) {
-                sourceBuffer +=
-                    unpackFloatVec3FromSignedTwoByteFixed(sourceBuffer, data.translation, translationCompressionRadix);
+                data.translation = unpackFloatVec3FromSignedBits(readJointBits(sourceBuffer, bitOffset, JOINT_TRANSLATION_BITS),
+                    maxTranslationDimension, JOINT_TRANSLATION_BITS_PER_COMPONENT);
+                bitOffset += JOINT_TRANSLATION_BITS;
                 _hasNewJointTranslations = true;
                 data.translationSet = true;
             }
         }
-    } // numJoints * 12 bytes
+        sourceBuffer += bytesForJointBits(bitOffset);
+    } // numValidJointTranslations * 36 bits
 
     #ifdef WANT_DEBUG
     if (numValidJointRotations > 15) {
         qDebug() << "RECEIVING -- rotations:" << numValidJointRotations
                  << "translations:" << numValidJointTranslations
-                 << "radix:" << translationCompressionRadix
+                 << "largest:" << maxTranslationDimension
                  << "size:" << (int)(sourceBuffer - startPosition);
     }
     #endif
@@ -0,0 +1,140 @@
+//
+//  EntityQueryBatch.cpp
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "EntityQueryBatch.h"
+
+#include <QtScript/QScriptEngine>
+
+#include <AABox.h>
+
+EntityQueryBatch::EntityQueryBatch(EntityTreePointer tree, EntityPropertyFlags desiredProperties, bool precisionPicking) :
+    _tree(tree),
+    _desiredProperties(desiredProperties),
+    _precisionPicking(precisionPicking)
+{
+    // the batch is handed back to the script thread once it has run, and deleted there
+    setAutoDelete(false);
+}
+
+void EntityQueryBatch::addSphere(const glm::vec3& center, float radius) {
+    Query query;
+    query.type = Sphere;
+    query.origin = center;
+    query.radius = radius;
+    _queries << query;
+}
+
+void EntityQueryBatch::addBox(const glm::vec3& corner, const glm::vec3& dimensions) {
+    Query query;
+    query.type = Box;
+    query.origin = corner;
+    query.extent = dimensions;
+    query.radius = 0.0f;
+    _queries << query;
+}
+
+void EntityQueryBatch::addRay(const PickRay& ray) {
+    Query query;
+    query.type = Ray;
+    query.origin = ray.origin;
+    query.extent = ray.direction;
+    query.radius = 0.0f;
+    _queries << query;
+}
+
+void EntityQueryBatch::run() {
+    if (_tree) {
+        // take the lock once for the whole batch, rather than once per query
+        _tree->withReadLock([&] {
+            for (Query& query : _queries) {
+                runQuery(query);
+            }
+        });
+    }
+    emit finished();
+}
+
+void EntityQueryBatch::runQuery(Query& query) {
+    bool wantProperties = !_desiredProperties.isEmpty();
+
+    if (query.type == Ray) {
+        RayToEntityIntersectionResult& result = query.intersection;
+        OctreeElementPointer element;
+        EntityItemPointer intersectedEntity = NULL;
+        QVector<EntityItemID> noEntityIdsToInclude;
+
+        // we already hold the read lock, which is recursive, so this never waits on the tree
+        result.intersects = _tree->findRayIntersection(query.origin, query.extent, element, result.distance, result.face,
+                                                       result.surfaceNormal, noEntityIdsToInclude,
+                                                       (void**)&intersectedEntity, Octree::Lock, &result.accurate,
+                                                       _precisionPicking);
+        if (result.intersects && intersectedEntity) {
+            result.entityID = intersectedEntity->getEntityItemID();
+            if (wantProperties) {
+                result.properties = intersectedEntity->getProperties(_desiredProperties);
+            }
+            result.intersection = query.origin + (query.extent * result.distance);
+        }
+        return;
+    }
+
+    QVector<EntityItemPointer> entities;
+    if (query.type == Sphere) {
+        _tree->findEntities(query.origin, query.radius, entities);
+    } else {
+        AABox box(query.origin, query.extent);
+        _tree->findEntities(box, entities);
+    }
+
+    query.foundIDs.reserve(entities.size());
+    if (wantProperties) {
+        query.foundProperties.reserve(entities.size());
+    }
+    foreach (EntityItemPointer entity, entities) {
+        query.foundIDs << entity->getEntityItemID();
+        if (wantProperties) {
+            query.foundProperties << entity->getProperties(_desiredProperties);
+        }
+    }
+}
+
+QScriptValue EntityQueryBatch::resultsToScriptValue(QScriptEngine* engine) const {
+    bool wantProperties = !_desiredProperties.isEmpty();
+
+    QScriptValue results = engine->newArray(_queries.size());
+    for (int i = 0; i < _queries.size(); i++) {
+        const Query& query = _queries[i];
+
+        if (query.type == Ray) {
+            QScriptValue intersection = RayToEntityIntersectionResultToScriptValue(engine, query.intersection);
+            if (!wantProperties) {
+                // nothing was copied, so don't hand back a full set of default properties
+                intersection.setProperty("properties", QScriptValue());
+            }
+            results.setProperty(i, intersection);
+            continue;
+        }
+
+        QScriptValue found = engine->newArray(query.foundIDs.size());
+        for (int j = 0; j < query.foundIDs.size(); j++) {
+            QScriptValue id = quuidToScriptValue(engine, query.foundIDs[j]);
+            if (wantProperties) {
+                QScriptValue entity = engine->newObject();
+                entity.setProperty("id", id);
+                entity.setProperty("properties", EntityItemPropertiesToScriptValue(engine, query.foundProperties[j]));
+                found.setProperty(j, entity);
+            } else {
+                found.setProperty(j, id);
+            }
+        }
+        results.setProperty(i, found);
+    }
+    return results;
+}
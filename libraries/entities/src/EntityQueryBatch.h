@@ -0,0 +1,70 @@
+//
+//  EntityQueryBatch.h
+//  libraries/entities/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_EntityQueryBatch_h
+#define hifi_EntityQueryBatch_h
+
+#include <QtCore/QObject>
+#include <QtCore/QRunnable>
+#include <QtCore/QVector>
+#include <QtScript/QScriptValue>
+
+#include <RegisteredMetaTypes.h>
+
+#include "EntityItemProperties.h"
+#include "EntityScriptingInterface.h"
+#include "EntityTree.h"
+
+/// A batch of sphere, box and ray queries against the entity tree, answered on a worker thread under a single read
+/// lock of the tree. Create it on the script thread, run it on a thread pool, and read the results back on the script
+/// thread once finished has been emitted.
+class EntityQueryBatch : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    EntityQueryBatch(EntityTreePointer tree, EntityPropertyFlags desiredProperties, bool precisionPicking = false);
+
+    void addSphere(const glm::vec3& center, float radius);
+    void addBox(const glm::vec3& corner, const glm::vec3& dimensions);
+    void addRay(const PickRay& ray);
+
+    int getQueryCount() const { return _queries.size(); }
+
+    virtual void run();
+
+    /// an array with one entry per query, in the order they were added: an array of entity IDs for a sphere or box
+    /// (or of { id, properties } objects if properties were requested) and an intersection result for a ray
+    QScriptValue resultsToScriptValue(QScriptEngine* engine) const;
+
+signals:
+    void finished();
+
+private:
+    enum QueryType { Sphere, Box, Ray };
+
+    struct Query {
+        QueryType type;
+        glm::vec3 origin; // center, corner or ray origin
+        glm::vec3 extent; // dimensions or ray direction
+        float radius;
+
+        QVector<QUuid> foundIDs;
+        QVector<EntityItemProperties> foundProperties;
+        RayToEntityIntersectionResult intersection;
+    };
+
+    void runQuery(Query& query);
+
+    EntityTreePointer _tree;
+    EntityPropertyFlags _desiredProperties;
+    bool _precisionPicking;
+    QVector<Query> _queries;
+};
+
+#endif // hifi_EntityQueryBatch_h
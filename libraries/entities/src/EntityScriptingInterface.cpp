@@ -17,6 +17,7 @@
 #include "EntitiesLogging.h"
 #include "EntityActionFactoryInterface.h"
 #include "EntityActionInterface.h"
+#include "EntityQueryBatch.h"
 #include "EntitySimulation.h"
 #include "EntityTree.h"
 #include "LightEntityItem.h"
@@ -31,6 +32,8 @@ EntityScriptingInterface::EntityScriptingInterface() :
     auto nodeList = DependencyManager::get<NodeList>();
     connect(nodeList.data(), &NodeList::canAdjustLocksChanged, this, &EntityScriptingInterface::canAdjustLocksChanged);
     connect(nodeList.data(), &NodeList::canRezChanged, this, &EntityScriptingInterface::canRezChanged);
+
+    _queryThreadPool.setMaxThreadCount(1);
 }
 
 void EntityScriptingInterface::queueEntityMessage(PacketType packetType,
@@ -309,6 +312,58 @@ RayToEntityIntersectionResult EntityScriptingInterface::findRayIntersectionWorke
     return result;
 }
 
+void EntityScriptingInterface::findEntitiesBatch(const QScriptValue& queries, const QScriptValue& desiredProperties,
+                                                 const QScriptValue& callback) {
+    EntityPropertyFlags desiredPropertyFlags;
+    EntityPropertyFlagsFromScriptValue(desiredProperties, desiredPropertyFlags);
+
+    EntityQueryBatch* batch = new EntityQueryBatch(_entityTree, desiredPropertyFlags);
+    int length = queries.property("length").toInt32();
+    for (int i = 0; i < length; i++) {
+        QScriptValue query = queries.property(i);
+        glm::vec3 origin;
+        glm::vec3 dimensions;
+        if (query.property("corner").isValid()) {
+            vec3FromScriptValue(query.property("corner"), origin);
+            vec3FromScriptValue(query.property("dimensions"), dimensions);
+            batch->addBox(origin, dimensions);
+        } else {
+            vec3FromScriptValue(query.property("center"), origin);
+            batch->addSphere(origin, (float)query.property("radius").toNumber());
+        }
+    }
+    startQueryBatch(batch, callback);
+}
+
+void EntityScriptingInterface::findRayIntersectionsBatch(const QScriptValue& rays, bool precisionPicking,
+                                                         const QScriptValue& desiredProperties, const QScriptValue& callback) {
+    EntityPropertyFlags desiredPropertyFlags;
+    EntityPropertyFlagsFromScriptValue(desiredProperties, desiredPropertyFlags);
+
+    EntityQueryBatch* batch = new EntityQueryBatch(_entityTree, desiredPropertyFlags, precisionPicking);
+    int length = rays.property("length").toInt32();
+    for (int i = 0; i < length; i++) {
+        PickRay ray;
+        pickRayFromScriptValue(rays.property(i), ray);
+        batch->addRay(ray);
+    }
+    startQueryBatch(batch, callback);
+}
+
+void EntityScriptingInterface::startQueryBatch(EntityQueryBatch* batch, const QScriptValue& callback) {
+    // the batch lives on the script thread, so its results are handed back there however long the worker takes
+    connect(batch, &EntityQueryBatch::finished, batch, [batch, callback] {
+        QScriptEngine* engine = callback.engine();
+        if (engine && callback.isFunction()) {
+            QScriptValueList args;
+            args << batch->resultsToScriptValue(engine);
+            callback.call(QScriptValue(), args);
+        }
+        batch->deleteLater();
+    });
+    _queryThreadPool.start(batch);
+}
+
 void EntityScriptingInterface::setLightsArePickable(bool value) {
     LightEntityItem::setLightsArePickable(value);
 }
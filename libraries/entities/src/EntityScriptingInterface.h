@@ -16,6 +16,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
 
 #include <DependencyManager.h>
 #include <Octree.h>
@@ -31,6 +32,7 @@
 #include "EntitiesScriptEngineProvider.h"
 #include "EntityItemProperties.h"
 
+class EntityQueryBatch;
 class EntityTree;
 class MouseEvent;
 
@@ -118,6 +120,18 @@ public slots:
     /// order to return an accurate result
     Q_INVOKABLE RayToEntityIntersectionResult findRayIntersectionBlocking(const PickRay& ray, bool precisionPicking = false, const QScriptValue& entityIdsToInclude = QScriptValue());
 
+    /// finds models for many queries at once without blocking the script; each query is either a sphere
+    /// { center, radius } or a box { corner, dimensions }. The whole batch is answered under a single lock of the tree
+    /// and callback is called with an array holding the IDs found for each query, or { id, properties } objects
+    /// carrying only the requested properties if desiredProperties names any
+    Q_INVOKABLE void findEntitiesBatch(const QScriptValue& queries, const QScriptValue& desiredProperties,
+                                       const QScriptValue& callback);
+
+    /// finds the ray intersections for many pick rays at once without blocking the script. callback is called with an
+    /// array of intersection results, whose properties only hold the requested properties, if desiredProperties names any
+    Q_INVOKABLE void findRayIntersectionsBatch(const QScriptValue& rays, bool precisionPicking,
+                                               const QScriptValue& desiredProperties, const QScriptValue& callback);
+
     Q_INVOKABLE void setLightsArePickable(bool value);
     Q_INVOKABLE bool getLightsArePickable() const;
 
@@ -188,8 +202,13 @@ private:
     RayToEntityIntersectionResult findRayIntersectionWorker(const PickRay& ray, Octree::lockType lockType,
                                                             bool precisionPicking, const QVector<EntityItemID>& entityIdsToInclude);
 
+    void startQueryBatch(EntityQueryBatch* batch, const QScriptValue& callback);
+
     EntityTreePointer _entityTree;
     EntitiesScriptEngineProvider* _entitiesScriptEngine = nullptr;
+
+    // answers batched queries, one batch at a time so scripts never hold more than one extra read lock of the tree
+    QThreadPool _queryThreadPool;
 };
 
 #endif // hifi_EntityScriptingInterface_h
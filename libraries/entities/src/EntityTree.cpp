@@ -9,9 +9,13 @@
 //  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
 //
 
+#include <thread>
+
 #include <PerfStat.h>
 #include <QDateTime>
+#include <QJsonDocument>
 #include <QtScript/QScriptEngine>
+#include <OctreeBinarySnapshot.h>
 
 #include "EntityTree.h"
 #include "EntitySimulation.h"
@@ -64,6 +68,11 @@ void EntityTree::eraseAllOctreeElements(bool createNewRoot) {
     foreach (EntityTreeElementPointer element, _entityToElementMap) {
         element->cleanupEntities();
     }
+    if (_trackChangesForJournal) {
+        foreach (const EntityItemID& entityID, _entityToElementMap.keys()) {
+            trackDeleteForJournal(entityID);
+        }
+    }
     _entityToElementMap.clear();
     Octree::eraseAllOctreeElements(createNewRoot);
 
@@ -90,6 +99,7 @@ void EntityTree::postAddEntity(EntityItemPointer entity) {
         _simulation->addEntity(entity);
     }
     _isDirty = true;
+    trackChangeForJournal(entity->getEntityItemID());
     maybeNotifyNewCollisionSoundURL("", entity->getCollisionSoundURL());
     emit addingEntity(entity->getEntityItemID());
 }
@@ -235,6 +245,8 @@ bool EntityTree::updateEntityWithElement(EntityItemPointer entity, const EntityI
         maybeNotifyNewCollisionSoundURL(collisionSoundURLBefore, entity->getCollisionSoundURL());
      }
 
+    trackChangeForJournal(entity->getEntityItemID());
+
     // TODO: this final containingElement check should eventually be removed (or wrapped in an #ifdef DEBUG).
     containingElement = getContainingElement(entity->getEntityItemID());
     if (!containingElement) {
@@ -340,6 +352,7 @@ void EntityTree::deleteEntity(const EntityItemID& entityID, bool force, bool ign
     }
 
     emit deletingEntity(entityID);
+    trackDeleteForJournal(entityID);
 
     // NOTE: callers must lock the tree before using this method
     DeleteEntityOperator theOperator(getThisPointer(), entityID);
@@ -379,6 +392,7 @@ void EntityTree::deleteEntities(QSet<EntityItemID> entityIDs, bool force, bool i
         // tell our delete operator about this entityID
         theOperator.addEntityIDToDeleteList(entityID);
         emit deletingEntity(entityID);
+        trackDeleteForJournal(entityID);
     }
 
     if (theOperator.getEntities().size() > 0) {
@@ -871,6 +885,7 @@ void EntityTree::entityChanged(EntityItemPointer entity) {
     if (_simulation) {
         _simulation->changeEntity(entity);
     }
+    trackChangeForJournal(entity->getEntityItemID());
 }
 
 void EntityTree::update() {
@@ -1165,6 +1180,7 @@ bool EntityTree::writeToMap(QVariantMap& entityDescription, OctreeElementPointer
     QScriptEngine scriptEngine;
     RecurseOctreeToMapOperator theOperator(entityDescription, element, &scriptEngine, skipDefaultValues);
     recurseTreeWithOperator(&theOperator);
+    entityDescription["Entities"] = theOperator.getEntities();
     return true;
 }
 
@@ -1199,6 +1215,229 @@ bool EntityTree::readFromMap(QVariantMap& map) {
     return true;
 }
 
+bool EntityTree::findAllEntitiesOperation(OctreeElementPointer element, void* extraData) {
+    QVector<EntityItemPointer>* foundEntities = static_cast<QVector<EntityItemPointer>*>(extraData);
+    EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
+    entityTreeElement->forEachEntity([&](EntityItemPointer entityItem) {
+        foundEntities->append(entityItem);
+    });
+    return true;
+}
+
+bool EntityTree::writeToBinarySnapshot(QByteArray& snapshot) {
+    // NOTE: callers must lock the tree before using this method
+    QVector<EntityItemPointer> entities;
+    recurseTreeWithOperation(findAllEntitiesOperation, &entities);
+
+    OctreeBinarySnapshot binarySnapshot(expectedDataPacketType(), expectedVersion());
+    QScriptEngine scriptEngine;
+    int jsonRecords = 0;
+
+    foreach (EntityItemPointer entity, entities) {
+        EntityItemProperties properties = entity->getProperties();
+        properties.markAllChanged(); // so the entire property set is encoded
+
+        QByteArray encodedEntity(MAX_OCTREE_PACKET_DATA_SIZE, 0);
+        if (EntityItemProperties::encodeEntityEditPacket(PacketType::EntityAdd, entity->getEntityItemID(),
+                                                         properties, encodedEntity)) {
+            // edit packets don't carry the created time, so it goes in front of the encoded entity
+            quint64 created = properties.getCreated();
+            QByteArray record(reinterpret_cast<const char*>(&created), sizeof(created));
+            record.append(encodedEntity);
+            binarySnapshot.appendRecord(OctreeBinarySnapshot::ENCODED_RECORD, record);
+        } else {
+            // too big for a single edit packet, save it the way a JSON save would
+            QVariant entityDescription = EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, properties).toVariant();
+            binarySnapshot.appendRecord(OctreeBinarySnapshot::JSON_RECORD,
+                                        QJsonDocument::fromVariant(entityDescription).toJson(QJsonDocument::Compact));
+            ++jsonRecords;
+        }
+    }
+
+    if (jsonRecords > 0) {
+        qCDebug(entities) << "Binary snapshot has" << jsonRecords << "of" << entities.size()
+            << "entities saved as JSON since they don't fit in an edit packet.";
+    }
+
+    snapshot = binarySnapshot.getData();
+    return true;
+}
+
+class DecodedSnapshotEntity {
+public:
+    EntityItemID entityID;
+    EntityItemProperties properties;
+    QVariantMap entityDescription; // only for JSON records, those go through the script engine on the loading thread
+    bool isValid = false;
+};
+
+static void decodeSnapshotRecord(const OctreeBinarySnapshot::Record& record, DecodedSnapshotEntity& decoded) {
+    if (record.format == OctreeBinarySnapshot::JSON_RECORD) {
+        QJsonDocument asDocument = QJsonDocument::fromJson(QByteArray::fromRawData(record.data, record.size));
+        decoded.entityDescription = asDocument.toVariant().toMap();
+        decoded.isValid = decoded.entityDescription.contains("id");
+    } else if (record.format == OctreeBinarySnapshot::ENCODED_RECORD && record.size > sizeof(quint64)) {
+        quint64 created;
+        memcpy(&created, record.data, sizeof(created));
+
+        int processedBytes = 0;
+        decoded.isValid = EntityItemProperties::decodeEntityEditPacket(
+            reinterpret_cast<const unsigned char*>(record.data + sizeof(quint64)), record.size - sizeof(quint64),
+            processedBytes, decoded.entityID, decoded.properties);
+        decoded.properties.setCreated(created);
+    }
+}
+
+bool EntityTree::readFromBinarySnapshot(const char* data, qint64 size) {
+    // NOTE: callers must lock the tree before using this method
+    std::vector<OctreeBinarySnapshot::Record> records;
+    if (!OctreeBinarySnapshot::readRecords(data, size, expectedDataPacketType(), expectedVersion(), records)) {
+        return false;
+    }
+
+    // decoding is most of the work of a load, so each batch of records is decoded across all cores
+    // and then added to the tree, in order, on this thread
+    const int numThreads = std::max(1, (int) std::thread::hardware_concurrency());
+    const size_t RECORDS_PER_THREAD_PER_BATCH = 256;
+    const size_t batchSize = RECORDS_PER_THREAD_PER_BATCH * numThreads;
+
+    QScriptEngine scriptEngine;
+    std::vector<DecodedSnapshotEntity> batch;
+
+    for (size_t batchStart = 0; batchStart < records.size(); batchStart += batchSize) {
+        size_t batchEnd = std::min(records.size(), batchStart + batchSize);
+        batch.clear();
+        batch.resize(batchEnd - batchStart);
+
+        auto decodeRecords = [&](int threadIndex) {
+            for (size_t i = batchStart + threadIndex; i < batchEnd; i += numThreads) {
+                decodeSnapshotRecord(records[i], batch[i - batchStart]);
+            }
+        };
+
+        std::vector<std::thread> decodeThreads;
+        for (int threadIndex = 1; threadIndex < numThreads && batchStart + threadIndex < batchEnd; ++threadIndex) {
+            decodeThreads.emplace_back(decodeRecords, threadIndex);
+        }
+        decodeRecords(0);
+        for (auto& thread : decodeThreads) {
+            thread.join();
+        }
+
+        for (DecodedSnapshotEntity& decoded : batch) {
+            if (!decoded.isValid) {
+                qCDebug(entities) << "Skipping unreadable entity in binary snapshot.";
+                continue;
+            }
+
+            if (!decoded.entityDescription.isEmpty()) {
+                // QVariantMap --> QScriptValue --> EntityItemProperties, the same as readFromMap
+                QScriptValue entityScriptValue = variantMapToScriptValue(decoded.entityDescription, scriptEngine);
+                EntityItemPropertiesFromScriptValueIgnoreReadOnly(entityScriptValue, decoded.properties);
+                decoded.entityID = EntityItemID(QUuid(decoded.entityDescription["id"].toString()));
+            }
+
+            EntityItemPointer entity = addEntity(decoded.entityID, decoded.properties);
+            if (!entity) {
+                qCDebug(entities) << "adding Entity failed:" << decoded.entityID << decoded.properties.getType();
+            }
+        }
+    }
+
+    return true;
+}
+
+void EntityTree::setTrackChangesForJournal(bool trackChanges) {
+    QMutexLocker locker(&_journalChangesLock);
+    _trackChangesForJournal = trackChanges;
+    _changedEntitiesForJournal.clear();
+    _deletedEntitiesForJournal.clear();
+}
+
+void EntityTree::trackChangeForJournal(const EntityItemID& entityID) {
+    if (_trackChangesForJournal) {
+        QMutexLocker locker(&_journalChangesLock);
+        // check again now that we hold the lock, the persist thread may have just stopped tracking
+        if (_trackChangesForJournal) {
+            _deletedEntitiesForJournal.remove(entityID);
+            _changedEntitiesForJournal.insert(entityID);
+        }
+    }
+}
+
+void EntityTree::trackDeleteForJournal(const EntityItemID& entityID) {
+    if (_trackChangesForJournal) {
+        QMutexLocker locker(&_journalChangesLock);
+        if (_trackChangesForJournal) {
+            _changedEntitiesForJournal.remove(entityID);
+            _deletedEntitiesForJournal.insert(entityID);
+        }
+    }
+}
+
+void EntityTree::takeChangesForJournal(QVariantList& changes) {
+    // NOTE: callers must lock the tree before using this method
+    QSet<EntityItemID> changedEntities;
+    QSet<EntityItemID> deletedEntities;
+    {
+        QMutexLocker locker(&_journalChangesLock);
+        changedEntities.swap(_changedEntitiesForJournal);
+        deletedEntities.swap(_deletedEntitiesForJournal);
+    }
+
+    foreach (const EntityItemID& entityID, deletedEntities) {
+        QVariantMap change;
+        change["id"] = entityID.toString();
+        change["deleted"] = true;
+        changes << change;
+    }
+
+    // a changed entity is journaled with the same description a full save would have for it
+    QScriptEngine scriptEngine;
+    foreach (const EntityItemID& entityID, changedEntities) {
+        EntityItemPointer entity = findEntityByEntityItemID(entityID);
+        if (entity) {
+            changes << EntityItemNonDefaultPropertiesToScriptValue(&scriptEngine, entity->getProperties()).toVariant();
+        }
+    }
+}
+
+void EntityTree::replayJournalChanges(const QVariantList& changes) {
+    // NOTE: callers must lock the tree before using this method
+
+    // only the last change to each entity matters
+    QHash<QUuid, QVariantMap> lastChanges;
+    foreach (const QVariant& change, changes) {
+        QVariantMap changeMap = change.toMap();
+        QUuid entityID(changeMap["id"].toString());
+        if (!entityID.isNull()) {
+            lastChanges[entityID] = changeMap;
+        }
+    }
+
+    // entities we have an older version of are replaced with the journaled one
+    QSet<EntityItemID> entitiesToDelete;
+    QVariantList entitiesToAdd;
+    for (auto it = lastChanges.constBegin(); it != lastChanges.constEnd(); ++it) {
+        if (findEntityByEntityItemID(EntityItemID(it.key()))) {
+            entitiesToDelete << EntityItemID(it.key());
+        }
+        if (!it.value()["deleted"].toBool()) {
+            entitiesToAdd << it.value();
+        }
+    }
+
+    deleteEntities(entitiesToDelete, true, true);
+
+    QVariantMap entityDescription;
+    entityDescription["Entities"] = entitiesToAdd;
+    readFromMap(entityDescription);
+
+    // nobody has been sent these entities yet, so there is nobody to tell about the deletes
+    QWriteLocker locker(&_recentlyDeletedEntitiesLock);
+    _recentlyDeletedEntityItemIDs.clear();
+}
+
 void EntityTree::resetClientEditStats() {
     _treeResetTime = usecTimestampNow();
     _maxEditDelta = 0;
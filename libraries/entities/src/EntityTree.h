@@ -12,6 +12,9 @@
 #ifndef hifi_EntityTree_h
 #define hifi_EntityTree_h
 
+#include <atomic>
+
+#include <QMutex>
 #include <QSet>
 #include <QVector>
 
@@ -199,6 +202,15 @@ public:
     bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues);
     bool readFromMap(QVariantMap& entityDescription);
 
+    virtual bool canJournalChanges() const { return true; }
+    virtual void setTrackChangesForJournal(bool trackChanges);
+    virtual void takeChangesForJournal(QVariantList& changes);
+    virtual void replayJournalChanges(const QVariantList& changes);
+
+    virtual bool canWriteBinarySnapshot() const { return true; }
+    virtual bool writeToBinarySnapshot(QByteArray& snapshot);
+    virtual bool readFromBinarySnapshot(const char* data, qint64 size);
+
     float getContentsLargestDimension();
 
     virtual void resetEditStats() {
@@ -246,6 +258,7 @@ private:
     static bool findInCubeOperation(OctreeElementPointer element, void* extraData);
     static bool findInBoxOperation(OctreeElementPointer element, void* extraData);
     static bool sendEntitiesOperation(OctreeElementPointer element, void* extraData);
+    static bool findAllEntitiesOperation(OctreeElementPointer element, void* extraData);
 
     void notifyNewlyCreatedEntity(const EntityItem& newEntity, const SharedNodePointer& senderNode);
 
@@ -262,6 +275,15 @@ private:
 
     bool _wantEditLogging = false;
     bool _wantTerseEditLogging = false;
+
+    // entities touched since the persist thread last asked, an entity is only ever in one of the two sets
+    void trackChangeForJournal(const EntityItemID& entityID);
+    void trackDeleteForJournal(const EntityItemID& entityID);
+    QMutex _journalChangesLock;
+    std::atomic<bool> _trackChangesForJournal { false }; // written under the lock, also read without it
+    QSet<EntityItemID> _changedEntitiesForJournal;
+    QSet<EntityItemID> _deletedEntitiesForJournal;
+
     void maybeNotifyNewCollisionSoundURL(const QString& oldCollisionSoundURL, const QString& newCollisionSoundURL);
 
 
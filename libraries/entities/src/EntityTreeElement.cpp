@@ -13,6 +13,7 @@
 
 #include <FBXReader.h>
 #include <GeometryUtil.h>
+#include <OctreeEncodeCache.h>
 
 #include "EntitiesLogging.h"
 #include "EntityItemProperties.h"
@@ -343,7 +344,7 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
             foreach(uint16_t i, indexesOfEntitiesToInclude) {
                 EntityItemPointer entity = _entityItems[i];
                 LevelDetails entityLevel = packetData->startLevel();
-                OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData,
+                OctreeElement::AppendState appendEntityState = appendEntityDataUsingCache(entity, packetData,
                     params, entityTreeElementExtraEncodeData);
 
                 // If none of this entity data was able to be appended, then discard it
@@ -433,6 +434,47 @@ OctreeElement::AppendState EntityTreeElement::appendElementData(OctreePacketData
     return appendElementState;
 }
 
+// any change to the entity, or to the element holding it, moves at least one of these timestamps
+static quint64 encodeCacheVersion(const EntityTreeElement* element, const EntityItemPointer& entity) {
+    quint64 stamps[] = { element->getLastChanged(), entity->getLastEdited(), entity->getLastUpdated(),
+                         entity->getLastSimulated(), entity->getLastChangedOnServer() };
+    quint64 version = 0;
+    for (quint64 stamp : stamps) {
+        version ^= stamp + 0x9e3779b97f4a7c15ULL + (version << 6) + (version >> 2);
+    }
+    return version;
+}
+
+OctreeElement::AppendState EntityTreeElement::appendEntityDataUsingCache(EntityItemPointer entity,
+        OctreePacketData* packetData, EncodeBitstreamParams& params,
+        EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const {
+
+    // only an entity that is being sent whole encodes the same for every client
+    bool cacheable = params.encodeCache &&
+        entityTreeElementExtraEncodeData->entities.value(entity->getEntityItemID()) == entity->getEntityProperties(params);
+    if (!cacheable) {
+        return entity->appendEntityData(packetData, params, entityTreeElementExtraEncodeData);
+    }
+
+    quint64 version = encodeCacheVersion(this, entity);
+    QByteArray encoded;
+    bool foundInCache = params.encodeCache->find(entity->getID(), version, encoded);
+    if (foundInCache && packetData->appendRawData((const unsigned char*)encoded.constData(), encoded.size())) {
+        return OctreeElement::COMPLETED;
+    }
+
+    // not cached or it didn't fit, encode it here so that it can be split across packets
+    int entityStart = packetData->getUncompressedByteOffset();
+    OctreeElement::AppendState appendEntityState = entity->appendEntityData(packetData, params,
+                                                                            entityTreeElementExtraEncodeData);
+    if (!foundInCache && appendEntityState == OctreeElement::COMPLETED) {
+        int entityEnd = packetData->getUncompressedByteOffset();
+        params.encodeCache->insert(entity->getID(), version,
+            QByteArray((const char*)packetData->getUncompressedData(entityStart), entityEnd - entityStart));
+    }
+    return appendEntityState;
+}
+
 bool EntityTreeElement::containsEntityBounds(EntityItemPointer entity) const {
     return containsBounds(entity->getMaximumAACube());
 }
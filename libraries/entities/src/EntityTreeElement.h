@@ -231,6 +231,11 @@ public:
 
 protected:
     virtual void init(unsigned char * octalCode);
+
+    /// appends an entity from params.encodeCache when it has one, and adds whole entities it had to encode
+    OctreeElement::AppendState appendEntityDataUsingCache(EntityItemPointer entity, OctreePacketData* packetData,
+        EncodeBitstreamParams& params, EntityTreeElementExtraEncodeData* entityTreeElementExtraEncodeData) const;
+
     EntityTreePointer _myTree;
     EntityItems _entityItems;
 };
@@ -23,6 +23,8 @@ RecurseOctreeToMapOperator::RecurseOctreeToMapOperator(QVariantMap& map,
         _engine(engine),
         _skipDefaultValues(skipDefaultValues)
 {
+    _entities = qvariant_cast<QVariantList>(_map["Entities"]);
+
     // if some element "top" was given, only save information for that element and its children.
     if (_top) {
         _withinTop = false;
@@ -44,7 +46,6 @@ bool RecurseOctreeToMapOperator::postRecursion(OctreeElementPointer element) {
     EntityItemProperties defaultProperties;
 
     EntityTreeElementPointer entityTreeElement = std::static_pointer_cast<EntityTreeElement>(element);
-    QVariantList entitiesQList = qvariant_cast<QVariantList>(_map["Entities"]);
 
     entityTreeElement->forEachEntity([&](EntityItemPointer entityItem) {
         EntityItemProperties properties = entityItem->getProperties();
@@ -54,10 +55,9 @@ bool RecurseOctreeToMapOperator::postRecursion(OctreeElementPointer element) {
         } else {
             qScriptValues = EntityItemPropertiesToScriptValue(_engine, properties);
         }
-        entitiesQList << qScriptValues.toVariant();
+        _entities << qScriptValues.toVariant();
     });
 
-    _map["Entities"] = entitiesQList;
     if (element == _top) {
         _withinTop = false;
     }
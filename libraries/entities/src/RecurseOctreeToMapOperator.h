@@ -16,8 +16,12 @@ public:
     RecurseOctreeToMapOperator(QVariantMap& map, OctreeElementPointer top, QScriptEngine* engine, bool skipDefaultValues);
     bool preRecursion(OctreeElementPointer element);
     bool postRecursion(OctreeElementPointer element);
+
+    /// the descriptions are collected here and only put in the map once the recursion is done
+    const QVariantList& getEntities() const { return _entities; }
  private:
     QVariantMap& _map;
+    QVariantList _entities;
     OctreeElementPointer _top;
     QScriptEngine* _engine;
     bool _withinTop;
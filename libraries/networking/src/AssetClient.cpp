@@ -41,6 +41,7 @@ AssetClient::AssetClient() {
     packetReceiver.registerListener(PacketType::AssetGetInfoReply, this, "handleAssetGetInfoReply");
     packetReceiver.registerMessageListener(PacketType::AssetGetReply, this, "handleAssetGetReply");
     packetReceiver.registerListener(PacketType::AssetUploadReply, this, "handleAssetUploadReply");
+    packetReceiver.registerListener(PacketType::AssetUploadChunkReply, this, "handleAssetUploadChunkReply");
 
     connect(nodeList.data(), &LimitedNodeList::nodeKilled, this, &AssetClient::handleNodeKilled);
 }
@@ -329,6 +330,76 @@ void AssetClient::handleAssetUploadReply(QSharedPointer<NLPacket> packet, Shared
     }
 }
 
+bool AssetClient::uploadAssetChunk(const QUuid& uploadID, const QString& extension, DataOffset totalSize, DataOffset offset,
+                                   const QByteArray& chunk, UploadChunkCallback callback) {
+    auto nodeList = DependencyManager::get<NodeList>();
+    SharedNodePointer assetServer = nodeList->soloNodeOfType(NodeType::AssetServer);
+
+    if (assetServer) {
+        auto packetList = NLPacketList::create(PacketType::AssetUploadChunk, QByteArray(), true, true);
+
+        auto messageID = ++_currentID;
+        packetList->writePrimitive(messageID);
+
+        packetList->write(uploadID.toRfc4122());
+
+        packetList->writePrimitive(static_cast<uint8_t>(extension.length()));
+        packetList->write(extension.toLatin1().constData(), extension.length());
+
+        packetList->writePrimitive(totalSize);
+        packetList->writePrimitive(offset);
+
+        DataOffset size = chunk.length();
+        packetList->writePrimitive(size);
+        packetList->write(chunk.constData(), size);
+
+        nodeList->sendPacketList(std::move(packetList), *assetServer);
+
+        _pendingChunkUploads[assetServer][messageID] = callback;
+
+        return true;
+    }
+    return false;
+}
+
+void AssetClient::handleAssetUploadChunkReply(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode) {
+    MessageID messageID;
+    packet->readPrimitive(&messageID);
+
+    AssetServerError error;
+    packet->readPrimitive(&error);
+
+    // the asset-server always tells us how much of the upload it has, that is where a resumed upload picks up
+    DataOffset bytesReceived { 0 };
+    packet->readPrimitive(&bytesReceived);
+
+    QString hashString;
+
+    // the hash is only present once the asset-server has the complete upload
+    if (!error && packet->bytesLeftToRead() >= (qint64) SHA256_HASH_LENGTH) {
+        auto hash = packet->read(SHA256_HASH_LENGTH);
+        hashString = hash.toHex();
+
+        qCDebug(asset_client) << "Successfully uploaded asset to asset-server - SHA256 hash is " << hashString;
+    }
+
+    // Check if we have any pending requests for this node
+    auto messageMapIt = _pendingChunkUploads.find(senderNode);
+    if (messageMapIt != _pendingChunkUploads.end()) {
+
+        // Found the node, get the MessageID -> Callback map
+        auto& messageCallbackMap = messageMapIt->second;
+
+        // Check if we have this pending request
+        auto requestIt = messageCallbackMap.find(messageID);
+        if (requestIt != messageCallbackMap.end()) {
+            auto callback = requestIt->second;
+            messageCallbackMap.erase(requestIt);
+            callback(true, error, bytesReceived, hashString);
+        }
+    }
+}
+
 void AssetClient::handleNodeKilled(SharedNodePointer node) {
     if (node->getType() != NodeType::AssetServer) {
         return;
@@ -364,4 +435,17 @@ void AssetClient::handleNodeKilled(SharedNodePointer node) {
             messageMapIt->second.clear();
         }
     }
+
+    {
+        auto messageMapIt = _pendingChunkUploads.find(node);
+        if (messageMapIt != _pendingChunkUploads.end()) {
+            // swap the callbacks out first, a failed upload is allowed to queue up its resume from the callback
+            auto callbacks = std::move(messageMapIt->second);
+            messageMapIt->second.clear();
+
+            for (const auto& value : callbacks) {
+                value.second(false, AssetServerError::NoError, 0, "");
+            }
+        }
+    }
 }
@@ -14,6 +14,7 @@
 #define hifi_AssetClient_h
 
 #include <QString>
+#include <QUuid>
 
 #include <DependencyManager.h>
 
@@ -33,6 +34,8 @@ struct AssetInfo {
 using ReceivedAssetCallback = std::function<void(bool responseReceived, AssetServerError serverError, const QByteArray& data)>;
 using GetInfoCallback = std::function<void(bool responseReceived, AssetServerError serverError, AssetInfo info)>;
 using UploadResultCallback = std::function<void(bool responseReceived, AssetServerError serverError, const QString& hash)>;
+using UploadChunkCallback = std::function<void(bool responseReceived, AssetServerError serverError,
+                                               DataOffset bytesReceived, const QString& hash)>;
 
 
 
@@ -51,6 +54,7 @@ private slots:
     void handleAssetGetInfoReply(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
     void handleAssetGetReply(QSharedPointer<NLPacketList> packetList, SharedNodePointer senderNode);
     void handleAssetUploadReply(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
+    void handleAssetUploadChunkReply(QSharedPointer<NLPacket> packet, SharedNodePointer senderNode);
 
     void handleNodeKilled(SharedNodePointer node);
 
@@ -58,11 +62,14 @@ private:
     bool getAssetInfo(const QString& hash, const QString& extension, GetInfoCallback callback);
     bool getAsset(const QString& hash, const QString& extension, DataOffset start, DataOffset end, ReceivedAssetCallback callback);
     bool uploadAsset(const QByteArray& data, const QString& extension, UploadResultCallback callback);
+    bool uploadAssetChunk(const QUuid& uploadID, const QString& extension, DataOffset totalSize, DataOffset offset,
+                          const QByteArray& chunk, UploadChunkCallback callback);
 
     static MessageID _currentID;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, ReceivedAssetCallback>> _pendingRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, GetInfoCallback>> _pendingInfoRequests;
     std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadResultCallback>> _pendingUploads;
+    std::unordered_map<SharedNodePointer, std::unordered_map<MessageID, UploadChunkCallback>> _pendingChunkUploads;
     
     friend class AssetRequest;
     friend class AssetUpload;
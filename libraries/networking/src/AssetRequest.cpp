@@ -14,6 +14,7 @@
 #include <algorithm>
 
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
 
 #include "AssetClient.h"
 #include "NetworkLogging.h"
@@ -82,48 +83,140 @@ void AssetRequest::start() {
         
         qCDebug(asset_client) << "Got size of " << _hash << " : " << info.size << " bytes";
         
-        int start = 0, end = _info.size;
+        // split the asset into chunks that we request in parallel, anything we have already received survives
+        // a dropped connection and only the missing chunks are asked for again
+        for (DataOffset start = 0; start < _info.size; start += ASSET_TRANSFER_CHUNK_SIZE) {
+            _chunksToRequest.push_back(start);
+        }
         
-        auto assetClient = DependencyManager::get<AssetClient>();
-        assetClient->getAsset(_hash, _extension, start, end, [this, start, end](bool responseReceived, AssetServerError serverError,
-                                                                                const QByteArray& data) {
-            if (!responseReceived) {
-                _error = NetworkError;
-            } else if (serverError != AssetServerError::NoError) {
-                switch (serverError) {
-                    case AssetServerError::AssetNotFound:
-                        _error = NotFound;
-                        break;
-                    case AssetServerError::InvalidByteRange:
-                        _error = InvalidByteRange;
-                        break;
-                    default:
-                        _error = UnknownError;
-                        break;
-                }
-            } else {
-                Q_ASSERT(data.size() == (end - start));
-                
-                // we need to check the hash of the received data to make sure it matches what we expect
-                if (hashData(data).toHex() == _hash) {
-                    memcpy(_data.data() + start, data.constData(), data.size());
-                    _totalReceived += data.size();
-                    emit progress(_totalReceived, _info.size);
-                    
-                    saveToCache(getUrl(), data);
-                } else {
-                    // hash doesn't match - we have an error
-                    _error = HashVerificationFailed;
-                }
-                
-            }
+        requestChunks();
+    });
+}
+
+void AssetRequest::requestChunks() {
+    static const int MAX_CHUNK_REQUESTS_IN_FLIGHT = 4;
+    
+    if (_error == NoError && _chunksToRequest.empty() && _numPendingRequests == 0) {
+        // this can only be an empty asset, there is nothing to ask for
+        finish();
+        return;
+    }
+    
+    auto assetClient = DependencyManager::get<AssetClient>();
+    
+    while (_error == NoError && _numPendingRequests < MAX_CHUNK_REQUESTS_IN_FLIGHT && !_chunksToRequest.empty()) {
+        DataOffset start = _chunksToRequest.front();
+        DataOffset end = std::min(start + ASSET_TRANSFER_CHUNK_SIZE, (DataOffset) _info.size);
+        
+        bool requestSent = assetClient->getAsset(_hash, _extension, start, end,
+                                                 [this, start, end](bool responseReceived, AssetServerError serverError,
+                                                                    const QByteArray& data) {
+            handleChunkReply(start, end, responseReceived, serverError, data);
+        });
+        
+        if (!requestSent) {
+            // we don't have an asset-server right now, wait for it to come back
+            scheduleRetry();
             
-            if (_error != NoError) {
-                qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+            if (_error != NoError && _numPendingRequests == 0) {
+                // we gave up and there is no reply left to come back and finish us
+                finish();
             }
-            
-            _state = Finished;
-            emit finished(this);
-        });
+            return;
+        }
+        
+        _chunksToRequest.pop_front();
+        ++_numPendingRequests;
+    }
+}
+
+void AssetRequest::handleChunkReply(DataOffset start, DataOffset end, bool responseReceived, AssetServerError serverError,
+                                    const QByteArray& data) {
+    --_numPendingRequests;
+    
+    if (_error == NoError) {
+        if (!responseReceived) {
+            // the connection to the asset-server dropped, hold on to this chunk and ask for it again
+            _chunksToRequest.push_front(start);
+            scheduleRetry();
+        } else if (serverError != AssetServerError::NoError) {
+            switch (serverError) {
+                case AssetServerError::AssetNotFound:
+                    _error = NotFound;
+                    break;
+                case AssetServerError::InvalidByteRange:
+                    _error = InvalidByteRange;
+                    break;
+                default:
+                    _error = UnknownError;
+                    break;
+            }
+        } else if (data.size() != (end - start)) {
+            _error = InvalidByteRange;
+        } else {
+            memcpy(_data.data() + start, data.constData(), data.size());
+            _totalReceived += data.size();
+            _numRetries = 0;
+            emit progress(_totalReceived, _info.size);
+        }
+    }
+    
+    if (_numPendingRequests > 0) {
+        return;
+    }
+    
+    if (_error != NoError) {
+        // only finish once nothing is in flight, the callbacks still reference this request
+        finish();
+    } else if (_chunksToRequest.empty()) {
+        // we need to check the hash of the received data to make sure it matches what we expect
+        if (hashData(_data).toHex() == _hash) {
+            saveToCache(getUrl(), _data);
+        } else {
+            // hash doesn't match - we have an error
+            _error = HashVerificationFailed;
+        }
+        finish();
+    } else if (!_isRetryScheduled) {
+        requestChunks();
+    }
+}
+
+void AssetRequest::scheduleRetry() {
+    static const int MAX_RETRIES = 5;
+    static const int RETRY_DELAY_MSECS = 2000;
+    
+    if (_isRetryScheduled) {
+        return;
+    }
+    
+    if (++_numRetries > MAX_RETRIES) {
+        // whoever asked for the retry finishes the request, once nothing is in flight
+        _error = NetworkError;
+        return;
+    }
+    
+    qCDebug(asset_client) << "Lost the asset-server while retrieving" << _hash << "- retrying with"
+        << _totalReceived << "of" << _info.size << "bytes received";
+    
+    // back off a little more every time, the domain may need a moment to hand us a new asset-server
+    _isRetryScheduled = true;
+    QTimer::singleShot(RETRY_DELAY_MSECS * _numRetries, this, [this] {
+        _isRetryScheduled = false;
+        requestChunks();
     });
 }
+
+void AssetRequest::finish() {
+    if (_error != NoError) {
+        qCWarning(asset_client) << "Got error retrieving asset" << _hash << "- error code" << _error;
+    } else {
+        // an empty asset never goes through a chunk reply, make sure it is still verified
+        if (_info.size == 0 && hashData(_data).toHex() != _hash) {
+            _error = HashVerificationFailed;
+        }
+    }
+    
+    _state = Finished;
+    emit finished(this);
+}
@@ -12,6 +12,8 @@
 #ifndef hifi_AssetRequest_h
 #define hifi_AssetRequest_h
 
+#include <deque>
+
 #include <QByteArray>
 #include <QObject>
 #include <QString>
@@ -53,6 +55,12 @@ signals:
     void progress(qint64 totalReceived, qint64 total);
 
 private:
+    void requestChunks();
+    void handleChunkReply(DataOffset start, DataOffset end, bool responseReceived, AssetServerError serverError,
+                          const QByteArray& data);
+    void scheduleRetry();
+    void finish();
+
     State _state = NotStarted;
     Error _error = NoError;
     AssetInfo _info;
@@ -61,6 +69,9 @@ private:
     QString _extension;
     QByteArray _data;
     int _numPendingRequests { 0 };
+    std::deque<DataOffset> _chunksToRequest; // start offsets of the chunks we still need
+    int _numRetries { 0 }; // consecutive retries without receiving any data
+    bool _isRetryScheduled { false };
 };
 
 #endif
@@ -11,8 +11,13 @@
 
 #include "AssetUpload.h"
 
+#include <algorithm>
+
 #include <QtCore/QFileInfo>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <UUID.h>
 
 #include "AssetClient.h"
 #include "NetworkLogging.h"
@@ -57,54 +62,200 @@ void AssetUpload::start() {
     
     if (_data.isEmpty() && !_filename.isEmpty()) {
         // try to open the file at the given filename
-        QFile file { _filename };
+        _file.setFileName(_filename);
         
-        if (file.open(QIODevice::ReadOnly)) {
+        if (_file.open(QIODevice::ReadOnly)) {
             
-            // file opened, read the data and grab the extension
+            // file opened, grab the extension - the contents are read as each chunk goes out
             _extension = QFileInfo(_filename).suffix();
-            
-            _data = file.readAll();
+            _totalSize = _file.size();
         } else {
-            // we couldn't open the file - set the error result
+            // we couldn't open the file - set the error result and emit that we are done
             _error = FileOpenError;
-            
-            // emit that we are done
             emit finished(this, QString());
+            return;
         }
+    } else {
+        _totalSize = _data.size();
+    }
+    
+    if ((uint64_t) _totalSize > MAX_UPLOAD_SIZE) {
+        _error = TooLarge;
+        emit finished(this, QString());
+        return;
     }
     
-    // ask the AssetClient to upload the asset and emit the proper signals from the passed callback
-    auto assetClient = DependencyManager::get<AssetClient>();
-   
     if (!_filename.isEmpty()) {
         qCDebug(asset_client) << "Attempting to upload" << _filename << "to asset-server.";
     }
     
-    assetClient->uploadAsset(_data, _extension, [this](bool responseReceived, AssetServerError error, const QString& hash){
+    _uploadID = QUuid::createUuid();
+    
+    if (_totalSize == 0) {
+        // an empty chunk is all an empty asset needs
+        sendResumeProbe();
+    } else {
+        sendChunks();
+    }
+}
+
+bool AssetUpload::sendChunk(DataOffset offset, DataOffset size) {
+    QByteArray chunk;
+    
+    if (_file.isOpen()) {
+        if (size > 0 && (!_file.seek(offset) || (chunk = _file.read(size)).size() != size)) {
+            qCWarning(asset_client) << "Could not read" << _filename << "for upload to asset-server.";
+            complete(FileOpenError);
+            return true;
+        }
+    } else {
+        chunk = QByteArray::fromRawData(_data.constData() + offset, size);
+    }
+    
+    auto assetClient = DependencyManager::get<AssetClient>();
+    auto attempt = _attempt;
+    
+    bool chunkSent = assetClient->uploadAssetChunk(_uploadID, _extension, _totalSize, offset, chunk,
+                                                   [this, attempt](bool responseReceived, AssetServerError error,
+                                                                   DataOffset bytesReceived, const QString& hash) {
+        handleChunkReply(attempt, responseReceived, error, bytesReceived, hash);
+    });
+    
+    if (chunkSent) {
+        ++_numChunksInFlight;
+    }
+    
+    return chunkSent;
+}
+
+void AssetUpload::sendChunks() {
+    static const int MAX_CHUNKS_IN_FLIGHT = 4;
+    
+    while (!_isComplete && !_isResyncing && _numChunksInFlight < MAX_CHUNKS_IN_FLIGHT && _nextOffset < _totalSize) {
+        DataOffset size = std::min(ASSET_TRANSFER_CHUNK_SIZE, _totalSize - _nextOffset);
+        
+        if (!sendChunk(_nextOffset, size)) {
+            // we don't have an asset-server right now, wait for it to come back
+            ++_attempt;
+            scheduleResume();
+            return;
+        }
+        
+        _nextOffset += size;
+    }
+}
+
+void AssetUpload::sendResumeProbe() {
+    // an empty chunk at the start of the upload just asks the asset-server how much it already has
+    _isResyncing = true;
+    _nextOffset = 0;
+    
+    if (!sendChunk(0, 0)) {
+        _isResyncing = false;
+        ++_attempt;
+        scheduleResume();
+    }
+}
+
+void AssetUpload::handleChunkReply(int attempt, bool responseReceived, AssetServerError error, DataOffset bytesReceived,
+                                   const QString& hash) {
+    --_numChunksInFlight;
+    
+    if (!_isComplete && attempt == _attempt) {
+        _isResyncing = false;
+        
         if (!responseReceived) {
-            _error = NetworkError;
+            // the connection to the asset-server dropped, the chunks it acknowledged are kept in its temporary file
+            ++_attempt;
+            scheduleResume();
         } else {
             switch (error) {
                 case AssetServerError::NoError:
-                    _error = NoError;
+                    _numRetries = 0;
+                    _nextOffset = std::max(_nextOffset, bytesReceived);
+                    emit progress(bytesReceived, _totalSize);
+                    
+                    if (!hash.isEmpty()) {
+                        complete(NoError, hash);
+                    }
+                    break;
+                case AssetServerError::InvalidByteRange:
+                    // the asset-server does not have what we thought it had (it may have restarted),
+                    // go back to the point it is at
+                    ++_attempt;
+                    _nextOffset = bytesReceived;
                     break;
                 case AssetServerError::AssetTooLarge:
-                    _error = TooLarge;
+                    complete(TooLarge);
                     break;
                 case AssetServerError::PermissionDenied:
-                    _error = PermissionDenied;
+                    complete(PermissionDenied);
                     break;
                 default:
-                    _error = FileOpenError;
+                    complete(FileOpenError);
                     break;
             }
         }
-        
-        if (_error == NoError && hash == hashData(_data).toHex()) {
-            saveToCache(getATPUrl(hash, _extension), _data);
+    }
+    
+    if (_isComplete) {
+        // only finish once nothing is in flight, the callbacks still reference this upload
+        if (_numChunksInFlight == 0) {
+            finish();
         }
+    } else if (!_isResumeScheduled) {
+        sendChunks();
+    }
+}
+
+void AssetUpload::scheduleResume() {
+    static const int MAX_RETRIES = 5;
+    static const int RETRY_DELAY_MSECS = 2000;
+    
+    if (_isResumeScheduled || _isComplete) {
+        return;
+    }
+    
+    if (++_numRetries > MAX_RETRIES) {
+        complete(NetworkError);
+        return;
+    }
+    
+    qCDebug(asset_client) << "Lost the asset-server during upload" << uuidStringWithoutCurlyBraces(_uploadID)
+        << "- will try to resume it";
+    
+    // back off a little more every time, the domain may need a moment to hand us a new asset-server
+    _isResumeScheduled = true;
+    QTimer::singleShot(RETRY_DELAY_MSECS * _numRetries, this, [this] {
+        _isResumeScheduled = false;
         
-        emit finished(this, hash);
+        if (!_isComplete) {
+            sendResumeProbe();
+        }
     });
 }
+
+void AssetUpload::complete(Error error, const QString& hash) {
+    _isComplete = true;
+    _error = error;
+    _hash = hash;
+    
+    if (_numChunksInFlight == 0) {
+        finish();
+    }
+}
+
+void AssetUpload::finish() {
+    if (_isFinished) {
+        return;
+    }
+    _isFinished = true;
+    
+    _file.close();
+    
+    if (_error == NoError && !_data.isEmpty() && _hash == hashData(_data).toHex()) {
+        saveToCache(getATPUrl(_hash, _extension), _data);
+    }
+    
+    emit finished(this, _hash);
+}
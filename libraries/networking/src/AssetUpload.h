@@ -14,13 +14,20 @@
 #ifndef hifi_AssetUpload_h
 #define hifi_AssetUpload_h
 
+#include <QtCore/QFile>
 #include <QtCore/QObject>
+#include <QtCore/QUuid>
 
 #include <cstdint>
 
+#include "AssetUtils.h"
+
 // You should be able to upload an asset from any thread, and handle the responses in a safe way
 // on your own thread. Everything should happen on AssetClient's thread, the caller should
 // receive events by connecting to signals on an object that lives on AssetClient's threads.
+//
+// The asset is sent in chunks that the asset-server appends to a temporary file. If the connection drops the upload
+// asks the asset-server how much it already has and picks up from there.
 
 class AssetUpload : public QObject {
     Q_OBJECT
@@ -52,10 +59,32 @@ signals:
     void progress(uint64_t totalReceived, uint64_t total);
     
 private:
+    bool sendChunk(DataOffset offset, DataOffset size);
+    void sendChunks();
+    void sendResumeProbe();
+    void handleChunkReply(int attempt, bool responseReceived, AssetServerError error, DataOffset bytesReceived,
+                          const QString& hash);
+    void scheduleResume();
+    void complete(Error error, const QString& hash = QString());
+    void finish();
+    
     QString _filename;
     QByteArray _data;
+    QFile _file; // uploads from disk are read a chunk at a time instead of being loaded up front
     QString _extension;
-    Error _error;
+    Error _error { NoError };
+    
+    QUuid _uploadID;
+    DataOffset _totalSize { 0 };
+    DataOffset _nextOffset { 0 };
+    int _numChunksInFlight { 0 };
+    int _attempt { 0 }; // bumped every time we resync with the asset-server, replies to older attempts are ignored
+    int _numRetries { 0 }; // consecutive retries without the asset-server acknowledging anything
+    bool _isResyncing { false };
+    bool _isResumeScheduled { false };
+    bool _isComplete { false };
+    bool _isFinished { false }; // finished is emitted exactly once, whichever path gets there first
+    QString _hash;
 };
 
 #endif // hifi_AssetUpload_h
@@ -27,6 +27,10 @@ QUrl getATPUrl(const QString& hash, const QString& extension) {
     }
 }
 
+bool isValidByteRange(DataOffset start, DataOffset end, qint64 assetSize) {
+    return start >= 0 && end > start && end <= assetSize;
+}
+
 QByteArray hashData(const QByteArray& data) {
     return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
 }
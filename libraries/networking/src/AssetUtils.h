@@ -24,16 +24,23 @@ const size_t SHA256_HASH_LENGTH = 32;
 const size_t SHA256_HASH_HEX_LENGTH = 64;
 const uint64_t MAX_UPLOAD_SIZE = 1000 * 1000 * 1000; // 1GB
 
+// uploads and downloads are split into requests of this size so that a dropped connection only costs one chunk
+const DataOffset ASSET_TRANSFER_CHUNK_SIZE = 1024 * 1024; // 1MB
+
 enum AssetServerError : uint8_t {
     NoError = 0,
     AssetNotFound,
     InvalidByteRange,
     AssetTooLarge,
-    PermissionDenied
+    PermissionDenied,
+    FileOperationFailed
 };
 
 QUrl getATPUrl(const QString& hash, const QString& extension = QString());
 
+// whether [start, end) is a non-empty range of bytes in an asset of assetSize bytes, start and end come off the wire
+bool isValidByteRange(DataOffset start, DataOffset end, qint64 assetSize);
+
 QByteArray hashData(const QByteArray& data);
 
 QByteArray loadFromCache(const QUrl& url);
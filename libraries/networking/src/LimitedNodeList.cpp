@@ -42,8 +42,6 @@ const char SOLO_NODE_TYPES[2] = {
 LimitedNodeList::LimitedNodeList(unsigned short socketListenPort, unsigned short dtlsListenPort) :
     linkedDataCreateCallback(NULL),
     _sessionUUID(),
-    _nodeHash(),
-    _nodeMutex(QReadWriteLock::Recursive),
     _nodeSocket(this),
     _dtlsSocket(NULL),
     _localSockAddr(),
@@ -213,16 +211,13 @@ bool LimitedNodeList::packetSourceAndHashMatch(const udt::Packet& packet) {
         QUuid sourceID = NLPacket::sourceIDInHeader(packet);
         
         // figure out which node this is from
-        SharedNodePointer matchingNode = nodeWithUUID(sourceID);
+        SharedNodePointer matchingNode = nodeForPacketSource(sourceID, packet.getSenderSockAddr());
         
         if (matchingNode) {
             if (!NON_VERIFIED_PACKETS.contains(headerType)) {
                 
-                QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(packet);
-                QByteArray expectedHash = NLPacket::hashForPacketAndSecret(packet, matchingNode->getConnectionSecret());
-            
-                // check if the md5 hash in the header matches the hash we would expect
-                if (packetHeaderHash != expectedHash) {
+                // check if the hash in the header matches the hash we would expect
+                if (!NLPacket::verificationHashMatches(packet, matchingNode->getConnectionSecret())) {
                     static QMultiMap<QUuid, PacketType> hashDebugSuppressMap;
                     
                     if (!hashDebugSuppressMap.contains(sourceID, headerType)) {
@@ -233,6 +228,8 @@ bool LimitedNodeList::packetSourceAndHashMatch(const udt::Packet& packet) {
 
                     return false;
                 }
+                
+                cachePacketSource(matchingNode, packet.getSenderSockAddr());
             }
 
             // No matter if this packet is handled or not, we update the timestamp for the last time we heard
@@ -412,6 +409,10 @@ qint64 LimitedNodeList::sendPacket(std::unique_ptr<NLPacket> packet, const Node&
 }
 
 int LimitedNodeList::updateNodeWithDataFromPacket(QSharedPointer<NLPacket> packet, SharedNodePointer sendingNode) {
+    return updateNodeWithDataFromPacket(*packet, sendingNode);
+}
+
+int LimitedNodeList::updateNodeWithDataFromPacket(NLPacket& packet, const SharedNodePointer& sendingNode) {
     QMutexLocker locker(&sendingNode->getMutex());
 
     NodeData* linkedData = sendingNode->getLinkedData();
@@ -421,32 +422,21 @@ int LimitedNodeList::updateNodeWithDataFromPacket(QSharedPointer<NLPacket> packe
 
     if (linkedData) {
         QMutexLocker linkedDataLocker(&linkedData->getMutex());
-        return linkedData->parseData(*packet);
+        return linkedData->parseData(packet);
     }
     
     return 0;
 }
 
 SharedNodePointer LimitedNodeList::nodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
-
-    NodeHash::const_iterator it = _nodeHash.find(nodeUUID);
-    return it == _nodeHash.cend() ? SharedNodePointer() : it->second;
- }
+    return _nodeTable.find(nodeUUID);
+}
 
 void LimitedNodeList::eraseAllNodes() {
     qCDebug(networking) << "Clearing the NodeList. Deleting all nodes in list.";
 
-    QSet<SharedNodePointer> killedNodes;
-    eachNode([&killedNodes](const SharedNodePointer& node){
-        killedNodes.insert(node);
-    });
-
-    {
-        // iterate the current nodes, emit that they are dying and remove them from the hash
-        QWriteLocker writeLocker(&_nodeMutex);
-        _nodeHash.clear();
-    }
+    // remove the current nodes from the table, then emit that they are dying
+    QList<SharedNodePointer> killedNodes = _nodeTable.clear();
     
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
@@ -461,19 +451,8 @@ void LimitedNodeList::reset() {
 }
 
 bool LimitedNodeList::killNodeWithUUID(const QUuid& nodeUUID) {
-    QReadLocker readLocker(&_nodeMutex);
-
-    NodeHash::iterator it = _nodeHash.find(nodeUUID);
-    if (it != _nodeHash.end()) {
-        SharedNodePointer matchingNode = it->second;
-
-        readLocker.unlock();
-        
-        {
-            QWriteLocker writeLocker(&_nodeMutex);
-            _nodeHash.unsafe_erase(it);
-        }
-        
+    SharedNodePointer matchingNode = _nodeTable.remove(nodeUUID);
+    if (matchingNode) {
         handleNodeKill(matchingNode);
         return true;
     }
@@ -489,7 +468,53 @@ void LimitedNodeList::processKillNode(NLPacket& packet) {
     killNodeWithUUID(nodeUUID);
 }
 
+SharedNodePointer LimitedNodeList::nodeForPacketSource(const QUuid& sourceID, const HifiSockAddr& senderSockAddr) {
+    int numKilledNodes = _numKilledNodes;
+    
+    if (numKilledNodes != _sourceNodeCacheKilledNodes) {
+        // a node has gone away since we filled the cache, don't hand it out for packets that claim to be from it
+        _sourceNodeCache.clear();
+        _sourceNodeCacheAddresses.clear();
+        _sourceNodeCacheKilledNodes = numKilledNodes;
+    }
+    
+    auto it = _sourceNodeCache.find(senderSockAddr);
+    
+    if (it != _sourceNodeCache.end() && it->second->getUUID() == sourceID) {
+        return it->second;
+    }
+    
+    return nodeWithUUID(sourceID);
+}
+
+void LimitedNodeList::cachePacketSource(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr) {
+    // only called once a packet from this address has passed verification, so a sender that just claims a known
+    // source ID can't add entries. Each node keeps at most one address, the one it last sent a verified packet from.
+    auto address = _sourceNodeCacheAddresses.find(node->getUUID());
+    if (address != _sourceNodeCacheAddresses.end()) {
+        if (address->second == senderSockAddr) {
+            return;
+        }
+        _sourceNodeCache.erase(address->second);
+        address->second = senderSockAddr;
+    } else {
+        _sourceNodeCacheAddresses.emplace(node->getUUID(), senderSockAddr);
+    }
+    
+    // another node may have sent from this address before, it loses its entry
+    auto previous = _sourceNodeCache.find(senderSockAddr);
+    if (previous != _sourceNodeCache.end()) {
+        _sourceNodeCacheAddresses.erase(previous->second->getUUID());
+        previous->second = node;
+    } else {
+        _sourceNodeCache.emplace(senderSockAddr, node);
+    }
+}
+
 void LimitedNodeList::handleNodeKill(const SharedNodePointer& node) {
+    // the node is already out of the table, so any lookup after this can't find it again
+    ++_numKilledNodes;
+    
     qCDebug(networking) << "Killed" << *node;
     node->stopPingTimer();
     emit nodeKilled(node);
@@ -503,10 +528,9 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
                                                    const HifiSockAddr& publicSocket, const HifiSockAddr& localSocket,
                                                    bool canAdjustLocks, bool canRez,
                                                    const QUuid& connectionSecret) {
-    NodeHash::const_iterator it = _nodeHash.find(uuid);
+    SharedNodePointer matchingNode = _nodeTable.find(uuid);
 
-    if (it != _nodeHash.end()) {
-        SharedNodePointer& matchingNode = it->second;
+    if (matchingNode) {
 
         matchingNode->setPublicSocket(publicSocket);
         matchingNode->setLocalSocket(localSocket);
@@ -525,7 +549,11 @@ SharedNodePointer LimitedNodeList::addOrUpdateNode(const QUuid& uuid, NodeType_t
 
         SharedNodePointer newNodePointer(newNode, &QObject::deleteLater);
 
-        _nodeHash.insert(UUIDNodePair(newNode->getUUID(), newNodePointer));
+        SharedNodePointer insertedNode = _nodeTable.insert(newNodePointer);
+        if (insertedNode != newNodePointer) {
+            // another thread added this node while we were creating it, use theirs
+            return insertedNode;
+        }
 
         qCDebug(networking) << "Added" << *newNode;
 
@@ -629,25 +657,14 @@ void LimitedNodeList::resetPacketStats() {
 
 void LimitedNodeList::removeSilentNodes() {
 
-    QSet<SharedNodePointer> killedNodes;
-
-    eachNodeHashIterator([&](NodeHash::iterator& it){
-        SharedNodePointer node = it->second;
-        node->getMutex().lock();
-
-        if ((usecTimestampNow() - node->getLastHeardMicrostamp()) > (NODE_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC)) {
-            // call the NodeHash erase to get rid of this node
-            it = _nodeHash.unsafe_erase(it);
-
-            killedNodes.insert(node);
-        } else {
-            // we didn't erase this node, push the iterator forwards
-            ++it;
-        }
-
-        node->getMutex().unlock();
+    QList<SharedNodePointer> killedNodes = _nodeTable.removeIf([](const SharedNodePointer& node) {
+        QMutexLocker locker(&node->getMutex());
+        return (usecTimestampNow() - node->getLastHeardMicrostamp()) > (NODE_SILENCE_THRESHOLD_MSECS * USECS_PER_MSEC);
     });
 
+    // let go of the nodes removed since we were last here, even if the table hasn't changed since
+    _nodeTable.reclaim();
+
     foreach(const SharedNodePointer& killedNode, killedNodes) {
         handleNodeKill(killedNode);
     }
@@ -885,11 +902,9 @@ void LimitedNodeList::sendPeerQueryToIceServer(const HifiSockAddr& iceServerSock
 }
 
 SharedNodePointer LimitedNodeList::findNodeWithAddr(const HifiSockAddr& addr) {
-    QReadLocker locker(&_nodeMutex);
-    auto it = std::find_if(std::begin(_nodeHash), std::end(_nodeHash), [&](const UUIDNodePair& pair) {
-        return pair.second->getActiveSocket() ? (*pair.second->getActiveSocket() == addr) : false;
+    return nodeMatchingPredicate([&](const SharedNodePointer& node) {
+        return node->getActiveSocket() ? (*node->getActiveSocket() == addr) : false;
     });
-    return (it != std::end(_nodeHash)) ? it->second : SharedNodePointer();
 }
 
 void LimitedNodeList::sendPacketToIceServer(PacketType packetType, const HifiSockAddr& iceServerSockAddr,
@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <stdint.h>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <unordered_map>
@@ -30,8 +31,6 @@
 #include <QtNetwork/QUdpSocket>
 #include <QtNetwork/QHostAddress>
 
-#include <tbb/concurrent_unordered_map.h>
-
 #include <DependencyManager.h>
 
 #include "DomainHandler.h"
@@ -39,6 +38,7 @@
 #include "NLPacket.h"
 #include "PacketReceiver.h"
 #include "NLPacketList.h"
+#include "NodeTable.h"
 #include "udt/PacketHeaders.h"
 #include "udt/Socket.h"
 #include "UUIDHasher.h"
@@ -60,10 +60,6 @@ const QHostAddress DEFAULT_ASSIGNMENT_CLIENT_MONITOR_HOSTNAME = QHostAddress::Lo
 
 const QString USERNAME_UUID_REPLACEMENT_STATS_KEY = "$username";
 
-using namespace tbb;
-typedef std::pair<QUuid, SharedNodePointer> UUIDNodePair;
-typedef concurrent_unordered_map<QUuid, SharedNodePointer, UUIDHasher> NodeHash;
-
 typedef quint8 PingType_t;
 namespace PingType {
     const PingType_t Agnostic = 0;
@@ -72,6 +68,15 @@ namespace PingType {
     const PingType_t Symmetric = 3;
 }
 
+// every node entry of a PacketType::DomainList starts with one of these
+typedef quint8 DomainListEntry_t;
+namespace DomainListEntry {
+    // followed by the node and the connection secret to use with it
+    const DomainListEntry_t AddedNode = 0;
+    // followed by the UUID of a node that has left the domain
+    const DomainListEntry_t RemovedNode = 1;
+}
+
 class LimitedNodeList : public QObject, public Dependency {
     Q_OBJECT
     SINGLETON_DEPENDENCY
@@ -128,9 +133,13 @@ public:
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const HifiSockAddr& sockAddr);
     qint64 sendPacketList(std::unique_ptr<NLPacketList> packetList, const Node& destinationNode);
 
+    // unreliable packets sent from the calling thread between these two calls go out to the socket together on flush
+    void beginSendBatch() { _nodeSocket.beginSendBatch(); }
+    qint64 flushSendBatch() { return _nodeSocket.flushSendBatch(); }
+
     void (*linkedDataCreateCallback)(Node *);
 
-    int size() const { return _nodeHash.size(); }
+    int size() const { return _nodeTable.size(); }
 
     SharedNodePointer nodeWithUUID(const QUuid& nodeUUID);
 
@@ -147,6 +156,7 @@ public:
     void processKillNode(NLPacket& packet);
 
     int updateNodeWithDataFromPacket(QSharedPointer<NLPacket> packet, SharedNodePointer matchingNode);
+    int updateNodeWithDataFromPacket(NLPacket& packet, const SharedNodePointer& matchingNode);
 
     unsigned int broadcastToNodes(std::unique_ptr<NLPacket> packet, const NodeSet& destinationNodeTypes);
     SharedNodePointer soloNodeOfType(NodeType_t nodeType);
@@ -165,48 +175,38 @@ public:
 
     SharedNodePointer findNodeWithAddr(const HifiSockAddr& addr);
     
+    // the node iterators work on a snapshot of the node list, and never wait on nodes being added or removed
+
     template<typename NodeLambda>
     void eachNode(NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
-
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            functor(it->second);
-        }
+        _nodeTable.forEach(functor);
     }
 
     template<typename PredLambda, typename NodeLambda>
     void eachMatchingNode(PredLambda predicate, NodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
-
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                functor(it->second);
+        _nodeTable.forEach([&](const SharedNodePointer& node) {
+            if (predicate(node)) {
+                functor(node);
             }
-        }
+        });
     }
 
     template<typename BreakableNodeLambda>
     void eachNodeBreakable(BreakableNodeLambda functor) {
-        QReadLocker readLock(&_nodeMutex);
-
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (!functor(it->second)) {
-                break;
-            }
-        }
+        _nodeTable.forEachBreakable(functor);
     }
 
     template<typename PredLambda>
     SharedNodePointer nodeMatchingPredicate(const PredLambda predicate) {
-        QReadLocker readLock(&_nodeMutex);
-
-        for (NodeHash::const_iterator it = _nodeHash.cbegin(); it != _nodeHash.cend(); ++it) {
-            if (predicate(it->second)) {
-                return it->second;
+        SharedNodePointer matchingNode;
+        _nodeTable.forEachBreakable([&](const SharedNodePointer& node) {
+            if (predicate(node)) {
+                matchingNode = node;
+                return false;
             }
-        }
-
-        return SharedNodePointer();
+            return true;
+        });
+        return matchingNode;
     }
 
     void putLocalPortIntoSharedMemory(const QString key, QObject* parent, quint16 localPort);
@@ -261,6 +261,8 @@ protected:
     bool isPacketVerified(const udt::Packet& packet);
     bool packetVersionMatch(const udt::Packet& packet);
     bool packetSourceAndHashMatch(const udt::Packet& packet);
+    SharedNodePointer nodeForPacketSource(const QUuid& sourceID, const HifiSockAddr& senderSockAddr);
+    void cachePacketSource(const SharedNodePointer& node, const HifiSockAddr& senderSockAddr);
     void processSTUNResponse(std::unique_ptr<udt::BasePacket> packet);
 
     void handleNodeKill(const SharedNodePointer& node);
@@ -273,8 +275,8 @@ protected:
 
 
     QUuid _sessionUUID;
-    NodeHash _nodeHash;
-    QReadWriteLock _nodeMutex;
+    NodeTable _nodeTable;
+    std::atomic<int> _numKilledNodes { 0 }; // bumped after a node is gone from _nodeTable, invalidates _sourceNodeCache
     udt::Socket _nodeSocket;
     QUdpSocket* _dtlsSocket;
     HifiSockAddr _localSockAddr;
@@ -283,6 +285,12 @@ protected:
 
     PacketReceiver* _packetReceiver;
 
+    // sender socket -> node that last sent a verified packet from it, spares packet verification the node table lookup
+    // only used from the socket's thread by packetSourceAndHashMatch
+    std::unordered_map<HifiSockAddr, SharedNodePointer> _sourceNodeCache;
+    std::unordered_map<QUuid, HifiSockAddr> _sourceNodeCacheAddresses; // node -> its one entry in _sourceNodeCache
+    int _sourceNodeCacheKilledNodes = 0;
+
     // XXX can BandwidthRecorder be used for this?
     int _numCollectedPackets;
     int _numCollectedBytes;
@@ -301,16 +309,6 @@ protected:
     QMap<quint64, ConnectionStep> _lastConnectionTimes;
     bool _areConnectionTimesComplete = false;
 
-    template<typename IteratorLambda>
-    void eachNodeHashIterator(IteratorLambda functor) {
-        QWriteLocker writeLock(&_nodeMutex);
-        NodeHash::iterator it = _nodeHash.begin();
-
-        while (it != _nodeHash.end()) {
-            functor(it);
-        }
-    }
-    
 private slots:
     void flagTimeForConnectionStep(ConnectionStep connectionStep, quint64 timestamp);
     void possiblyTimeoutSTUNAddressLookup();
@@ -11,10 +11,37 @@
 
 #include "NLPacket.h"
 
+#include "SipHash.h"
+
+static_assert(NUM_BYTES_VERIFICATION_HASH == NUM_BYTES_SIPHASH_128, "Verification hash is a 128-bit SipHash");
+
+static int verificationHashOffset(const udt::Packet& packet) {
+    return udt::Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
+        + NUM_BYTES_RFC4122_UUID;
+}
+
+static void computeHashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret, uint8_t* hash) {
+    // the connection secret is the key, laid out in RFC 4122 byte order without going through a QByteArray
+    uint8_t key[NUM_BYTES_SIPHASH_KEY];
+    key[0] = (uint8_t) (connectionSecret.data1 >> 24);
+    key[1] = (uint8_t) (connectionSecret.data1 >> 16);
+    key[2] = (uint8_t) (connectionSecret.data1 >> 8);
+    key[3] = (uint8_t) connectionSecret.data1;
+    key[4] = (uint8_t) (connectionSecret.data2 >> 8);
+    key[5] = (uint8_t) connectionSecret.data2;
+    key[6] = (uint8_t) (connectionSecret.data3 >> 8);
+    key[7] = (uint8_t) connectionSecret.data3;
+    memcpy(key + 8, connectionSecret.data4, sizeof(connectionSecret.data4));
+    
+    // the hash covers everything following it in the packet
+    int offset = verificationHashOffset(packet) + NUM_BYTES_VERIFICATION_HASH;
+    sipHash128(key, packet.getData() + offset, packet.getDataSize() - offset, hash);
+}
+
 int NLPacket::localHeaderSize(PacketType type) {
     bool nonSourced = NON_SOURCED_PACKETS.contains(type);
     bool nonVerified = NON_VERIFIED_PACKETS.contains(type);
-    qint64 optionalSize = (nonSourced ? 0 : NUM_BYTES_RFC4122_UUID) + ((nonSourced || nonVerified) ? 0 : NUM_BYTES_MD5_HASH);
+    qint64 optionalSize = (nonSourced ? 0 : NUM_BYTES_RFC4122_UUID) + ((nonSourced || nonVerified) ? 0 : NUM_BYTES_VERIFICATION_HASH);
     return sizeof(PacketType) + sizeof(PacketVersion) + optionalSize;
 }
 int NLPacket::totalHeaderSize(PacketType type, bool isPartOfMessage) {
@@ -32,7 +59,7 @@ std::unique_ptr<NLPacket> NLPacket::create(PacketType type, qint64 size, bool is
     return packet;
 }
 
-std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(std::unique_ptr<char[]> data, qint64 size,
+std::unique_ptr<NLPacket> NLPacket::fromReceivedPacket(udt::PacketData data, qint64 size,
                                                        const HifiSockAddr& senderSockAddr) {
     // Fail with null data
     Q_ASSERT(data);
@@ -87,7 +114,7 @@ NLPacket::NLPacket(const NLPacket& other) : Packet(other) {
     _sourceID = other._sourceID;
 }
 
-NLPacket::NLPacket(std::unique_ptr<char[]> data, qint64 size, const HifiSockAddr& senderSockAddr) :
+NLPacket::NLPacket(udt::PacketData data, qint64 size, const HifiSockAddr& senderSockAddr) :
     Packet(std::move(data), size, senderSockAddr)
 {    
     // sanity check before we decrease the payloadSize with the payloadCapacity
@@ -145,22 +172,20 @@ QUuid NLPacket::sourceIDInHeader(const udt::Packet& packet) {
 }
 
 QByteArray NLPacket::verificationHashInHeader(const udt::Packet& packet) {
-    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion) + NUM_BYTES_RFC4122_UUID;
-    return QByteArray(packet.getData() + offset, NUM_BYTES_MD5_HASH);
+    return QByteArray(packet.getData() + verificationHashOffset(packet), NUM_BYTES_VERIFICATION_HASH);
 }
 
 QByteArray NLPacket::hashForPacketAndSecret(const udt::Packet& packet, const QUuid& connectionSecret) {
-    QCryptographicHash hash(QCryptographicHash::Md5);
-    
-    int offset = Packet::totalHeaderSize(packet.isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
-        + NUM_BYTES_RFC4122_UUID + NUM_BYTES_MD5_HASH;
-    
-    // add the packet payload and the connection UUID
-    hash.addData(packet.getData() + offset, packet.getDataSize() - offset);
-    hash.addData(connectionSecret.toRfc4122());
+    QByteArray hash(NUM_BYTES_VERIFICATION_HASH, 0);
+    computeHashForPacketAndSecret(packet, connectionSecret, reinterpret_cast<uint8_t*>(hash.data()));
+    return hash;
+}
+
+bool NLPacket::verificationHashMatches(const udt::Packet& packet, const QUuid& connectionSecret) {
+    uint8_t expectedHash[NUM_BYTES_VERIFICATION_HASH];
+    computeHashForPacketAndSecret(packet, connectionSecret, expectedHash);
     
-    // return the hash
-    return hash.result();
+    return memcmp(packet.getData() + verificationHashOffset(packet), expectedHash, NUM_BYTES_VERIFICATION_HASH) == 0;
 }
 
 void NLPacket::writeTypeAndVersion() {
@@ -210,9 +235,6 @@ void NLPacket::writeSourceID(const QUuid& sourceID) const {
 void NLPacket::writeVerificationHashGivenSecret(const QUuid& connectionSecret) const {
     Q_ASSERT(!NON_SOURCED_PACKETS.contains(_type) && !NON_VERIFIED_PACKETS.contains(_type));
     
-    auto offset = Packet::totalHeaderSize(isPartOfMessage()) + sizeof(PacketType) + sizeof(PacketVersion)
-                + NUM_BYTES_RFC4122_UUID;
-    QByteArray verificationHash = hashForPacketAndSecret(*this, connectionSecret);
-    
-    memcpy(_packet.get() + offset, verificationHash.data(), verificationHash.size());
+    computeHashForPacketAndSecret(*this, connectionSecret,
+                                  reinterpret_cast<uint8_t*>(_packet.get() + verificationHashOffset(*this)));
 }
@@ -23,6 +23,9 @@ public:
     
     static std::unique_ptr<NLPacketList> fromPacketList(std::unique_ptr<PacketList>);
 
+    // copies the closed packets of other, so a message written once can be sent to many nodes
+    static std::unique_ptr<NLPacketList> createCopy(const NLPacketList& other);
+
     const QUuid& getSourceID() const { return _sourceID; }
     
 private:
@@ -202,6 +202,7 @@ void NodeList::reset() {
     LimitedNodeList::reset();
 
     _numNoReplyDomainCheckIns = 0;
+    _domainListVersion = 0;
 
     // refresh the owner UUID to the NULL UUID
     setSessionUUID(QUuid());
@@ -283,6 +284,11 @@ void NodeList::sendDomainServerCheckIn() {
 
         // pack our data to send to the domain-server
         packetStream << _ownerType << _publicSockAddr << _localSockAddr << _nodeTypesOfInterest.toList();
+
+        if (domainPacketType == PacketType::DomainListRequest) {
+            // tell the domain-server which list we have, so it only needs to send us what changed since
+            packetStream << _domainListVersion;
+        }
         
         // if this is a connect request, and we can present a username signature, send it along
         if (!_domainHandler.isConnected() ) {
@@ -510,10 +516,39 @@ void NodeList::processDomainServerList(QSharedPointer<NLPacket> packet) {
     quint8 thisNodeCanRez;
     packetStream >> thisNodeCanRez;
     setThisNodeCanRez((bool) thisNodeCanRez);
+
+    quint32 listVersion;
+    packetStream >> listVersion;
+
+    // a list of changes is only good on top of the version it was made from - the other packets of the same list
+    // will already have moved us on to the version it brings us to
+    quint32 baseVersion;
+    packetStream >> baseVersion;
+
+    if (baseVersion != 0 && listVersion < _domainListVersion) {
+        // changes we have already moved past, that were held up on the way
+        return;
+    } else if (baseVersion != 0 && baseVersion != _domainListVersion && listVersion != _domainListVersion) {
+        qCDebug(networking) << "Domain list changes from version" << baseVersion << "don't apply to version"
+            << _domainListVersion << "- will ask for the full list.";
+        _domainListVersion = 0;
+        return;
+    }
+
+    _domainListVersion = listVersion;
     
     // pull each node in the packet
     while (packetStream.device()->pos() < packet->getPayloadSize()) {
-        parseNodeFromPacketStream(packetStream);
+        DomainListEntry_t entryType;
+        packetStream >> entryType;
+
+        if (entryType == DomainListEntry::RemovedNode) {
+            QUuid nodeUUID;
+            packetStream >> nodeUUID;
+            killNodeWithUUID(nodeUUID);
+        } else {
+            parseNodeFromPacketStream(packetStream);
+        }
     }
 }
 
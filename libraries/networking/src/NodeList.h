@@ -119,6 +119,7 @@ private:
     NodeSet _nodeTypesOfInterest;
     DomainHandler _domainHandler;
     int _numNoReplyDomainCheckIns;
+    quint32 _domainListVersion { 0 }; // last version of the domain list we applied, 0 asks for the full list
     HifiSockAddr _assignmentServerSocket;
     bool _isShuttingDown { false };
     QTimer _keepAlivePingTimer;
@@ -0,0 +1,134 @@
+//
+//  NodeTable.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeTable.h"
+
+#include <functional>
+#include <thread>
+
+NodeTable::NodeTable() :
+    _nodes(new NodeMap()),
+    _generation(0)
+{
+    for (auto& stripe : _readers) {
+        stripe.counts[0] = 0;
+        stripe.counts[1] = 0;
+    }
+}
+
+NodeTable::~NodeTable() {
+    for (auto& retired : _retired) {
+        delete retired.second;
+    }
+    delete _nodes.load();
+}
+
+std::atomic<int>* NodeTable::enterRead() const {
+    static const std::hash<std::thread::id> threadHash;
+    ReaderStripe& stripe = _readers[threadHash(std::this_thread::get_id()) % NUM_READER_STRIPES];
+
+    while (true) {
+        quint64 generation = _generation.load();
+        std::atomic<int>& count = stripe.counts[generation & 1];
+        count.fetch_add(1);
+
+        // if the generation moved on before we were counted, a writer may not have seen us - count us in the new one
+        if (_generation.load() == generation) {
+            return &count;
+        }
+        count.fetch_sub(1);
+    }
+}
+
+bool NodeTable::hasReadersInGeneration(quint64 generation) const {
+    for (auto& stripe : _readers) {
+        if (stripe.counts[generation & 1].load() != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SharedNodePointer NodeTable::find(const QUuid& uuid) const {
+    ReadSection section(*this);
+    auto it = section.nodes->find(uuid);
+    return it == section.nodes->cend() ? SharedNodePointer() : it->second;
+}
+
+int NodeTable::size() const {
+    ReadSection section(*this);
+    return (int)section.nodes->size();
+}
+
+SharedNodePointer NodeTable::insert(const SharedNodePointer& node) {
+    QMutexLocker locker(&_writeMutex);
+
+    const NodeMap* nodes = _nodes.load();
+    auto it = nodes->find(node->getUUID());
+    if (it != nodes->cend()) {
+        return it->second;
+    }
+
+    NodeMap* newNodes = new NodeMap(*nodes);
+    newNodes->insert({ node->getUUID(), node });
+    publish(newNodes);
+
+    return node;
+}
+
+SharedNodePointer NodeTable::remove(const QUuid& uuid) {
+    QMutexLocker locker(&_writeMutex);
+
+    const NodeMap* nodes = _nodes.load();
+    auto it = nodes->find(uuid);
+    if (it == nodes->cend()) {
+        return SharedNodePointer();
+    }
+
+    SharedNodePointer removedNode = it->second;
+
+    NodeMap* newNodes = new NodeMap(*nodes);
+    newNodes->erase(uuid);
+    publish(newNodes);
+
+    return removedNode;
+}
+
+QList<SharedNodePointer> NodeTable::clear() {
+    return removeIf([](const SharedNodePointer& node) { return true; });
+}
+
+void NodeTable::reclaim() {
+    QMutexLocker locker(&_writeMutex);
+    reclaimLocked();
+}
+
+void NodeTable::publish(NodeMap* newNodes) {
+    const NodeMap* oldNodes = _nodes.exchange(newNodes);
+    _retired.push_back({ _generation.load(), oldNodes });
+    reclaimLocked();
+}
+
+void NodeTable::reclaimLocked() {
+    // Readers are counted against the generation they entered in. We only move to the next generation once nobody is
+    // left in the previous one, so at generation G every reader from G - 2 or before is gone, and with it anyone who
+    // could have loaded a snapshot replaced in G - 2.
+    quint64 generation = _generation.load();
+    while (!_retired.empty() && generation < _retired.back().first + 2 && !hasReadersInGeneration(generation + 1)) {
+        _generation.store(++generation);
+    }
+
+    auto firstKept = _retired.begin();
+    while (firstKept != _retired.end() && firstKept->first + 2 <= generation) {
+        delete firstKept->second;
+        ++firstKept;
+    }
+    _retired.erase(_retired.begin(), firstKept);
+}
@@ -0,0 +1,142 @@
+//
+//  NodeTable.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_NodeTable_h
+#define hifi_NodeTable_h
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+
+#include <UUIDHasher.h>
+
+#include "Node.h"
+
+using NodeMap = std::unordered_map<QUuid, SharedNodePointer, UUIDHasher>;
+
+/// The nodes of a LimitedNodeList, readable from any thread without taking a lock.
+///
+/// Readers work on an immutable snapshot of the table. Writers are serialized, copy the current snapshot, change the
+/// copy and publish it in place of the old one, so a reader never waits on a writer and iteration always sees a
+/// consistent set of nodes. Replaced snapshots are freed once every reader that could still be looking at them has
+/// left, which readers report on a few striped counters rather than one shared lock.
+class NodeTable {
+public:
+    NodeTable();
+    ~NodeTable();
+
+    SharedNodePointer find(const QUuid& uuid) const;
+    int size() const;
+
+    // functor sees the nodes as they were when it started, and may safely add or remove nodes itself
+    template<typename NodeLambda>
+    void forEach(NodeLambda functor) const {
+        ReadSection section(*this);
+        for (auto it = section.nodes->cbegin(); it != section.nodes->cend(); ++it) {
+            functor(it->second);
+        }
+    }
+
+    // stops once functor returns false
+    template<typename BreakableNodeLambda>
+    void forEachBreakable(BreakableNodeLambda functor) const {
+        ReadSection section(*this);
+        for (auto it = section.nodes->cbegin(); it != section.nodes->cend(); ++it) {
+            if (!functor(it->second)) {
+                break;
+            }
+        }
+    }
+
+    /// adds node unless there is already a node with its UUID, and returns whichever node is now in the table
+    SharedNodePointer insert(const SharedNodePointer& node);
+
+    /// returns the removed node, or a null pointer if there was none with that UUID
+    SharedNodePointer remove(const QUuid& uuid);
+
+    /// removes the nodes predicate returns true for, and returns them
+    template<typename PredLambda>
+    QList<SharedNodePointer> removeIf(PredLambda predicate);
+
+    /// removes and returns all the nodes
+    QList<SharedNodePointer> clear();
+
+    /// frees replaced snapshots no reader can still be using. Writers do this on their own, calling it regularly
+    /// just lets go of removed nodes sooner when the table isn't changing.
+    void reclaim();
+
+private:
+    NodeTable(const NodeTable& other) = delete;
+    NodeTable& operator=(const NodeTable& other) = delete;
+
+    // marks the calling thread as reading for as long as it is alive
+    class ReadSection {
+    public:
+        ReadSection(const NodeTable& table) : counter(table.enterRead()), nodes(table._nodes.load()) {}
+        ~ReadSection() { counter->fetch_sub(1); }
+
+        std::atomic<int>* counter;
+        const NodeMap* nodes;
+    };
+
+    struct ReaderStripe {
+        // one count for readers that entered during an even generation, one for an odd one
+        std::atomic<int> counts[2];
+        char padding[64 - 2 * sizeof(std::atomic<int>)]; // keep each stripe on its own cache line
+    };
+
+    std::atomic<int>* enterRead() const;
+    bool hasReadersInGeneration(quint64 generation) const;
+
+    // called with _writeMutex held
+    void publish(NodeMap* newNodes);
+    void reclaimLocked();
+
+    static const int NUM_READER_STRIPES = 16;
+    mutable ReaderStripe _readers[NUM_READER_STRIPES];
+
+    std::atomic<const NodeMap*> _nodes;
+    std::atomic<quint64> _generation;
+
+    QMutex _writeMutex;
+    std::vector<std::pair<quint64, const NodeMap*>> _retired; // snapshot and the generation it was replaced in
+};
+
+template<typename PredLambda>
+QList<SharedNodePointer> NodeTable::removeIf(PredLambda predicate) {
+    QMutexLocker locker(&_writeMutex);
+
+    QList<SharedNodePointer> removedNodes;
+    NodeMap* newNodes = new NodeMap(*_nodes.load());
+
+    for (auto it = newNodes->begin(); it != newNodes->end();) {
+        if (predicate(it->second)) {
+            removedNodes << it->second;
+            it = newNodes->erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (removedNodes.isEmpty()) {
+        delete newNodes;
+    } else {
+        publish(newNodes);
+    }
+
+    return removedNodes;
+}
+
+#endif // hifi_NodeTable_h
@@ -15,6 +15,7 @@
 #include <QMutexLocker>
 
 #include "DependencyManager.h"
+#include "LogHandler.h"
 #include "NetworkLogging.h"
 #include "NodeList.h"
 #include "SharedUtil.h"
@@ -134,6 +135,29 @@ bool PacketReceiver::registerListener(PacketType type, QObject* listener, const
     }
 }
 
+void PacketReceiver::registerQueuedListenerForTypes(PacketTypeList types, QObject* listener, PacketQueue* queue) {
+    Q_ASSERT_X(!types.empty(), "PacketReceiver::registerQueuedListenerForTypes", "No types to register");
+    Q_ASSERT_X(listener, "PacketReceiver::registerQueuedListenerForTypes", "No object to register");
+    Q_ASSERT_X(queue, "PacketReceiver::registerQueuedListenerForTypes", "No queue to register");
+
+    QMutexLocker locker(&_packetListenerLock);
+
+    for (PacketType type : types) {
+        Q_ASSERT_X(!NON_SOURCED_PACKETS.contains(type), "PacketReceiver::registerQueuedListenerForTypes",
+                   "Only sourced packets can be queued");
+
+        if (_packetListenerMap.contains(type) || _packetQueueMap.contains(type)) {
+            qCWarning(networking) << "Registering a queued packet listener for packet type" << type
+                << "that will remove a previously registered listener";
+            _packetListenerMap.remove(type);
+        }
+
+        _packetQueueMap[type] = ObjectQueuePair(QPointer<QObject>(listener), queue);
+
+        qCDebug(networking) << "Registering a queued packet listener for packet type" << type;
+    }
+}
+
 QMetaMethod PacketReceiver::matchingMethodForListener(PacketType type, QObject* object, const char* slot) const {
     Q_ASSERT_X(object, "PacketReceiver::matchingMethodForListener", "No object to call");
     Q_ASSERT_X(slot, "PacketReceiver::matchingMethodForListener", "No slot to call");
@@ -228,6 +252,17 @@ void PacketReceiver::unregisterListener(QObject* listener) {
             }
         }
         
+        // clear any registrations for this listener in _packetQueueMap, after which nothing is pushed to its queue
+        auto queueIt = _packetQueueMap.begin();
+        
+        while (queueIt != _packetQueueMap.end()) {
+            if (queueIt.value().first == listener) {
+                queueIt = _packetQueueMap.erase(queueIt);
+            } else {
+                ++queueIt;
+            }
+        }
+        
         // clear any registrations for this listener in _packetListListener
         auto listIt = _packetListListenerMap.begin();
         
@@ -386,6 +421,10 @@ void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
     
     QMutexLocker packetListenerLocker(&_packetListenerLock);
     
+    if (queueVerifiedPacket(nlPacket, matchingNode)) {
+        return;
+    }
+    
     bool listenerIsDead = false;
     
     auto it = _packetListenerMap.find(nlPacket->getType());
@@ -480,3 +519,40 @@ void PacketReceiver::handleVerifiedPacket(std::unique_ptr<udt::Packet> packet) {
         _packetListenerMap.insert(nlPacket->getType(), { nullptr, QMetaMethod() });
     }
 }
+
+bool PacketReceiver::queueVerifiedPacket(std::unique_ptr<NLPacket>& packet, const SharedNodePointer& matchingNode) {
+    // called with _packetListenerLock held
+    auto it = _packetQueueMap.find(packet->getType());
+    
+    if (it == _packetQueueMap.end()) {
+        return false;
+    }
+    
+    if (!it.value().first) {
+        qCDebug(networking).nospace() << "Queued listener for packet " << packet->getType()
+            << " has been destroyed. Removing from queue map.";
+        _packetQueueMap.erase(it);
+        return false;
+    }
+    
+    if (!matchingNode) {
+        // without a node there is nothing for the listener to attribute this packet to
+        emit dataReceived(NodeType::Unassigned, packet->getDataSize());
+        return true;
+    }
+    
+    emit dataReceived(matchingNode->getType(), packet->getDataSize());
+    matchingNode->recordBytesReceived(packet->getDataSize());
+    
+    PacketType packetType = packet->getType();
+    
+    if (!it.value().second->push({ std::move(packet), matchingNode })) {
+        static const QString QUEUE_FULL_REGEX = "PacketReceiver dropped a packet of type [0-9]+, its queue is full";
+        static QString repeatedMessage = LogHandler::getInstance().addRepeatedMessageRegex(QUEUE_FULL_REGEX);
+        
+        qCDebug(networking).nospace() << "PacketReceiver dropped a packet of type " << (int) packetType
+            << ", its queue is full";
+    }
+    
+    return true;
+}
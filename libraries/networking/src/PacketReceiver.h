@@ -22,8 +22,11 @@
 #include <QtCore/QPointer>
 #include <QtCore/QSet>
 
+#include <SPSCQueue.h>
+
 #include "NLPacket.h"
 #include "NLPacketList.h"
+#include "Node.h"
 #include "udt/PacketHeaders.h"
 
 class EntityEditPacketSender;
@@ -33,6 +36,12 @@ class PacketReceiver : public QObject {
     Q_OBJECT
 public:
     using PacketTypeList = std::vector<PacketType>;
+
+    struct QueuedPacket {
+        std::unique_ptr<NLPacket> packet;
+        SharedNodePointer sendingNode;
+    };
+    using PacketQueue = SPSCQueue<QueuedPacket>;
     
     PacketReceiver(QObject* parent = 0);
     PacketReceiver(const PacketReceiver&) = delete;
@@ -49,6 +58,12 @@ public:
     bool registerListenerForTypes(PacketTypeList types, QObject* listener, const char* slot);
     bool registerMessageListener(PacketType type, QObject* listener, const char* slot);
     bool registerListener(PacketType type, QObject* listener, const char* slot);
+
+    // Packets of these types from known nodes are pushed onto queue by the thread reading the socket, instead of being
+    // invoked on listener through its event loop. The listener drains the queue from its own thread whenever suits it.
+    // Packets are dropped if the queue is full or the sender isn't a known node.
+    void registerQueuedListenerForTypes(PacketTypeList types, QObject* listener, PacketQueue* queue);
+
     void unregisterListener(QObject* listener);
     
     void handleVerifiedPacket(std::unique_ptr<udt::Packet> packet);
@@ -66,12 +81,16 @@ private:
     QMetaMethod matchingMethodForListener(PacketType type, QObject* object, const char* slot) const;
     void registerVerifiedListener(PacketType type, QObject* listener, const QMetaMethod& slot);
     
+    bool queueVerifiedPacket(std::unique_ptr<NLPacket>& packet, const SharedNodePointer& matchingNode);
+
     using ObjectMethodPair = std::pair<QPointer<QObject>, QMetaMethod>;
+    using ObjectQueuePair = std::pair<QPointer<QObject>, PacketQueue*>;
 
     QMutex _packetListenerLock;
     // TODO: replace the two following hashes with an std::vector once we switch Packet/PacketList to Message
     QHash<PacketType, ObjectMethodPair> _packetListenerMap;
     QHash<PacketType, ObjectMethodPair> _packetListListenerMap;
+    QHash<PacketType, ObjectQueuePair> _packetQueueMap;
     int _inPacketCount = 0;
     int _inByteCount = 0;
     bool _shouldDropPackets = false;
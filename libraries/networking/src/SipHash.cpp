@@ -0,0 +1,87 @@
+//
+//  SipHash.cpp
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SipHash.h"
+
+// follows the reference implementation by Jean-Philippe Aumasson and Daniel J. Bernstein
+
+static inline uint64_t rotateLeft(uint64_t x, int bits) {
+    return (x << bits) | (x >> (64 - bits));
+}
+
+static inline uint64_t readLittleEndian64(const uint8_t* bytes) {
+    return ((uint64_t) bytes[0]) | ((uint64_t) bytes[1] << 8) | ((uint64_t) bytes[2] << 16) | ((uint64_t) bytes[3] << 24)
+        | ((uint64_t) bytes[4] << 32) | ((uint64_t) bytes[5] << 40) | ((uint64_t) bytes[6] << 48)
+        | ((uint64_t) bytes[7] << 56);
+}
+
+static inline void writeLittleEndian64(uint64_t value, uint8_t* bytes) {
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = (uint8_t) (value >> (8 * i));
+    }
+}
+
+#define SIPROUND \
+    do { \
+        v0 += v1; v1 = rotateLeft(v1, 13); v1 ^= v0; v0 = rotateLeft(v0, 32); \
+        v2 += v3; v3 = rotateLeft(v3, 16); v3 ^= v2; \
+        v0 += v3; v3 = rotateLeft(v3, 21); v3 ^= v0; \
+        v2 += v1; v1 = rotateLeft(v1, 17); v1 ^= v2; v2 = rotateLeft(v2, 32); \
+    } while (0)
+
+void sipHash128(const uint8_t key[NUM_BYTES_SIPHASH_KEY], const void* data, size_t length,
+                uint8_t hash[NUM_BYTES_SIPHASH_128]) {
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+    
+    uint64_t k0 = readLittleEndian64(key);
+    uint64_t k1 = readLittleEndian64(key + 8);
+    
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1 ^ 0xee;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+    
+    const uint8_t* end = input + (length - (length % 8));
+    
+    for (; input != end; input += 8) {
+        uint64_t m = readLittleEndian64(input);
+        
+        v3 ^= m;
+        SIPROUND;
+        SIPROUND;
+        v0 ^= m;
+    }
+    
+    // the last block holds the leftover bytes and the low byte of the length
+    uint64_t b = ((uint64_t) length) << 56;
+    
+    for (size_t i = 0; i < length % 8; ++i) {
+        b |= ((uint64_t) input[i]) << (8 * i);
+    }
+    
+    v3 ^= b;
+    SIPROUND;
+    SIPROUND;
+    v0 ^= b;
+    
+    v2 ^= 0xee;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    writeLittleEndian64(v0 ^ v1 ^ v2 ^ v3, hash);
+    
+    v1 ^= 0xdd;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    SIPROUND;
+    writeLittleEndian64(v0 ^ v1 ^ v2 ^ v3, hash + 8);
+}
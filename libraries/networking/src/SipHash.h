@@ -0,0 +1,24 @@
+//
+//  SipHash.h
+//  libraries/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SipHash_h
+#define hifi_SipHash_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+const int NUM_BYTES_SIPHASH_KEY = 16;
+const int NUM_BYTES_SIPHASH_128 = 16;
+
+// SipHash-2-4 with the 128-bit output, a keyed MAC that is cheap enough to run over every packet we receive
+void sipHash128(const uint8_t key[NUM_BYTES_SIPHASH_KEY], const void* data, size_t length,
+                uint8_t hash[NUM_BYTES_SIPHASH_128]);
+
+#endif // hifi_SipHash_h
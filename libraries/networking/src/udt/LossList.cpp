@@ -11,34 +11,36 @@
 
 #include "LossList.h"
 
+#include <iterator>
+
 #include "ControlPacket.h"
 
 using namespace udt;
 using namespace std;
 
 void LossList::append(SequenceNumber seq) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < seq), "LossList::append(SequenceNumber)",
+    Q_ASSERT_X(_lossList.empty() || (_lossList.rbegin()->second < seq), "LossList::append(SequenceNumber)",
                "SequenceNumber appended is not greater than the last SequenceNumber in the list");
     
-    if (getLength() > 0 && _lossList.back().second + 1 == seq) {
-        ++_lossList.back().second;
+    if (getLength() > 0 && _lossList.rbegin()->second + 1 == seq) {
+        ++_lossList.rbegin()->second;
     } else {
-        _lossList.push_back(make_pair(seq, seq));
+        _lossList.emplace_hint(_lossList.end(), seq, seq);
     }
     _length += 1;
 }
 
 void LossList::append(SequenceNumber start, SequenceNumber end) {
-    Q_ASSERT_X(_lossList.empty() || (_lossList.back().second < start),
+    Q_ASSERT_X(_lossList.empty() || (_lossList.rbegin()->second < start),
                "LossList::append(SequenceNumber, SequenceNumber)",
                "SequenceNumber range appended is not greater than the last SequenceNumber in the list");
     Q_ASSERT_X(start <= end,
                "LossList::append(SequenceNumber, SequenceNumber)", "Range start greater than range end");
 
-    if (getLength() > 0 && _lossList.back().second + 1 == start) {
-        _lossList.back().second = end;
+    if (getLength() > 0 && _lossList.rbegin()->second + 1 == start) {
+        _lossList.rbegin()->second = end;
     } else {
-        _lossList.push_back(make_pair(start, end));
+        _lossList.emplace_hint(_lossList.end(), start, end);
     }
     _length += seqlen(start, end);
 }
@@ -47,60 +49,60 @@ void LossList::insert(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::insert(SequenceNumber, SequenceNumber)", "Range start greater than range end");
     
-    auto it = find_if_not(_lossList.begin(), _lossList.end(), [&start](pair<SequenceNumber, SequenceNumber> pair){
-        return pair.second < start;
-    });
+    // the first range starting after start, the one before it is the only one that can start before and still touch
+    auto it = _lossList.upper_bound(start);
     
-    if (it == _lossList.end() || end < it->first) {
-        // No overlap, simply insert
-        _length += seqlen(start, end);
-        _lossList.insert(it, make_pair(start, end));
-    } else {
-        // If it starts before segment, extend segment
-        if (start < it->first) {
-            _length += seqlen(start, it->first - 1);
-            it->first = start;
-        }
-        
-        // If it ends after segment, extend segment
-        if (end > it->second) {
-            _length += seqlen(it->second + 1, end);
-            it->second = end;
-        }
-        
-        auto it2 = it;
-        ++it2;
-        // For all ranges touching the current range
-        while (it2 != _lossList.end() && it->second >= it2->first - 1) {
-            // extend current range if necessary
-            if (it->second < it2->second) {
-                _length += seqlen(it->second + 1, it2->second);
-                it->second = it2->second;
+    if (it != _lossList.begin()) {
+        auto previous = std::prev(it);
+        if (previous->second + 1 >= start) {
+            if (previous->second >= end) {
+                // already entirely lost
+                return;
             }
-            
-            // Remove overlapping range
-            _length -= seqlen(it2->first, it2->second);
-            it2 = _lossList.erase(it2);
+            start = previous->first;
+            _length -= seqlen(previous->first, previous->second);
+            _lossList.erase(previous);
+        }
+    }
+    
+    // swallow every range that starts within or right after the new one
+    while (it != _lossList.end() && it->first <= end + 1) {
+        if (it->second > end) {
+            end = it->second;
         }
+        _length -= seqlen(it->first, it->second);
+        it = _lossList.erase(it);
     }
+    
+    _lossList.emplace_hint(it, start, end);
+    _length += seqlen(start, end);
+}
+
+LossList::RangeMap::iterator LossList::findRange(SequenceNumber seq) {
+    auto it = _lossList.upper_bound(seq);
+    
+    if (it == _lossList.begin()) {
+        return _lossList.end();
+    }
+    
+    --it;
+    return (seq <= it->second) ? it : _lossList.end();
 }
 
 bool LossList::remove(SequenceNumber seq) {
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&seq](pair<SequenceNumber, SequenceNumber> pair) {
-        return pair.first <= seq && seq <= pair.second;
-    });
+    auto it = findRange(seq);
     
-    if (it != end(_lossList)) {
-        if (it->first == it->second) {
-            _lossList.erase(it);
-        } else if (seq == it->first) {
-            ++it->first;
-        } else if (seq == it->second) {
-            --it->second;
-        } else {
-            auto temp = it->second;
-            it->second = seq - 1;
-            _lossList.insert(++it, make_pair(seq + 1, temp));
+    if (it != _lossList.end()) {
+        SequenceNumber first = it->first;
+        SequenceNumber last = it->second;
+        
+        // keys can't change in place, so the range is replaced by what is left of it on either side
+        auto next = _lossList.erase(it);
+        if (seq != last) {
+            next = _lossList.emplace_hint(next, seq + 1, last);
+        }
+        if (seq != first) {
+            _lossList.emplace_hint(next, first, seq - 1);
         }
         _length -= 1;
         
@@ -115,50 +117,48 @@ bool LossList::remove(SequenceNumber seq) {
 void LossList::remove(SequenceNumber start, SequenceNumber end) {
     Q_ASSERT_X(start <= end,
                "LossList::remove(SequenceNumber, SequenceNumber)", "Range start greater than range end");
-    // Find the first segment sharing sequence numbers
-    auto it = find_if(_lossList.begin(), _lossList.end(), [&start, &end](pair<SequenceNumber, SequenceNumber> pair) {
-        return (pair.first <= start && start <= pair.second) || (start <= pair.first && pair.first <= end);
-    });
     
-    // If we found one
-    if (it != _lossList.end()) {
-        
-        // While the end of the current segment is contained, either shorten it (first one only - sometimes)
-        // or remove it altogether since it is fully contained it the range
-        while (it != _lossList.end() && end >= it->second) {
-            if (start <= it->first) {
-                // Segment is contained, update new length and erase it.
-                _length -= seqlen(it->first, it->second);
-                it = _lossList.erase(it);
+    auto it = _lossList.upper_bound(start);
+    
+    // the range before the first one starting after start may begin before start and reach into what we remove
+    if (it != _lossList.begin()) {
+        auto previous = std::prev(it);
+        if (previous->second >= start) {
+            SequenceNumber last = previous->second;
+            
+            // keep its beginning, if it has one before start, and its end too if it goes past what we remove
+            _length -= seqlen(start, last);
+            if (previous->first == start) {
+                _lossList.erase(previous);
             } else {
-                // Beginning of segment not contained, modify end of segment.
-                // Will only occur sometimes one the first loop
-                _length -= seqlen(start, it->second);
-                it->second = start - 1;
-                ++it;
+                previous->second = start - 1;
+            }
+            
+            if (last > end) {
+                _length += seqlen(end + 1, last);
+                _lossList.emplace_hint(it, end + 1, last);
+                return;
             }
         }
+    }
+    
+    // every range starting within what we remove is either removed whole or loses its beginning
+    while (it != _lossList.end() && it->first <= end) {
+        SequenceNumber last = it->second;
+        _length -= seqlen(it->first, last);
+        it = _lossList.erase(it);
         
-        // There might be more to remove
-        if (it != _lossList.end() && it->first <= end) {
-            if (start <= it->first) {
-                // Truncate beginning of segment
-                _length -= seqlen(it->first, end);
-                it->first = end + 1;
-            } else {
-                // Cut it in half if the range we are removing is contained within one segment
-                _length -= seqlen(start, end);
-                auto temp = it->second;
-                it->second = start - 1;
-                _lossList.insert(++it, make_pair(end + 1, temp));
-            }
+        if (last > end) {
+            _length += seqlen(end + 1, last);
+            _lossList.emplace_hint(it, end + 1, last);
+            break;
         }
     }
 }
 
 SequenceNumber LossList::getFirstSequenceNumber() const {
     Q_ASSERT_X(getLength() > 0, "LossList::getFirstSequenceNumber()", "Trying to get first element of an empty list");
-    return _lossList.front().first;
+    return _lossList.begin()->first;
 }
 
 SequenceNumber LossList::popFirstSequenceNumber() {
@@ -170,9 +170,9 @@ SequenceNumber LossList::popFirstSequenceNumber() {
 void LossList::write(ControlPacket& packet, int maxPairs) {
     int writtenPairs = 0;
     
-    for (const auto& pair : _lossList) {
-        packet.writePrimitive(pair.first);
-        packet.writePrimitive(pair.second);
+    for (const auto& range : _lossList) {
+        packet.writePrimitive(range.first);
+        packet.writePrimitive(range.second);
         
         ++writtenPairs;
         
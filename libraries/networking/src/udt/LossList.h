@@ -12,7 +12,7 @@
 #ifndef hifi_LossList_h
 #define hifi_LossList_h
 
-#include <list>
+#include <map>
 
 #include "SequenceNumber.h"
 
@@ -20,6 +20,9 @@ namespace udt {
 
 class ControlPacket;
     
+// Disjoint ranges of sequence numbers, kept sorted in a tree keyed by the first sequence number of each range so that
+// finding the range a sequence number falls in is logarithmic. Every range must lie within SequenceNumber::THRESHOLD
+// of the others, which the flow window guarantees, for the wrapping comparison to order them.
 class LossList {
 public:
     LossList() {}
@@ -30,7 +33,7 @@ public:
     void append(SequenceNumber seq);
     void append(SequenceNumber start, SequenceNumber end);
     
-    // inserts anywhere - MUCH slower
+    // inserts anywhere, merging with the ranges it overlaps or touches
     void insert(SequenceNumber start, SequenceNumber end);
     
     bool remove(SequenceNumber seq);
@@ -44,7 +47,12 @@ public:
     void write(ControlPacket& packet, int maxPairs = -1);
     
 private:
-    std::list<std::pair<SequenceNumber, SequenceNumber>> _lossList;
+    using RangeMap = std::map<SequenceNumber, SequenceNumber>; // first -> last sequence number of each range
+    
+    // the range containing seq, or end() if there is none
+    RangeMap::iterator findRange(SequenceNumber seq);
+    
+    RangeMap _lossList;
     int _length { 0 };
 };
     
@@ -0,0 +1,65 @@
+//
+//  PacketBufferPool.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketBufferPool.h"
+
+using namespace udt;
+
+void PacketDataDeleter::operator()(char* data) const {
+    if (_pool) {
+        _pool->release(data);
+    } else {
+        delete[] data;
+    }
+}
+
+PacketBufferPool::~PacketBufferPool() {
+    for (auto buffer : _freeBuffers) {
+        delete[] buffer;
+    }
+}
+
+PacketData PacketBufferPool::acquire() {
+    char* buffer = nullptr;
+    
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        if (!_freeBuffers.empty()) {
+            buffer = _freeBuffers.back();
+            _freeBuffers.pop_back();
+        }
+    }
+    
+    if (!buffer) {
+        buffer = new char[BUFFER_SIZE];
+    }
+    
+    return PacketData(buffer, PacketDataDeleter(shared_from_this()));
+}
+
+int PacketBufferPool::getNumFreeBuffers() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return (int) _freeBuffers.size();
+}
+
+void PacketBufferPool::release(char* buffer) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        
+        if ((int) _freeBuffers.size() < _maxFreeBuffers) {
+            _freeBuffers.push_back(buffer);
+            return;
+        }
+    }
+    
+    // we're already holding on to enough buffers to absorb a burst, let this one go
+    delete[] buffer;
+}
@@ -0,0 +1,67 @@
+//
+//  PacketBufferPool.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_PacketBufferPool_h
+#define hifi_PacketBufferPool_h
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Constants.h"
+
+namespace udt {
+
+class PacketBufferPool;
+
+// frees the data of a packet - data that came from a PacketBufferPool is handed back to it instead of being deleted
+class PacketDataDeleter {
+public:
+    PacketDataDeleter() {}
+    PacketDataDeleter(std::shared_ptr<PacketBufferPool> pool) : _pool(std::move(pool)) {}
+    
+    void operator()(char* data) const;
+    
+private:
+    std::shared_ptr<PacketBufferPool> _pool;
+};
+
+using PacketData = std::unique_ptr<char[], PacketDataDeleter>;
+
+// Recycles fixed size receive buffers so the Socket does not go to the heap for every datagram it reads.
+// Buffers can be handed back from any thread, the packets they end up in often die on another one.
+class PacketBufferPool : public std::enable_shared_from_this<PacketBufferPool> {
+public:
+    static const int BUFFER_SIZE = MAX_PACKET_SIZE;
+    static const int DEFAULT_MAX_FREE_BUFFERS = 4096;
+    
+    PacketBufferPool(int maxFreeBuffers = DEFAULT_MAX_FREE_BUFFERS) : _maxFreeBuffers(maxFreeBuffers) {}
+    ~PacketBufferPool();
+    
+    // returns a buffer of BUFFER_SIZE bytes that will come back to this pool once it is released
+    PacketData acquire();
+    
+    int getNumFreeBuffers();
+    
+private:
+    friend class PacketDataDeleter;
+    
+    void release(char* buffer);
+    
+    std::mutex _mutex;
+    std::vector<char*> _freeBuffers;
+    int _maxFreeBuffers;
+};
+
+} // namespace udt
+
+#endif // hifi_PacketBufferPool_h
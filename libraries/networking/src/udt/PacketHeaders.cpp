@@ -41,11 +41,19 @@ PacketVersion versionForPacketType(PacketType packetType) {
         case PacketType::EntityAdd:
         case PacketType::EntityEdit:
         case PacketType::EntityData:
-            return VERSION_ENTITIES_PARTICLES_ADDITIVE_BLENDING;
+            return VERSION_ENTITIES_SIPHASH_VERIFICATION;
         case PacketType::AvatarData:
         case PacketType::BulkAvatarData:
+            return VERSION_AVATAR_QUANTIZED_JOINTS;
+        case PacketType::DomainList:
+        case PacketType::DomainListRequest:
+            return VERSION_DOMAIN_LIST_CHANGES;
+        case PacketType::MicrophoneAudioNoEcho:
+        case PacketType::MicrophoneAudioWithEcho:
+        case PacketType::MixedAudio:
+            return VERSION_AUDIO_HAS_CODEC_ID;
         default:
-            return 16;
+            return 17;
     }
 }
 
@@ -90,13 +90,17 @@ public:
         DomainServerRemovedNode,
         MessagesData,
         MessagesSubscribe,
-        MessagesUnsubscribe
+        MessagesUnsubscribe,
+        AssetUploadChunk,
+        AssetUploadChunkReply,
+        NegotiateAudioFormat,
+        SelectedAudioFormat
     };
 };
 
 using PacketType = PacketTypeEnum::Value;
 
-const int NUM_BYTES_MD5_HASH = 16;
+const int NUM_BYTES_VERIFICATION_HASH = 16;
 
 typedef char PacketVersion;
 
@@ -159,5 +163,12 @@ const PacketVersion VERSION_ENTITIES_ANIMATION_PROPERTIES_GROUP = 46;
 const PacketVersion VERSION_ENTITIES_KEYLIGHT_PROPERTIES_GROUP = 47;
 const PacketVersion VERSION_ENTITIES_KEYLIGHT_PROPERTIES_GROUP_BIS = 48;
 const PacketVersion VERSION_ENTITIES_PARTICLES_ADDITIVE_BLENDING = 49;
+const PacketVersion VERSION_ENTITIES_SIPHASH_VERIFICATION = 50;
+
+const PacketVersion VERSION_AVATAR_QUANTIZED_JOINTS = 18;
+
+const PacketVersion VERSION_AUDIO_HAS_CODEC_ID = 18;
+
+const PacketVersion VERSION_DOMAIN_LIST_CHANGES = 18;
 
 #endif // hifi_PacketHeaders_h
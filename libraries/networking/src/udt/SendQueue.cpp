@@ -127,9 +127,7 @@ void SendQueue::ack(SequenceNumber ack) {
     {
         // remove any ACKed packets from the map of sent packets
         QWriteLocker locker(&_sentLock);
-        for (auto seq = SequenceNumber { (uint32_t) _lastACKSequenceNumber }; seq <= ack; ++seq) {
-            _sentPackets.erase(seq);
-        }
+        _sentPackets.removeUpTo(ack);
     }
     
     {   // remove any sequence numbers equal to or lower than this ACK in the loss list
@@ -223,9 +221,8 @@ void SendQueue::sendNewPacketAndAddToSentList(std::unique_ptr<Packet> newPacket,
     {
         // Insert the packet we have just sent in the sent list
         QWriteLocker locker(&_sentLock);
-        _sentPackets[newPacket->getSequenceNumber()].swap(newPacket);
+        _sentPackets.insert(sequenceNumber, std::move(newPacket));
     }
-    Q_ASSERT_X(!newPacket, "SendQueue::sendNewPacketAndAddToSentList()", "Overriden packet in sent list");
     
     emit packetSent(packetSize, payloadSize);
 }
@@ -349,14 +346,11 @@ bool SendQueue::maybeResendPacket() {
             QReadLocker sentLocker(&_sentLock);
             
             // see if we can find the packet to re-send
-            auto it = _sentPackets.find(resendNumber);
+            Packet* resendPacket = _sentPackets.find(resendNumber);
             
-            if (it != _sentPackets.end()) {
-                // we found the packet - grab it
-                auto& resendPacket = *(it->second);
-                
+            if (resendPacket) {
                 // send it off
-                sendPacket(resendPacket);
+                sendPacket(*resendPacket);
                 
                 // unlock the sent packets
                 sentLocker.unlock();
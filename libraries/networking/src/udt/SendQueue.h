@@ -18,7 +18,6 @@
 #include <list>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 
 #include <QtCore/QObject>
 #include <QtCore/QReadWriteLock>
@@ -29,6 +28,7 @@
 
 #include "Constants.h"
 #include "PacketQueue.h"
+#include "SentPacketBuffer.h"
 #include "SequenceNumber.h"
 #include "LossList.h"
 
@@ -125,7 +125,7 @@ private:
     LossList _naks; // Sequence numbers of packets to resend
     
     mutable QReadWriteLock _sentLock; // Protects the sent packet list
-    std::unordered_map<SequenceNumber, std::unique_ptr<Packet>> _sentPackets; // Packets waiting for ACK.
+    SentPacketBuffer _sentPackets; // Packets waiting for ACK.
     
     std::mutex _handshakeMutex; // Protects the handshake ACK condition_variable
     std::atomic<bool> _hasReceivedHandshakeACK { false }; // flag for receipt of handshake ACK from client
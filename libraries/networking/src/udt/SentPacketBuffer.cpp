@@ -0,0 +1,93 @@
+//
+//  SentPacketBuffer.cpp
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SentPacketBuffer.h"
+
+#include <algorithm>
+
+using namespace udt;
+
+static const int INITIAL_CAPACITY = 256;
+
+SentPacketBuffer::SentPacketBuffer() :
+    _slots(INITIAL_CAPACITY)
+{
+    
+}
+
+void SentPacketBuffer::insert(SequenceNumber sequenceNumber, PacketPointer packet) {
+    if (_count == 0) {
+        _first = sequenceNumber;
+        _firstIndex = 0;
+    }
+    
+    int offset = seqoff(_first, sequenceNumber);
+    Q_ASSERT_X(offset >= _count, "SentPacketBuffer::insert", "SequenceNumber inserted is not after the last one");
+    
+    if (offset < 0) {
+        // older than anything we hold, so it has been ACKed already
+        return;
+    }
+    
+    if (offset >= (int)_slots.size()) {
+        grow(offset + 1);
+    }
+    
+    _slots[slotIndex(offset)] = std::move(packet);
+    _count = std::max(_count, offset + 1);
+}
+
+Packet* SentPacketBuffer::find(SequenceNumber sequenceNumber) const {
+    if (_count == 0) {
+        return nullptr;
+    }
+    
+    int offset = seqoff(_first, sequenceNumber);
+    
+    if (offset < 0 || offset >= _count) {
+        return nullptr;
+    }
+    
+    return _slots[slotIndex(offset)].get();
+}
+
+void SentPacketBuffer::removeUpTo(SequenceNumber sequenceNumber) {
+    if (_count == 0) {
+        return;
+    }
+    
+    int numRemoved = std::min(seqoff(_first, sequenceNumber) + 1, _count);
+    
+    for (int i = 0; i < numRemoved; ++i) {
+        _slots[slotIndex(i)].reset();
+    }
+    
+    if (numRemoved > 0) {
+        _first += numRemoved;
+        _firstIndex = slotIndex(numRemoved);
+        _count -= numRemoved;
+    }
+}
+
+void SentPacketBuffer::grow(int minimumCapacity) {
+    size_t capacity = _slots.size();
+    while (capacity < (size_t)minimumCapacity) {
+        capacity *= 2;
+    }
+    
+    // unwrap the run so the oldest packet is back at the start
+    std::vector<PacketPointer> slots(capacity);
+    for (int i = 0; i < _count; ++i) {
+        slots[i] = std::move(_slots[slotIndex(i)]);
+    }
+    
+    _slots.swap(slots);
+    _firstIndex = 0;
+}
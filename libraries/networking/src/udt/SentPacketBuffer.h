@@ -0,0 +1,54 @@
+//
+//  SentPacketBuffer.h
+//  libraries/networking/src/udt
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_SentPacketBuffer_h
+#define hifi_SentPacketBuffer_h
+
+#include <memory>
+#include <vector>
+
+#include "Packet.h"
+#include "SequenceNumber.h"
+
+namespace udt {
+
+// Packets sent but not yet ACKed, in a ring indexed by their offset from the oldest one. Sequence numbers go out in
+// order and are ACKed in order, so the packets in flight always form one run and lookups never need to hash.
+// The ring grows to fit the run, which the flow window keeps well short of SequenceNumber::THRESHOLD.
+class SentPacketBuffer {
+public:
+    using PacketPointer = std::unique_ptr<Packet>;
+    
+    SentPacketBuffer();
+    
+    bool isEmpty() const { return _count == 0; }
+    
+    // sequenceNumber must come after any packet already held
+    void insert(SequenceNumber sequenceNumber, PacketPointer packet);
+    
+    // nullptr if the packet was never sent or has been ACKed
+    Packet* find(SequenceNumber sequenceNumber) const;
+    
+    // drops every packet up to and including sequenceNumber
+    void removeUpTo(SequenceNumber sequenceNumber);
+    
+private:
+    void grow(int minimumCapacity);
+    int slotIndex(int offset) const { return (_firstIndex + offset) & (int)(_slots.size() - 1); }
+    
+    std::vector<PacketPointer> _slots; // size is always a power of two
+    SequenceNumber _first; // sequence number held at _firstIndex
+    int _firstIndex { 0 };
+    int _count { 0 }; // number of sequence numbers from _first to the last one inserted
+};
+    
+}
+
+#endif // hifi_SentPacketBuffer_h
@@ -11,6 +11,15 @@
 
 #include "Socket.h"
 
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
 #include <QtCore/QThread>
 
 #include <LogHandler.h>
@@ -24,6 +33,11 @@
 
 using namespace udt;
 
+#ifdef Q_OS_LINUX
+static const int RECEIVE_BATCH_SIZE = 32;
+static const int SEND_BATCH_SIZE = 64;
+#endif
+
 Socket::Socket(QObject* parent) :
     QObject(parent),
     _synTimer(new QTimer(this))
@@ -151,12 +165,25 @@ void Socket::writeReliablePacketList(PacketList* packetList, const HifiSockAddr&
 }
 
 qint64 Socket::writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
-    return writeDatagram(QByteArray::fromRawData(data, size), sockAddr);
+    if (_sendBatchThread == QThread::currentThread()) {
+        // the caller may re-use or destroy its packet as soon as we return, so the batch keeps a copy
+        auto offset = _sendBatchData.size();
+        _sendBatchData.insert(_sendBatchData.end(), data, data + size);
+        _sendBatchDatagrams.push_back({ sockAddr, offset, size });
+        
+        return size;
+    }
+    
+    return writeDatagramToSocket(data, size, sockAddr);
 }
 
 qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr) {
+    return writeDatagram(datagram.constData(), datagram.size(), sockAddr);
+}
+
+qint64 Socket::writeDatagramToSocket(const char* data, qint64 size, const HifiSockAddr& sockAddr) {
     
-    qint64 bytesWritten = _udpSocket.writeDatagram(datagram, sockAddr.getAddress(), sockAddr.getPort());
+    qint64 bytesWritten = _udpSocket.writeDatagram(data, size, sockAddr.getAddress(), sockAddr.getPort());
     
     if (bytesWritten < 0) {
         // when saturating a link this isn't an uncommon message - suppress it so it doesn't bomb the debug
@@ -170,6 +197,94 @@ qint64 Socket::writeDatagram(const QByteArray& datagram, const HifiSockAddr& soc
     return bytesWritten;
 }
 
+void Socket::beginSendBatch() {
+    Q_ASSERT_X(!_sendBatchThread, "Socket::beginSendBatch", "Only one send batch can be open at a time");
+    _sendBatchThread = QThread::currentThread();
+}
+
+qint64 Socket::flushSendBatch() {
+    Q_ASSERT_X(_sendBatchThread == QThread::currentThread(), "Socket::flushSendBatch",
+               "A send batch must be flushed from the thread that began it");
+    _sendBatchThread = nullptr;
+    
+    qint64 totalBytesWritten = 0;
+    size_t nextDatagram = 0;
+    
+#ifdef Q_OS_LINUX
+    auto socketDescriptor = _udpSocket.socketDescriptor();
+    
+    mmsghdr messages[SEND_BATCH_SIZE];
+    iovec vectors[SEND_BATCH_SIZE];
+    sockaddr_in destinations[SEND_BATCH_SIZE];
+    
+    while (socketDescriptor != -1 && nextDatagram < _sendBatchDatagrams.size()) {
+        int numMessages = 0;
+        memset(messages, 0, sizeof(messages));
+        
+        while (nextDatagram < _sendBatchDatagrams.size() && numMessages < SEND_BATCH_SIZE) {
+            auto& datagram = _sendBatchDatagrams[nextDatagram++];
+            auto& address = datagram.sockAddr.getAddress();
+            
+            if (address.protocol() != QAbstractSocket::IPv4Protocol) {
+                // the node socket is bound to IPv4, leave anything else for QUdpSocket to deal with
+                auto bytesWritten = writeDatagramToSocket(&_sendBatchData[datagram.offset], datagram.size, datagram.sockAddr);
+                totalBytesWritten += std::max(bytesWritten, (qint64) 0);
+                continue;
+            }
+            
+            memset(&destinations[numMessages], 0, sizeof(sockaddr_in));
+            destinations[numMessages].sin_family = AF_INET;
+            destinations[numMessages].sin_addr.s_addr = htonl(address.toIPv4Address());
+            destinations[numMessages].sin_port = htons(datagram.sockAddr.getPort());
+            
+            vectors[numMessages].iov_base = &_sendBatchData[datagram.offset];
+            vectors[numMessages].iov_len = datagram.size;
+            
+            messages[numMessages].msg_hdr.msg_name = &destinations[numMessages];
+            messages[numMessages].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[numMessages].msg_hdr.msg_iov = &vectors[numMessages];
+            messages[numMessages].msg_hdr.msg_iovlen = 1;
+            
+            ++numMessages;
+        }
+        
+        int numSent = 0;
+        while (numSent < numMessages) {
+            int result = sendmmsg(socketDescriptor, &messages[numSent], numMessages - numSent, 0);
+            
+            if (result < 0) {
+                // sendmmsg stops at the first message that fails - drop that one, same as a failed writeDatagram
+                static const QString SEND_ERROR_REGEX = "Socket::flushSendBatch sendmmsg failed - .+";
+                static QString repeatedMessage
+                    = LogHandler::getInstance().addRepeatedMessageRegex(SEND_ERROR_REGEX);
+                
+                qCDebug(networking) << "Socket::flushSendBatch sendmmsg failed -" << strerror(errno);
+                
+                ++numSent;
+            } else {
+                for (int i = numSent; i < numSent + result; ++i) {
+                    totalBytesWritten += messages[i].msg_len;
+                }
+                
+                numSent += result;
+            }
+        }
+    }
+#endif
+    
+    // write whatever is left one datagram at a time
+    for (; nextDatagram < _sendBatchDatagrams.size(); ++nextDatagram) {
+        auto& datagram = _sendBatchDatagrams[nextDatagram];
+        auto bytesWritten = writeDatagramToSocket(&_sendBatchData[datagram.offset], datagram.size, datagram.sockAddr);
+        totalBytesWritten += std::max(bytesWritten, (qint64) 0);
+    }
+    
+    _sendBatchData.clear();
+    _sendBatchDatagrams.clear();
+    
+    return totalBytesWritten;
+}
+
 Connection& Socket::findOrCreateConnection(const HifiSockAddr& sockAddr) {
     auto it = _connectionsHash.find(sockAddr);
 
@@ -222,62 +337,146 @@ void Socket::readPendingDatagrams() {
         // setup a HifiSockAddr to read into
         HifiSockAddr senderSockAddr;
         
-        // setup a buffer to read the packet into
-        auto buffer = std::unique_ptr<char[]>(new char[packetSizeWithHeader]);
+        // grab a pooled buffer to read the packet into, unless the datagram is too large for one
+        auto buffer = (packetSizeWithHeader <= PacketBufferPool::BUFFER_SIZE)
+            ? _bufferPool->acquire() : PacketData(new char[packetSizeWithHeader]);
        
         // pull the datagram
         _udpSocket.readDatagram(buffer.get(), packetSizeWithHeader,
                                 senderSockAddr.getAddressPointer(), senderSockAddr.getPortPointer());
         
-        auto it = _unfilteredHandlers.find(senderSockAddr);
+        processDatagram(std::move(buffer), packetSizeWithHeader, senderSockAddr);
         
-        if (it != _unfilteredHandlers.end()) {
-            // we have a registered unfiltered handler for this HifiSockAddr - call that and return
-            if (it->second) {
-                auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
-                it->second(std::move(basePacket));
+#ifdef Q_OS_LINUX
+        // QUdpSocket only re-arms its read notifier from readDatagram, which is why the first datagram goes through it
+        // - everything queued up behind that one is pulled in batches
+        readDatagramBatches();
+#endif
+    }
+}
+
+#ifdef Q_OS_LINUX
+void Socket::readDatagramBatches() {
+    auto socketDescriptor = _udpSocket.socketDescriptor();
+    
+    if (socketDescriptor == -1) {
+        return;
+    }
+    
+    if (_receiveRing.empty()) {
+        _receiveRing.reserve(RECEIVE_BATCH_SIZE);
+        
+        for (int i = 0; i < RECEIVE_BATCH_SIZE; ++i) {
+            _receiveRing.push_back(_bufferPool->acquire());
+        }
+    }
+    
+    mmsghdr messages[RECEIVE_BATCH_SIZE];
+    iovec vectors[RECEIVE_BATCH_SIZE];
+    sockaddr_storage senderAddresses[RECEIVE_BATCH_SIZE];
+    
+    while (true) {
+        memset(messages, 0, sizeof(messages));
+        
+        for (int i = 0; i < RECEIVE_BATCH_SIZE; ++i) {
+            vectors[i].iov_base = _receiveRing[i].get();
+            vectors[i].iov_len = PacketBufferPool::BUFFER_SIZE;
+            
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_name = &senderAddresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        }
+        
+        int numReceived = recvmmsg(socketDescriptor, messages, RECEIVE_BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        
+        if (numReceived < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                qCDebug(networking) << "Socket::readDatagramBatches recvmmsg failed -" << strerror(errno);
             }
             
             return;
         }
         
-        // check if this was a control packet or a data packet
-        bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
-        
-        if (isControlPacket) {
-            // setup a control packet from the data we just read
-            auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+        for (int i = 0; i < numReceived; ++i) {
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                // this didn't fit in a pooled buffer so it isn't one of ours, and the rest of it is gone by now
+                // - drop it, the buffer stays in the ring
+                static const QString TRUNCATED_REGEX = "Socket::readDatagramBatches dropped a datagram larger than .+";
+                static QString repeatedMessage = LogHandler::getInstance().addRepeatedMessageRegex(TRUNCATED_REGEX);
+                
+                qCDebug(networking) << "Socket::readDatagramBatches dropped a datagram larger than"
+                    << PacketBufferPool::BUFFER_SIZE << "bytes from"
+                    << HifiSockAddr(reinterpret_cast<const sockaddr*>(&senderAddresses[i]));
+                continue;
+            }
             
-            // move this control packet to the matching connection
-            auto& connection = findOrCreateConnection(senderSockAddr);
-            connection.processControl(move(controlPacket));
+            HifiSockAddr senderSockAddr(reinterpret_cast<const sockaddr*>(&senderAddresses[i]));
             
-        } else {
-            // setup a Packet from the data we just read
-            auto packet = Packet::fromReceivedPacket(std::move(buffer), packetSizeWithHeader, senderSockAddr);
+            // hand the filled buffer off with the packet and put a fresh one in its slot
+            auto buffer = std::move(_receiveRing[i]);
+            _receiveRing[i] = _bufferPool->acquire();
             
-            // call our verification operator to see if this packet is verified
-            if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
-                if (packet->isReliable()) {
-                    // if this was a reliable packet then signal the matching connection with the sequence number
-                    auto& connection = findOrCreateConnection(senderSockAddr);
-                    
-                    if (!connection.processReceivedSequenceNumber(packet->getSequenceNumber(),
-                                                                  packet->getDataSize(),
-                                                                  packet->getPayloadSize())) {
-                        // the connection indicated that we should not continue processing this packet
-                        return;
-                    }
-                }
+            processDatagram(std::move(buffer), messages[i].msg_len, senderSockAddr);
+        }
+        
+        if (numReceived < RECEIVE_BATCH_SIZE) {
+            // the socket has been drained
+            return;
+        }
+    }
+}
+#endif
 
-                if (packet->isPartOfMessage()) {
-                    auto& connection = findOrCreateConnection(senderSockAddr);
-                    connection.queueReceivedMessagePacket(std::move(packet));
-                } else if (_packetHandler) {
-                    // call the verified packet callback to let it handle this packet
-                    _packetHandler(std::move(packet));
+void Socket::processDatagram(PacketData buffer, qint64 size, const HifiSockAddr& senderSockAddr) {
+    auto it = _unfilteredHandlers.find(senderSockAddr);
+    
+    if (it != _unfilteredHandlers.end()) {
+        // we have a registered unfiltered handler for this HifiSockAddr - call that and return
+        if (it->second) {
+            auto basePacket = BasePacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+            it->second(std::move(basePacket));
+        }
+        
+        return;
+    }
+    
+    // check if this was a control packet or a data packet
+    bool isControlPacket = *reinterpret_cast<uint32_t*>(buffer.get()) & CONTROL_BIT_MASK;
+    
+    if (isControlPacket) {
+        // setup a control packet from the data we just read
+        auto controlPacket = ControlPacket::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        
+        // move this control packet to the matching connection
+        auto& connection = findOrCreateConnection(senderSockAddr);
+        connection.processControl(move(controlPacket));
+        
+    } else {
+        // setup a Packet from the data we just read
+        auto packet = Packet::fromReceivedPacket(std::move(buffer), size, senderSockAddr);
+        
+        // call our verification operator to see if this packet is verified
+        if (!_packetFilterOperator || _packetFilterOperator(*packet)) {
+            if (packet->isReliable()) {
+                // if this was a reliable packet then signal the matching connection with the sequence number
+                auto& connection = findOrCreateConnection(senderSockAddr);
+                
+                if (!connection.processReceivedSequenceNumber(packet->getSequenceNumber(),
+                                                              packet->getDataSize(),
+                                                              packet->getPayloadSize())) {
+                    // the connection indicated that we should not continue processing this packet
+                    return;
                 }
             }
+
+            if (packet->isPartOfMessage()) {
+                auto& connection = findOrCreateConnection(senderSockAddr);
+                connection.queueReceivedMessagePacket(std::move(packet));
+            } else if (_packetHandler) {
+                // call the verified packet callback to let it handle this packet
+                _packetHandler(std::move(packet));
+            }
         }
     }
 }
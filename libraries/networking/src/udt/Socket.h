@@ -14,8 +14,10 @@
 #ifndef hifi_Socket_h
 #define hifi_Socket_h
 
+#include <atomic>
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
@@ -24,6 +26,7 @@
 #include "../HifiSockAddr.h"
 #include "CongestionControl.h"
 #include "Connection.h"
+#include "PacketBufferPool.h"
 
 //#define UDT_CONNECTION_DEBUG
 
@@ -60,6 +63,11 @@ public:
     qint64 writeDatagram(const char* data, qint64 size, const HifiSockAddr& sockAddr);
     qint64 writeDatagram(const QByteArray& datagram, const HifiSockAddr& sockAddr);
     
+    // Datagrams written from the calling thread after beginSendBatch are copied into a batch instead of hitting the socket.
+    // flushSendBatch writes the whole batch (with sendmmsg where available) and returns the number of bytes written.
+    void beginSendBatch();
+    qint64 flushSendBatch();
+    
     void bind(const QHostAddress& address, quint16 port = 0) { _udpSocket.bind(address, port); setSystemBufferSizes(); }
     void rebind();
     
@@ -87,6 +95,12 @@ private slots:
 private:
     void setSystemBufferSizes();
     Connection& findOrCreateConnection(const HifiSockAddr& sockAddr);
+    
+    void processDatagram(PacketData buffer, qint64 size, const HifiSockAddr& senderSockAddr);
+    qint64 writeDatagramToSocket(const char* data, qint64 size, const HifiSockAddr& sockAddr);
+#ifdef Q_OS_LINUX
+    void readDatagramBatches();
+#endif
    
     // privatized methods used by UDTTest - they are private since they must be called on the Socket thread
     ConnectionStats::Stats sampleStatsForConnection(const HifiSockAddr& destination);
@@ -106,6 +120,19 @@ private:
     std::unordered_map<HifiSockAddr, SequenceNumber> _unreliableSequenceNumbers;
     std::unordered_map<HifiSockAddr, std::unique_ptr<Connection>> _connectionsHash;
     
+    std::shared_ptr<PacketBufferPool> _bufferPool { std::make_shared<PacketBufferPool>() };
+    std::vector<PacketData> _receiveRing; // buffers recvmmsg reads into, consumed slots are refilled from _bufferPool
+    
+    struct BatchedDatagram {
+        HifiSockAddr sockAddr;
+        size_t offset; // into _sendBatchData
+        qint64 size;
+    };
+    
+    std::atomic<QThread*> _sendBatchThread { nullptr }; // thread whose writes are being batched, if any
+    std::vector<char> _sendBatchData;
+    std::vector<BatchedDatagram> _sendBatchDatagrams;
+    
     int _synInterval = 10; // 10ms
     QTimer* _synTimer;
     
@@ -45,11 +45,12 @@
 #include "OctreeConstants.h"
 #include "OctreeElementBag.h"
 #include "Octree.h"
+#include "OctreeBinarySnapshot.h"
 #include "ViewFrustum.h"
 #include "OctreeLogging.h"
 
 
-QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz"};
+QVector<QString> PERSIST_EXTENSIONS = {"svo", "json", "json.gz", "bin"};
 
 float boundaryDistanceForRenderLevel(unsigned int renderLevel, float voxelSizeScale) {
     return voxelSizeScale / powf(2, renderLevel);
@@ -1749,6 +1750,10 @@ bool Octree::readFromFile(const char* fileName) {
         return readJSONFromGzippedFile(qFileName);
     }
 
+    if (qFileName.endsWith(".bin")) {
+        return readBinarySnapshotFromFile(qFileName);
+    }
+
     QFile file(qFileName);
 
     if (!file.open(QIODevice::ReadOnly)) {
@@ -1791,6 +1796,30 @@ bool Octree::readJSONFromGzippedFile(QString qFileName) {
     return readJSONFromStream(-1, jsonStream);
 }
 
+bool Octree::readBinarySnapshotFromFile(QString qFileName) {
+    QFile file(qFileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Cannot open binary snapshot for reading: " << qFileName;
+        return false;
+    }
+
+    qCDebug(octree) << "Loading binary snapshot" << qFileName << "...";
+
+    // the records are decoded straight out of the mapping, only fall back to reading the file if it can't be mapped
+    qint64 fileSize = file.size();
+    QByteArray fileData;
+    const char* data = reinterpret_cast<const char*>(file.map(0, fileSize));
+    if (!data) {
+        fileData = file.readAll();
+        data = fileData.constData();
+    }
+
+    bool success = readFromBinarySnapshot(data, fileSize);
+
+    file.close(); // also unmaps the file
+    return success;
+}
+
 bool Octree::readFromURL(const QString& urlString) {
     bool readOk = false;
 
@@ -2011,6 +2040,8 @@ void Octree::writeToFile(const char* fileName, OctreeElementPointer element, QSt
         writeToJSONFile(cFileName, element);
     } else if (persistAsFileType == "json.gz") {
         writeToJSONFile(cFileName, element, true);
+    } else if (persistAsFileType == "bin" && !element && canWriteBinarySnapshot()) {
+        writeToBinarySnapshotFile(cFileName);
     } else {
         qCDebug(octree) << "unable to write octree to file of type" << persistAsFileType;
     }
@@ -2021,6 +2052,14 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
 
     qCDebug(octree, "Saving JSON SVO to file %s...", fileName);
 
+    if (!writeToJSONMap(entityDescription, element)) {
+        return;
+    }
+
+    writeJSONMapToFile(entityDescription, fileName, doGzip);
+}
+
+bool Octree::writeToJSONMap(QVariantMap& entityDescription, OctreeElementPointer element) {
     OctreeElementPointer top;
     if (element) {
         top = element;
@@ -2037,9 +2076,12 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
     bool entityDescriptionSuccess = writeToMap(entityDescription, top, true);
     if (!entityDescriptionSuccess) {
         qCritical("Failed to convert Entities to QVariantMap while saving to json.");
-        return;
+        return false;
     }
+    return true;
+}
 
+bool Octree::writeJSONMapToFile(const QVariantMap& entityDescription, const char* fileName, bool doGzip) {
     // convert the QVariantMap to JSON
     QByteArray jsonData = QJsonDocument::fromVariant(entityDescription).toJson();
     QByteArray jsonDataForFile;
@@ -2047,18 +2089,31 @@ void Octree::writeToJSONFile(const char* fileName, OctreeElementPointer element,
     if (doGzip) {
         if (!gzip(jsonData, jsonDataForFile, -1)) {
             qCritical("unable to gzip data while saving to json.");
-            return;
+            return false;
         }
     } else {
         jsonDataForFile = jsonData;
     }
 
     QFile persistFile(fileName);
-    if (persistFile.open(QIODevice::WriteOnly)) {
-        persistFile.write(jsonDataForFile);
+    if (persistFile.open(QIODevice::WriteOnly) && persistFile.write(jsonDataForFile) == jsonDataForFile.size()) {
+        return true;
     } else {
         qCritical("Could not write to JSON description of entities.");
+        return false;
+    }
+}
+
+void Octree::writeToBinarySnapshotFile(const char* fileName) {
+    qCDebug(octree, "Saving binary snapshot to file %s...", fileName);
+
+    QByteArray snapshot;
+    if (!writeToBinarySnapshot(snapshot)) {
+        qCritical("Failed to encode binary snapshot.");
+        return;
     }
+
+    OctreeBinarySnapshot::writeToFile(snapshot, fileName);
 }
 
 void Octree::writeToSVOFile(const char* fileName, OctreeElementPointer element) {
@@ -23,6 +23,7 @@ class ReadBitstreamToTreeParams;
 class Octree;
 class OctreeElement;
 class OctreeElementBag;
+class OctreeEncodeCache;
 class OctreePacketData;
 class Shape;
 typedef std::shared_ptr<Octree> OctreePointer;
@@ -92,6 +93,7 @@ public:
     CoverageMap* map;
     JurisdictionMap* jurisdictionMap;
     OctreeElementExtraEncodeData* extraEncodeData;
+    OctreeEncodeCache* encodeCache; // items encoded for other clients, when the server shares them
 
     // output hints from the encode process
     typedef enum {
@@ -142,6 +144,7 @@ public:
             map(map),
             jurisdictionMap(jurisdictionMap),
             extraEncodeData(extraEncodeData),
+            encodeCache(nullptr),
             stopReason(UNKNOWN)
     {}
 
@@ -323,6 +326,26 @@ public:
     void writeToJSONFile(const char* filename, OctreeElementPointer element = NULL, bool doGzip = false);
     void writeToSVOFile(const char* filename, OctreeElementPointer element = NULL);
     virtual bool writeToMap(QVariantMap& entityDescription, OctreeElementPointer element, bool skipDefaultValues) = 0;
+    bool writeToJSONMap(QVariantMap& entityDescription, OctreeElementPointer element = NULL);
+    static bool writeJSONMapToFile(const QVariantMap& entityDescription, const char* filename, bool doGzip = false);
+    void writeToBinarySnapshotFile(const char* filename);
+
+    // Binary snapshots (see OctreeBinarySnapshot) hold a full save as one encoded record per item,
+    // which is faster to write and to read back than JSON. Trees that can encode their items one at a time override these.
+    virtual bool canWriteBinarySnapshot() const { return false; }
+    /// encodes every item in the tree into snapshot, callers must lock the tree
+    virtual bool writeToBinarySnapshot(QByteArray& snapshot) { return false; }
+    /// adds the items of a snapshot to the tree, callers must lock the tree
+    virtual bool readFromBinarySnapshot(const char* data, qint64 size) { return false; }
+
+    // Change journal, lets the OctreePersistThread append what changed since the last persist instead of writing
+    // out the whole tree every time. Trees that can describe their items one at a time override these.
+    virtual bool canJournalChanges() const { return false; }
+    virtual void setTrackChangesForJournal(bool trackChanges) { }
+    /// moves a description of every item added, edited or deleted since the last call into changes
+    virtual void takeChangesForJournal(QVariantList& changes) { }
+    /// applies changes from takeChangesForJournal, in order, on top of what is in the tree
+    virtual void replayJournalChanges(const QVariantList& changes) { }
 
     // Octree importers
     bool readFromFile(const char* filename);
@@ -331,6 +354,7 @@ public:
     bool readSVOFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromStream(unsigned long streamLength, QDataStream& inputStream);
     bool readJSONFromGzippedFile(QString qFileName);
+    bool readBinarySnapshotFromFile(QString qFileName);
     virtual bool readFromMap(QVariantMap& entityDescription) = 0;
 
     unsigned long getOctreeElementsCount();
@@ -0,0 +1,108 @@
+//
+//  OctreeBinarySnapshot.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <cstring>
+
+#include <QFile>
+
+#include "OctreeLogging.h"
+#include "OctreeBinarySnapshot.h"
+
+const quint8 OctreeBinarySnapshot::FORMAT_VERSION = 1;
+
+static const char SNAPSHOT_MAGIC[] = { 'H', 'F', 'O', 'S' };
+
+static const int SNAPSHOT_HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + 4 * sizeof(quint8) + sizeof(quint32);
+static const int RECORD_COUNT_OFFSET = sizeof(SNAPSHOT_MAGIC) + 4 * sizeof(quint8);
+static const int RECORD_HEADER_SIZE = sizeof(quint8) + sizeof(quint32);
+
+OctreeBinarySnapshot::OctreeBinarySnapshot(PacketType type, PacketVersion version) :
+    _recordCount(0)
+{
+    _data.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    _data.append((char) FORMAT_VERSION);
+    _data.append((char) type);
+    _data.append((char) version);
+    _data.append((char) 0); // reserved
+
+    // the record count is patched in as records are appended
+    _data.append(QByteArray(sizeof(quint32), 0));
+}
+
+void OctreeBinarySnapshot::appendRecord(RecordFormat format, const char* data, quint32 size) {
+    _data.append((char) format);
+    _data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    _data.append(data, size);
+
+    ++_recordCount;
+    memcpy(_data.data() + RECORD_COUNT_OFFSET, &_recordCount, sizeof(_recordCount));
+}
+
+bool OctreeBinarySnapshot::writeToFile(const QByteArray& snapshot, const char* filename) {
+    QFile persistFile(filename);
+    if (persistFile.open(QIODevice::WriteOnly) && persistFile.write(snapshot) == snapshot.size()) {
+        return true;
+    } else {
+        qCritical("Could not write binary snapshot to %s", filename);
+        return false;
+    }
+}
+
+bool OctreeBinarySnapshot::readRecords(const char* data, qint64 size, PacketType type, PacketVersion version,
+                                       std::vector<Record>& records) {
+    if (size < SNAPSHOT_HEADER_SIZE || memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        qCDebug(octree) << "Not a binary snapshot.";
+        return false;
+    }
+
+    const char* dataAt = data + sizeof(SNAPSHOT_MAGIC);
+    quint8 formatVersion = (quint8) *dataAt++;
+    PacketType gotType = (PacketType) *dataAt++;
+    PacketVersion gotVersion = *dataAt++;
+    dataAt++; // reserved
+
+    if (formatVersion != FORMAT_VERSION || gotType != type || gotVersion != version) {
+        qCDebug(octree) << "Binary snapshot format" << (int) formatVersion << "type" << gotType << "version" << (int) gotVersion
+            << "can't be read, expected format" << (int) FORMAT_VERSION << "type" << type << "version" << (int) version
+            << "- the persist thread sets it aside, use a JSON export to move content between versions.";
+        return false;
+    }
+
+    quint32 recordCount;
+    memcpy(&recordCount, dataAt, sizeof(recordCount));
+    dataAt += sizeof(recordCount);
+
+    const char* dataEnd = data + size;
+    records.clear();
+    records.reserve(recordCount);
+
+    for (quint32 i = 0; i < recordCount; ++i) {
+        if (dataEnd - dataAt < RECORD_HEADER_SIZE) {
+            qCDebug(octree) << "Binary snapshot is truncated after" << i << "of" << recordCount << "records.";
+            return false;
+        }
+
+        Record record;
+        record.format = (quint8) *dataAt++;
+        memcpy(&record.size, dataAt, sizeof(record.size));
+        dataAt += sizeof(record.size);
+
+        if ((quint64) (dataEnd - dataAt) < record.size) {
+            qCDebug(octree) << "Binary snapshot is truncated after" << i << "of" << recordCount << "records.";
+            return false;
+        }
+
+        record.data = dataAt;
+        dataAt += record.size;
+        records.push_back(record);
+    }
+
+    return true;
+}
@@ -0,0 +1,63 @@
+//
+//  OctreeBinarySnapshot.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeBinarySnapshot_h
+#define hifi_OctreeBinarySnapshot_h
+
+#include <vector>
+
+#include <QByteArray>
+
+#include <udt/PacketHeaders.h>
+
+/// Versioned binary full save of an octree, one length-prefixed record per item.
+/// The header carries the data packet type and version of the tree, records are only decoded by the same version.
+///
+///     "HFOS" | format version (1 byte) | packet type (1 byte) | packet version (1 byte) | reserved (1 byte) |
+///     record count (4 bytes) | records...
+///
+/// every record is its format (1 byte), its size (4 bytes) and then that many bytes of data.
+class OctreeBinarySnapshot {
+public:
+    enum RecordFormat : quint8 {
+        ENCODED_RECORD = 0, // the tree's own binary encoding of the item
+        JSON_RECORD = 1 // compact JSON, for items that the binary encoding can't hold
+    };
+
+    class Record {
+    public:
+        quint8 format;
+        const char* data;
+        quint32 size;
+    };
+
+    static const quint8 FORMAT_VERSION;
+
+    OctreeBinarySnapshot(PacketType type, PacketVersion version);
+
+    void appendRecord(RecordFormat format, const char* data, quint32 size);
+    void appendRecord(RecordFormat format, const QByteArray& data) { appendRecord(format, data.constData(), data.size()); }
+
+    quint32 getRecordCount() const { return _recordCount; }
+    const QByteArray& getData() const { return _data; }
+
+    /// writes data from getData() to a file in one go
+    static bool writeToFile(const QByteArray& snapshot, const char* filename);
+
+    /// splits a snapshot (usually a memory-mapped file) into its records, which point into data
+    static bool readRecords(const char* data, qint64 size, PacketType type, PacketVersion version,
+                            std::vector<Record>& records);
+
+private:
+    QByteArray _data;
+    quint32 _recordCount;
+};
+
+#endif // hifi_OctreeBinarySnapshot_h
@@ -0,0 +1,123 @@
+//
+//  OctreeChangeJournal.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeChangeJournal.h"
+
+#include <QFileInfo>
+#include <QJsonDocument>
+
+#include "OctreeLogging.h"
+
+OctreeChangeJournal::OctreeChangeJournal(const QString& persistFilename) :
+    _filename(persistFilename + ".journal"),
+    _compactingFilename(persistFilename + ".journal.compacting"),
+    _file(_filename)
+{
+
+}
+
+bool OctreeChangeJournal::append(const QVariantList& changes) {
+    QByteArray lines;
+
+    if (!_file.isOpen()) {
+        // if we crashed part way through a change make sure the next one starts on its own line
+        QFile existingFile(_filename);
+        if (existingFile.open(QIODevice::ReadOnly) && existingFile.size() > 0) {
+            existingFile.seek(existingFile.size() - 1);
+            if (existingFile.read(1) != "\n") {
+                lines += '\n';
+            }
+        }
+
+        if (!_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCDebug(octree) << "ERROR could not open change journal" << _filename << "-" << _file.errorString();
+            return false;
+        }
+    }
+
+    foreach (const QVariant& change, changes) {
+        lines += QJsonDocument::fromVariant(change).toJson(QJsonDocument::Compact);
+        lines += '\n';
+    }
+
+    if (_file.write(lines) != lines.size() || !_file.flush()) {
+        qCDebug(octree) << "ERROR could not write to change journal" << _filename << "-" << _file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+QVariantList OctreeChangeJournal::readChanges() const {
+    QVariantList changes;
+    readChangesFromFile(_compactingFilename, changes);
+    readChangesFromFile(_filename, changes);
+    return changes;
+}
+
+void OctreeChangeJournal::readChangesFromFile(const QString& filename, QVariantList& changes) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        QJsonDocument change = QJsonDocument::fromJson(line);
+
+        if (!change.isObject()) {
+            // we crashed part way through writing this change
+            qCDebug(octree) << "Ignoring incomplete change in" << filename;
+            continue;
+        }
+
+        changes << change.toVariant();
+    }
+}
+
+qint64 OctreeChangeJournal::getSize() const {
+    return QFileInfo(_filename).size();
+}
+
+bool OctreeChangeJournal::beginCompaction() {
+    _file.close();
+
+    if (!QFile::exists(_filename)) {
+        return true;
+    }
+
+    if (QFile::exists(_compactingFilename)) {
+        // the last full save never made it to disk, keep what it was covering and add to it
+        QFile compactingFile(_compactingFilename);
+        QFile file(_filename);
+
+        if (!compactingFile.open(QIODevice::WriteOnly | QIODevice::Append) || !file.open(QIODevice::ReadOnly)
+            || compactingFile.write(file.readAll()) != file.size()) {
+            qCDebug(octree) << "ERROR could not move change journal" << _filename << "aside";
+            return false;
+        }
+
+        compactingFile.close();
+        file.close();
+        return QFile::remove(_filename);
+    }
+
+    return QFile::rename(_filename, _compactingFilename);
+}
+
+void OctreeChangeJournal::finishCompaction() {
+    QFile::remove(_compactingFilename);
+}
+
+void OctreeChangeJournal::clear() {
+    _file.close();
+    QFile::remove(_filename);
+    QFile::remove(_compactingFilename);
+}
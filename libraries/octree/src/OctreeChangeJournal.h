@@ -0,0 +1,52 @@
+//
+//  OctreeChangeJournal.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeChangeJournal_h
+#define hifi_OctreeChangeJournal_h
+
+#include <QFile>
+#include <QString>
+#include <QVariantList>
+
+/// Append-only log of the changes persisted since the last full save of an octree.
+/// Every change is written as one line of compact JSON, so a torn write at the end of the file only loses that change.
+///
+/// When a full save starts the journal is moved aside as the "compacting" journal and a fresh one is started.
+/// The compacting journal is only removed once the full save is safely on disk, until then both are replayed on load.
+class OctreeChangeJournal {
+public:
+    OctreeChangeJournal(const QString& persistFilename);
+
+    /// appends changes to the end of the journal and flushes them to disk
+    bool append(const QVariantList& changes);
+
+    /// reads back the changes of the compacting journal followed by those of the current journal
+    QVariantList readChanges() const;
+
+    qint64 getSize() const;
+
+    /// moves what has been journaled so far aside, call before taking the full save that covers it
+    bool beginCompaction();
+
+    /// the full save that covers the compacting journal is on disk, call from any thread
+    void finishCompaction();
+
+    /// removes both journals, used after a full save that was not preceded by beginCompaction
+    void clear();
+
+private:
+    static void readChangesFromFile(const QString& filename, QVariantList& changes);
+
+    QString _filename;
+    QString _compactingFilename;
+    QFile _file;
+};
+
+#endif // hifi_OctreeChangeJournal_h
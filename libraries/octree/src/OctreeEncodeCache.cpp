@@ -0,0 +1,84 @@
+//
+//  OctreeEncodeCache.cpp
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "OctreeEncodeCache.h"
+
+OctreeEncodeCache::OctreeEncodeCache(int maxBytes) :
+    _maxBytes(maxBytes)
+{
+}
+
+bool OctreeEncodeCache::find(const QUuid& id, quint64 version, QByteArray& encoded) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto entry = _entries.find(id);
+    if (entry == _entries.end() || entry->version != version) {
+        ++_misses;
+        return false;
+    }
+
+    // move it to the most recently used end
+    _leastRecentlyUsed.splice(_leastRecentlyUsed.end(), _leastRecentlyUsed, entry->lruPosition);
+
+    // implicitly shared, the bytes are only copied into the caller's packet
+    encoded = entry->encoded;
+    ++_hits;
+    return true;
+}
+
+void OctreeEncodeCache::insert(const QUuid& id, quint64 version, const QByteArray& encoded) {
+    if (encoded.size() > _maxBytes) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto entry = _entries.find(id);
+    if (entry == _entries.end()) {
+        Entry newEntry;
+        newEntry.lruPosition = _leastRecentlyUsed.insert(_leastRecentlyUsed.end(), id);
+        entry = _entries.insert(id, newEntry);
+        ++_entryCount;
+    } else {
+        _bytes -= entry->encoded.size();
+        _leastRecentlyUsed.splice(_leastRecentlyUsed.end(), _leastRecentlyUsed, entry->lruPosition);
+    }
+
+    entry->version = version;
+    entry->encoded = encoded;
+    _bytes += encoded.size();
+
+    evictToBudget();
+}
+
+void OctreeEncodeCache::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _leastRecentlyUsed.clear();
+    _bytes = 0;
+    _entryCount = 0;
+}
+
+void OctreeEncodeCache::setMaxBytes(int maxBytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxBytes = maxBytes;
+    evictToBudget();
+}
+
+void OctreeEncodeCache::evictToBudget() {
+    while (_bytes > _maxBytes && !_leastRecentlyUsed.empty()) {
+        auto entry = _entries.find(_leastRecentlyUsed.front());
+        _bytes -= entry->encoded.size();
+        _entries.erase(entry);
+        _leastRecentlyUsed.pop_front();
+        --_entryCount;
+        ++_evictions;
+    }
+}
@@ -0,0 +1,69 @@
+//
+//  OctreeEncodeCache.h
+//  libraries/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEncodeCache_h
+#define hifi_OctreeEncodeCache_h
+
+#include <atomic>
+#include <list>
+#include <mutex>
+
+#include <QByteArray>
+#include <QHash>
+#include <QUuid>
+
+/// Encoded items of an octree, shared by all of the send threads of a server so that an item in view of many clients
+/// is only encoded once. An entry is found by the item's ID and a version, which the tree must change whenever the
+/// encoding of the item would change. The least recently used entries are dropped when over the byte budget.
+class OctreeEncodeCache {
+public:
+    OctreeEncodeCache(int maxBytes);
+
+    /// \return true and sets encoded if there is an entry for this version of the item
+    bool find(const QUuid& id, quint64 version, QByteArray& encoded);
+
+    /// adds or replaces the entry for an item
+    void insert(const QUuid& id, quint64 version, const QByteArray& encoded);
+
+    void clear();
+
+    void setMaxBytes(int maxBytes);
+    int getMaxBytes() const { return _maxBytes; }
+    int getBytes() const { return _bytes; }
+    int getEntryCount() const { return _entryCount; }
+
+    quint64 getHits() const { return _hits; }
+    quint64 getMisses() const { return _misses; }
+    quint64 getEvictions() const { return _evictions; }
+
+private:
+    class Entry {
+    public:
+        quint64 version;
+        QByteArray encoded;
+        std::list<QUuid>::iterator lruPosition;
+    };
+
+    void evictToBudget();
+
+    std::mutex _mutex;
+    QHash<QUuid, Entry> _entries;
+    std::list<QUuid> _leastRecentlyUsed; // most recently used at the back
+
+    std::atomic<int> _maxBytes;
+    std::atomic<int> _bytes { 0 };
+    std::atomic<int> _entryCount { 0 };
+
+    std::atomic<quint64> _hits { 0 };
+    std::atomic<quint64> _misses { 0 };
+    std::atomic<quint64> _evictions { 0 };
+};
+
+#endif // hifi_OctreeEncodeCache_h
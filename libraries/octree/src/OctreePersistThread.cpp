@@ -18,6 +18,7 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -27,15 +28,18 @@
 #include <PathUtils.h>
 
 #include "OctreeLogging.h"
+#include "OctreeBinarySnapshot.h"
 #include "OctreePersistThread.h"
 
 const int OctreePersistThread::DEFAULT_PERSIST_INTERVAL = 1000 * 30; // every 30 seconds
+const int OctreePersistThread::DEFAULT_SNAPSHOT_INTERVAL = 60 * 10; // every 10 minutes
 
 OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval,
                                          bool wantBackup, const QJsonObject& settings, bool debugTimestampNow,
                                          QString persistAsFileType) :
     _tree(tree),
-    _filename(filename),
+    // in case the persist filename has an extension that doesn't match the file type
+    _filename(fileNameWithoutExtension(filename, PERSIST_EXTENSIONS) + "." + persistAsFileType),
     _persistInterval(persistInterval),
     _initialLoadComplete(false),
     _loadTimeUSecs(0),
@@ -43,13 +47,22 @@ OctreePersistThread::OctreePersistThread(OctreePointer tree, const QString& file
     _wantBackup(wantBackup),
     _debugTimestampNow(debugTimestampNow),
     _lastTimeDebug(0),
-    _persistAsFileType(persistAsFileType)
+    _persistAsFileType(persistAsFileType),
+    _journal(_filename),
+    _wantChangeJournal(false),
+    _snapshotInterval(DEFAULT_SNAPSHOT_INTERVAL),
+    _lastSnapshot(0),
+    _wantSnapshot(false),
+    _persistFileUnreadable(false)
 {
     parseSettings(settings);
 
-    // in case the persist filename has an extension that doesn't match the file type
-    QString sansExt = fileNameWithoutExtension(_filename, PERSIST_EXTENSIONS);
-    _filename = sansExt + "." + _persistAsFileType;
+    // the journal holds JSON descriptions of single items, it can't be folded into a binary svo
+    _wantChangeJournal = _snapshotInterval > 0 && _persistAsFileType != "svo" && _tree->canJournalChanges();
+}
+
+OctreePersistThread::~OctreePersistThread() {
+    waitForSnapshot();
 }
 
 void OctreePersistThread::parseSettings(const QJsonObject& settings) {
@@ -100,6 +113,14 @@ void OctreePersistThread::parseSettings(const QJsonObject& settings) {
     } else {
         qCDebug(octree) << "BACKUP RULES: NONE";
     }
+
+    QJsonValue snapshotIntervalVal = settings["persistSnapshotInterval"];
+    if (snapshotIntervalVal.isString()) {
+        _snapshotInterval = snapshotIntervalVal.toString().toInt();
+    } else if (snapshotIntervalVal.isDouble()) {
+        _snapshotInterval = snapshotIntervalVal.toInt();
+    }
+    qCDebug(octree) << "SNAPSHOT INTERVAL:" << _snapshotInterval;
 }
 
 quint64 OctreePersistThread::getMostRecentBackupTimeInUsecs(const QString& format) {
@@ -149,9 +170,48 @@ bool OctreePersistThread::process() {
             }
 
             persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+
+            // a binary snapshot written by another version can't be decoded, move it out of the way of the next
+            // persist so it isn't overwritten by an empty tree, and load the newest save in another format instead
+            QString unreadableFilename = findMostRecentFileExtension(_filename, PERSIST_EXTENSIONS);
+            if (!persistantFileRead && unreadableFilename.endsWith(".bin") && QFile::exists(unreadableFilename)) {
+                if (setAsideUnreadableFile(unreadableFilename)) {
+                    if (unreadableFilename == _filename) {
+                        _journal.clear(); // its changes were made on top of the file that was set aside
+                    }
+                    persistantFileRead = _tree->readFromFile(qPrintable(_filename.toLocal8Bit()));
+                } else {
+                    _persistFileUnreadable = true;
+                }
+            }
+
+            // anything persisted after the last full save is in the change journal
+            QVariantList journalChanges = _journal.readChanges();
+
+            // if the persist file type was changed we loaded the newest file of the old type, so its journal is the one
+            // that goes with it, ours is older than that file
+            QString loadedFilename = findMostRecentFileExtension(_filename, PERSIST_EXTENSIONS);
+            if (loadedFilename != _filename) {
+                journalChanges = OctreeChangeJournal(loadedFilename).readChanges();
+                _journal.clear();
+                _wantSnapshot = true;
+            }
+            if (!journalChanges.isEmpty()) {
+                qCDebug(octree) << "Replaying" << journalChanges.size() << "changes from the change journal...";
+                _tree->replayJournalChanges(journalChanges);
+                persistantFileRead = true;
+
+                // fold them into a full save the next time we persist
+                _wantSnapshot = true;
+            }
+
             _tree->pruneTree();
         });
 
+        // from here on we want to hear about every change so that we can journal it
+        _tree->setTrackChangesForJournal(_wantChangeJournal);
+        _lastSnapshot = usecTimestampNow();
+
         quint64 loadDone = usecTimestampNow();
         _loadTimeUSecs = loadDone - loadStarted;
 
@@ -225,12 +285,42 @@ bool OctreePersistThread::process() {
 void OctreePersistThread::aboutToFinish() {
     qCDebug(octree) << "Persist thread about to finish...";
     persist();
+    waitForSnapshot();
     qCDebug(octree) << "Persist thread done with about to finish...";
     _stopThread = true;
 }
 
+bool OctreePersistThread::setAsideUnreadableFile(const QString& filename) {
+    QString asideFilename = filename + ".unreadable-" + QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss");
+
+    if (!QFile::rename(filename, asideFilename)) {
+        qCritical() << "Could not read" << filename << "and could not move it to" << asideFilename
+            << "- not persisting over it.";
+        return false;
+    }
+
+    qCritical() << "Could not read" << filename << "- moved it to" << asideFilename;
+
+    // keep the changes that were journaled on top of it along with it
+    QString journalFilename = filename + ".journal";
+    if (QFile::exists(journalFilename)) {
+        QFile::copy(journalFilename, asideFilename + ".journal");
+    }
+    return true;
+}
+
 void OctreePersistThread::persist() {
-    if (_tree->isDirty()) {
+    if (_persistFileUnreadable) {
+        qCDebug(octree) << "Not persisting, the persist file that failed to load is still in the way:" << _filename;
+        return;
+    }
+
+    if (_wantChangeJournal) {
+        persistChanges();
+        return;
+    }
+
+    if (_tree->isDirty() || _wantSnapshot) {
 
         _tree->withWriteLock([&] {
             qCDebug(octree) << "pruning Octree before saving...";
@@ -254,6 +344,10 @@ void OctreePersistThread::persist() {
             _tree->clearDirtyBit(); // tree is clean after saving
             qCDebug(octree) << "DONE saving Octree to file...";
 
+            // a journal left over from running with one is covered by this save
+            _journal.clear();
+            _wantSnapshot = false;
+
             lockFile.close();
             qCDebug(octree) << "saving Octree lock file closed:" << lockFileName;
             remove(qPrintable(lockFileName));
@@ -262,6 +356,118 @@ void OctreePersistThread::persist() {
     }
 }
 
+void OctreePersistThread::persistChanges() {
+    if (!_tree->isDirty() && !_wantSnapshot) {
+        return;
+    }
+
+    quint64 now = usecTimestampNow();
+    QFileInfo snapshotInfo(_filename);
+
+    // take a full save once the interval is up, or once replaying the journal would cost more than reading a full save
+    bool takeSnapshot = _wantSnapshot || !snapshotInfo.exists()
+        || (now - _lastSnapshot) > (quint64) _snapshotInterval * USECS_PER_SECOND
+        || _journal.getSize() > snapshotInfo.size();
+
+    if (takeSnapshot) {
+        _tree->withWriteLock([&] {
+            _tree->pruneTree();
+        });
+    }
+
+    QVariantList changes;
+    QVariantMap snapshot;
+    QByteArray binarySnapshot;
+    bool wantBinarySnapshot = _persistAsFileType == "bin";
+
+    // NOTE: callers must lock the tree before using this
+    auto collectSnapshot = [&] {
+        if (wantBinarySnapshot) {
+            _tree->writeToBinarySnapshot(binarySnapshot);
+        } else {
+            _tree->writeToJSONMap(snapshot);
+        }
+    };
+
+    {
+        PerformanceWarning warn(true, takeSnapshot ? "Collecting Octree Snapshot" : "Collecting Octree Changes", true);
+
+        _tree->withReadLock([&] {
+            _tree->takeChangesForJournal(changes);
+
+            if (takeSnapshot) {
+                collectSnapshot();
+            }
+
+            _tree->clearDirtyBit();
+        });
+    }
+
+    // the snapshot is taken under the same lock as the changes, so the journal up to here is covered by it
+    if (!changes.isEmpty()) {
+        if (_journal.append(changes)) {
+            qCDebug(octree) << "Journaled" << changes.size() << "changes to" << _filename;
+        } else {
+            // we have lost these changes from the journal, get them to disk with a full save
+            takeSnapshot = true;
+            _tree->withReadLock(collectSnapshot);
+        }
+    }
+
+    time(&_lastPersistTime);
+
+    if (!takeSnapshot) {
+        return;
+    }
+
+    // the previous snapshot has to be on disk before we back it up or move the journal aside again
+    waitForSnapshot();
+
+    qCDebug(octree) << "persist operation calling backup...";
+    backup(); // handle backup if requested
+    qCDebug(octree) << "persist operation DONE with backup...";
+
+    if (!_journal.beginCompaction()) {
+        // keep journaling on top of the last snapshot that made it, we'll try again next time
+        _wantSnapshot = true;
+        return;
+    }
+
+    _wantSnapshot = false;
+    _lastSnapshot = now;
+
+    // converting to JSON, compressing and writing the snapshot doesn't need the tree, so don't hold up persisting for it
+    bool doGzip = _persistAsFileType == "json.gz";
+    _snapshotThread = std::thread([this, snapshot, binarySnapshot, wantBinarySnapshot, doGzip] {
+        QString tempFileName = _filename + ".tmp";
+
+        bool wroteSnapshot = wantBinarySnapshot
+            ? OctreeBinarySnapshot::writeToFile(binarySnapshot, qPrintable(tempFileName))
+            : Octree::writeJSONMapToFile(snapshot, qPrintable(tempFileName), doGzip);
+
+        if (wroteSnapshot) {
+#ifdef Q_OS_WIN
+            // rename() fails on Windows if target exists
+            remove(qPrintable(_filename));
+#endif
+            if (rename(qPrintable(tempFileName), qPrintable(_filename)) == 0) {
+                _journal.finishCompaction();
+                qCDebug(octree) << "DONE saving Octree snapshot to file" << _filename;
+                return;
+            }
+        }
+
+        qCDebug(octree) << "ERROR saving Octree snapshot to file" << _filename << "- keeping its change journal";
+        remove(qPrintable(tempFileName));
+    });
+}
+
+void OctreePersistThread::waitForSnapshot() {
+    if (_snapshotThread.joinable()) {
+        _snapshotThread.join();
+    }
+}
+
 void OctreePersistThread::restoreFromMostRecentBackup() {
     qCDebug(octree) << "Restoring from most recent backup...";
     
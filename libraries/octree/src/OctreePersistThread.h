@@ -14,9 +14,12 @@
 #ifndef hifi_OctreePersistThread_h
 #define hifi_OctreePersistThread_h
 
+#include <thread>
+
 #include <QString>
 #include <GenericThread.h>
 #include "Octree.h"
+#include "OctreeChangeJournal.h"
 
 /// Generalized threaded processor for handling received inbound packets.
 class OctreePersistThread : public GenericThread {
@@ -32,10 +35,12 @@ public:
     };
 
     static const int DEFAULT_PERSIST_INTERVAL;
+    static const int DEFAULT_SNAPSHOT_INTERVAL;
 
     OctreePersistThread(OctreePointer tree, const QString& filename, int persistInterval = DEFAULT_PERSIST_INTERVAL,
                         bool wantBackup = false, const QJsonObject& settings = QJsonObject(),
                         bool debugTimestampNow = false, QString persistAsFileType="svo");
+    ~OctreePersistThread();
 
     bool isInitialLoadComplete() const { return _initialLoadComplete; }
     quint64 getLoadElapsedTime() const { return _loadTimeUSecs; }
@@ -50,9 +55,12 @@ protected:
     virtual bool process();
 
     void persist();
+    void persistChanges();
+    void waitForSnapshot();
     void backup();
     void rollOldBackupVersions(const BackupRule& rule);
     void restoreFromMostRecentBackup();
+    bool setAsideUnreadableFile(const QString& filename);
     bool getMostRecentBackup(const QString& format, QString& mostRecentBackupFileName, QDateTime& mostRecentBackupTime);
     quint64 getMostRecentBackupTimeInUsecs(const QString& format);
     void parseSettings(const QJsonObject& settings);
@@ -74,6 +82,15 @@ private:
     quint64 _lastTimeDebug;
 
     QString _persistAsFileType;
+
+    // between full saves (snapshots) only the changes are appended to the journal
+    OctreeChangeJournal _journal;
+    bool _wantChangeJournal;
+    int _snapshotInterval; // seconds, 0 writes a full save on every persist
+    quint64 _lastSnapshot;
+    bool _wantSnapshot;
+    std::thread _snapshotThread; // writes the last snapshot out to disk
+    bool _persistFileUnreadable; // the file we loaded from couldn't be read or moved aside, so never persist over it
 };
 
 #endif // hifi_OctreePersistThread_h
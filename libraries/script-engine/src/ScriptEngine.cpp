@@ -42,6 +42,7 @@
 #include "ScriptCache.h"
 #include "ScriptEngineLogging.h"
 #include "ScriptEngine.h"
+#include "ScriptScheduler.h"
 #include "TypedArrays.h"
 #include "XMLHttpRequestClass.h"
 #include "WebSocketClass.h"
@@ -653,30 +654,15 @@ QScriptValue ScriptEngine::evaluate(const QString& sourceCode, const QString& fi
 }
 
 void ScriptEngine::run() {
-    if (_stoppingAllScripts) {
-        return; // bail early - avoid setting state in init(), as evaluate() will bail too
-    }
-    
-    if (!_isInitialized) {
-        init();
-    }
-
-    _isRunning = true;
-    _isFinished = false;
-    if (_wantSignals) {
-        emit runningStateChanged();
+    if (!beginRunning()) {
+        return;
     }
 
-    QScriptValue result = evaluate(_scriptContents, _fileNameString);
-
     QElapsedTimer startTime;
     startTime.start();
 
     int thisFrame = 0;
 
-    auto nodeList = DependencyManager::get<NodeList>();
-    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
-
     qint64 lastUpdate = usecTimestampNow();
 
     while (!_isFinished) {
@@ -695,30 +681,62 @@ void ScriptEngine::run() {
             break;
         }
 
-        if (!_isFinished && entityScriptingInterface->getEntityPacketSender()->serversExist()) {
-            // release the queue of edit entity messages.
-            entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
-
-            // since we're in non-threaded mode, call process so that the packets are sent
-            if (!entityScriptingInterface->getEntityPacketSender()->isThreaded()) {
-                entityScriptingInterface->getEntityPacketSender()->process();
-            }
-        }
-
         qint64 now = usecTimestampNow();
         float deltaTime = (float) (now - lastUpdate) / (float) USECS_PER_SECOND;
 
-        if (!_isFinished) {
-            if (_wantSignals) {
-                emit update(deltaTime);
-            }
-        }
+        updateRunning(deltaTime);
         lastUpdate = now;
+    }
+
+    finishRunning();
+}
 
-        // Debug and clear exceptions
-        hadUncaughtExceptions(*this, _fileNameString);
+bool ScriptEngine::beginRunning() {
+    if (_stoppingAllScripts) {
+        return false; // bail early - avoid setting state in init(), as evaluate() will bail too
+    }
+    
+    if (!_isInitialized) {
+        init();
     }
 
+    _isRunning = true;
+    _isFinished = false;
+    if (_wantSignals) {
+        emit runningStateChanged();
+    }
+
+    evaluate(_scriptContents, _fileNameString);
+    return true;
+}
+
+void ScriptEngine::updateRunning(float deltaTime) {
+    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
+
+    if (!_isFinished && entityScriptingInterface->getEntityPacketSender()->serversExist()) {
+        // release the queue of edit entity messages.
+        entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
+
+        // since we're in non-threaded mode, call process so that the packets are sent - unless we're hosted on a
+        // ScriptScheduler, where whoever hosts us drives the sender from one thread rather than every instance doing it
+        if (!_schedulerWorker && !entityScriptingInterface->getEntityPacketSender()->isThreaded()) {
+            entityScriptingInterface->getEntityPacketSender()->process();
+        }
+    }
+
+    if (!_isFinished) {
+        if (_wantSignals) {
+            emit update(deltaTime);
+        }
+    }
+
+    // Debug and clear exceptions
+    hadUncaughtExceptions(*this, _fileNameString);
+}
+
+void ScriptEngine::finishRunning() {
+    auto entityScriptingInterface = DependencyManager::get<EntityScriptingInterface>();
+
     stopAllTimers(); // make sure all our timers are stopped if the script is ending
     if (_wantSignals) {
         emit scriptEnding();
@@ -729,7 +747,7 @@ void ScriptEngine::run() {
         entityScriptingInterface->getEntityPacketSender()->releaseQueuedMessages();
 
         // since we're in non-threaded mode, call process so that the packets are sent
-        if (!entityScriptingInterface->getEntityPacketSender()->isThreaded()) {
+        if (!_schedulerWorker && !entityScriptingInterface->getEntityPacketSender()->isThreaded()) {
             // wait here till the edit packet sender is completely done sending
             while (entityScriptingInterface->getEntityPacketSender()->hasPacketsToSend()) {
                 entityScriptingInterface->getEntityPacketSender()->process();
@@ -756,6 +774,11 @@ void ScriptEngine::run() {
 // NOTE: This is private because it must be called on the same thread that created the timers, which is why
 // we want to only call it in our own run "shutdown" processing.
 void ScriptEngine::stopAllTimers() {
+    if (_schedulerWorker) {
+        _schedulerWorker->removeTimers(this);
+        return;
+    }
+
     QMutableHashIterator<QTimer*, QScriptValue> i(_timerFunctionMap);
     while (i.hasNext()) {
         i.next();
@@ -811,6 +834,11 @@ void ScriptEngine::timerFired() {
 }
 
 QObject* ScriptEngine::setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot) {
+    if (_schedulerWorker) {
+        // our worker keeps the timers of all of its scripts together
+        return _schedulerWorker->addTimer(this, function, intervalMS, isSingleShot);
+    }
+
     // create the timer, add it to the map, and start it
     QTimer* newTimer = new QTimer(this);
     newTimer->setSingleShot(isSingleShot);
@@ -852,6 +880,14 @@ void ScriptEngine::stopTimer(QTimer *timer) {
     }
 }
 
+void ScriptEngine::clearTimer(QObject* timer) {
+    if (_schedulerWorker) {
+        _schedulerWorker->removeTimer(timer);
+    } else {
+        stopTimer(reinterpret_cast<QTimer*>(timer));
+    }
+}
+
 QUrl ScriptEngine::resolvePath(const QString& include) const {
     QUrl url(include);
     // first lets check to see if it's already a full URL
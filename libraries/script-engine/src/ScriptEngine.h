@@ -43,6 +43,8 @@ const unsigned int SCRIPT_DATA_CALLBACK_USECS = floor(((1.0f / 60.0f) * 1000 * 1
 
 typedef QHash<QString, QScriptValueList> RegisteredEventHandlers;
 
+class ScriptSchedulerWorker;
+
 class EntityScriptDetails {
 public:
     QString scriptText;
@@ -66,6 +68,8 @@ public:
 
     /// run the script in the callers thread, exit when stop() is called.
     void run();
+
+    // NOTE - to run the script on a worker shared with other scripts instead, hand it to a ScriptScheduler
     
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // NOTE - these are NOT intended to be public interfaces available to scripts, the are only Q_INVOKABLE so we can
@@ -107,8 +111,8 @@ public:
 
     Q_INVOKABLE QObject* setInterval(const QScriptValue& function, int intervalMS);
     Q_INVOKABLE QObject* setTimeout(const QScriptValue& function, int timeoutMS);
-    Q_INVOKABLE void clearInterval(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
-    Q_INVOKABLE void clearTimeout(QObject* timer) { stopTimer(reinterpret_cast<QTimer*>(timer)); }
+    Q_INVOKABLE void clearInterval(QObject* timer) { clearTimer(timer); }
+    Q_INVOKABLE void clearTimeout(QObject* timer) { clearTimer(timer); }
     Q_INVOKABLE void print(const QString& message);
     Q_INVOKABLE QUrl resolvePath(const QString& path) const;
 
@@ -173,6 +177,8 @@ protected:
     bool _wantSignals = true;
     QHash<EntityItemID, EntityScriptDetails> _entityScripts;
 private:
+    friend class ScriptSchedulerWorker;
+
     void init();
     QString getFilename() const;
     void waitTillDoneRunning();
@@ -181,10 +187,16 @@ private:
     void stopAllTimers();
     void refreshFileScript(const EntityItemID& entityID);
 
+    // the pieces of run(), so that a ScriptSchedulerWorker can drive the script from its own loop
+    bool beginRunning();
+    void updateRunning(float deltaTime);
+    void finishRunning();
+
     void setParentURL(const QString& parentURL) { _parentURL = parentURL; }
 
     QObject* setupTimerWithInterval(const QScriptValue& function, int intervalMS, bool isSingleShot);
     void stopTimer(QTimer* timer);
+    void clearTimer(QObject* timer);
 
     QString _fileNameString;
     Quat _quatLibrary;
@@ -193,6 +205,9 @@ private:
     bool _isUserLoaded;
     bool _isReloading;
 
+    // set when running on a ScriptScheduler, which then owns our timers
+    ScriptSchedulerWorker* _schedulerWorker { nullptr };
+
     ArrayBufferClass* _arrayBufferClass;
 
     QHash<EntityItemID, RegisteredEventHandlers> _registeredHandlers;
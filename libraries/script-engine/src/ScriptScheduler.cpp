@@ -0,0 +1,300 @@
+//
+//  ScriptScheduler.cpp
+//  libraries/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "ScriptScheduler.h"
+
+#include <algorithm>
+
+#include <NumericalConstants.h>
+
+#include "ScriptEngine.h"
+
+ScriptScheduler::ScriptScheduler(int numWorkers, QObject* parent) :
+    QObject(parent)
+{
+    if (numWorkers <= 0) {
+        numWorkers = std::max(QThread::idealThreadCount(), 1);
+    }
+
+    qRegisterMetaType<ScriptEngine*>();
+
+    for (int i = 0; i < numWorkers; ++i) {
+        QThread* thread = new QThread();
+        thread->setObjectName(QString("Script Scheduler Worker %1").arg(i));
+
+        ScriptSchedulerWorker* worker = new ScriptSchedulerWorker();
+        worker->moveToThread(thread);
+
+        connect(worker, &ScriptSchedulerWorker::scriptFinished, this, &ScriptScheduler::scriptFinished);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+
+        thread->start();
+
+        _workers.push_back(worker);
+        _threads.push_back(thread);
+    }
+}
+
+ScriptScheduler::~ScriptScheduler() {
+    for (QThread* thread : _threads) {
+        thread->quit();
+    }
+    for (QThread* thread : _threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+void ScriptScheduler::addScript(ScriptEngine* engine) {
+    auto worker = *std::min_element(_workers.begin(), _workers.end(),
+        [](const ScriptSchedulerWorker* a, const ScriptSchedulerWorker* b) {
+            return a->getNumScripts() < b->getNumScripts();
+        });
+
+    // counted now, so that scripts added back to back are spread out before the workers have started them
+    ++worker->_numScripts;
+    ++_numScripts;
+
+    engine->moveToThread(worker->thread());
+    QMetaObject::invokeMethod(worker, "startScript", Q_ARG(ScriptEngine*, engine));
+}
+
+void ScriptScheduler::stopAllScripts() {
+    // blocks until every engine has ended, so that they are done with anything they share before the caller tears it down
+    for (ScriptSchedulerWorker* worker : _workers) {
+        QMetaObject::invokeMethod(worker, "stopAllScripts", Qt::BlockingQueuedConnection);
+    }
+}
+
+void ScriptScheduler::scriptFinished() {
+    if (--_numScripts == 0) {
+        emit allScriptsFinished();
+    }
+}
+
+ScriptSchedulerWorker::ScriptSchedulerWorker() :
+    _wakeTimer(this)
+{
+    _clock.start();
+
+    _wakeTimer.setSingleShot(true);
+    _wakeTimer.setTimerType(Qt::PreciseTimer);
+    connect(&_wakeTimer, &QTimer::timeout, this, &ScriptSchedulerWorker::wake);
+}
+
+void ScriptSchedulerWorker::startScript(ScriptEngine* engine) {
+    engine->_schedulerWorker = this;
+
+    if (!engine->beginRunning()) {
+        // we're stopping all scripts, this one never gets to run
+        engine->deleteLater();
+        --_numScripts;
+        emit scriptFinished();
+        return;
+    }
+
+    quint64 now = _clock.nsecsElapsed() / NSECS_PER_USEC;
+    if (_engines.empty()) {
+        _lastUpdateUsecs = now;
+        _nextUpdateUsecs = now + SCRIPT_DATA_CALLBACK_USECS;
+    }
+    _engines.push_back(engine);
+
+    scheduleWake(now);
+}
+
+void ScriptSchedulerWorker::stopAllScripts() {
+    _wakeTimer.stop();
+
+    // finishing an engine processes events, which can start others on this worker, so take them one at a time
+    while (!_engines.empty()) {
+        ScriptEngine* engine = _engines.back();
+        _engines.pop_back();
+
+        engine->stop();
+        engine->finishRunning();
+        delete engine;
+
+        --_numScripts;
+        emit scriptFinished();
+    }
+}
+
+QObject* ScriptSchedulerWorker::addTimer(ScriptEngine* engine, const QScriptValue& function,
+                                         int intervalMS, bool isSingleShot) {
+    Timer timer;
+    timer.id = ++_lastTimerID;
+    timer.engine = engine;
+    timer.handle = new QObject(engine);
+    timer.function = function;
+    timer.intervalMS = intervalMS;
+    timer.isSingleShot = isSingleShot;
+
+    // the wheel is only advanced when we wake up, count from now rather than from then
+    quint64 nowMS = _clock.elapsed();
+    if (_timers.isEmpty()) {
+        _wheelTime = nowMS;
+    }
+    insertTimer(timer, intervalMS + (int)(nowMS - _wheelTime));
+
+    scheduleWake(_clock.nsecsElapsed() / NSECS_PER_USEC);
+    return timer.handle;
+}
+
+void ScriptSchedulerWorker::removeTimer(QObject* handle) {
+    auto found = _timers.find(handle);
+    if (found != _timers.end()) {
+        _wheel[found.value().first].erase(found.value().second);
+        _timers.erase(found);
+        delete handle;
+    }
+}
+
+void ScriptSchedulerWorker::removeTimers(ScriptEngine* engine) {
+    auto it = _timers.begin();
+    while (it != _timers.end()) {
+        if (it.value().second->engine == engine) {
+            QObject* handle = it.key();
+            _wheel[it.value().first].erase(it.value().second);
+            it = _timers.erase(it);
+            delete handle;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ScriptSchedulerWorker::insertTimer(Timer timer, int delayMS) {
+    int ticks = std::max(delayMS, 1);
+    int slot = (int)((_wheelTime + ticks) % WHEEL_SLOTS);
+    timer.rounds = (ticks - 1) / WHEEL_SLOTS;
+
+    TimerList& list = _wheel[slot];
+    list.push_back(timer);
+    _timers.insert(timer.handle, std::make_pair(slot, std::prev(list.end())));
+}
+
+void ScriptSchedulerWorker::advanceWheel(quint64 nowMS) {
+    if (_timers.isEmpty()) {
+        _wheelTime = nowMS;
+        return;
+    }
+
+    std::vector<std::pair<QObject*, quint64>> due;
+
+    while (_wheelTime < nowMS) {
+        ++_wheelTime;
+        int slot = (int)(_wheelTime % WHEEL_SLOTS);
+
+        due.clear();
+        for (Timer& timer : _wheel[slot]) {
+            if (timer.rounds > 0) {
+                --timer.rounds;
+            } else if (!timer.engine->isFinished()) {
+                due.push_back(std::make_pair(timer.handle, timer.id));
+            }
+        }
+
+        for (auto& handleAndID : due) {
+            // a callback we already made this turn can clear or replace a timer that was due after it
+            auto found = _timers.find(handleAndID.first);
+            if (found == _timers.end() || found.value().second->id != handleAndID.second) {
+                continue;
+            }
+
+            Timer timer = *found.value().second;
+            _wheel[found.value().first].erase(found.value().second);
+            _timers.erase(found);
+
+            if (timer.isSingleShot) {
+                delete timer.handle;
+            } else {
+                // rescheduled before the call, so that the callback can clear it
+                insertTimer(timer, timer.intervalMS);
+            }
+
+            if (timer.function.isValid()) {
+                timer.function.call();
+            }
+        }
+    }
+}
+
+quint64 ScriptSchedulerWorker::nextTimerDue(quint64 untilMS) const {
+    if (!_timers.isEmpty()) {
+        for (quint64 time = _wheelTime + 1; time < untilMS; ++time) {
+            for (const Timer& timer : _wheel[time % WHEEL_SLOTS]) {
+                if (timer.rounds == 0) {
+                    return time;
+                }
+            }
+        }
+    }
+    return untilMS;
+}
+
+void ScriptSchedulerWorker::updateScripts(quint64 now) {
+    float deltaTime = (float)(now - _lastUpdateUsecs) / (float)USECS_PER_SECOND;
+    _lastUpdateUsecs = now;
+
+    // if we fell more than a whole update behind, don't try to catch up with back to back updates
+    _nextUpdateUsecs += SCRIPT_DATA_CALLBACK_USECS;
+    if (_nextUpdateUsecs <= now) {
+        _nextUpdateUsecs = now + SCRIPT_DATA_CALLBACK_USECS;
+    }
+
+    // finishing an engine processes events, which can start others on this worker, so walk by index
+    size_t i = 0;
+    while (i < _engines.size()) {
+        ScriptEngine* engine = _engines[i];
+
+        if (!engine->isFinished()) {
+            engine->updateRunning(deltaTime);
+        }
+
+        if (engine->isFinished()) {
+            _engines.erase(_engines.begin() + i);
+
+            engine->finishRunning();
+            engine->deleteLater();
+
+            --_numScripts;
+            emit scriptFinished();
+        } else {
+            ++i;
+        }
+    }
+}
+
+void ScriptSchedulerWorker::scheduleWake(quint64 now) {
+    if (_engines.empty()) {
+        // timers only belong to running engines, so there is nothing to wake up for
+        _wakeTimer.stop();
+        return;
+    }
+
+    quint64 nowMS = now / USECS_PER_MSEC;
+    quint64 updateMS = (_nextUpdateUsecs + USECS_PER_MSEC - 1) / USECS_PER_MSEC;
+    quint64 wakeMS = nextTimerDue(updateMS);
+
+    _wakeTimer.start((int)(wakeMS > nowMS ? wakeMS - nowMS : 0));
+}
+
+void ScriptSchedulerWorker::wake() {
+    quint64 now = _clock.nsecsElapsed() / NSECS_PER_USEC;
+
+    advanceWheel(now / USECS_PER_MSEC);
+
+    if (now >= _nextUpdateUsecs) {
+        updateScripts(now);
+    }
+
+    scheduleWake(_clock.nsecsElapsed() / NSECS_PER_USEC);
+}
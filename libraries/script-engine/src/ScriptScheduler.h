@@ -0,0 +1,121 @@
+//
+//  ScriptScheduler.h
+//  libraries/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptScheduler_h
+#define hifi_ScriptScheduler_h
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtScript/QScriptValue>
+
+class ScriptEngine;
+class ScriptSchedulerWorker;
+
+/// Runs many ScriptEngines on a small set of worker threads, instead of a thread and a run loop per engine.
+/// Each worker has its own event loop, ticks the update of all of its engines together at SCRIPT_DATA_CALLBACK_USECS
+/// and keeps their setTimeout/setInterval callbacks in a timer wheel, so an engine with nothing to do costs nothing.
+class ScriptScheduler : public QObject {
+    Q_OBJECT
+public:
+    /// numWorkers of 0 uses one worker per core
+    ScriptScheduler(int numWorkers = 0, QObject* parent = nullptr);
+    ~ScriptScheduler();
+
+    int getNumWorkers() const { return (int) _workers.size(); }
+    int getNumScripts() const { return _numScripts; }
+
+    /// moves the engine to the least loaded worker and runs it there, the engine is deleted once it has finished
+    void addScript(ScriptEngine* engine);
+
+    /// stops, finishes and deletes every engine, returning once they all have. Don't call it from a worker thread.
+    void stopAllScripts();
+
+signals:
+    void allScriptsFinished();
+
+private slots:
+    void scriptFinished();
+
+private:
+    std::vector<ScriptSchedulerWorker*> _workers;
+    std::vector<QThread*> _threads;
+    int _numScripts { 0 };
+};
+
+/// One worker of a ScriptScheduler, living on its own thread along with the engines it runs.
+class ScriptSchedulerWorker : public QObject {
+    Q_OBJECT
+public:
+    ScriptSchedulerWorker();
+
+    int getNumScripts() const { return _numScripts; }
+
+    // timers for the engines of this worker, only called from its thread
+    QObject* addTimer(ScriptEngine* engine, const QScriptValue& function, int intervalMS, bool isSingleShot);
+    void removeTimer(QObject* handle);
+    void removeTimers(ScriptEngine* engine);
+
+public slots:
+    void startScript(ScriptEngine* engine);
+    void stopAllScripts();
+
+signals:
+    void scriptFinished();
+
+private slots:
+    void wake();
+
+private:
+    friend class ScriptScheduler;
+    friend class ScriptSchedulerTests;
+
+    class Timer {
+    public:
+        quint64 id; // handles can be reused once deleted, ids can't
+        ScriptEngine* engine;
+        QObject* handle;
+        QScriptValue function;
+        int intervalMS;
+        bool isSingleShot;
+        int rounds; // turns of the wheel left before it is due
+    };
+    using TimerList = std::list<Timer>;
+
+    // one millisecond per slot, timers further out than a turn wait for their rounds to run down
+    static const int WHEEL_SLOTS = 256;
+
+    void insertTimer(Timer timer, int delayMS);
+    void advanceWheel(quint64 now);
+    quint64 nextTimerDue(quint64 until) const;
+    void updateScripts(quint64 now);
+    void scheduleWake(quint64 now);
+
+    QElapsedTimer _clock;
+    QTimer _wakeTimer;
+
+    std::vector<ScriptEngine*> _engines;
+    std::atomic<int> _numScripts { 0 };
+    quint64 _lastUpdateUsecs { 0 };
+    quint64 _nextUpdateUsecs { 0 };
+
+    TimerList _wheel[WHEEL_SLOTS];
+    quint64 _wheelTime { 0 }; // msecs on _clock that the wheel has been advanced through
+    QHash<QObject*, std::pair<int, TimerList::iterator>> _timers;
+    quint64 _lastTimerID { 0 };
+};
+
+#endif // hifi_ScriptScheduler_h
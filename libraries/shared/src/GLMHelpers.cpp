@@ -134,6 +134,85 @@ int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatO
     return sizeof(quatParts);
 }
 
+const int SMALLEST_THREE_COMPONENT_BITS = 15;
+const float SMALLEST_THREE_COMPONENT_RANGE = 0.70710678f; // 1 / sqrt(2)
+
+uint64_t packOrientationQuatToSmallestThree(const glm::quat& quatInput) {
+    glm::quat quatNormalized = glm::normalize(quatInput);
+    float components[4] = { quatNormalized.x, quatNormalized.y, quatNormalized.z, quatNormalized.w };
+
+    int largestIndex = 0;
+    for (int i = 1; i < 4; i++) {
+        if (fabsf(components[i]) > fabsf(components[largestIndex])) {
+            largestIndex = i;
+        }
+    }
+
+    // q and -q are the same orientation, flip so that the dropped component is positive
+    float sign = components[largestIndex] < 0.0f ? -1.0f : 1.0f;
+
+    const uint64_t COMPONENT_MAX = (1 << SMALLEST_THREE_COMPONENT_BITS) - 1;
+    uint64_t packed = largestIndex;
+    int shift = 2;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float normalized = (sign * components[i] + SMALLEST_THREE_COMPONENT_RANGE) / (2.0f * SMALLEST_THREE_COMPONENT_RANGE);
+            uint64_t part = (uint64_t)glm::clamp(roundf(normalized * COMPONENT_MAX), 0.0f, (float)COMPONENT_MAX);
+            packed |= part << shift;
+            shift += SMALLEST_THREE_COMPONENT_BITS;
+        }
+    }
+    return packed;
+}
+
+glm::quat unpackOrientationQuatFromSmallestThree(uint64_t packed) {
+    const uint64_t COMPONENT_MAX = (1 << SMALLEST_THREE_COMPONENT_BITS) - 1;
+    int largestIndex = (int)(packed & 0x3);
+
+    float components[4];
+    float sumOfSquares = 0.0f;
+    int shift = 2;
+    for (int i = 0; i < 4; i++) {
+        if (i != largestIndex) {
+            float normalized = ((packed >> shift) & COMPONENT_MAX) / (float)COMPONENT_MAX;
+            components[i] = normalized * 2.0f * SMALLEST_THREE_COMPONENT_RANGE - SMALLEST_THREE_COMPONENT_RANGE;
+            sumOfSquares += components[i] * components[i];
+            shift += SMALLEST_THREE_COMPONENT_BITS;
+        }
+    }
+    components[largestIndex] = sqrtf(glm::max(0.0f, 1.0f - sumOfSquares));
+
+    return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+}
+
+uint64_t packFloatVec3ToSignedBits(const glm::vec3& vector, float range, int bitsPerComponent) {
+    const int64_t componentMax = ((int64_t)1 << (bitsPerComponent - 1)) - 1;
+    const uint64_t componentMask = ((uint64_t)1 << bitsPerComponent) - 1;
+    float scale = range > 0.0f ? componentMax / range : 0.0f;
+
+    uint64_t packed = 0;
+    for (int i = 0; i < 3; i++) {
+        int64_t part = (int64_t)glm::clamp(roundf(vector[i] * scale), (float)-componentMax, (float)componentMax);
+        packed |= ((uint64_t)part & componentMask) << (i * bitsPerComponent);
+    }
+    return packed;
+}
+
+glm::vec3 unpackFloatVec3FromSignedBits(uint64_t packed, float range, int bitsPerComponent) {
+    const int64_t componentMax = ((int64_t)1 << (bitsPerComponent - 1)) - 1;
+    const uint64_t componentMask = ((uint64_t)1 << bitsPerComponent) - 1;
+    const uint64_t signBit = (uint64_t)1 << (bitsPerComponent - 1);
+
+    glm::vec3 vector;
+    for (int i = 0; i < 3; i++) {
+        uint64_t bits = (packed >> (i * bitsPerComponent)) & componentMask;
+        // sign extend
+        int64_t part = (bits & signBit) ? (int64_t)(bits | ~componentMask) : (int64_t)bits;
+        vector[i] = part * range / componentMax;
+    }
+    return vector;
+}
+
 //  Safe version of glm::eulerAngles; uses the factorization method described in David Eberly's
 //  http://www.geometrictools.com/Documentation/EulerAngles.pdf (via Clyde,
 // https://github.com/threerings/clyde/blob/master/src/main/java/com/threerings/math/Quaternion.java)
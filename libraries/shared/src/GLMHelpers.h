@@ -95,6 +95,18 @@ int unpackFloatAngleFromTwoByte(const uint16_t* byteAnglePointer, float* destina
 int packOrientationQuatToBytes(unsigned char* buffer, const glm::quat& quatInput);
 int unpackOrientationQuatFromBytes(const unsigned char* buffer, glm::quat& quatOutput);
 
+// "Smallest three" packing of an orientation quat: the largest component is dropped and rebuilt from the other three,
+// which are each within +/- 1/sqrt(2). Uses the low SMALLEST_THREE_QUAT_BITS bits of the result, 2 bits for the index
+// of the dropped component and 15 bits for each of the other three.
+const int SMALLEST_THREE_QUAT_BITS = 47;
+uint64_t packOrientationQuatToSmallestThree(const glm::quat& quatInput);
+glm::quat unpackOrientationQuatFromSmallestThree(uint64_t packed);
+
+// Packs each component of a vec3 into a signed bitsPerComponent-bit integer spanning [-range, range].
+// Components outside of that range are clamped, uses the low 3 * bitsPerComponent bits of the result.
+uint64_t packFloatVec3ToSignedBits(const glm::vec3& vector, float range, int bitsPerComponent);
+glm::vec3 unpackFloatVec3FromSignedBits(uint64_t packed, float range, int bitsPerComponent);
+
 // Ratios need the be highly accurate when less than 10, but not very accurate above 10, and they
 // are never greater than 1000 to 1, this allows us to encode each component in 16bits
 int packFloatRatioToTwoByte(unsigned char* buffer, float ratio);
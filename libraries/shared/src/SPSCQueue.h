@@ -0,0 +1,86 @@
+//
+//  SPSCQueue.h
+//  libraries/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#pragma once
+
+#ifndef hifi_SPSCQueue_h
+#define hifi_SPSCQueue_h
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/// A bounded queue for handing items from exactly one producer thread to exactly one consumer thread without a lock.
+///
+/// push may only ever be called from the producer and pop from the consumer. The capacity is rounded up to a power
+/// of two; push fails rather than blocks once the queue is full.
+template<typename T>
+class SPSCQueue {
+public:
+    SPSCQueue(size_t capacity) : _slots(roundUpToPowerOfTwo(capacity)), _mask(_slots.size() - 1) {}
+
+    size_t capacity() const { return _slots.size(); }
+
+    // approximate from any thread other than the producer or consumer
+    size_t size() const { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+    bool isEmpty() const { return size() == 0; }
+
+    /// returns false and leaves item alone if the queue is full
+    bool push(T&& item) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) == _slots.size()) {
+            return false;
+        }
+
+        _slots[tail & _mask] = std::move(item);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// returns false if the queue is empty
+    bool pop(T& item) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        // move out and reset the slot so it doesn't hold on to what it pointed at until it is reused
+        item = std::move(_slots[head & _mask]);
+        _slots[head & _mask] = T();
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    SPSCQueue(const SPSCQueue& other) = delete;
+    SPSCQueue& operator=(const SPSCQueue& other) = delete;
+
+    static size_t roundUpToPowerOfTwo(size_t capacity) {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    std::vector<T> _slots;
+    const size_t _mask;
+
+    // head is only written by the consumer and tail by the producer, pad them onto cache lines of their own
+    // - alignas would make whatever holds the queue over-aligned, which plain operator new doesn't honour in C++11
+    char _headPadding[64];
+    std::atomic<size_t> _head { 0 };
+    char _tailPadding[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> _tail { 0 };
+    char _endPadding[64 - sizeof(std::atomic<size_t>)];
+};
+
+#endif // hifi_SPSCQueue_h
@@ -0,0 +1,150 @@
+//
+//  AudioCodecTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioCodecTests.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <AudioCodec.h>
+#include <AudioConstants.h>
+
+QTEST_MAIN(AudioCodecTests)
+
+const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+const int NUM_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+const float TWO_PI = 6.28318530718f;
+
+// a tone with its frequency and amplitude picked so it covers a range of step sizes, like speech does
+static void fillWithTone(int16_t* samples, int numFrames, int numChannels, int channel, float frequency, float amplitude) {
+    for (int i = 0; i < numFrames; i++) {
+        float phase = TWO_PI * frequency * (float)i / (float)AudioConstants::SAMPLE_RATE;
+        samples[i * numChannels + channel] = (int16_t)(amplitude * sinf(phase));
+    }
+}
+
+// signal to noise ratio of the decoded samples, in dB
+static float signalToNoise(const int16_t* original, const int16_t* decoded, int numSamples, int numChannels, int channel) {
+    double signal = 0.0;
+    double noise = 0.0;
+    for (int i = channel; i < numSamples; i += numChannels) {
+        double error = (double)decoded[i] - (double)original[i];
+        signal += (double)original[i] * (double)original[i];
+        noise += error * error;
+    }
+    return (noise > 0.0) ? (float)(10.0 * log10(signal / noise)) : INFINITY;
+}
+
+void AudioCodecTests::lookup() {
+    const AudioCodec* pcm = AudioCodec::getPCM();
+    QVERIFY(pcm != NULL);
+    QCOMPARE(AudioCodec::forID(pcm->getID()), pcm);
+    QCOMPARE(AudioCodec::forName(pcm->getName()), pcm);
+
+    QStringList names = AudioCodec::getSupportedNames();
+    QVERIFY(names.size() > 1);
+    QVERIFY(names.contains(pcm->getName()));
+
+    foreach (const QString& name, names) {
+        const AudioCodec* codec = AudioCodec::forName(name);
+        QVERIFY(codec != NULL);
+        QCOMPARE(AudioCodec::forID(codec->getID()), codec);
+    }
+
+    QVERIFY(AudioCodec::forName("no-such-codec") == NULL);
+    QVERIFY(AudioCodec::forID(255) == NULL);
+}
+
+void AudioCodecTests::selectFrom() {
+    // the first offered codec that we support wins
+    QCOMPARE(AudioCodec::selectFrom(QStringList() << "no-such-codec" << "ima-adpcm" << "pcm"),
+             AudioCodec::forName("ima-adpcm"));
+    QCOMPARE(AudioCodec::selectFrom(QStringList() << "pcm" << "ima-adpcm"), AudioCodec::getPCM());
+
+    // everyone falls back to PCM
+    QCOMPARE(AudioCodec::selectFrom(QStringList() << "no-such-codec"), AudioCodec::getPCM());
+    QCOMPARE(AudioCodec::selectFrom(QStringList()), AudioCodec::getPCM());
+}
+
+void AudioCodecTests::pcmRoundTrip() {
+    const AudioCodec* pcm = AudioCodec::getPCM();
+
+    int16_t samples[NUM_SAMPLES];
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        samples[i] = (int16_t)((qrand() % 65536) - 32768);
+    }
+
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+    QCOMPARE(pcm->getEncodedBytes(NUM_SAMPLES, 2), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+    QCOMPARE(pcm->encode(samples, NUM_SAMPLES, 2, encoded), AudioConstants::NETWORK_FRAME_BYTES_STEREO);
+
+    int16_t decoded[NUM_SAMPLES];
+    QCOMPARE(pcm->getDecodedSamples(AudioConstants::NETWORK_FRAME_BYTES_STEREO, 2), NUM_SAMPLES);
+    QCOMPARE(pcm->decode(encoded, AudioConstants::NETWORK_FRAME_BYTES_STEREO, 2, decoded), NUM_SAMPLES);
+    QCOMPARE(memcmp(samples, decoded, sizeof(samples)), 0);
+}
+
+void AudioCodecTests::adpcmSize() {
+    const AudioCodec* adpcm = AudioCodec::forName("ima-adpcm");
+
+    // at least a 3.5x saving on a frame, whether it is the mono mic or the stereo mix
+    QVERIFY(adpcm->getEncodedBytes(NUM_SAMPLES, 2) * 7 <= AudioConstants::NETWORK_FRAME_BYTES_STEREO * 2);
+    QVERIFY(adpcm->getEncodedBytes(NUM_FRAMES, 1) * 7 <= AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL * 2);
+
+    QCOMPARE(adpcm->getDecodedSamples(adpcm->getEncodedBytes(NUM_SAMPLES, 2), 2), NUM_SAMPLES);
+    QCOMPARE(adpcm->getDecodedSamples(adpcm->getEncodedBytes(NUM_FRAMES, 1), 1), NUM_FRAMES);
+
+    // too short to hold the headers
+    QCOMPARE(adpcm->getDecodedSamples(1, 2), 0);
+}
+
+void AudioCodecTests::adpcmRoundTrip() {
+    const AudioCodec* adpcm = AudioCodec::forName("ima-adpcm");
+
+    int16_t samples[NUM_FRAMES];
+    fillWithTone(samples, NUM_FRAMES, 1, 0, 440.0f, 8000.0f);
+
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_PER_CHANNEL];
+    int encodedBytes = adpcm->encode(samples, NUM_FRAMES, 1, encoded);
+    QCOMPARE(encodedBytes, adpcm->getEncodedBytes(NUM_FRAMES, 1));
+
+    int16_t decoded[NUM_FRAMES];
+    QCOMPARE(adpcm->decode(encoded, encodedBytes, 1, decoded), NUM_FRAMES);
+
+    const float MIN_SIGNAL_TO_NOISE = 20.0f;
+    QVERIFY(signalToNoise(samples, decoded, NUM_FRAMES, 1, 0) > MIN_SIGNAL_TO_NOISE);
+
+    // silence stays close to silent
+    memset(samples, 0, sizeof(samples));
+    encodedBytes = adpcm->encode(samples, NUM_FRAMES, 1, encoded);
+    adpcm->decode(encoded, encodedBytes, 1, decoded);
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        QVERIFY(abs(decoded[i]) < 8);
+    }
+}
+
+void AudioCodecTests::adpcmStereoChannelsAreIndependent() {
+    const AudioCodec* adpcm = AudioCodec::forName("ima-adpcm");
+
+    // a loud low tone on the left and a quiet high one on the right
+    int16_t samples[NUM_SAMPLES];
+    fillWithTone(samples, NUM_FRAMES, 2, 0, 220.0f, 20000.0f);
+    fillWithTone(samples, NUM_FRAMES, 2, 1, 1760.0f, 2000.0f);
+
+    char encoded[AudioConstants::NETWORK_FRAME_BYTES_STEREO];
+    int encodedBytes = adpcm->encode(samples, NUM_SAMPLES, 2, encoded);
+
+    int16_t decoded[NUM_SAMPLES];
+    QCOMPARE(adpcm->decode(encoded, encodedBytes, 2, decoded), NUM_SAMPLES);
+
+    const float MIN_SIGNAL_TO_NOISE = 20.0f;
+    QVERIFY(signalToNoise(samples, decoded, NUM_SAMPLES, 2, 0) > MIN_SIGNAL_TO_NOISE);
+    QVERIFY(signalToNoise(samples, decoded, NUM_SAMPLES, 2, 1) > MIN_SIGNAL_TO_NOISE);
+}
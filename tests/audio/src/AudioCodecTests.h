@@ -0,0 +1,27 @@
+//
+//  AudioCodecTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioCodecTests_h
+#define hifi_AudioCodecTests_h
+
+#include <QtTest/QtTest>
+
+class AudioCodecTests : public QObject {
+    Q_OBJECT
+private slots:
+    void lookup();
+    void selectFrom();
+    void pcmRoundTrip();
+    void adpcmSize();
+    void adpcmRoundTrip();
+    void adpcmStereoChannelsAreIndependent();
+};
+
+#endif // hifi_AudioCodecTests_h
@@ -0,0 +1,156 @@
+//
+//  AudioMixKernelsTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioMixKernelsTests.h"
+
+#include <glm/glm.hpp>
+
+#include <AudioConstants.h>
+#include <AudioMixKernels.h>
+#include <AudioRingBuffer.h>
+
+QTEST_MAIN(AudioMixKernelsTests)
+
+const int NUM_FRAMES = AudioConstants::NETWORK_FRAME_SAMPLES_PER_CHANNEL;
+const int NUM_SAMPLES = AudioConstants::NETWORK_FRAME_SAMPLES_STEREO;
+const int MAX_DELAY = 20;
+const int NUM_BENCHMARK_SOURCES = 100;
+
+static void fillWithNoise(int16_t* samples, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+        samples[i] = (int16_t)((qrand() % 65536) - 32768);
+    }
+}
+
+// the mono path AudioMixer::addStreamToMixForListeningNodeWithStream used before the kernels,
+// reading through the ring buffer iterator and clamping into an int16 mix for every stream
+static void mixMonoToStereoInt16(int16_t* mix, AudioRingBuffer::ConstIterator input, float gainL, float gainR, int delay) {
+    int16_t preMix[NUM_SAMPLES + (MAX_DELAY * 2)];
+    memset(preMix, 0, sizeof(preMix));
+
+    int leftIndex = 0;
+    int rightIndex = 1 + (delay * 2);
+
+    AudioRingBuffer::ConstIterator historical = input - delay;
+    int historicalIndex = 1;
+    for (int i = 0; i < delay; i++) {
+        preMix[historicalIndex] += *historical * gainR;
+        ++historical;
+        historicalIndex += 2;
+    }
+
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        int16_t sample = input[i];
+        if (leftIndex <= NUM_SAMPLES) {
+            preMix[leftIndex] += (int16_t)(sample * gainL);
+        }
+        if (rightIndex <= NUM_SAMPLES) {
+            preMix[rightIndex] += (int16_t)(sample * gainR);
+        }
+        leftIndex += 2;
+        rightIndex += 2;
+    }
+
+    for (int s = 0; s < NUM_SAMPLES; s++) {
+        mix[s] = glm::clamp(mix[s] + preMix[s], AudioConstants::MIN_SAMPLE_VALUE, AudioConstants::MAX_SAMPLE_VALUE);
+    }
+}
+
+void AudioMixKernelsTests::mixMonoToStereo() {
+    int16_t input[MAX_DELAY + NUM_FRAMES];
+    fillWithNoise(input, MAX_DELAY + NUM_FRAMES);
+
+    float mix[NUM_SAMPLES];
+    memset(mix, 0, sizeof(mix));
+
+    const float GAIN_L = 0.8f;
+    const float GAIN_R = 0.3f;
+    const int16_t* frame = input + MAX_DELAY;
+
+    ::mixMonoToStereo(mix, frame, input, GAIN_L, GAIN_R, NUM_FRAMES);
+
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        QCOMPARE(mix[2 * i], frame[i] * GAIN_L);
+        QCOMPARE(mix[2 * i + 1], input[i] * GAIN_R);
+    }
+}
+
+void AudioMixKernelsTests::mixStereo() {
+    int16_t input[NUM_SAMPLES];
+    fillWithNoise(input, NUM_SAMPLES);
+
+    float mix[NUM_SAMPLES];
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        mix[i] = (float)i;
+    }
+
+    const float GAIN = 0.5f;
+    ::mixStereo(mix, input, GAIN, NUM_SAMPLES);
+
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        QCOMPARE(mix[i], (float)i + input[i] * GAIN);
+    }
+}
+
+void AudioMixKernelsTests::convertMixToInt16() {
+    // an odd count so the leftovers after the SIMD loop are covered too
+    const int NUM_TEST_SAMPLES = 37;
+    float mix[NUM_TEST_SAMPLES];
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        mix[i] = (i - NUM_TEST_SAMPLES / 2) * 4000.25f;
+    }
+
+    int16_t output[NUM_TEST_SAMPLES];
+    ::convertMixToInt16(mix, output, NUM_TEST_SAMPLES);
+
+    for (int i = 0; i < NUM_TEST_SAMPLES; i++) {
+        int expected = glm::clamp((int)lrintf(mix[i]), AudioConstants::MIN_SAMPLE_VALUE, AudioConstants::MAX_SAMPLE_VALUE);
+        QCOMPARE((int)output[i], expected);
+    }
+}
+
+void AudioMixKernelsTests::benchmarkInt16Mix() {
+    AudioRingBuffer ringBuffer(NUM_FRAMES);
+    int16_t input[NUM_FRAMES * 2];
+    fillWithNoise(input, NUM_FRAMES * 2);
+    ringBuffer.writeSamples(input, NUM_FRAMES * 2);
+    ringBuffer.shiftReadPosition(NUM_FRAMES);
+
+    int16_t mix[NUM_SAMPLES];
+
+    QBENCHMARK {
+        memset(mix, 0, sizeof(mix));
+        for (int source = 0; source < NUM_BENCHMARK_SOURCES; source++) {
+            mixMonoToStereoInt16(mix, ringBuffer.nextOutput(), 0.1f, 0.05f, source % MAX_DELAY);
+        }
+    }
+}
+
+void AudioMixKernelsTests::benchmarkKernelMix() {
+    AudioRingBuffer ringBuffer(NUM_FRAMES);
+    int16_t input[NUM_FRAMES * 2];
+    fillWithNoise(input, NUM_FRAMES * 2);
+    ringBuffer.writeSamples(input, NUM_FRAMES * 2);
+    ringBuffer.shiftReadPosition(NUM_FRAMES);
+
+    int16_t streamSamples[MAX_DELAY + NUM_FRAMES];
+    float mix[NUM_SAMPLES];
+    int16_t output[NUM_SAMPLES];
+
+    QBENCHMARK {
+        memset(mix, 0, sizeof(mix));
+        for (int source = 0; source < NUM_BENCHMARK_SOURCES; source++) {
+            int delay = source % MAX_DELAY;
+            (ringBuffer.nextOutput() - delay).readSamples(streamSamples, delay + NUM_FRAMES);
+            ::mixMonoToStereo(mix, streamSamples + delay, streamSamples, 0.1f, 0.05f, NUM_FRAMES);
+        }
+        ::convertMixToInt16(mix, output, NUM_SAMPLES);
+    }
+}
@@ -0,0 +1,232 @@
+//
+//  AudioSRCTests.cpp
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AudioSRCTests.h"
+
+#include <algorithm>
+#include <math.h>
+
+#include <QtCore/QElapsedTimer>
+
+#include <AudioSIMD.h>
+#include <AudioSRC.h>
+
+QTEST_MAIN(AudioSRCTests)
+
+const int NETWORK_SAMPLE_RATE = 24000;
+const int BLOCKS_PER_SECOND = 100;
+const int NUM_BENCHMARK_SECONDS = 10;
+
+static QVector<int16_t> makeSine(int sampleRate, int numChannels, int numFrames, float frequency, float amplitude) {
+    QVector<int16_t> samples(numFrames * numChannels);
+    for (int i = 0; i < numFrames; i++) {
+        float sample = amplitude * (float)sin(2.0 * 3.14159265358979 * frequency * i / sampleRate);
+        for (int channel = 0; channel < numChannels; channel++) {
+            samples[i * numChannels + channel] = (int16_t)sample;
+        }
+    }
+    return samples;
+}
+
+// resamples in blocks the size the client uses, returning the output frames produced
+static int renderBlocks(AudioSRC& src, const QVector<int16_t>& input, int sampleRate, int numChannels,
+                        QVector<int16_t>& output) {
+    int blockFrames = sampleRate / BLOCKS_PER_SECOND;
+    int inputFrames = input.size() / numChannels;
+    output.resize(src.getMaxOutput(inputFrames) * numChannels + src.getMaxOutput(blockFrames) * numChannels);
+
+    int outputFrames = 0;
+    for (int i = 0; i + blockFrames <= inputFrames; i += blockFrames) {
+        int numOutput = src.render(input.constData() + i * numChannels, output.data() + outputFrames * numChannels,
+                                   blockFrames);
+
+        // every block produces what the SRC promised, so callers can size their buffers from it
+        if (numOutput < src.getMinOutput(blockFrames) || numOutput > src.getMaxOutput(blockFrames)) {
+            return -1;
+        }
+        outputFrames += numOutput;
+    }
+    return outputFrames;
+}
+
+static double rms(const int16_t* samples, int numSamples) {
+    double sum = 0.0;
+    for (int i = 0; i < numSamples; i++) {
+        sum += (double)samples[i] * samples[i];
+    }
+    return sqrt(sum / numSamples);
+}
+
+static void benchmark(int inputSampleRate, int numChannels) {
+    QVector<int16_t> input = makeSine(inputSampleRate, numChannels, inputSampleRate, 440.0f, 8000.0f);
+    QVector<int16_t> output;
+
+    AudioSRC src(inputSampleRate, NETWORK_SAMPLE_RATE, numChannels);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < NUM_BENCHMARK_SECONDS; i++) {
+        renderBlocks(src, input, inputSampleRate, numChannels, output);
+    }
+    qint64 nsecs = std::max(timer.nsecsElapsed(), (qint64)1);
+
+    double framesPerSecond = (double)inputSampleRate * NUM_BENCHMARK_SECONDS * 1.0e9 / nsecs;
+    qDebug() << inputSampleRate << "->" << NETWORK_SAMPLE_RATE << (numChannels == 2 ? "stereo" : "mono")
+        << (qint64)framesPerSecond << "input frames/sec";
+}
+
+void AudioSRCTests::outputFrames() {
+    const int INPUT_RATES[] = { 48000, 44100, 32000, 16000 };
+
+    for (int inputSampleRate : INPUT_RATES) {
+        for (int numChannels = 1; numChannels <= AudioSRC::MAX_CHANNELS; numChannels++) {
+            QVector<int16_t> input = makeSine(inputSampleRate, numChannels, inputSampleRate, 440.0f, 8000.0f);
+            QVector<int16_t> output;
+
+            AudioSRC src(inputSampleRate, NETWORK_SAMPLE_RATE, numChannels);
+            int outputFrames = renderBlocks(src, input, inputSampleRate, numChannels, output);
+
+            // one second in gives one second out, give or take a frame of phase
+            QVERIFY(outputFrames >= 0);
+            QVERIFY(qAbs(outputFrames - NETWORK_SAMPLE_RATE) <= 1);
+        }
+    }
+}
+
+void AudioSRCTests::passbandGain() {
+    const int INPUT_RATES[] = { 48000, 44100 };
+    const float AMPLITUDE = 8000.0f;
+
+    for (int inputSampleRate : INPUT_RATES) {
+        for (int numChannels = 1; numChannels <= AudioSRC::MAX_CHANNELS; numChannels++) {
+            QVector<int16_t> input = makeSine(inputSampleRate, numChannels, inputSampleRate, 1000.0f, AMPLITUDE);
+            QVector<int16_t> output;
+
+            AudioSRC src(inputSampleRate, NETWORK_SAMPLE_RATE, numChannels);
+            int outputFrames = renderBlocks(src, input, inputSampleRate, numChannels, output);
+            QVERIFY(outputFrames > 0);
+
+            // skip the filter's settling time, then a passband tone should keep its level on every channel
+            int settleFrames = NETWORK_SAMPLE_RATE / 10;
+            int numSamples = (outputFrames - settleFrames) * numChannels;
+            double expected = AMPLITUDE / sqrt(2.0);
+            double actual = rms(output.constData() + settleFrames * numChannels, numSamples);
+            QVERIFY(qAbs(actual - expected) < expected * 0.01);
+
+            if (numChannels == 2) {
+                // both channels saw the same input, so only the dither can tell them apart
+                for (int i = settleFrames; i < outputFrames; i++) {
+                    QVERIFY(qAbs(output[2 * i] - output[2 * i + 1]) <= 1);
+                }
+            }
+        }
+    }
+}
+
+void AudioSRCTests::avx2MatchesSSE2() {
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+    if (!cpuSupportsAVX2()) {
+        QSKIP("this CPU doesn't support AVX2");
+    }
+
+    // rational and irrational (output rate that doesn't reduce) resampling, in mono and stereo
+    const int OUTPUT_RATES[] = { NETWORK_SAMPLE_RATE, 47999 };
+    const int INPUT_SAMPLE_RATE = 48000;
+    const int NUM_FRAMES = 480;
+
+    // the two versions sum the taps in a different order, so allow for float rounding
+    const float TOLERANCE = 1.0e-5f;
+
+    qsrand(1);
+    for (int outputSampleRate : OUTPUT_RATES) {
+        for (int numChannels = 1; numChannels <= AudioSRC::MAX_CHANNELS; numChannels++) {
+            AudioSRC sse2(INPUT_SAMPLE_RATE, outputSampleRate, numChannels);
+            AudioSRC avx2(INPUT_SAMPLE_RATE, outputSampleRate, numChannels);
+
+            QVector<int16_t> input(NUM_FRAMES * numChannels);
+            for (int16_t& sample : input) {
+                sample = (int16_t)(qrand() - RAND_MAX / 2);
+            }
+
+            // int16 to float
+            QVector<float> sse2Inputs[AudioSRC::MAX_CHANNELS];
+            QVector<float> avx2Inputs[AudioSRC::MAX_CHANNELS];
+            float* sse2InputPointers[AudioSRC::MAX_CHANNELS];
+            float* avx2InputPointers[AudioSRC::MAX_CHANNELS];
+            for (int channel = 0; channel < AudioSRC::MAX_CHANNELS; channel++) {
+                // the filters read a filter length past the last frame
+                sse2Inputs[channel].fill(0.0f, NUM_FRAMES + sse2._numTaps);
+                avx2Inputs[channel].fill(0.0f, NUM_FRAMES + avx2._numTaps);
+                sse2InputPointers[channel] = sse2Inputs[channel].data();
+                avx2InputPointers[channel] = avx2Inputs[channel].data();
+            }
+            sse2.convertInputFromInt16_SSE2(input.constData(), sse2InputPointers, NUM_FRAMES);
+            avx2.convertInputFromInt16_AVX2(input.constData(), avx2InputPointers, NUM_FRAMES);
+            for (int channel = 0; channel < numChannels; channel++) {
+                QCOMPARE(avx2Inputs[channel], sse2Inputs[channel]);
+            }
+
+            // filter
+            int maxOutput = sse2.getMaxOutput(NUM_FRAMES);
+            QVector<float> sse2Outputs[AudioSRC::MAX_CHANNELS];
+            QVector<float> avx2Outputs[AudioSRC::MAX_CHANNELS];
+            float* sse2OutputPointers[AudioSRC::MAX_CHANNELS];
+            float* avx2OutputPointers[AudioSRC::MAX_CHANNELS];
+            for (int channel = 0; channel < AudioSRC::MAX_CHANNELS; channel++) {
+                sse2Outputs[channel].fill(0.0f, maxOutput);
+                avx2Outputs[channel].fill(0.0f, maxOutput);
+                sse2OutputPointers[channel] = sse2Outputs[channel].data();
+                avx2OutputPointers[channel] = avx2Outputs[channel].data();
+            }
+
+            int sse2Frames;
+            int avx2Frames;
+            if (numChannels == 1) {
+                sse2Frames = sse2.multirateFilter1_SSE2(sse2InputPointers[0], sse2OutputPointers[0], NUM_FRAMES);
+                avx2Frames = avx2.multirateFilter1_AVX2(avx2InputPointers[0], avx2OutputPointers[0], NUM_FRAMES);
+            } else {
+                sse2Frames = sse2.multirateFilter2_SSE2(sse2InputPointers[0], sse2InputPointers[1],
+                                                        sse2OutputPointers[0], sse2OutputPointers[1], NUM_FRAMES);
+                avx2Frames = avx2.multirateFilter2_AVX2(avx2InputPointers[0], avx2InputPointers[1],
+                                                        avx2OutputPointers[0], avx2OutputPointers[1], NUM_FRAMES);
+            }
+            QCOMPARE(avx2Frames, sse2Frames);
+            QVERIFY(sse2Frames > 0);
+
+            for (int channel = 0; channel < numChannels; channel++) {
+                for (int i = 0; i < sse2Frames; i++) {
+                    QVERIFY(qAbs(avx2Outputs[channel][i] - sse2Outputs[channel][i]) <= TOLERANCE);
+                }
+            }
+
+            // float to int16, the dither is random and in [-1, 1], so after rounding the two can be up to 3 apart
+            QVector<int16_t> sse2Output(sse2Frames * numChannels);
+            QVector<int16_t> avx2Output(sse2Frames * numChannels);
+            sse2.convertOutputToInt16_SSE2(sse2OutputPointers, sse2Output.data(), sse2Frames);
+            avx2.convertOutputToInt16_AVX2(sse2OutputPointers, avx2Output.data(), sse2Frames);
+            for (int i = 0; i < sse2Output.size(); i++) {
+                QVERIFY(qAbs(avx2Output[i] - sse2Output[i]) <= 3);
+            }
+        }
+    }
+#else
+    QSKIP("AVX2 is x86 only");
+#endif
+}
+
+void AudioSRCTests::benchmark48To24() {
+    benchmark(48000, 1);
+    benchmark(48000, 2);
+}
+
+void AudioSRCTests::benchmark44To24() {
+    benchmark(44100, 1);
+    benchmark(44100, 2);
+}
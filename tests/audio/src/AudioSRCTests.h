@@ -0,0 +1,28 @@
+//
+//  AudioSRCTests.h
+//  tests/audio/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AudioSRCTests_h
+#define hifi_AudioSRCTests_h
+
+#include <QtTest/QtTest>
+
+class AudioSRCTests : public QObject {
+    Q_OBJECT
+private slots:
+    void outputFrames();
+    void passbandGain();
+    void avx2MatchesSSE2();
+
+    // frames/sec through render, for the rates the client resamples its input to the network rate from
+    void benchmark48To24();
+    void benchmark44To24();
+};
+
+#endif // hifi_AudioSRCTests_h
@@ -0,0 +1,48 @@
+//
+//  AssetUtilsTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "AssetUtilsTests.h"
+#include "../QTestExtensions.h"
+
+#include <limits>
+
+#include <AssetUtils.h>
+
+QTEST_MAIN(AssetUtilsTests)
+
+static const qint64 ASSET_SIZE = 100;
+
+void AssetUtilsTests::validByteRangeTest() {
+    QVERIFY(isValidByteRange(0, ASSET_SIZE, ASSET_SIZE));
+    QVERIFY(isValidByteRange(0, 1, ASSET_SIZE));
+    QVERIFY(isValidByteRange(ASSET_SIZE - 1, ASSET_SIZE, ASSET_SIZE));
+    QVERIFY(isValidByteRange(10, 20, ASSET_SIZE));
+}
+
+void AssetUtilsTests::negativeByteRangeTest() {
+    // would read from before the start of the asset
+    QVERIFY(!isValidByteRange(-1, 10, ASSET_SIZE));
+    QVERIFY(!isValidByteRange(-50, ASSET_SIZE, ASSET_SIZE));
+    QVERIFY(!isValidByteRange(std::numeric_limits<DataOffset>::min(), 1, ASSET_SIZE));
+    QVERIFY(!isValidByteRange(-10, -1, ASSET_SIZE));
+}
+
+void AssetUtilsTests::emptyByteRangeTest() {
+    QVERIFY(!isValidByteRange(0, 0, ASSET_SIZE));
+    QVERIFY(!isValidByteRange(50, 50, ASSET_SIZE));
+    QVERIFY(!isValidByteRange(20, 10, ASSET_SIZE));
+    QVERIFY(!isValidByteRange(0, 1, 0));
+}
+
+void AssetUtilsTests::pastEndByteRangeTest() {
+    QVERIFY(!isValidByteRange(0, ASSET_SIZE + 1, ASSET_SIZE));
+    QVERIFY(!isValidByteRange(ASSET_SIZE, ASSET_SIZE + 10, ASSET_SIZE));
+    QVERIFY(!isValidByteRange(10, std::numeric_limits<DataOffset>::max(), ASSET_SIZE));
+}
@@ -0,0 +1,28 @@
+//
+//  AssetUtilsTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_AssetUtilsTests_h
+#define hifi_AssetUtilsTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class AssetUtilsTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test the byte ranges the asset-server accepts in an AssetGet request
+    void validByteRangeTest();
+    void negativeByteRangeTest();
+    void emptyByteRangeTest();
+    void pastEndByteRangeTest();
+};
+
+#endif // hifi_AssetUtilsTests_h
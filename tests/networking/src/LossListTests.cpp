@@ -0,0 +1,160 @@
+//
+//  LossListTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "LossListTests.h"
+#include "../QTestExtensions.h"
+
+#include <udt/LossList.h>
+#include <udt/SentPacketBuffer.h>
+
+using namespace udt;
+
+QTEST_MAIN(LossListTests)
+
+static SequenceNumber seq(SequenceNumber::Type value) {
+    return SequenceNumber(value);
+}
+
+void LossListTests::appendTest() {
+    LossList lossList;
+    QVERIFY(lossList.isEmpty());
+
+    lossList.append(seq(10));
+    lossList.append(seq(11));
+    lossList.append(seq(15), seq(20));
+
+    QCOMPARE(lossList.getLength(), 8);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(10));
+
+    QVERIFY(lossList.remove(seq(11)));
+    QVERIFY(!lossList.remove(seq(12)));
+    QCOMPARE(lossList.getLength(), 7);
+}
+
+void LossListTests::insertTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(12));
+    lossList.append(seq(20), seq(22));
+    lossList.append(seq(30), seq(32));
+
+    // before everything
+    lossList.insert(seq(1), seq(2));
+    QCOMPARE(lossList.getLength(), 11);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(1));
+
+    // already lost
+    lossList.insert(seq(20), seq(21));
+    QCOMPARE(lossList.getLength(), 11);
+
+    // bridges the first two ranges and overlaps the third
+    lossList.insert(seq(11), seq(31));
+    QCOMPARE(lossList.getLength(), 2 + 23);
+
+    for (int i = 10; i <= 32; i++) {
+        QVERIFY(lossList.remove(seq(i)));
+    }
+    QCOMPARE(lossList.getLength(), 2);
+}
+
+void LossListTests::removeTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(14));
+
+    // the middle, the beginning then the end
+    QVERIFY(lossList.remove(seq(12)));
+    QVERIFY(lossList.remove(seq(10)));
+    QVERIFY(lossList.remove(seq(14)));
+    QCOMPARE(lossList.getLength(), 2);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(11));
+
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(11));
+    QCOMPARE(lossList.popFirstSequenceNumber(), seq(13));
+    QVERIFY(lossList.isEmpty());
+    QVERIFY(!lossList.remove(seq(13)));
+}
+
+void LossListTests::removeRangeTest() {
+    LossList lossList;
+    lossList.append(seq(10), seq(20));
+    lossList.append(seq(30), seq(40));
+    lossList.append(seq(50), seq(60));
+
+    // split one range
+    lossList.remove(seq(14), seq(16));
+    QCOMPARE(lossList.getLength(), 30);
+    QVERIFY(!lossList.remove(seq(15)));
+    QVERIFY(lossList.remove(seq(17)));
+
+    // cut the end of one, all of the next and the beginning of the last
+    lossList.remove(seq(19), seq(55));
+    QCOMPARE(lossList.getLength(), 4 + 1 + 5);
+    QVERIFY(lossList.remove(seq(18)));
+    QVERIFY(!lossList.remove(seq(35)));
+    QCOMPARE(lossList.getLength(), 9);
+
+    // everything up to an ACK, starting exactly on a range
+    lossList.remove(lossList.getFirstSequenceNumber(), seq(56));
+    QCOMPARE(lossList.getLength(), 4);
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(57));
+}
+
+void LossListTests::wrapTest() {
+    LossList lossList;
+    lossList.append(seq(SequenceNumber::MAX - 2), seq(2));
+    QCOMPARE(lossList.getLength(), 6);
+
+    lossList.append(seq(5));
+    QCOMPARE(lossList.getFirstSequenceNumber(), seq(SequenceNumber::MAX - 2));
+
+    // removing across the wrap leaves what is on either side of it
+    lossList.remove(seq(0), seq(1));
+    QCOMPARE(lossList.getLength(), 5);
+    QVERIFY(lossList.remove(seq(SequenceNumber::MAX)));
+    QVERIFY(lossList.remove(seq(2)));
+    QVERIFY(!lossList.remove(seq(0)));
+
+    lossList.insert(seq(SequenceNumber::MAX), seq(4));
+    QCOMPARE(lossList.getLength(), 9);
+    QCOMPARE(seq(0) - 1, seq(SequenceNumber::MAX));
+}
+
+void LossListTests::sentPacketBufferTest() {
+    SentPacketBuffer sentPackets;
+    QVERIFY(sentPackets.isEmpty());
+
+    // start close enough to the wrap that the run crosses it, and send enough that the ring has to grow
+    const int NUM_PACKETS = 1000;
+    SequenceNumber first = seq(SequenceNumber::MAX - 100);
+
+    QHash<int, Packet*> sent;
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        auto packet = Packet::create();
+        sent[i] = packet.get();
+        sentPackets.insert(first + i, std::move(packet));
+    }
+
+    QCOMPARE(sentPackets.find(first), sent[0]);
+    QCOMPARE(sentPackets.find(first + 150), sent[150]);
+    QCOMPARE(sentPackets.find(first + (NUM_PACKETS - 1)), sent[NUM_PACKETS - 1]);
+    QVERIFY(!sentPackets.find(first + NUM_PACKETS));
+    QVERIFY(!sentPackets.find(first - 1));
+
+    sentPackets.removeUpTo(first + 499);
+    QVERIFY(!sentPackets.find(first + 499));
+    QCOMPARE(sentPackets.find(first + 500), sent[500]);
+
+    // an old ACK changes nothing
+    sentPackets.removeUpTo(first + 10);
+    QCOMPARE(sentPackets.find(first + 500), sent[500]);
+
+    sentPackets.removeUpTo(first + (NUM_PACKETS - 1));
+    QVERIFY(sentPackets.isEmpty());
+    QVERIFY(!sentPackets.find(first + 999));
+}
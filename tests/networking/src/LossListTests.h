@@ -0,0 +1,40 @@
+//
+//  LossListTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_LossListTests_h
+#define hifi_LossListTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class LossListTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test appending single sequence numbers and ranges
+    void appendTest();
+
+    // Test inserting ranges that overlap or touch existing ones
+    void insertTest();
+
+    // Test removing single sequence numbers, splitting ranges
+    void removeTest();
+
+    // Test removing ranges that cover, cut or split existing ones
+    void removeRangeTest();
+
+    // Test ranges that run past SequenceNumber::MAX
+    void wrapTest();
+
+    // Test the sent packet ring the send queue keeps alongside its loss list
+    void sentPacketBufferTest();
+};
+
+#endif // hifi_LossListTests_h
@@ -0,0 +1,175 @@
+//
+//  NodeTableTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "NodeTableTests.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QThread>
+
+#include <NodeTable.h>
+
+QTEST_MAIN(NodeTableTests)
+
+const int NUM_BENCHMARK_NODES = 500;
+const int NUM_BENCHMARK_READERS = 4;
+const int BENCHMARK_MSECS = 2000;
+
+static SharedNodePointer createNode() {
+    return SharedNodePointer(new Node(QUuid::createUuid(), NodeType::Agent, HifiSockAddr(), HifiSockAddr(), false, false));
+}
+
+static QVector<SharedNodePointer> createNodes(int numNodes) {
+    QVector<SharedNodePointer> nodes;
+    for (int i = 0; i < numNodes; i++) {
+        nodes << createNode();
+    }
+    return nodes;
+}
+
+void NodeTableTests::insertFindRemove() {
+    NodeTable table;
+    SharedNodePointer node = createNode();
+
+    QCOMPARE(table.insert(node), node);
+    QCOMPARE(table.size(), 1);
+    QCOMPARE(table.find(node->getUUID()), node);
+    QVERIFY(table.find(QUuid::createUuid()).isNull());
+
+    // a second node with the same UUID doesn't replace the first
+    SharedNodePointer duplicate(new Node(node->getUUID(), NodeType::Agent, HifiSockAddr(), HifiSockAddr(), false, false));
+    QCOMPARE(table.insert(duplicate), node);
+    QCOMPARE(table.size(), 1);
+
+    QCOMPARE(table.remove(node->getUUID()), node);
+    QVERIFY(table.remove(node->getUUID()).isNull());
+    QCOMPARE(table.size(), 0);
+}
+
+void NodeTableTests::iterationIsSnapshot() {
+    NodeTable table;
+    QVector<SharedNodePointer> nodes = createNodes(10);
+    for (auto& node : nodes) {
+        table.insert(node);
+    }
+
+    // removing every node from inside the iteration still visits all of them, and doesn't deadlock
+    int numVisited = 0;
+    table.forEach([&](const SharedNodePointer& node) {
+        table.remove(node->getUUID());
+        table.insert(createNode());
+        numVisited++;
+    });
+
+    QCOMPARE(numVisited, nodes.size());
+    QCOMPARE(table.size(), nodes.size());
+    for (auto& node : nodes) {
+        QVERIFY(table.find(node->getUUID()).isNull());
+    }
+}
+
+void NodeTableTests::removeIf() {
+    NodeTable table;
+    QVector<SharedNodePointer> nodes = createNodes(10);
+    for (int i = 0; i < nodes.size(); i++) {
+        nodes[i]->setType(i % 2 ? NodeType::Agent : NodeType::AudioMixer);
+        table.insert(nodes[i]);
+    }
+
+    QList<SharedNodePointer> removed = table.removeIf([](const SharedNodePointer& node) {
+        return node->getType() == NodeType::AudioMixer;
+    });
+
+    QCOMPARE(removed.size(), 5);
+    QCOMPARE(table.size(), 5);
+    table.forEach([](const SharedNodePointer& node) {
+        QCOMPARE(node->getType(), (NodeType_t)NodeType::Agent);
+    });
+
+    QCOMPARE(table.clear().size(), 5);
+    QCOMPARE(table.size(), 0);
+}
+
+// runs lookup on NUM_BENCHMARK_READERS threads while churn adds and removes a node on this one
+template<typename Lookup, typename Churn>
+static double lookupsPerSecond(const QVector<SharedNodePointer>& nodes, Lookup lookup, Churn churn) {
+    std::atomic<bool> stop { false };
+    std::atomic<qint64> numLookups { 0 };
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < NUM_BENCHMARK_READERS; i++) {
+        readers.emplace_back([&, i] {
+            qint64 count = 0;
+            int index = i;
+            while (!stop) {
+                lookup(nodes[index]->getUUID());
+                index = (index + 7) % nodes.size();
+                count++;
+            }
+            numLookups += count;
+        });
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < BENCHMARK_MSECS) {
+        churn();
+        QThread::usleep(100);
+    }
+    stop = true;
+
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    return numLookups * 1000.0 / timer.elapsed();
+}
+
+void NodeTableTests::benchmarkContendedLookups() {
+    QVector<SharedNodePointer> nodes = createNodes(NUM_BENCHMARK_NODES);
+    SharedNodePointer churnNode = createNode();
+
+    QHash<QUuid, SharedNodePointer> hash;
+    QReadWriteLock lock(QReadWriteLock::Recursive);
+    for (auto& node : nodes) {
+        hash.insert(node->getUUID(), node);
+    }
+
+    double lockedRate = lookupsPerSecond(nodes, [&](const QUuid& uuid) {
+        QReadLocker locker(&lock);
+        return hash.value(uuid);
+    }, [&] {
+        QWriteLocker locker(&lock);
+        if (!hash.remove(churnNode->getUUID())) {
+            hash.insert(churnNode->getUUID(), churnNode);
+        }
+    });
+
+    NodeTable table;
+    for (auto& node : nodes) {
+        table.insert(node);
+    }
+
+    double tableRate = lookupsPerSecond(nodes, [&](const QUuid& uuid) {
+        return table.find(uuid);
+    }, [&] {
+        if (!table.remove(churnNode->getUUID())) {
+            table.insert(churnNode);
+        }
+    });
+
+    qDebug() << NUM_BENCHMARK_READERS << "readers:" << (qint64)lockedRate << "lookups/sec with QReadWriteLock,"
+        << (qint64)tableRate << "with NodeTable";
+}
@@ -0,0 +1,28 @@
+//
+//  NodeTableTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_NodeTableTests_h
+#define hifi_NodeTableTests_h
+
+#include <QtTest/QtTest>
+
+class NodeTableTests : public QObject {
+    Q_OBJECT
+private slots:
+    void insertFindRemove();
+    void iterationIsSnapshot();
+    void removeIf();
+
+    // lookups/sec from several threads while another adds and removes nodes,
+    // against the read/write locked hash the node list used before
+    void benchmarkContendedLookups();
+};
+
+#endif // hifi_NodeTableTests_h
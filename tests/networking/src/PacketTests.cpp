@@ -18,7 +18,7 @@ QTEST_MAIN(PacketTests)
 
 std::unique_ptr<Packet> copyToReadPacket(std::unique_ptr<Packet>& packet) {
     auto size = packet->getDataSize();
-    auto data = std::unique_ptr<char[]>(new char[size]);
+    auto data = udt::PacketData(new char[size]);
     memcpy(data.get(), packet->getData(), size);
     return Packet::fromReceivedPacket(std::move(data), size, HifiSockAddr());
 }
@@ -180,3 +180,23 @@ void PacketTests::primitiveTest() {
     QCOMPARE(recvPacket->peekPrimitive(&noValue), 0);
     QCOMPARE(recvPacket->readPrimitive(&noValue), 0);
 }
+
+void PacketTests::pooledDataTest() {
+    auto pool = std::make_shared<udt::PacketBufferPool>();
+    
+    auto sentPacket = Packet::create(PacketType::Unknown);
+    sentPacket->write("Hello, world!", 13);
+    
+    auto data = pool->acquire();
+    char* buffer = data.get();
+    memcpy(buffer, sentPacket->getData(), sentPacket->getDataSize());
+    
+    auto packet = Packet::fromReceivedPacket(std::move(data), sentPacket->getDataSize(), HifiSockAddr());
+    QCOMPARE(packet->getDataSize(), sentPacket->getDataSize());
+    QCOMPARE(pool->getNumFreeBuffers(), 0);
+    
+    // the buffer goes back to the pool with the packet and is the next one handed out
+    packet.reset();
+    QCOMPARE(pool->getNumFreeBuffers(), 1);
+    QCOMPARE(pool->acquire().get(), buffer);
+}
@@ -36,6 +36,9 @@ private slots:
 
     // Test set/get packet type
     void packetTypeTest();
+
+    // Test that received packets hand their pooled data back to the pool
+    void pooledDataTest();
 };
 
 #endif // hifi_PacketTests_h
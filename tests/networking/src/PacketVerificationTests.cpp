@@ -0,0 +1,130 @@
+//
+//  PacketVerificationTests.cpp
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "PacketVerificationTests.h"
+
+#include <QtCore/QCryptographicHash>
+
+#include <NLPacket.h>
+#include <SipHash.h>
+
+QTEST_MAIN(PacketVerificationTests)
+
+const int BENCHMARK_PAYLOAD_SIZE = 1024;
+const int NUM_BENCHMARK_PACKETS = 1000;
+
+static std::unique_ptr<NLPacket> createVerifiedPacket(const QUuid& sourceID, const QUuid& connectionSecret) {
+    auto sentPacket = NLPacket::create(PacketType::AvatarData, BENCHMARK_PAYLOAD_SIZE);
+    
+    for (int i = 0; i < BENCHMARK_PAYLOAD_SIZE; i++) {
+        sentPacket->writePrimitive((quint8) qrand());
+    }
+    
+    sentPacket->writeSourceID(sourceID);
+    sentPacket->writeVerificationHashGivenSecret(connectionSecret);
+    
+    // copy it to a packet like the one the receiving socket would hand us
+    auto size = sentPacket->getDataSize();
+    auto data = udt::PacketData(new char[size]);
+    memcpy(data.get(), sentPacket->getData(), size);
+    
+    return NLPacket::fromReceivedPacket(std::move(data), size, HifiSockAddr());
+}
+
+void PacketVerificationTests::sipHashVectorsTest() {
+    // from the SipHash reference implementation, key is 00 01 .. 0f and the message of length n is 00 01 .. n - 1
+    const uint8_t EXPECTED_EMPTY[NUM_BYTES_SIPHASH_128] = {
+        0xa3, 0x81, 0x7f, 0x04, 0xba, 0x25, 0xa8, 0xe6, 0x6d, 0xf6, 0x72, 0x14, 0xc7, 0x55, 0x02, 0x93
+    };
+    const uint8_t EXPECTED_ONE_BYTE[NUM_BYTES_SIPHASH_128] = {
+        0xda, 0x87, 0xc1, 0xd8, 0x6b, 0x99, 0xaf, 0x44, 0x34, 0x76, 0x59, 0x11, 0x9b, 0x22, 0xfc, 0x45
+    };
+    const uint8_t EXPECTED_63_BYTES[NUM_BYTES_SIPHASH_128] = {
+        0x51, 0x50, 0xd1, 0x77, 0x2f, 0x50, 0x83, 0x4a, 0x50, 0x3e, 0x06, 0x9a, 0x97, 0x3f, 0xbd, 0x7c
+    };
+    
+    uint8_t key[NUM_BYTES_SIPHASH_KEY];
+    for (int i = 0; i < NUM_BYTES_SIPHASH_KEY; i++) {
+        key[i] = (uint8_t) i;
+    }
+    
+    uint8_t message[63];
+    for (int i = 0; i < 63; i++) {
+        message[i] = (uint8_t) i;
+    }
+    
+    uint8_t hash[NUM_BYTES_SIPHASH_128];
+    
+    sipHash128(key, message, 0, hash);
+    QCOMPARE(memcmp(hash, EXPECTED_EMPTY, NUM_BYTES_SIPHASH_128), 0);
+    
+    sipHash128(key, message, 1, hash);
+    QCOMPARE(memcmp(hash, EXPECTED_ONE_BYTE, NUM_BYTES_SIPHASH_128), 0);
+    
+    sipHash128(key, message, 63, hash);
+    QCOMPARE(memcmp(hash, EXPECTED_63_BYTES, NUM_BYTES_SIPHASH_128), 0);
+}
+
+void PacketVerificationTests::verificationTest() {
+    QUuid sourceID = QUuid::createUuid();
+    QUuid connectionSecret = QUuid::createUuid();
+    
+    auto packet = createVerifiedPacket(sourceID, connectionSecret);
+    
+    QCOMPARE(NLPacket::sourceIDInHeader(*packet), sourceID);
+    QVERIFY(NLPacket::verificationHashMatches(*packet, connectionSecret));
+    QCOMPARE(NLPacket::verificationHashInHeader(*packet), NLPacket::hashForPacketAndSecret(*packet, connectionSecret));
+    
+    // the wrong secret must not verify
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, QUuid::createUuid()));
+    
+    // neither should a modified payload
+    packet->getPayload()[BENCHMARK_PAYLOAD_SIZE / 2] ^= 0x1;
+    QVERIFY(!NLPacket::verificationHashMatches(*packet, connectionSecret));
+}
+
+void PacketVerificationTests::benchmarkMD5Verification() {
+    QUuid connectionSecret = QUuid::createUuid();
+    auto packet = createVerifiedPacket(QUuid::createUuid(), connectionSecret);
+    
+    int offset = NLPacket::totalHeaderSize(PacketType::AvatarData);
+    int numMatches = 0;
+    
+    QBENCHMARK {
+        for (int i = 0; i < NUM_BENCHMARK_PACKETS; i++) {
+            // what packet verification used to do for every sourced packet
+            QByteArray packetHeaderHash = NLPacket::verificationHashInHeader(*packet);
+            
+            QCryptographicHash hash(QCryptographicHash::Md5);
+            hash.addData(packet->getData() + offset, packet->getDataSize() - offset);
+            hash.addData(connectionSecret.toRfc4122());
+            
+            numMatches += (packetHeaderHash == hash.result());
+        }
+    }
+    
+    // the hash in the packet isn't an MD5 one so this is only here to keep the work from being optimized out
+    QVERIFY(numMatches >= 0);
+}
+
+void PacketVerificationTests::benchmarkSipHashVerification() {
+    QUuid connectionSecret = QUuid::createUuid();
+    auto packet = createVerifiedPacket(QUuid::createUuid(), connectionSecret);
+    
+    int numMatches = 0;
+    
+    QBENCHMARK {
+        for (int i = 0; i < NUM_BENCHMARK_PACKETS; i++) {
+            numMatches += NLPacket::verificationHashMatches(*packet, connectionSecret);
+        }
+    }
+    
+    QVERIFY(numMatches > 0);
+}
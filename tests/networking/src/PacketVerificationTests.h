@@ -0,0 +1,34 @@
+//
+//  PacketVerificationTests.h
+//  tests/networking/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_PacketVerificationTests_h
+#define hifi_PacketVerificationTests_h
+
+#pragma once
+
+#include <QtTest/QtTest>
+
+class PacketVerificationTests : public QObject {
+    Q_OBJECT
+private slots:
+    // Test SipHash-2-4-128 against the reference vectors
+    void sipHashVectorsTest();
+
+    // Test that a written verification hash verifies, and that tampering is caught
+    void verificationTest();
+
+    // Cost of verifying an avatar sized packet with the MD5 hash we used to use
+    void benchmarkMD5Verification();
+
+    // Cost of verifying an avatar sized packet with SipHash
+    void benchmarkSipHashVerification();
+};
+
+#endif // hifi_PacketVerificationTests_h
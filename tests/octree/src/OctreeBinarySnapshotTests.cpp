@@ -0,0 +1,141 @@
+//
+//  OctreeBinarySnapshotTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <EntityTree.h>
+#include <OctreeBinarySnapshot.h>
+
+#include "OctreeBinarySnapshotTests.h"
+
+QTEST_MAIN(OctreeBinarySnapshotTests)
+
+static const PacketType SNAPSHOT_TYPE = PacketType::EntityData;
+
+static OctreeBinarySnapshot makeSnapshot() {
+    OctreeBinarySnapshot snapshot(SNAPSHOT_TYPE, versionForPacketType(SNAPSHOT_TYPE));
+    snapshot.appendRecord(OctreeBinarySnapshot::ENCODED_RECORD, QByteArray("\x01\x02\x03", 3));
+    snapshot.appendRecord(OctreeBinarySnapshot::JSON_RECORD, QByteArray("{\"id\":\"a\"}"));
+    snapshot.appendRecord(OctreeBinarySnapshot::ENCODED_RECORD, QByteArray());
+    return snapshot;
+}
+
+void OctreeBinarySnapshotTests::recordsRoundTrip() {
+    OctreeBinarySnapshot snapshot = makeSnapshot();
+    QCOMPARE(snapshot.getRecordCount(), (quint32) 3);
+
+    const QByteArray& data = snapshot.getData();
+    std::vector<OctreeBinarySnapshot::Record> records;
+    QVERIFY(OctreeBinarySnapshot::readRecords(data.constData(), data.size(), SNAPSHOT_TYPE,
+                                              versionForPacketType(SNAPSHOT_TYPE), records));
+
+    QCOMPARE((int) records.size(), 3);
+    QCOMPARE(records[0].format, (quint8) OctreeBinarySnapshot::ENCODED_RECORD);
+    QCOMPARE(QByteArray(records[0].data, records[0].size), QByteArray("\x01\x02\x03", 3));
+    QCOMPARE(records[1].format, (quint8) OctreeBinarySnapshot::JSON_RECORD);
+    QCOMPARE(QByteArray(records[1].data, records[1].size), QByteArray("{\"id\":\"a\"}"));
+    QCOMPARE(records[2].size, (quint32) 0);
+}
+
+void OctreeBinarySnapshotTests::otherVersionIsRejected() {
+    const QByteArray data = makeSnapshot().getData();
+    std::vector<OctreeBinarySnapshot::Record> records;
+
+    QVERIFY(!OctreeBinarySnapshot::readRecords(data.constData(), data.size(), SNAPSHOT_TYPE,
+                                               versionForPacketType(SNAPSHOT_TYPE) + 1, records));
+    QVERIFY(!OctreeBinarySnapshot::readRecords(data.constData(), data.size(), PacketType::Unknown,
+                                               versionForPacketType(SNAPSHOT_TYPE), records));
+
+    // JSON isn't mistaken for a snapshot
+    QByteArray json("{\"Entities\":[]}");
+    QVERIFY(!OctreeBinarySnapshot::readRecords(json.constData(), json.size(), SNAPSHOT_TYPE,
+                                               versionForPacketType(SNAPSHOT_TYPE), records));
+}
+
+void OctreeBinarySnapshotTests::truncatedSnapshotIsRejected() {
+    const QByteArray data = makeSnapshot().getData();
+    std::vector<OctreeBinarySnapshot::Record> records;
+
+    // cut into the header of the (empty) last record, drop it entirely, and cut into the data of the one before it
+    for (int cut : { 2, 5, 7 }) {
+        QVERIFY(!OctreeBinarySnapshot::readRecords(data.constData(), data.size() - cut, SNAPSHOT_TYPE,
+                                                   versionForPacketType(SNAPSHOT_TYPE), records));
+    }
+}
+
+static EntityTreePointer makeEntityTree() {
+    auto tree = std::make_shared<EntityTree>();
+    tree->createRootElement();
+    tree->setIsServer(true);
+    return tree;
+}
+
+void OctreeBinarySnapshotTests::entityTreeRoundTrip() {
+    auto tree = makeEntityTree();
+
+    EntityItemProperties small;
+    small.setType(EntityTypes::Box);
+    small.setName("small");
+    small.setPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+    small.setDimensions(glm::vec3(0.5f));
+    EntityItemID smallID(QUuid::createUuid());
+
+    // user data this big doesn't fit in an edit packet, so this one is saved as a JSON record
+    EntityItemProperties large;
+    large.setType(EntityTypes::Box);
+    large.setName("large");
+    large.setPosition(glm::vec3(4.0f, 5.0f, 6.0f));
+    large.setUserData(QString(4 * MAX_OCTREE_PACKET_DATA_SIZE, 'x'));
+    EntityItemID largeID(QUuid::createUuid());
+
+    QByteArray snapshot;
+    tree->withWriteLock([&] {
+        QVERIFY(tree->addEntity(smallID, small));
+        QVERIFY(tree->addEntity(largeID, large));
+        QVERIFY(tree->writeToBinarySnapshot(snapshot));
+    });
+
+    std::vector<OctreeBinarySnapshot::Record> records;
+    QVERIFY(OctreeBinarySnapshot::readRecords(snapshot.constData(), snapshot.size(), tree->expectedDataPacketType(),
+                                              tree->expectedVersion(), records));
+    QCOMPARE((int) records.size(), 2);
+    int jsonRecords = 0;
+    for (auto& record : records) {
+        jsonRecords += record.format == OctreeBinarySnapshot::JSON_RECORD ? 1 : 0;
+    }
+    QCOMPARE(jsonRecords, 1);
+
+    auto loadedTree = makeEntityTree();
+    loadedTree->withWriteLock([&] {
+        QVERIFY(loadedTree->readFromBinarySnapshot(snapshot.constData(), snapshot.size()));
+    });
+
+    EntityItemPointer original = tree->findEntityByEntityItemID(smallID);
+    EntityItemPointer loaded = loadedTree->findEntityByEntityItemID(smallID);
+    QVERIFY(loaded);
+    QCOMPARE(loaded->getType(), EntityTypes::Box);
+    QCOMPARE(loaded->getName(), QString("small"));
+    QCOMPARE(loaded->getPosition(), glm::vec3(1.0f, 2.0f, 3.0f));
+    QCOMPARE(loaded->getDimensions(), glm::vec3(0.5f));
+    QCOMPARE(loaded->getCreated(), original->getCreated());
+
+    loaded = loadedTree->findEntityByEntityItemID(largeID);
+    QVERIFY(loaded);
+    QCOMPARE(loaded->getName(), QString("large"));
+    QCOMPARE(loaded->getPosition(), glm::vec3(4.0f, 5.0f, 6.0f));
+    QCOMPARE(loaded->getUserData(), large.getUserData());
+
+    // a snapshot of another entity version is refused rather than half decoded
+    QByteArray otherVersion = snapshot;
+    otherVersion[6] = (char) (tree->expectedVersion() - 1);
+    auto otherTree = makeEntityTree();
+    otherTree->withWriteLock([&] {
+        QVERIFY(!otherTree->readFromBinarySnapshot(otherVersion.constData(), otherVersion.size()));
+    });
+    QVERIFY(!otherTree->findEntityByEntityItemID(smallID));
+}
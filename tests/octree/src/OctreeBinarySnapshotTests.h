@@ -0,0 +1,26 @@
+//
+//  OctreeBinarySnapshotTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeBinarySnapshotTests_h
+#define hifi_OctreeBinarySnapshotTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeBinarySnapshotTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void recordsRoundTrip();
+    void otherVersionIsRejected();
+    void truncatedSnapshotIsRejected();
+    void entityTreeRoundTrip();
+};
+
+#endif // hifi_OctreeBinarySnapshotTests_h
@@ -0,0 +1,113 @@
+//
+//  OctreeChangeJournalTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <OctreeChangeJournal.h>
+
+#include "OctreeChangeJournalTests.h"
+
+QTEST_MAIN(OctreeChangeJournalTests)
+
+static QVariantMap makeChange(const QString& id, int value) {
+    QVariantMap change;
+    change["id"] = id;
+    change["value"] = value;
+    return change;
+}
+
+void OctreeChangeJournalTests::init() {
+    _dir = new QTemporaryDir();
+    QVERIFY(_dir->isValid());
+}
+
+void OctreeChangeJournalTests::cleanup() {
+    delete _dir;
+    _dir = nullptr;
+}
+
+QString OctreeChangeJournalTests::persistFilename() const {
+    return _dir->path() + "/models.json.gz";
+}
+
+void OctreeChangeJournalTests::appendAndReadBack() {
+    OctreeChangeJournal journal(persistFilename());
+
+    QCOMPARE(journal.readChanges().size(), 0);
+
+    QVERIFY(journal.append(QVariantList() << makeChange("a", 1) << makeChange("b", 2)));
+    QVERIFY(journal.append(QVariantList() << makeChange("a", 3)));
+
+    // a new journal on the same file sees everything, in order
+    QVariantList changes = OctreeChangeJournal(persistFilename()).readChanges();
+    QCOMPARE(changes.size(), 3);
+    QCOMPARE(changes[0].toMap()["id"].toString(), QString("a"));
+    QCOMPARE(changes[1].toMap()["value"].toInt(), 2);
+    QCOMPARE(changes[2].toMap()["value"].toInt(), 3);
+}
+
+void OctreeChangeJournalTests::tornWriteIsSkipped() {
+    {
+        OctreeChangeJournal journal(persistFilename());
+        QVERIFY(journal.append(QVariantList() << makeChange("a", 1)));
+    }
+
+    // simulate a crash part way through writing a change
+    {
+        QFile file(persistFilename() + ".journal");
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write("{\"id\":\"b\",\"val");
+    }
+
+    OctreeChangeJournal journal(persistFilename());
+    QCOMPARE(journal.readChanges().size(), 1);
+
+    // changes after the torn one still make it back
+    QVERIFY(journal.append(QVariantList() << makeChange("c", 3)));
+
+    QVariantList changes = journal.readChanges();
+    QCOMPARE(changes.size(), 2);
+    QCOMPARE(changes[1].toMap()["id"].toString(), QString("c"));
+}
+
+void OctreeChangeJournalTests::compactionKeepsJournalUntilFinished() {
+    OctreeChangeJournal journal(persistFilename());
+
+    QVERIFY(journal.append(QVariantList() << makeChange("a", 1)));
+    QVERIFY(journal.beginCompaction());
+    QCOMPARE(journal.getSize(), qint64(0));
+
+    // changes after the snapshot started go to a fresh journal, the old one is still read until the snapshot is done
+    QVERIFY(journal.append(QVariantList() << makeChange("b", 2)));
+    QCOMPARE(journal.readChanges().size(), 2);
+
+    journal.finishCompaction();
+
+    QVariantList changes = journal.readChanges();
+    QCOMPARE(changes.size(), 1);
+    QCOMPARE(changes[0].toMap()["id"].toString(), QString("b"));
+}
+
+void OctreeChangeJournalTests::failedCompactionIsMerged() {
+    OctreeChangeJournal journal(persistFilename());
+
+    QVERIFY(journal.append(QVariantList() << makeChange("a", 1)));
+    QVERIFY(journal.beginCompaction());
+
+    // the snapshot never finishes, the next compaction has to cover both
+    QVERIFY(journal.append(QVariantList() << makeChange("b", 2)));
+    QVERIFY(journal.beginCompaction());
+
+    QVariantList changes = journal.readChanges();
+    QCOMPARE(changes.size(), 2);
+    QCOMPARE(changes[0].toMap()["id"].toString(), QString("a"));
+    QCOMPARE(changes[1].toMap()["id"].toString(), QString("b"));
+
+    journal.finishCompaction();
+    QCOMPARE(journal.readChanges().size(), 0);
+}
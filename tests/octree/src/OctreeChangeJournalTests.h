@@ -0,0 +1,35 @@
+//
+//  OctreeChangeJournalTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeChangeJournalTests_h
+#define hifi_OctreeChangeJournalTests_h
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+class OctreeChangeJournalTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void appendAndReadBack();
+    void tornWriteIsSkipped();
+    void compactionKeepsJournalUntilFinished();
+    void failedCompactionIsMerged();
+
+private:
+    QString persistFilename() const;
+
+    QTemporaryDir* _dir { nullptr };
+};
+
+#endif // hifi_OctreeChangeJournalTests_h
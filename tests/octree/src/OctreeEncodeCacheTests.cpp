@@ -0,0 +1,91 @@
+//
+//  OctreeEncodeCacheTests.cpp
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <OctreeEncodeCache.h>
+
+#include "OctreeEncodeCacheTests.h"
+
+QTEST_MAIN(OctreeEncodeCacheTests)
+
+void OctreeEncodeCacheTests::findMatchesVersion() {
+    OctreeEncodeCache cache(1000);
+    QUuid id = QUuid::createUuid();
+    QByteArray encoded;
+
+    QVERIFY(!cache.find(id, 1, encoded));
+
+    cache.insert(id, 1, QByteArray("first"));
+    QVERIFY(cache.find(id, 1, encoded));
+    QCOMPARE(encoded, QByteArray("first"));
+
+    // a changed item is a miss until it is encoded again
+    QVERIFY(!cache.find(id, 2, encoded));
+    cache.insert(id, 2, QByteArray("second"));
+    QVERIFY(cache.find(id, 2, encoded));
+    QCOMPARE(encoded, QByteArray("second"));
+
+    QCOMPARE(cache.getHits(), (quint64)2);
+    QCOMPARE(cache.getMisses(), (quint64)2);
+}
+
+void OctreeEncodeCacheTests::replaceKeepsByteCount() {
+    OctreeEncodeCache cache(1000);
+    QUuid id = QUuid::createUuid();
+
+    cache.insert(id, 1, QByteArray(100, 'a'));
+    cache.insert(id, 2, QByteArray(40, 'b'));
+    QCOMPARE(cache.getBytes(), 40);
+    QCOMPARE(cache.getEntryCount(), 1);
+
+    cache.clear();
+    QCOMPARE(cache.getBytes(), 0);
+    QCOMPARE(cache.getEntryCount(), 0);
+}
+
+void OctreeEncodeCacheTests::evictsLeastRecentlyUsed() {
+    OctreeEncodeCache cache(300);
+    QUuid first = QUuid::createUuid();
+    QUuid second = QUuid::createUuid();
+    QUuid third = QUuid::createUuid();
+    QByteArray encoded;
+
+    cache.insert(first, 1, QByteArray(100, 'a'));
+    cache.insert(second, 1, QByteArray(100, 'b'));
+    cache.insert(third, 1, QByteArray(100, 'c'));
+
+    // using the first makes the second the least recently used
+    QVERIFY(cache.find(first, 1, encoded));
+
+    cache.insert(QUuid::createUuid(), 1, QByteArray(100, 'd'));
+    QVERIFY(cache.find(first, 1, encoded));
+    QVERIFY(!cache.find(second, 1, encoded));
+    QVERIFY(cache.find(third, 1, encoded));
+    QCOMPARE(cache.getEvictions(), (quint64)1);
+    QCOMPARE(cache.getBytes(), 300);
+
+    // shrinking the budget evicts right away
+    cache.setMaxBytes(100);
+    QCOMPARE(cache.getBytes(), 100);
+    QCOMPARE(cache.getEntryCount(), 1);
+    QVERIFY(cache.find(third, 1, encoded));
+}
+
+void OctreeEncodeCacheTests::skipsItemsOverBudget() {
+    OctreeEncodeCache cache(100);
+    QUuid small = QUuid::createUuid();
+    QByteArray encoded;
+
+    cache.insert(small, 1, QByteArray(50, 'a'));
+    cache.insert(QUuid::createUuid(), 1, QByteArray(101, 'b'));
+
+    // the large item wasn't added, and didn't push out the small one
+    QCOMPARE(cache.getEntryCount(), 1);
+    QVERIFY(cache.find(small, 1, encoded));
+}
@@ -0,0 +1,26 @@
+//
+//  OctreeEncodeCacheTests.h
+//  tests/octree/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_OctreeEncodeCacheTests_h
+#define hifi_OctreeEncodeCacheTests_h
+
+#include <QtTest/QtTest>
+
+class OctreeEncodeCacheTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void findMatchesVersion();
+    void replaceKeepsByteCount();
+    void evictsLeastRecentlyUsed();
+    void skipsItemsOverBudget();
+};
+
+#endif // hifi_OctreeEncodeCacheTests_h
@@ -0,0 +1,119 @@
+//
+//  ScriptSchedulerTests.cpp
+//  tests/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include <ScriptEngine.h>
+#include <ScriptScheduler.h>
+
+#include "ScriptSchedulerTests.h"
+
+QTEST_MAIN(ScriptSchedulerTests)
+
+class TimerCalls {
+public:
+    ScriptSchedulerWorker* worker { nullptr };
+    QObject* handle { nullptr };
+    int calls { 0 };
+    bool clearOnCall { false };
+};
+
+static QScriptValue countCall(QScriptContext* context, QScriptEngine* engine, void* arg) {
+    TimerCalls* timerCalls = static_cast<TimerCalls*>(arg);
+    ++timerCalls->calls;
+    if (timerCalls->clearOnCall) {
+        timerCalls->worker->removeTimer(timerCalls->handle);
+    }
+    return QScriptValue();
+}
+
+// goes around addTimer, which counts the delay from the clock rather than from where the wheel is
+static QObject* insertTimer(ScriptSchedulerWorker& worker, ScriptEngine& engine, TimerCalls& timerCalls,
+                            int intervalMS, bool isSingleShot) {
+    ScriptSchedulerWorker::Timer timer;
+    timer.id = ++worker._lastTimerID;
+    timer.engine = &engine;
+    timer.handle = new QObject(&engine);
+    timer.function = engine.newFunction(countCall, &timerCalls);
+    timer.intervalMS = intervalMS;
+    timer.isSingleShot = isSingleShot;
+
+    worker.insertTimer(timer, intervalMS);
+
+    timerCalls.worker = &worker;
+    timerCalls.handle = timer.handle;
+    return timer.handle;
+}
+
+void ScriptSchedulerTests::singleShotFiresOnce() {
+    ScriptSchedulerWorker worker;
+    ScriptEngine engine("", "singleShotFiresOnce");
+    TimerCalls timerCalls;
+
+    quint64 start = worker._wheelTime;
+    insertTimer(worker, engine, timerCalls, 10, true);
+
+    worker.advanceWheel(start + 9);
+    QCOMPARE(timerCalls.calls, 0);
+    worker.advanceWheel(start + 10);
+    QCOMPARE(timerCalls.calls, 1);
+
+    // further turns of the wheel pass its slot again
+    worker.advanceWheel(start + 600);
+    QCOMPARE(timerCalls.calls, 1);
+    QVERIFY(worker._timers.isEmpty());
+}
+
+void ScriptSchedulerTests::intervalRepeats() {
+    ScriptSchedulerWorker worker;
+    ScriptEngine engine("", "intervalRepeats");
+    TimerCalls timerCalls;
+
+    quint64 start = worker._wheelTime;
+    QObject* handle = insertTimer(worker, engine, timerCalls, 100, false);
+
+    worker.advanceWheel(start + 1000);
+    QCOMPARE(timerCalls.calls, 10);
+    worker.advanceWheel(start + 1099);
+    QCOMPARE(timerCalls.calls, 10);
+
+    worker.removeTimer(handle);
+    worker.advanceWheel(start + 2000);
+    QCOMPARE(timerCalls.calls, 10);
+}
+
+void ScriptSchedulerTests::delaysBeyondOneTurn() {
+    // either side of whole turns of the wheel, and far enough out to need several rounds
+    for (int delayMS : { 1, 255, 256, 257, 512, 513, 1000, 5000 }) {
+        ScriptSchedulerWorker worker;
+        ScriptEngine engine("", "delaysBeyondOneTurn");
+        TimerCalls timerCalls;
+
+        quint64 start = worker._wheelTime;
+        insertTimer(worker, engine, timerCalls, delayMS, true);
+
+        worker.advanceWheel(start + delayMS - 1);
+        QCOMPARE(timerCalls.calls, 0);
+        worker.advanceWheel(start + delayMS);
+        QCOMPARE(timerCalls.calls, 1);
+    }
+}
+
+void ScriptSchedulerTests::timerClearedFromItsOwnCallback() {
+    ScriptSchedulerWorker worker;
+    ScriptEngine engine("", "timerClearedFromItsOwnCallback");
+    TimerCalls timerCalls;
+    timerCalls.clearOnCall = true;
+
+    quint64 start = worker._wheelTime;
+    insertTimer(worker, engine, timerCalls, 10, false);
+
+    worker.advanceWheel(start + 100);
+    QCOMPARE(timerCalls.calls, 1);
+    QVERIFY(worker._timers.isEmpty());
+}
@@ -0,0 +1,26 @@
+//
+//  ScriptSchedulerTests.h
+//  tests/script-engine/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#ifndef hifi_ScriptSchedulerTests_h
+#define hifi_ScriptSchedulerTests_h
+
+#include <QtTest/QtTest>
+
+class ScriptSchedulerTests : public QObject {
+    Q_OBJECT
+
+private slots:
+    void singleShotFiresOnce();
+    void intervalRepeats();
+    void delaysBeyondOneTurn();
+    void timerClearedFromItsOwnCallback();
+};
+
+#endif // hifi_ScriptSchedulerTests_h
@@ -0,0 +1,87 @@
+//
+//  GLMHelpersTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "GLMHelpersTests.h"
+
+#include <GLMHelpers.h>
+#include <NumericalConstants.h>
+
+QTEST_MAIN(GLMHelpersTests)
+
+static QVector<glm::quat> testOrientations(bool includeTies = true) {
+    QVector<glm::quat> orientations;
+    orientations << glm::quat();
+    orientations << glm::quat(-1.0f, 0.0f, 0.0f, 0.0f);
+    orientations << glm::angleAxis(PI / 3.0f, glm::vec3(1.0f, 0.0f, 0.0f));
+    orientations << glm::angleAxis(PI, glm::vec3(0.0f, 1.0f, 0.0f));
+    orientations << glm::angleAxis(-0.3f, glm::normalize(glm::vec3(1.0f, -2.0f, 3.0f)));
+    if (includeTies) {
+        // all four components equal, the largest is a tie
+        orientations << glm::quat(0.5f, 0.5f, 0.5f, 0.5f);
+        orientations << glm::quat(0.5f, -0.5f, 0.5f, -0.5f);
+    }
+    return orientations;
+}
+
+void GLMHelpersTests::testSmallestThreeQuatRoundTrip() {
+    // 15 bits over +/- 1/sqrt(2) is a step of ~4.3e-5, keep a generous margin for the rebuilt component
+    const float MAX_ANGLE_ERROR = 0.001f;
+
+    foreach (const glm::quat& orientation, testOrientations()) {
+        glm::quat unpacked = unpackOrientationQuatFromSmallestThree(packOrientationQuatToSmallestThree(orientation));
+
+        // q and -q are the same orientation
+        float dot = fabsf(glm::dot(glm::normalize(orientation), unpacked));
+        float angleError = 2.0f * acosf(glm::min(dot, 1.0f));
+        QVERIFY2(angleError < MAX_ANGLE_ERROR, qPrintable(QString("angle error %1").arg(angleError)));
+    }
+}
+
+void GLMHelpersTests::testSmallestThreeQuatFitsInBits() {
+    const uint64_t UNUSED_BITS_MASK = ~(((uint64_t)1 << SMALLEST_THREE_QUAT_BITS) - 1);
+
+    foreach (const glm::quat& orientation, testOrientations()) {
+        QCOMPARE(packOrientationQuatToSmallestThree(orientation) & UNUSED_BITS_MASK, (uint64_t)0);
+    }
+
+    // packing an unpacked value should give back the same bits, so a relayed joint isn't seen as changed.
+    // with a tie for the largest component the rebuilt one can come back smaller and the dropped index moves.
+    foreach (const glm::quat& orientation, testOrientations(false)) {
+        uint64_t packed = packOrientationQuatToSmallestThree(orientation);
+        QCOMPARE(packOrientationQuatToSmallestThree(unpackOrientationQuatFromSmallestThree(packed)), packed);
+    }
+}
+
+void GLMHelpersTests::testSignedBitsVec3RoundTrip() {
+    const int BITS_PER_COMPONENT = 12;
+    const float RANGE = 2.0f;
+    const float MAX_ERROR = RANGE / ((1 << (BITS_PER_COMPONENT - 1)) - 1);
+
+    QVector<glm::vec3> vectors;
+    vectors << glm::vec3(0.0f) << glm::vec3(RANGE, -RANGE, 0.5f) << glm::vec3(-0.001f, 1.234f, -1.999f);
+
+    foreach (const glm::vec3& vector, vectors) {
+        uint64_t packed = packFloatVec3ToSignedBits(vector, RANGE, BITS_PER_COMPONENT);
+        QCOMPARE(packed >> (3 * BITS_PER_COMPONENT), (uint64_t)0);
+
+        glm::vec3 unpacked = unpackFloatVec3FromSignedBits(packed, RANGE, BITS_PER_COMPONENT);
+        for (int i = 0; i < 3; i++) {
+            QVERIFY(fabsf(unpacked[i] - vector[i]) <= MAX_ERROR);
+        }
+    }
+
+    // out of range components are clamped
+    glm::vec3 clamped = unpackFloatVec3FromSignedBits(packFloatVec3ToSignedBits(glm::vec3(10.0f, -10.0f, 0.0f), RANGE,
+                                                                                 BITS_PER_COMPONENT), RANGE, BITS_PER_COMPONENT);
+    QCOMPARE(clamped, glm::vec3(RANGE, -RANGE, 0.0f));
+
+    // a zero range packs to zero instead of dividing by it
+    QCOMPARE(packFloatVec3ToSignedBits(glm::vec3(1.0f), 0.0f, BITS_PER_COMPONENT), (uint64_t)0);
+}
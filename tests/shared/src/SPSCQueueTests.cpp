@@ -0,0 +1,96 @@
+//
+//  SPSCQueueTests.cpp
+//  tests/shared/src
+//
+//  Copyright 2015 High Fidelity, Inc.
+//
+//  Distributed under the Apache License, Version 2.0.
+//  See the accompanying file LICENSE or http://www.apache.org/licenses/LICENSE-2.0.html
+//
+
+#include "SPSCQueueTests.h"
+
+#include <memory>
+#include <thread>
+
+#include <SPSCQueue.h>
+
+QTEST_MAIN(SPSCQueueTests)
+
+void SPSCQueueTests::capacityIsPowerOfTwo() {
+    QCOMPARE(SPSCQueue<int>(1).capacity(), (size_t)1);
+    QCOMPARE(SPSCQueue<int>(5).capacity(), (size_t)8);
+    QCOMPARE(SPSCQueue<int>(64).capacity(), (size_t)64);
+}
+
+void SPSCQueueTests::pushUntilFull() {
+    SPSCQueue<int> queue(4);
+
+    for (int i = 0; i < 4; i++) {
+        QVERIFY(queue.push(int(i)));
+    }
+    QVERIFY(!queue.push(4));
+    QCOMPARE(queue.size(), (size_t)4);
+
+    int item = -1;
+    for (int i = 0; i < 4; i++) {
+        QVERIFY(queue.pop(item));
+        QCOMPARE(item, i);
+    }
+    QVERIFY(!queue.pop(item));
+    QVERIFY(queue.isEmpty());
+}
+
+void SPSCQueueTests::wrapsAround() {
+    SPSCQueue<std::unique_ptr<int>> queue(4);
+
+    // go round the ring several times with the queue partly full, so the slots are reused at every offset
+    int next = 0;
+    int expected = 0;
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 3; i++) {
+            QVERIFY(queue.push(std::unique_ptr<int>(new int(next++))));
+        }
+        std::unique_ptr<int> item;
+        for (int i = 0; i < 2; i++) {
+            QVERIFY(queue.pop(item));
+            QCOMPARE(*item, expected++);
+        }
+    }
+
+    std::unique_ptr<int> item;
+    while (queue.pop(item)) {
+        QCOMPARE(*item, expected++);
+    }
+    QCOMPARE(expected, next);
+}
+
+void SPSCQueueTests::handsOffAcrossThreads() {
+    const int NUM_ITEMS = 1000000;
+    SPSCQueue<int> queue(256);
+
+    std::thread producer([&] {
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            while (!queue.push(int(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // the consumer has to see every item exactly once and in order
+    int expected = 0;
+    bool inOrder = true;
+    int item;
+    while (expected < NUM_ITEMS) {
+        if (queue.pop(item)) {
+            inOrder = inOrder && (item == expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    QVERIFY(inOrder);
+    QVERIFY(queue.isEmpty());
+}
@@ -55,6 +55,9 @@ const QCommandLineOption MESSAGE_SEED {
 const QCommandLineOption STATS_INTERVAL {
     "stats-interval", "stats output interval (default is 100ms)", "milliseconds"
 };
+const QCommandLineOption LOSS_PERCENT {
+    "loss", "percentage of received data packets to drop, simulating a lossy link (receiver only, default is 0)", "percent"
+};
 
 const QStringList CLIENT_STATS_TABLE_HEADERS {
     "Send (P/s)", "Est. Max (P/s)", "RTT (ms)", "CW (P)", "Period (us)",
@@ -65,7 +68,7 @@ const QStringList CLIENT_STATS_TABLE_HEADERS {
 const QStringList SERVER_STATS_TABLE_HEADERS {
     "  Mb/s  ", "Recv P/s", "Est. Max (P/s)", "RTT (ms)", "CW (P)",
     "Sent ACK", "Sent LACK", "Sent NAK", "Sent TNAK",
-    "Recv ACK2", "Duplicates (P)"
+    "Recv ACK2", "Duplicates (P)", "Dropped (P)", "Avg Mb/s"
 };
 
 UDTTest::UDTTest(int& argc, char** argv) :
@@ -178,6 +181,22 @@ UDTTest::UDTTest(int& argc, char** argv) :
         // so that they can be verified
         _socket.setPacketListHandler(
             [this](std::unique_ptr<udt::PacketList> packetList) { handlePacketList(std::move(packetList)); });
+        
+        if (_argumentParser.isSet(LOSS_PERCENT)) {
+            _lossPercent = _argumentParser.value(LOSS_PERCENT).toFloat();
+            qDebug() << "Dropping" << _lossPercent << "% of received data packets";
+            
+            // dropped before the connection sees them, so the sender has to find out and re-send like on a real link
+            _socket.setPacketFilterOperator([this](const udt::Packet& packet) {
+                if (_lossDistribution(_lossGenerator) < _lossPercent) {
+                    ++_droppedPackets;
+                    return false;
+                }
+                return true;
+            });
+        }
+    } else if (_argumentParser.isSet(LOSS_PERCENT)) {
+        qWarning() << "loss has no effect when sending - pass it to the receiver instead. It will be ignored.";
     }
     
     // the sender reports stats every 100 milliseconds, unless passed a custom value
@@ -201,7 +220,7 @@ void UDTTest::parseArguments() {
     _argumentParser.addOptions({
         PORT_OPTION, TARGET_OPTION, PACKET_SIZE, MIN_PACKET_SIZE, MAX_PACKET_SIZE,
         MAX_SEND_BYTES, MAX_SEND_PACKETS, UNRELIABLE_PACKETS, ORDERED_PACKETS,
-        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL
+        MESSAGE_SIZE, MESSAGE_SEED, STATS_INTERVAL, LOSS_PERCENT
     });
     
     if (!_argumentParser.parse(arguments())) {
@@ -386,6 +405,17 @@ void UDTTest::sampleStats() {
             
             double megabitsPerSecond = (stats.receivedBytes * MEGABITS_PER_BYTE * MS_PER_SECOND) / _statsInterval;
             
+            // the average since data started coming in is what to compare between runs at different loss rates
+            if (!_receiveTimer.isValid() && stats.receivedBytes > 0) {
+                _receiveTimer.start();
+            } else if (_receiveTimer.isValid()) {
+                _totalReceivedBytes += stats.receivedBytes;
+            }
+            
+            qint64 receivingMsecs = _receiveTimer.isValid() ? _receiveTimer.elapsed() : 0;
+            double averageMegabitsPerSecond = (receivingMsecs > 0)
+                ? (_totalReceivedBytes * MEGABITS_PER_BYTE * MS_PER_SECOND) / receivingMsecs : 0.0;
+            
             // setup a list of left justified values
             QStringList values {
                 QString::number(megabitsPerSecond, 'f', 2).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
@@ -398,7 +428,9 @@ void UDTTest::sampleStats() {
                 QString::number(stats.events[udt::ConnectionStats::Stats::SentNAK]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
                 QString::number(stats.events[udt::ConnectionStats::Stats::SentTimeoutNAK]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
                 QString::number(stats.events[udt::ConnectionStats::Stats::ReceivedACK2]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
-                QString::number(stats.events[udt::ConnectionStats::Stats::Duplicate]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size())
+                QString::number(stats.events[udt::ConnectionStats::Stats::Duplicate]).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
+                QString::number(_droppedPackets).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size()),
+                QString::number(averageMegabitsPerSecond, 'f', 2).rightJustified(SERVER_STATS_TABLE_HEADERS[++headerIndex].size())
             };
             
             // output this line of values
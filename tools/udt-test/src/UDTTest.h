@@ -19,6 +19,7 @@
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
 
 #include <udt/Constants.h>
 #include <udt/Socket.h>
@@ -62,6 +63,14 @@ private:
     int _totalQueuedBytes { 0 }; // keeps track of the number of bytes we have already queued
     
     int _statsInterval { 100 }; // recording interval for stats in milliseconds
+    
+    float _lossPercent { 0.0f }; // percentage of received data packets dropped to simulate a lossy link
+    std::mt19937 _lossGenerator { _randomDevice() }; // kept apart from _generator so ordered data still verifies
+    std::uniform_real_distribution<float> _lossDistribution { 0.0f, 100.0f };
+    int _droppedPackets { 0 };
+    
+    quint64 _totalReceivedBytes { 0 };
+    QElapsedTimer _receiveTimer; // started at the first stats sample with data in it, for average throughput
 };
 
 #endif // hifi_UDTTest_h